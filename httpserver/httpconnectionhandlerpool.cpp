@@ -55,6 +55,25 @@ HttpConnectionHandler* HttpConnectionHandlerPool::getConnectionHandler() {
 }
 
 
+int HttpConnectionHandlerPool::getPoolSize() {
+    mutex.lock();
+    int size=pool.count();
+    mutex.unlock();
+    return size;
+}
+
+
+int HttpConnectionHandlerPool::getBusyCount() {
+    int busy=0;
+    mutex.lock();
+    foreach(HttpConnectionHandler* handler, pool) {
+        if (handler->isBusy()) busy++;
+    }
+    mutex.unlock();
+    return busy;
+}
+
+
 void HttpConnectionHandlerPool::cleanup() {
     int maxIdleHandlers=settings->value("minThreads",1).toInt();
     int idleCounter=0;
@@ -62,6 +62,12 @@ public:
     /** Get a free connection handler, or 0 if not available. */
     HttpConnectionHandler* getConnectionHandler();
 
+    /** Get the number of connection handlers currently in the pool */
+    int getPoolSize();
+
+    /** Get the number of connection handlers currently serving a connection */
+    int getBusyCount();
+
 private:
 
     /** Settings for this pool */
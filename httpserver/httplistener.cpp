@@ -14,6 +14,7 @@ HttpListener::HttpListener(QSettings* settings, HttpRequestHandler* requestHandl
     Q_ASSERT(settings!=0);
     Q_ASSERT(requestHandler!=0);
     pool=NULL;
+    rejected=0;
     this->settings=settings;
     this->requestHandler=requestHandler;
     // Reqister type of socketDescriptor for signal/slot handling
@@ -54,6 +55,16 @@ void HttpListener::close() {
     }
 }
 
+int HttpListener::getLoad(int &threads, int &busy, int &maxThreads) {
+    threads=busy=0;
+    if (pool) {
+        threads=pool->getPoolSize();
+        busy=pool->getBusyCount();
+    }
+    maxThreads=settings->value("maxThreads",100).toInt();
+    return rejected.load();
+}
+
 void HttpListener::incomingConnection(tSocketDescriptor socketDescriptor) {
 #ifdef SUPERVERBOSE
     wDebug("HttpListener: New connection");
@@ -75,6 +86,7 @@ void HttpListener::incomingConnection(tSocketDescriptor socketDescriptor) {
     else {
         // Reject the connection
         wDebug("HttpListener: Too many incoming connections");
+        rejected.ref();
         QTcpSocket* socket=new QTcpSocket(this);
         socket->setSocketDescriptor(socketDescriptor);
         connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
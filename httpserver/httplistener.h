@@ -9,6 +9,7 @@
 #include <QTcpServer>
 #include <QSettings>
 #include <QBasicTimer>
+#include <QAtomicInt>
 #include "httpglobal.h"
 #include "httpconnectionhandler.h"
 #include "httpconnectionhandlerpool.h"
@@ -68,6 +69,15 @@ public:
     */
     void close();
 
+    /**
+      Report the current load on the listener, used for monitoring.
+      @param threads Receives the number of connection handlers in the pool
+      @param busy Receives the number of connection handlers serving a connection
+      @param maxThreads Receives the configured upper limit of connection handlers
+      @return number of connections rejected with 503 since the listener was created
+    */
+    int getLoad(int &threads, int &busy, int &maxThreads);
+
 protected:
 
     /** Serves new incoming connection requests */
@@ -84,6 +94,9 @@ private:
     /** Pool of connection handlers */
     HttpConnectionHandlerPool* pool;
 
+    /** Number of connections rejected because the pool was exhausted */
+    QAtomicInt rejected;
+
 signals:
 
     /**
@@ -0,0 +1,48 @@
+/*
+ * Library:   lmfit (Levenberg-Marquardt least squares fitting)
+ *
+ * File:      lmcurve_user.c
+ *
+ * Contents:  Implements lmcurve_user(), a variant of lmcurve() that passes
+ *            a user data pointer through to the model function.
+ *
+ * Copyright: GoldenCheetah Contributors (2026), after lmcurve by
+ *            Joachim Wuttke, Forschungszentrum Juelich GmbH (2004-2013)
+ *
+ * License:   see ../COPYING (FreeBSD)
+ */
+
+#include "lmmin.h"
+#include "lmcurve_user.h"
+
+
+typedef struct {
+    const double *const t;
+    const double *const y;
+    double (*const g) (const double t, const double *par, void *user);
+    void *const user;
+} lmcurve_user_data_struct;
+
+
+void lmcurve_user_evaluate(
+    const double *const par, const int m_dat, const void *const data,
+    double *const fvec, int *const info)
+{
+    const lmcurve_user_data_struct *d = (const lmcurve_user_data_struct*)data;
+
+    for (int i = 0; i < m_dat; i++ )
+        fvec[i] = d->y[i] - d->g(d->t[i], par, d->user);
+}
+
+
+void lmcurve_user(
+    const int n_par, double *const par, const int m_dat,
+    const double *const t, const double *const y,
+    double (*const g)(const double t, const double *const par, void *user),
+    void *const user,
+    const lm_control_struct *const control, lm_status_struct *const status)
+{
+    lmcurve_user_data_struct data = {t, y, g, user};
+    lmmin(n_par, par, m_dat, NULL, (const void *const) &data,
+          lmcurve_user_evaluate, control, status);
+}
@@ -0,0 +1,40 @@
+/*
+ * Library:   lmfit (Levenberg-Marquardt least squares fitting)
+ *
+ * File:      lmcurve_user.h
+ *
+ * Contents:  Declares lmcurve_user(), a variant of lmcurve() that passes
+ *            a user data pointer through to the model function, so the
+ *            model needn't be reached through a global and independent
+ *            fits can run at the same time.
+ *
+ * Copyright: GoldenCheetah Contributors (2026), after lmcurve by
+ *            Joachim Wuttke, Forschungszentrum Juelich GmbH (2004-2013)
+ *
+ * License:   see ../COPYING (FreeBSD)
+ */
+
+#ifndef LMCURVEUSER_H
+#define LMCURVEUSER_H
+#undef __BEGIN_DECLS
+#undef __END_DECLS
+#ifdef __cplusplus
+#define __BEGIN_DECLS extern "C" {
+#define __END_DECLS }
+#else
+#define __BEGIN_DECLS /* empty */
+#define __END_DECLS   /* empty */
+#endif
+
+#include <lmstruct.h>
+
+__BEGIN_DECLS
+
+void lmcurve_user(
+    const int n_par, double* par, const int m_dat,
+    const double* t, const double* y,
+    double (*g)(const double t, const double* par, void* user), void* user,
+    const lm_control_struct* control, lm_status_struct* status);
+
+__END_DECLS
+#endif /* LMCURVEUSER_H */
@@ -463,8 +463,36 @@ public:
     enum EntryType { Directory, File, Symlink };
 
     void addEntry(EntryType type, const QString &fileName, const QByteArray &contents);
+    void writeEntry(EntryType type, const QString &fileName, const QByteArray &data, bool deflated, uint crc_32, uint size);
 };
 
+static QByteArray deflateContents(const QByteArray &contents)
+{
+    QByteArray data;
+    ulong len = contents.length();
+    // shamelessly copied form zlib
+    len += (len >> 12) + (len >> 14) + 11;
+    int res;
+    do {
+        data.resize(len);
+        res = deflate((uchar*)data.data(), &len, (const uchar*)contents.constData(), contents.length());
+
+        switch (res) {
+        case Z_OK:
+            data.resize(len);
+            break;
+        case Z_MEM_ERROR:
+            qWarning("QZip: Z_MEM_ERROR: Not enough memory to compress file, skipping");
+            data.resize(0);
+            break;
+        case Z_BUF_ERROR:
+            len *= 2;
+            break;
+        }
+    } while (res == Z_BUF_ERROR);
+    return data;
+}
+
 LocalFileHeader CentralFileHeader::toLocalHeader() const
 {
     LocalFileHeader h;
@@ -580,12 +608,6 @@ void ZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const Q
     ZDEBUG() << "adding" << entryTypes[type] <<":" << fileName.toUtf8().data() << (type == 2 ? QByteArray(" -> " + contents).constData() : "");
 #endif
 
-    if (! (device->isOpen() || device->open(QIODevice::WriteOnly))) {
-        status = ZipWriter::FileOpenError;
-        return;
-    }
-    device->seek(start_of_directory);
-
     // don't compress small files
     ZipWriter::CompressionPolicy compression = compressionPolicy;
     if (compressionPolicy == ZipWriter::AutoCompress) {
@@ -595,43 +617,32 @@ void ZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const Q
             compression = ZipWriter::AlwaysCompress;
     }
 
+// TODO add a check if data.length() > contents.length().  Then try to store the original and revert the compression method to be uncompressed
+    bool deflated = (compression == ZipWriter::AlwaysCompress);
+    QByteArray data = deflated ? deflateContents(contents) : contents;
+    uint crc_32 = ::crc32(0, 0, 0);
+    crc_32 = ::crc32(crc_32, (const uchar *)contents.constData(), contents.length());
+
+    writeEntry(type, fileName, data, deflated, crc_32, contents.length());
+}
+
+void ZipWriterPrivate::writeEntry(EntryType type, const QString &fileName, const QByteArray &data, bool deflated, uint crc_32, uint size)
+{
+    if (! (device->isOpen() || device->open(QIODevice::WriteOnly))) {
+        status = ZipWriter::FileOpenError;
+        return;
+    }
+    device->seek(start_of_directory);
+
     FileHeader header;
     memset(&header.h, 0, sizeof(CentralFileHeader));
     writeUInt(header.h.signature, 0x02014b50);
 
     writeUShort(header.h.version_needed, 0x14);
-    writeUInt(header.h.uncompressed_size, contents.length());
+    writeUInt(header.h.uncompressed_size, size);
     writeMSDosDate(header.h.last_mod_file, QDateTime::currentDateTime());
-    QByteArray data = contents;
-    if (compression == ZipWriter::AlwaysCompress) {
-        writeUShort(header.h.compression_method, 8);
-
-       ulong len = contents.length();
-        // shamelessly copied form zlib
-        len += (len >> 12) + (len >> 14) + 11;
-        int res;
-        do {
-            data.resize(len);
-            res = deflate((uchar*)data.data(), &len, (const uchar*)contents.constData(), contents.length());
-
-            switch (res) {
-            case Z_OK:
-                data.resize(len);
-                break;
-            case Z_MEM_ERROR:
-                qWarning("QZip: Z_MEM_ERROR: Not enough memory to compress file, skipping");
-                data.resize(0);
-                break;
-            case Z_BUF_ERROR:
-                len *= 2;
-                break;
-            }
-        } while (res == Z_BUF_ERROR);
-    }
-// TODO add a check if data.length() > contents.length().  Then try to store the original and revert the compression method to be uncompressed
+    if (deflated) writeUShort(header.h.compression_method, 8);
     writeUInt(header.h.compressed_size, data.length());
-    uint crc_32 = ::crc32(0, 0, 0);
-    crc_32 = ::crc32(crc_32, (const uchar *)contents.constData(), contents.length());
     writeUInt(header.h.crc_32, crc_32);
 
     header.file_name = fileName.toLocal8Bit();
@@ -1202,6 +1213,25 @@ void ZipWriter::addFile(const QString &fileName, QIODevice *device)
         device->close();
 }
 
+/*!
+    Deflate \a data and calculate its crc ready for addCompressedFile().
+    Touches no state so can be called from any thread.
+*/
+QByteArray ZipWriter::compress(const QByteArray &data, uint *crc_32)
+{
+    *crc_32 = ::crc32(::crc32(0, 0, 0), (const uchar *)data.constData(), data.length());
+    return deflateContents(data);
+}
+
+/*!
+    Add a file whose contents were deflated by compress(), \a size is
+    the length of the original contents.
+*/
+void ZipWriter::addCompressedFile(const QString &fileName, const QByteArray &compressed, uint crc_32, uint size)
+{
+    d->writeEntry(ZipWriterPrivate::File, QDir::fromNativeSeparators(fileName), compressed, true, crc_32, size);
+}
+
 /*!
     Create a new directory in the archive with the specified \a dirName and
     the \a permissions;
@@ -100,6 +100,12 @@ public:
 
     void addFile(const QString &fileName, QIODevice *device);
 
+    // compress ahead of time (e.g. from a worker thread) with compress()
+    // and add the result with addCompressedFile(), compression is always
+    // deflate regardless of the compression policy
+    static QByteArray compress(const QByteArray &data, uint *crc_32);
+    void addCompressedFile(const QString &fileName, const QByteArray &compressed, uint crc_32, uint size);
+
     void addDirectory(const QString &dirName);
 
     void addSymLink(const QString &fileName, const QString &destination);
@@ -101,6 +101,7 @@ ANT::ANT(QObject *parent, DeviceConfiguration *devConf, QString athlete) : QThre
     baud=115200;
     powerchannels=0;
     configuring = false;
+    logging = 0;
 
     // kickr
     kickrDeviceID = 0;
@@ -126,10 +127,8 @@ ANT::ANT(QObject *parent, DeviceConfiguration *devConf, QString athlete) : QThre
     if (!elapsedTimer.isMonotonic())
         qDebug() << "Caution: ANT timer is not monotonic";
 
-    // state machine
-    state = ST_WAIT_FOR_SYNC;
-    length = bytes = 0;
-    checksum = ANT_SYNC_BYTE;
+    // receive buffer
+    rx.clear();
 
     // ant ids - may not be configured of course
     if (devConf && devConf->deviceProfile.length())
@@ -246,9 +245,7 @@ void ANT::run()
 
     for (int i=0; i<ANT_MAX_CHANNELS; i++) antChannel[i]->init();
 
-    state = ST_WAIT_FOR_SYNC;
-    length = bytes = 0;
-    checksum = ANT_SYNC_BYTE;
+    rx.clear();
 
     if (openPort() == 0) {
 
@@ -268,14 +265,18 @@ void ANT::run()
 
     while(1)
     {
-        // read more bytes from the device
-        uint8_t byte;
+        // read whatever the device has straight into the free space
+        // in the receive buffer, it never fills since all complete
+        // messages are consumed after each read
+        int space;
+        unsigned char *into = rx.space(space);
 
-        int rc = rawRead(&byte, 1);
+        int rc = rawRead(into, space);
 
-        if (rc > 0)
-            receiveByte((unsigned char)byte);
-        else {
+        if (rc > 0) {
+            rx.received(rc);
+            receiveMessages();
+        } else if (rc < 0) {
 
             // Recognise USB device removal. Linux transitions through -5 (I/O error)
             // to -6 (No such device or address). Windows seems to stick on -5
@@ -949,52 +950,15 @@ ANT::sendMessage(ANTMessage m) {
     rawWrite((uint8_t*)padding, 5);
 }
 
+//
+// Frame complete messages from the receive buffer, a message is
+// sync, length, id, data[length], checksum. Anything that doesn't
+// frame or checksum is skipped a byte at a time to resync.
+//
 void
-ANT::receiveByte(unsigned char byte) {
-
-    switch (state) {
-        case ST_WAIT_FOR_SYNC:
-            if (byte == ANT_SYNC_BYTE) {
-                state = ST_GET_LENGTH;
-                checksum = ANT_SYNC_BYTE;
-                rxMessage[0] = byte;
-            }
-            break;
-
-        case ST_GET_LENGTH:
-            if ((byte == 0) || (byte > ANT_MAX_LENGTH)) {
-                state = ST_WAIT_FOR_SYNC;
-            }
-            else {
-              rxMessage[ANT_OFFSET_LENGTH] = byte;
-                checksum ^= byte;
-                length = byte;
-                bytes = 0;
-                state = ST_GET_MESSAGE_ID;
-            }
-            break;
-
-        case ST_GET_MESSAGE_ID:
-            rxMessage[ANT_OFFSET_ID] = byte;
-            checksum ^= byte;
-            state = ST_GET_DATA;
-            break;
-
-        case ST_GET_DATA:
-            rxMessage[ANT_OFFSET_DATA + bytes] = byte;
-            checksum ^= byte;
-            if (++bytes >= length){
-                state = ST_VALIDATE_PACKET;
-            }
-            break;
+ANT::receiveMessages(void) {
 
-        case ST_VALIDATE_PACKET:
-            if (checksum == byte){
-                processMessage();
-            }
-            state = ST_WAIT_FOR_SYNC;
-            break;
-    }
+    while (rx.next(rxMessage)) processMessage();
 }
 
 
@@ -1014,16 +978,24 @@ ANT::handleChannelEvent(void) {
 void
 ANT::processMessage(void) {
 
-    ANTMessage m(this, rxMessage); // for debug!
-
 //fprintf(stderr, "<< receive %i: ", rxMessage[ANT_OFFSET_CHANNEL_NUMBER]);
-//for(int i=0; i<m.length+3; i++) fprintf(stderr, "%02x ", m.data[i]);
+//for(int i=0; i<rxMessage[ANT_OFFSET_LENGTH]+3; i++) fprintf(stderr, "%02x ", rxMessage[i]);
 //fprintf(stderr, "\n");
 
-    struct timeval timestamp;
-    get_timeofday (&timestamp);
-    unsigned char RS = 'R';
-    emit receivedAntMessage(RS, m, timestamp);
+    // the log only wants the raw bytes, so don't decode the message
+    // and don't bother at all unless someone is logging
+    if (logging.load()) {
+        ANTMessage m;
+        memcpy(m.data, rxMessage, ANT_MAX_MESSAGE_SIZE);
+        m.sync = rxMessage[0];
+        m.length = rxMessage[1];
+        m.type = rxMessage[2];
+
+        struct timeval timestamp;
+        get_timeofday (&timestamp);
+        unsigned char RS = 'R';
+        emit receivedAntMessage(RS, m, timestamp);
+    }
 
     switch (rxMessage[ANT_OFFSET_ID]) {
         case ANT_NOTIF_STARTUP:
@@ -1253,6 +1225,8 @@ int ANT::rawWrite(uint8_t *bytes, int size) // unix!!
 
 }
 
+// returns the number of bytes read, 0 when nothing arrived whilst
+// waiting or -ve on error when the caller should back off
 int ANT::rawRead(uint8_t bytes[], int size)
 {
 #ifdef WIN32
@@ -1260,8 +1234,10 @@ int ANT::rawRead(uint8_t bytes[], int size)
     switch (usbMode) {
 #ifdef GC_HAVE_USBXPRESS
     case USB1:
-        return USBXpress::read(&devicePort, bytes, size);
-        break;
+    {
+        int rc = USBXpress::read(&devicePort, bytes, size);
+        return rc ? rc : -1; // nothing there, caller backs off
+    }
 #endif
     case USB2:
         return usb2->read((char *)bytes, size);
@@ -1280,17 +1256,21 @@ int ANT::rawRead(uint8_t bytes[], int size)
         return usb2->read((char *)bytes, size);
     }
 #endif
-    int i=0;
-    uint8_t byte;
-
-    // read one byte at a time sleeping when no data ready
-    // until we timeout waiting then return error
-    for (i=0; i<size; i++) {
-        int rc = read(devicePort, &byte, 1);
-        if (rc == -1 || rc == 0) return -1; // error!
-        else bytes[i] = byte;
-    }
-    return i;
+    // wait for the port to have something for us and
+    // then take everything that is there in one go
+    struct pollfd fds;
+    fds.fd = devicePort;
+    fds.events = POLLIN;
+    fds.revents = 0;
+
+    int rc = poll(&fds, 1, ANT_POLL_TIMEOUT);
+    if (rc == 0) return 0; // timed out, nothing arrived
+    if (rc < 0) return errno == EINTR ? 0 : -1;
+
+    rc = read(devicePort, bytes, size);
+    if (rc == -1 && (errno == EAGAIN || errno == EINTR)) return 0;
+    if (rc <= 0) return -1; // error or hangup
+    return rc;
 
 #endif
     return -1; // keep compiler happy.
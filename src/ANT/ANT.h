@@ -42,6 +42,7 @@
 #include <QProgressDialog>
 #include <QFile>
 #include <QSemaphore>
+#include <QAtomicInt>
 
 //
 // Time
@@ -70,6 +71,7 @@
 #else
 #include <termios.h> // unix!!
 #include <unistd.h> // unix!!
+#include <poll.h> // unix!!
 #include <sys/ioctl.h>
 #ifndef N_TTY // for OpenBSD
 #define N_TTY 0
@@ -145,6 +147,7 @@ struct setChannelAtom {
 //======================================================================
 
 #include "ANTMessages.h"
+#include "ANTFramer.h"
 
 // ANT constants
 #define ANT_MAX_DATA_MESSAGE_SIZE    8
@@ -204,14 +207,14 @@ struct setChannelAtom {
 #define ANT_OFFSET_MESSAGE_ID      4
 #define ANT_OFFSET_MESSAGE_CODE    5
 
-// other ANT stuff
-#define ANT_SYNC_BYTE        0xA4
-#define ANT_MAX_LENGTH       9
+// other ANT stuff, framing is in ANTFramer.h
 #define ANT_KEY_LENGTH       8
 #define ANT_MAX_BURST_DATA   8
-#define ANT_MAX_MESSAGE_SIZE 12
 #define ANT_MAX_CHANNELS     8
 
+// receive buffering
+#define ANT_POLL_TIMEOUT     10  // ms to wait for serial data before checking for commands
+
 // Channel messages
 #define RESPONSE_NO_ERROR               0
 #define EVENT_RX_SEARCH_TIMEOUT         1
@@ -443,6 +446,7 @@ public slots:
     int setup();                                // reset system, network key and device pairing - moved out of start()
     bool isConfiguring() { return configuring; }
     void setConfigurationMode(bool x) { configuring = x; }
+    void setLogging(bool x) { logging.store(x ? 1 : 0); } // emit received messages for antlog.raw
     void setChannel(int channel, int device_number, int channel_type) {
         channelQueue.enqueue(setChannelAtom(channel, device_number, channel_type));
     }
@@ -497,7 +501,7 @@ public:
 
     // transmission
     void sendMessage(ANTMessage);
-    void receiveByte(unsigned char byte);
+    void receiveMessages(void);
     void handleChannelEvent(void);
     void processMessage(void);
 
@@ -682,6 +686,7 @@ private:
     QMutex pvars;  // lock/unlock access to telemetry data between thread and controller
     int Status;     // what status is the client in?
     bool configuring; // set to true if we're in configuration mode.
+    QAtomicInt logging; // set whilst the ANT log is open
     int channels;  // how many 4 or 8 ? depends upon the USB stick...
 
     // access to device file
@@ -710,12 +715,8 @@ private:
     bool ANT_Reset_Acknowledge;
     unsigned char rxMessage[ANT_MAX_MESSAGE_SIZE];
 
-    // state machine whilst receiving bytes
-    enum States {ST_WAIT_FOR_SYNC, ST_GET_LENGTH, ST_GET_MESSAGE_ID, ST_GET_DATA, ST_VALIDATE_PACKET} state;
-    //enum States state;
-    int length;
-    int bytes;
-    int checksum;
+    // bytes read from the device, messages are framed in place
+    ANTFramer rx;
     int powerchannels; // how many power channels do we have?
     QDateTime lastCadenceMessage;
 
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_ANTFramer_h
+#define _GC_ANTFramer_h 1
+
+// framing of the ANT serial protocol
+#define ANT_SYNC_BYTE        0xA4
+#define ANT_MAX_LENGTH       9
+#define ANT_MAX_MESSAGE_SIZE 12
+
+// receive buffering
+#define ANT_RX_BUFFER        512 // must be a power of 2
+
+//
+// The bytes read from an ANT stick. The device is read straight into
+// the free space and complete messages are framed in place, so nothing
+// is allocated per message; bad frames resync a byte at a time. Head
+// and tail run freely and are masked when indexing.
+//
+// It has no dependencies so it can be exercised on its own, see the
+// pty replay test in test/antreplay.
+//
+class ANTFramer
+{
+    public:
+        ANTFramer() : head(0), tail(0) {}
+
+        void clear() { head = tail = 0; }
+
+        // contiguous free space to read into, it never fills up
+        // as long as complete messages are taken after each read
+        unsigned char *space(int &bytes) {
+            unsigned int offset = head & (ANT_RX_BUFFER-1);
+            int free = ANT_RX_BUFFER - int(head - tail);
+            int linear = ANT_RX_BUFFER - int(offset);
+            bytes = free < linear ? free : linear;
+            return buffer + offset;
+        }
+
+        // bytes were read into space()
+        void received(int bytes) { head += bytes; }
+
+        // copy the next complete message with a good checksum into
+        // message (ANT_MAX_MESSAGE_SIZE bytes), false if there isn't one
+        bool next(unsigned char *message) {
+            const unsigned int mask = ANT_RX_BUFFER-1;
+
+            while (head - tail >= 5) {
+
+                if (buffer[tail & mask] != ANT_SYNC_BYTE) {
+                    tail++;
+                    continue;
+                }
+
+                unsigned int length = buffer[(tail+1) & mask];
+                if (length == 0 || length > ANT_MAX_LENGTH) {
+                    tail++;
+                    continue;
+                }
+
+                // wait for the rest of it
+                unsigned int size = length + 4;
+                if (head - tail < size) return false;
+
+                unsigned char checksum = 0;
+                for (unsigned int i=0; i<size-1; i++) {
+                    message[i] = buffer[(tail+i) & mask];
+                    checksum ^= message[i];
+                }
+
+                if (checksum == buffer[(tail+size-1) & mask]) {
+                    tail += size;
+                    return true;
+                }
+                tail++;
+            }
+            return false;
+        }
+
+    private:
+        unsigned char buffer[ANT_RX_BUFFER];
+        unsigned int head, tail;
+};
+
+#endif // _GC_ANTFramer_h
@@ -89,6 +89,7 @@ ANTlocalController::start()
     }
 
     logger->open();
+    myANTlocal->setLogging(true);
     myANTlocal->start();
     myANTlocal->setup();
     return 0;
@@ -113,6 +114,7 @@ int
 ANTlocalController::stop()
 {
     int rc =  myANTlocal->stop();
+    myANTlocal->setLogging(false);
     logger->close();
     return rc;
 }
@@ -166,6 +168,7 @@ ANTlocalController::getRealtimeData(RealtimeData &rtData)
         msgBox.exec();
         parent->Stop(1);
         parent->Disconnect();
+        myANTlocal->setLogging(false);
         logger->close();
         return;
     }
@@ -174,6 +177,20 @@ ANTlocalController::getRealtimeData(RealtimeData &rtData)
     processRealtimeData(rtData);
 }
 
+/*
+ * gets called from the acquisition thread, the ANT thread
+ * keeps the telemetry so we just take a copy of it
+ */
+bool
+ANTlocalController::sampleRealtimeData(RealtimeData &rtData)
+{
+    if (!myANTlocal->isRunning()) return false;
+
+    myANTlocal->getRealtimeData(rtData);
+    processRealtimeData(rtData);
+    return true;
+}
+
 uint8_t
 ANTlocalController::getCalibrationType()
 {
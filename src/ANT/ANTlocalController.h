@@ -58,7 +58,9 @@ public:
 
     // telemetry push pull
     bool doesPush(), doesPull(), doesLoad();
+    bool doesSample() { return true; }
     void getRealtimeData(RealtimeData &rtData);
+    bool sampleRealtimeData(RealtimeData &rtData);
     void pushRealtimeData(RealtimeData &rtData);
 
     // now with the kickr we can control trainers
@@ -22,6 +22,8 @@
 #include "Athlete.h"
 #include "AllPlotWindow.h"
 #include "AllPlotSlopeCurve.h"
+#include "AllPlotDecimation.h"
+#include "AllPlotSmoothing.h"
 #include "ReferenceLineDialog.h"
 #include "ExhaustionDialog.h"
 #include "RideFile.h"
@@ -281,7 +283,7 @@ class TimeScaleDraw: public ScaleScaleDraw
 static inline double
 max(double a, double b) { if (a > b) return a; else return b; }
 
-AllPlotObject::AllPlotObject(AllPlot *plot, QList<UserData*> user) : plot(plot)
+AllPlotObject::AllPlotObject(AllPlot *plot, QList<UserData*> user) : plot(plot), ride(NULL)
 {
     maxKM = maxSECS = 0;
 
@@ -1618,30 +1620,6 @@ AllPlot::setHighlightIntervals(bool state)
     }
 }
 
-struct DataPoint {
-
-    double time, hr, watts, atiss, antiss, np, rv, rcad, rgct,
-           smo2, thb, o2hb, hhb, ap, xp, speed, cad, 
-           alt, temp, wind, torque, lrbalance, lte, rte, lps, rps,
-           lpco, rpco, lppb, rppb, lppe, rppe, lpppb, rpppb, lpppe, rpppe,
-           kphd, wattsd, cadd, nmd, hrd, slope, tcore;
-
-    // user values
-    QList<double>user;
-
-    DataPoint(double t, double h, double w, double at, double an, double n, double rv, double rcad, double rgct,
-              double smo2, double thb, double o2hb, double hhb, double l, double x, double s, double c,
-              double a, double te, double wi, double tq, double lrb, double lte, double rte, double lps, double rps,
-              double lpco, double rpco, double lppb, double rppb, double lppe, double rppe, double lpppb, double rpppb, double lpppe, double rpppe,
-              double kphd, double wattsd, double cadd, double nmd, double hrd, double sl, double tcore, QList<double>user) :
-
-              time(t), hr(h), watts(w), atiss(at), antiss(an), np(n), rv(rv), rcad(rcad), rgct(rgct),
-              smo2(smo2), thb(thb), o2hb(o2hb), hhb(hhb), ap(l), xp(x), speed(s), cad(c),
-              alt(a), temp(te), wind(wi), torque(tq), lrbalance(lrb), lte(lte), rte(rte), lps(lps), rps(rps),
-              lpco(lpco), rpco(rpco), lppb(lppb), rppb(rppb), lppe(lppe), rppe(rppe), lpppb(lpppb), rpppb(rpppb), lpppe(lpppe), rpppe(rpppe),
-              kphd(kphd), wattsd(wattsd), cadd(cadd), nmd(nmd), hrd(hrd), slope(sl), tcore(tcore), user(user) {}
-};
-
 bool AllPlot::shadeZones() const
 {
     return shade_zones;
@@ -1819,11 +1797,6 @@ AllPlot::recalc(AllPlotObject *objects)
     
     // we should only smooth the curves if objects->smoothed rate is greater than sample rate
 
-    // user data totals
-    QVector<double> utotals;
-    utotals.resize(objects->U.count());
-    utotals.fill(0);
-
     // Offset for timeOfDay
     if (context->isCompareIntervals || !bytimeofday)
         timeoffset = 0;
@@ -1832,312 +1805,92 @@ AllPlot::recalc(AllPlotObject *objects)
 
     if (applysmooth > 0) {
 
-        double totalWatts = 0.0;
-        double totalNP = 0.0;
-        double totalRCad = 0.0;
-        double totalRV = 0.0;
-        double totalRGCT = 0.0;
-        double totalSmO2 = 0.0;
-        double totaltHb = 0.0;
-        double totalO2Hb = 0.0;
-        double totalHHb = 0.0;
-        double totalATISS = 0.0;
-        double totalANTISS = 0.0;
-        double totalXP = 0.0;
-        double totalAP = 0.0;
-        double totalHr = 0.0;
-        double totalTcore = 0.0;
-        double totalSpeed = 0.0;
-        double totalAccel = 0.0;
-        double totalWattsD = 0.0;
-        double totalCadD = 0.0;
-        double totalNmD = 0.0;
-        double totalHrD = 0.0;
-        double totalCad = 0.0;
-        double totalDist = 0.0;
-        double totalAlt = 0.0;
-        double totalSlope = 0.0;
-        double totalTemp = 0.0;
-        double totalWind = 0.0;
-        double totalTorque = 0.0;
-        double totalBalance = 0.0;
-        double totalLTE = 0.0;
-        double totalRTE = 0.0;
-        double totalLPS = 0.0;
-        double totalRPS = 0.0;
-        double totalLPCO = 0.0;
-        double totalRPCO = 0.0;
-        double totalLPPB = 0.0;
-        double totalRPPB = 0.0;
-        double totalLPPE = 0.0;
-        double totalRPPE = 0.0;
-        double totalLPPPB = 0.0;
-        double totalRPPPB = 0.0;
-        double totalLPPPE = 0.0;
-        double totalRPPPE = 0.0;
-        double currentGearRatio = 0.0;
-
-
-        QList<DataPoint> list;
-
-        objects->smoothWatts.resize(rideTimeSecs + 1);
-        objects->smoothNP.resize(rideTimeSecs + 1);
+        // smoothing is shared across all plots of the same ride, so
+        // the overview, stacked and full plots only smooth it once
+        AllPlotSmoothing *smoothing = AllPlotSmoothing::instance();
+        RideFile *ride = objects->ride;
+
+        // each second averages the samples recorded in the preceding
+        // "applysmooth" seconds - for points in time smaller than "applysmooth"
+        // only the available datapoints left are used to build the average
+        smoothing->setWindow(ride, objects->timeArray, applysmooth, rideTimeSecs);
+        const QVector<int> &from = smoothing->from(ride);
+        const QVector<int> &to = smoothing->to(ride);
+
+        for(int k=0; k<objects->U.count(); k++) {
+            objects->U[k].smooth = smoothing->smooth(ride, RideFile::none + 1 + k, objects->U[k].array);
+        }
+        objects->smoothWatts = smoothing->smooth(ride, RideFile::watts, objects->wattsArray);
+        objects->smoothNP = smoothing->smooth(ride, RideFile::IsoPower, objects->npArray);
+        objects->smoothRV = smoothing->smooth(ride, RideFile::rvert, objects->rvArray);
+        objects->smoothRCad = smoothing->smooth(ride, RideFile::rcad, objects->rcadArray);
+        objects->smoothRGCT = smoothing->smooth(ride, RideFile::rcontact, objects->rgctArray);
+        objects->smoothSmO2 = smoothing->smooth(ride, RideFile::smo2, objects->smo2Array);
+        objects->smoothtHb = smoothing->smooth(ride, RideFile::thb, objects->thbArray);
+        objects->smoothO2Hb = smoothing->smooth(ride, RideFile::o2hb, objects->o2hbArray);
+        objects->smoothHHb = smoothing->smooth(ride, RideFile::hhb, objects->hhbArray);
+        objects->smoothAT = smoothing->smooth(ride, RideFile::aTISS, objects->atissArray);
+        objects->smoothANT = smoothing->smooth(ride, RideFile::anTISS, objects->antissArray);
+        objects->smoothXP = smoothing->smooth(ride, RideFile::xPower, objects->xpArray);
+        objects->smoothAP = smoothing->smooth(ride, RideFile::aPower, objects->apArray);
+        objects->smoothHr = smoothing->smooth(ride, RideFile::hr, objects->hrArray);
+        objects->smoothTcore = smoothing->smooth(ride, RideFile::tcore, objects->tcoreArray);
+        objects->smoothSpeed = smoothing->smooth(ride, RideFile::kph, objects->speedArray);
+        objects->smoothAccel = smoothing->smooth(ride, RideFile::kphd, objects->accelArray);
+        objects->smoothWattsD = smoothing->smooth(ride, RideFile::wattsd, objects->wattsDArray);
+        objects->smoothCadD = smoothing->smooth(ride, RideFile::cadd, objects->cadDArray);
+        objects->smoothNmD = smoothing->smooth(ride, RideFile::nmd, objects->nmDArray);
+        objects->smoothHrD = smoothing->smooth(ride, RideFile::hrd, objects->hrDArray);
+        objects->smoothCad = smoothing->smooth(ride, RideFile::cad, objects->cadArray);
+        objects->smoothAltitude = smoothing->smooth(ride, RideFile::alt, objects->altArray);
+        objects->smoothSlope = smoothing->smooth(ride, RideFile::slope, objects->slopeArray);
+        objects->smoothTemp = smoothing->smooth(ride, RideFile::temp, objects->tempArray, AllPlotSmoothing::LastKnown);
+        objects->smoothWind = smoothing->smooth(ride, RideFile::headwind, objects->windArray);
+        objects->smoothTorque = smoothing->smooth(ride, RideFile::nm, objects->torqueArray);
+        objects->smoothLTE = smoothing->smooth(ride, RideFile::lte, objects->lteArray, AllPlotSmoothing::Positive);
+        objects->smoothRTE = smoothing->smooth(ride, RideFile::rte, objects->rteArray, AllPlotSmoothing::Positive);
+        objects->smoothLPS = smoothing->smooth(ride, RideFile::lps, objects->lpsArray, AllPlotSmoothing::Positive);
+        objects->smoothRPS = smoothing->smooth(ride, RideFile::rps, objects->rpsArray, AllPlotSmoothing::Positive);
+        objects->smoothLPCO = smoothing->smooth(ride, RideFile::lpco, objects->lpcoArray);
+        objects->smoothRPCO = smoothing->smooth(ride, RideFile::rpco, objects->rpcoArray);
+
+        const QVector<double> balance = smoothing->smooth(ride, RideFile::lrbalance, objects->balanceArray, AllPlotSmoothing::Balance);
+        const QVector<double> lppb = smoothing->smooth(ride, RideFile::lppb, objects->lppbArray, AllPlotSmoothing::Positive);
+        const QVector<double> rppb = smoothing->smooth(ride, RideFile::rppb, objects->rppbArray, AllPlotSmoothing::Positive);
+        const QVector<double> lppe = smoothing->smooth(ride, RideFile::lppe, objects->lppeArray, AllPlotSmoothing::Positive);
+        const QVector<double> rppe = smoothing->smooth(ride, RideFile::rppe, objects->rppeArray, AllPlotSmoothing::Positive);
+        const QVector<double> lpppb = smoothing->smooth(ride, RideFile::lpppb, objects->lpppbArray, AllPlotSmoothing::Positive);
+        const QVector<double> rpppb = smoothing->smooth(ride, RideFile::rpppb, objects->rpppbArray, AllPlotSmoothing::Positive);
+        const QVector<double> lpppe = smoothing->smooth(ride, RideFile::lpppe, objects->lpppeArray, AllPlotSmoothing::Positive);
+        const QVector<double> rpppe = smoothing->smooth(ride, RideFile::rpppe, objects->rpppeArray, AllPlotSmoothing::Positive);
+
         objects->smoothGear.resize(rideTimeSecs + 1);
-        objects->smoothRV.resize(rideTimeSecs + 1);
-        objects->smoothRCad.resize(rideTimeSecs + 1);
-        objects->smoothRGCT.resize(rideTimeSecs + 1);
-        objects->smoothSmO2.resize(rideTimeSecs + 1);
-        objects->smoothtHb.resize(rideTimeSecs + 1);
-        objects->smoothO2Hb.resize(rideTimeSecs + 1);
-        objects->smoothHHb.resize(rideTimeSecs + 1);
-        objects->smoothAT.resize(rideTimeSecs + 1);
-        objects->smoothANT.resize(rideTimeSecs + 1);
-        objects->smoothXP.resize(rideTimeSecs + 1);
-        objects->smoothAP.resize(rideTimeSecs + 1);
-        objects->smoothHr.resize(rideTimeSecs + 1);
-        objects->smoothTcore.resize(rideTimeSecs + 1);
-        objects->smoothSpeed.resize(rideTimeSecs + 1);
-        objects->smoothAccel.resize(rideTimeSecs + 1);
-        objects->smoothWattsD.resize(rideTimeSecs + 1);
-        objects->smoothCadD.resize(rideTimeSecs + 1);
-        objects->smoothNmD.resize(rideTimeSecs + 1);
-        objects->smoothHrD.resize(rideTimeSecs + 1);
-        objects->smoothCad.resize(rideTimeSecs + 1);
         objects->smoothTime.resize(rideTimeSecs + 1);
         objects->smoothDistance.resize(rideTimeSecs + 1);
-        objects->smoothAltitude.resize(rideTimeSecs + 1);
-        objects->smoothSlope.resize(rideTimeSecs + 1);
-        objects->smoothTemp.resize(rideTimeSecs + 1);
-        objects->smoothWind.resize(rideTimeSecs + 1);
         objects->smoothRelSpeed.resize(rideTimeSecs + 1);
-        objects->smoothTorque.resize(rideTimeSecs + 1);
         objects->smoothBalanceL.resize(rideTimeSecs + 1);
         objects->smoothBalanceR.resize(rideTimeSecs + 1);
-        objects->smoothLTE.resize(rideTimeSecs + 1);
-        objects->smoothRTE.resize(rideTimeSecs + 1);
-        objects->smoothLPS.resize(rideTimeSecs + 1);
-        objects->smoothRPS.resize(rideTimeSecs + 1);
-        objects->smoothLPCO.resize(rideTimeSecs + 1);
-        objects->smoothRPCO.resize(rideTimeSecs + 1);
         objects->smoothLPP.resize(rideTimeSecs + 1);
         objects->smoothRPP.resize(rideTimeSecs + 1);
         objects->smoothLPPP.resize(rideTimeSecs + 1);
         objects->smoothRPPP.resize(rideTimeSecs + 1);
-        for(int k=0; k<objects->U.count(); k++) {
-            objects->U[k].smooth.resize(rideTimeSecs + 1);
-        }
 
-        // do the smoothing by calculating the average of the "applysmooth" values left
-        // of the current data point - for points in time smaller than "applysmooth"
-        // only the available datapoints left are used to build the average
-        int i = 0;
+        // now the values that are derived from the smoothed values
+        // or taken from the last sample rather than smoothed
         for (int secs = 0; secs <= rideTimeSecs; ++secs) {
-            while ((i < objects->timeArray.count()) && (objects->timeArray[i] <= secs)) {
-
-                // collect user data if its there
-                QList<double> udata;
-                for (int k=0; k<objects->U.count(); k++) udata << (objects->U[k].array.size() > i ? objects->U[k].array[i] : 0);
-
-                // add to list
-                DataPoint dp(objects->timeArray[i],
-                             (!objects->hrArray.empty() ? objects->hrArray[i] : 0),
-                             (!objects->wattsArray.empty() ? objects->wattsArray[i] : 0),
-                             (!objects->atissArray.empty() ? objects->atissArray[i] : 0),
-                             (!objects->antissArray.empty() ? objects->antissArray[i] : 0),
-                             (!objects->npArray.empty() ? objects->npArray[i] : 0),
-                             (!objects->rvArray.empty() ? objects->rvArray[i] : 0),
-                             (!objects->rcadArray.empty() ? objects->rcadArray[i] : 0),
-                             (!objects->rgctArray.empty() ? objects->rgctArray[i] : 0),
-                             (!objects->smo2Array.empty() ? objects->smo2Array[i] : 0),
-                             (!objects->thbArray.empty() ? objects->thbArray[i] : 0),
-                             (!objects->o2hbArray.empty() ? objects->o2hbArray[i] : 0),
-                             (!objects->hhbArray.empty() ? objects->hhbArray[i] : 0),
-                             (!objects->apArray.empty() ? objects->apArray[i] : 0),
-                             (!objects->xpArray.empty() ? objects->xpArray[i] : 0),
-                             (!objects->speedArray.empty() ? objects->speedArray[i] : 0),
-                             (!objects->cadArray.empty() ? objects->cadArray[i] : 0),
-                             (!objects->altArray.empty() ? objects->altArray[i] : 0),
-                             (!objects->tempArray.empty() ? objects->tempArray[i] : 0),
-                             (!objects->windArray.empty() ? objects->windArray[i] : 0),
-                             (!objects->torqueArray.empty() ? objects->torqueArray[i] : 0),
-                             (!objects->balanceArray.empty() ? objects->balanceArray[i] : 0),
-                             (!objects->lteArray.empty() ? objects->lteArray[i] : 0),
-                             (!objects->rteArray.empty() ? objects->rteArray[i] : 0),
-                             (!objects->lpsArray.empty() ? objects->lpsArray[i] : 0),
-                             (!objects->rpsArray.empty() ? objects->rpsArray[i] : 0),
-                             (!objects->lpcoArray.empty() ? objects->lpcoArray[i] : 0),
-                             (!objects->rpcoArray.empty() ? objects->rpcoArray[i] : 0),
-                             (!objects->lppbArray.empty() ? objects->lppbArray[i] : 0),
-                             (!objects->rppbArray.empty() ? objects->rppbArray[i] : 0),
-                             (!objects->lppeArray.empty() ? objects->lppeArray[i] : 0),
-                             (!objects->rppeArray.empty() ? objects->rppeArray[i] : 0),
-                             (!objects->lpppbArray.empty() ? objects->lpppbArray[i] : 0),
-                             (!objects->rpppbArray.empty() ? objects->rpppbArray[i] : 0),
-                             (!objects->lpppeArray.empty() ? objects->lpppeArray[i] : 0),
-                             (!objects->rpppeArray.empty() ? objects->rpppeArray[i] : 0),
-                             (!objects->accelArray.empty() ? objects->accelArray[i] : 0),
-                             (!objects->wattsDArray.empty() ? objects->wattsDArray[i] : 0),
-                             (!objects->cadDArray.empty() ? objects->cadDArray[i] : 0),
-                             (!objects->nmDArray.empty() ? objects->nmDArray[i] : 0),
-                             (!objects->hrDArray.empty() ? objects->hrDArray[i] : 0),
-                             (!objects->slopeArray.empty() ? objects->slopeArray[i] : 0),
-                             (!objects->tcoreArray.empty() ? objects->tcoreArray[i] : 0),
-                            udata);
-
-                // apend to list
-                list.append(dp);
-
-                // maintain totals
-                if (!objects->wattsArray.empty()) totalWatts += objects->wattsArray[i];
-                if (!objects->npArray.empty()) totalNP += objects->npArray[i];
-                if (!objects->rvArray.empty()) totalRV += objects->rvArray[i];
-                if (!objects->rcadArray.empty()) totalRCad += objects->rcadArray[i];
-                if (!objects->rgctArray.empty()) totalRGCT += objects->rgctArray[i];
-                if (!objects->smo2Array.empty()) totalSmO2 += objects->smo2Array[i];
-                if (!objects->thbArray.empty()) totaltHb += objects->thbArray[i];
-                if (!objects->o2hbArray.empty()) totalO2Hb += objects->o2hbArray[i];
-                if (!objects->hhbArray.empty()) totalHHb += objects->hhbArray[i];
-                if (!objects->atissArray.empty()) totalATISS += objects->atissArray[i];
-                if (!objects->antissArray.empty()) totalANTISS += objects->antissArray[i];
-                if (!objects->xpArray.empty()) totalXP += objects->xpArray[i];
-                if (!objects->apArray.empty()) totalAP += objects->apArray[i];
-                if (!objects->tcoreArray.empty()) totalTcore    += objects->tcoreArray[i];
-                if (!objects->hrArray.empty()) totalHr    += objects->hrArray[i];
-                if (!objects->accelArray.empty()) totalAccel += objects->accelArray[i];
-                if (!objects->wattsDArray.empty()) totalWattsD += objects->wattsDArray[i];
-                if (!objects->cadDArray.empty()) totalCadD += objects->cadDArray[i];
-                if (!objects->nmDArray.empty()) totalNmD += objects->nmDArray[i];
-                if (!objects->hrDArray.empty()) totalHrD += objects->hrDArray[i];
-                if (!objects->speedArray.empty()) totalSpeed += objects->speedArray[i];
-                if (!objects->cadArray.empty()) totalCad   += objects->cadArray[i];
-                if (!objects->altArray.empty()) totalAlt   += objects->altArray[i];
-                if (!objects->slopeArray.empty()) totalSlope   += objects->slopeArray[i];
-                if (!objects->windArray.empty()) totalWind   += objects->windArray[i];
-                if (!objects->torqueArray.empty()) totalTorque   += objects->torqueArray[i];
-                if (!objects->tempArray.empty() ) {
-                    if (objects->tempArray[i] == RideFile::NA) {
-                        dp.temp = (i>0 && !list.empty()?list.back().temp:0.0);
-                        totalTemp   += dp.temp;
-                    }
-                    else {
-                        totalTemp   += objects->tempArray[i];
-                    }
-                }
-                if (!objects->balanceArray.empty()) totalBalance   += (objects->balanceArray[i]>0?objects->balanceArray[i]:50);
-                if (!objects->lteArray.empty()) totalLTE   += (objects->lteArray[i]>0?objects->lteArray[i]:0);
-                if (!objects->rteArray.empty()) totalRTE   += (objects->rteArray[i]>0?objects->rteArray[i]:0);
-                if (!objects->lpsArray.empty()) totalLPS   += (objects->lpsArray[i]>0?objects->lpsArray[i]:0);
-                if (!objects->rpsArray.empty()) totalRPS   += (objects->rpsArray[i]>0?objects->rpsArray[i]:0);
-                if (!objects->lpcoArray.empty()) totalLPCO   += objects->lpcoArray[i];
-                if (!objects->rpcoArray.empty()) totalRPCO   += objects->rpcoArray[i];
-                if (!objects->lppbArray.empty()) totalLPPB   += (objects->lppbArray[i]>0?objects->lppbArray[i]:0);
-                if (!objects->rppbArray.empty()) totalRPPB   += (objects->rppbArray[i]>0?objects->rppbArray[i]:0);
-                if (!objects->lppeArray.empty()) totalLPPE   += (objects->lppeArray[i]>0?objects->lppeArray[i]:0);
-                if (!objects->rppeArray.empty()) totalRPPE   += (objects->rppeArray[i]>0?objects->rppeArray[i]:0);
-                if (!objects->lpppbArray.empty()) totalLPPPB   += (objects->lpppbArray[i]>0?objects->lpppbArray[i]:0);
-                if (!objects->rpppbArray.empty()) totalRPPPB   += (objects->rpppbArray[i]>0?objects->rpppbArray[i]:0);
-                if (!objects->lpppeArray.empty()) totalLPPPE   += (objects->lpppeArray[i]>0?objects->lpppeArray[i]:0);
-                if (!objects->rpppeArray.empty()) totalRPPPE   += (objects->rpppeArray[i]>0?objects->rpppeArray[i]:0);
-
-                // set values which must not be smoothed
-                if (!objects->gearArray.empty()) currentGearRatio = (objects->gearArray[i]>0?objects->gearArray[i]:0);
-                totalDist   = objects->distanceArray[i];
-
-                // totalise user data
-                for(int k=0; k<utotals.count(); k++) utotals[k] += udata[k];
-
-                ++i;
-            }
 
-            // remove data from before smoothing duration (er, really?)
-            while (!list.empty() && (list.front().time < secs - applysmooth)) {
-                DataPoint &dp = list.front();
-                totalWatts -= dp.watts;
-                totalNP -= dp.np;
-                totalRV -= dp.rv;
-                totalRCad -= dp.rcad;
-                totalRGCT -= dp.rgct;
-                totalSmO2 -= dp.smo2;
-                totaltHb -= dp.thb;
-                totalO2Hb -= dp.o2hb;
-                totalHHb -= dp.hhb;
-                totalATISS -= dp.atiss;
-                totalANTISS -= dp.antiss;
-                totalAP -= dp.ap;
-                totalXP -= dp.xp;
-                totalHr    -= dp.hr;
-                totalTcore    -= dp.tcore;
-                totalSpeed -= dp.speed;
-                totalAccel -= dp.kphd;
-                totalWattsD -= dp.wattsd;
-                totalCadD -= dp.cadd;
-                totalNmD -= dp.nmd;
-                totalHrD -= dp.hrd;
-                totalCad   -= dp.cad;
-                totalAlt   -= dp.alt;
-                totalSlope -= dp.slope;
-                totalTemp   -= dp.temp;
-                totalWind   -= dp.wind;
-                totalTorque   -= dp.torque;
-                totalLTE   -= dp.lte;
-                totalRTE   -= dp.rte;
-                totalLPS   -= dp.lps;
-                totalRPS   -= dp.rps;
-                totalLPCO  -= dp.lpco;
-                totalRPCO  -= dp.rpco;
-                totalLPPB   -= dp.lppb;
-                totalRPPB   -= dp.rppb;
-                totalLPPE   -= dp.lppe;
-                totalRPPE   -= dp.rppe;
-                totalLPPPB  -= dp.lpppb;
-                totalRPPPB  -= dp.rpppb;
-                totalLPPPE  -= dp.lpppe;
-                totalRPPPE  -= dp.rpppe;
-                totalBalance   -= (dp.lrbalance>0?dp.lrbalance:50);
-                for(int k=0; k<utotals.count(); k++) utotals[k] -= dp.user[k];
-
-                list.removeFirst();
-            }
+            // last sample recorded
+            int last = to[secs] - 1;
+            double totalDist = last >= 0 ? objects->distanceArray[last] : 0;
+            double gear = last >= 0 && !objects->gearArray.empty() ? objects->gearArray[last] : 0;
 
             // TODO: this is wrong.  We should do a weighted average over the
             // seconds represented by each point...
-            if (list.empty()) {
-
-                for (int k=0; k<objects->U.count(); k++) objects->U[k].smooth[secs] = 0.0;
-                objects->smoothWatts[secs] = 0.0;
-                objects->smoothNP[secs] = 0.0;
-                objects->smoothRV[secs] = 0.0;
-                objects->smoothRCad[secs] = 0.0;
-                objects->smoothRGCT[secs] = 0.0;
-                objects->smoothSmO2[secs] = 0.0;
-                objects->smoothtHb[secs] = 0.0;
-                objects->smoothO2Hb[secs] = 0.0;
-                objects->smoothHHb[secs] = 0.0;
-                objects->smoothAT[secs] = 0.0;
-                objects->smoothANT[secs] = 0.0;
-                objects->smoothXP[secs] = 0.0;
-                objects->smoothAP[secs] = 0.0;
-                objects->smoothHr[secs]    = 0.0;
-                objects->smoothTcore[secs]    = 0.0;
-                objects->smoothSpeed[secs] = 0.0;
-                objects->smoothAccel[secs] = 0.0;
-                objects->smoothWattsD[secs] = 0.0;
-                objects->smoothCadD[secs] = 0.0;
-                objects->smoothNmD[secs] = 0.0;
-                objects->smoothHrD[secs] = 0.0;
-                objects->smoothCad[secs]   = 0.0;
-                objects->smoothAltitude[secs]   = ((secs > 0) ? objects->smoothAltitude[secs - 1] : objects->altArray[secs] ) ;
-                objects->smoothSlope[secs]   =  0.0;
-                objects->smoothTemp[secs]   = 0.0;
-                objects->smoothWind[secs] = 0.0;
+            if (from[secs] == to[secs]) {
+
+                objects->smoothAltitude[secs]   = ((secs > 0) ? objects->smoothAltitude[secs - 1] : 
+                                                   (!objects->altArray.empty() ? objects->altArray[0] : 0));
                 objects->smoothRelSpeed[secs] =  QwtIntervalSample();
-                objects->smoothTorque[secs] = 0.0;
-                objects->smoothLTE[secs] = 0.0;
-                objects->smoothRTE[secs] = 0.0;
-                objects->smoothLPS[secs] = 0.0;
-                objects->smoothRPS[secs] = 0.0;
-                objects->smoothLPCO[secs] = 0.0;
-                objects->smoothRPCO[secs] = 0.0;
                 objects->smoothLPP[secs] = QwtIntervalSample();
                 objects->smoothRPP[secs] = QwtIntervalSample();
                 objects->smoothLPPP[secs] = QwtIntervalSample();
@@ -2147,65 +1900,29 @@ AllPlot::recalc(AllPlotObject *objects)
 
             } else {
 
-                for(int k=0; k<utotals.count(); k++) objects->U[k].smooth[secs] = utotals[k] / list.size();
-                objects->smoothWatts[secs]    = totalWatts / list.size();
-                objects->smoothNP[secs]    = totalNP / list.size();
-                objects->smoothRV[secs]    = totalRV / list.size();
-                objects->smoothRCad[secs]    = totalRCad / list.size();
-                objects->smoothRGCT[secs]    = totalRGCT / list.size();
-                objects->smoothSmO2[secs]    = totalSmO2 / list.size();
-                objects->smoothtHb[secs]    = totaltHb / list.size();
-                objects->smoothO2Hb[secs]    = totalO2Hb / list.size();
-                objects->smoothHHb[secs]    = totalHHb / list.size();
-                objects->smoothAT[secs]    = totalATISS / list.size();
-                objects->smoothANT[secs]    = totalANTISS / list.size();
-                objects->smoothXP[secs]    = totalXP / list.size();
-                objects->smoothAP[secs]    = totalAP / list.size();
-                objects->smoothHr[secs]       = totalHr / list.size();
-                objects->smoothTcore[secs]       = totalTcore / list.size();
-                objects->smoothSpeed[secs]    = totalSpeed / list.size();
-                objects->smoothAccel[secs]    = totalAccel / double(list.size());
-                objects->smoothWattsD[secs]    = totalWattsD / double(list.size());
-                objects->smoothCadD[secs]    = totalCadD / double(list.size());
-                objects->smoothNmD[secs]    = totalNmD / double(list.size());
-                objects->smoothHrD[secs]    = totalHrD / double(list.size());
-                objects->smoothCad[secs]      = totalCad / list.size();
-                objects->smoothAltitude[secs]      = totalAlt / list.size();
-                objects->smoothSlope[secs]      = totalSlope / double(list.size());
-                objects->smoothTemp[secs]      = totalTemp / list.size();
-                objects->smoothWind[secs]    = totalWind / list.size();
-                objects->smoothTorque[secs]    = totalTorque / list.size();
-                objects->smoothRelSpeed[secs] =  QwtIntervalSample(bydist ? totalDist : secs / 60.0, 
-                                                                   QwtInterval(qMin(totalWind / list.size(),
-                                                                   totalSpeed / list.size()), 
-                                                                   qMax(totalWind / list.size(), 
-                                                                   totalSpeed / list.size())));
+                double x = bydist ? totalDist : secs / 60.0;
+                double wind = objects->smoothWind.at(secs);
+                double speed = objects->smoothSpeed.at(secs);
+                objects->smoothRelSpeed[secs] =  QwtIntervalSample(x, QwtInterval(qMin(wind, speed), qMax(wind, speed)));
 
                 // left /right pedal data
-                double balance = totalBalance / list.size();
-                if (balance == 0) {
+                if (balance[secs] == 0) {
                     objects->smoothBalanceL[secs]    = 50;
                     objects->smoothBalanceR[secs]    = 50;
-                } else if (balance >= 50) {
-                    objects->smoothBalanceL[secs]    = balance;
+                } else if (balance[secs] >= 50) {
+                    objects->smoothBalanceL[secs]    = balance[secs];
                     objects->smoothBalanceR[secs]    = 50;
                 }
                 else {
                     objects->smoothBalanceL[secs]    = 50;
-                    objects->smoothBalanceR[secs]    = balance;
+                    objects->smoothBalanceR[secs]    = balance[secs];
                 }
-                objects->smoothLTE[secs]    = totalLTE / list.size();
-                objects->smoothRTE[secs]    = totalRTE / list.size();
-                objects->smoothLPS[secs]    = totalLPS / list.size();
-                objects->smoothRPS[secs]    = totalRPS / list.size();
-                objects->smoothLPCO[secs]   = totalLPCO / list.size();
-                objects->smoothRPCO[secs]   = totalRPCO / list.size();
-                objects->smoothLPP[secs]    = QwtIntervalSample( bydist ? totalDist : secs / 60.0, QwtInterval(totalLPPB / list.size(), totalLPPE / list.size() ) );
-                objects->smoothRPP[secs]    = QwtIntervalSample( bydist ? totalDist : secs / 60.0, QwtInterval(totalRPPB / list.size(), totalRPPE / list.size() ) );
-                objects->smoothLPPP[secs]   = QwtIntervalSample( bydist ? totalDist : secs / 60.0, QwtInterval(totalLPPPB / list.size(), totalLPPPE / list.size() ) );
-                objects->smoothRPPP[secs]   = QwtIntervalSample( bydist ? totalDist : secs / 60.0, QwtInterval(totalRPPPB / list.size(), totalRPPPE / list.size() ) );
+                objects->smoothLPP[secs]    = QwtIntervalSample(x, QwtInterval(lppb[secs], lppe[secs]));
+                objects->smoothRPP[secs]    = QwtIntervalSample(x, QwtInterval(rppb[secs], rppe[secs]));
+                objects->smoothLPPP[secs]   = QwtIntervalSample(x, QwtInterval(lpppb[secs], lpppe[secs]));
+                objects->smoothRPPP[secs]   = QwtIntervalSample(x, QwtInterval(rpppb[secs], rpppe[secs]));
             }
-            objects->smoothGear[secs] = currentGearRatio;
+            objects->smoothGear[secs] = gear > 0 ? gear : 0;
             objects->smoothDistance[secs] = totalDist;
             objects->smoothTime[secs]  =  secs / 60.0;
         }
@@ -2363,115 +2080,116 @@ AllPlot::recalc(AllPlotObject *objects)
         setMatchLabels(objects);
     }
 
-    // set curve.
+    // set curve, decimated to what is visible on the canvas
+    // the slope curve colours by gradient so needs every sample
     for(int k=0; k<objects->U.count(); k++) {
         if (!objects->U[k].array.empty()) {
-            objects->U[k].curve->setSamples(xaxis.data() + startingIndex, objects->U[k].smooth.data() + startingIndex, totalPoints);
+            objects->U[k].curve->setData(new AllPlotDecimatedData(this, xaxis, objects->U[k].smooth, startingIndex, totalPoints));
         }
     }
 
     if (!objects->wattsArray.empty()) {
-        objects->wattsCurve->setSamples(xaxis.data() + startingIndex, objects->smoothWatts.data() + startingIndex, totalPoints);
+        objects->wattsCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothWatts, startingIndex, totalPoints));
     }
 
     if (!objects->antissArray.empty()) {
-        objects->antissCurve->setSamples(xaxis.data() + startingIndex, objects->smoothANT.data() + startingIndex, totalPoints);
+        objects->antissCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothANT, startingIndex, totalPoints));
     }
 
     if (!objects->atissArray.empty()) {
-        objects->atissCurve->setSamples(xaxis.data() + startingIndex, objects->smoothAT.data() + startingIndex, totalPoints);
+        objects->atissCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothAT, startingIndex, totalPoints));
     }
 
     if (!objects->rvArray.empty()) {
-        objects->rvCurve->setSamples(xaxis.data() + startingIndex, objects->smoothRV.data() + startingIndex, totalPoints);
+        objects->rvCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothRV, startingIndex, totalPoints));
     }
 
     if (!objects->rcadArray.empty()) {
-        objects->rcadCurve->setSamples(xaxis.data() + startingIndex, objects->smoothRCad.data() + startingIndex, totalPoints);
+        objects->rcadCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothRCad, startingIndex, totalPoints));
     }
 
     if (!objects->rgctArray.empty()) {
-        objects->rgctCurve->setSamples(xaxis.data() + startingIndex, objects->smoothRGCT.data() + startingIndex, totalPoints);
+        objects->rgctCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothRGCT, startingIndex, totalPoints));
     }
 
     if (!objects->gearArray.empty()) {
-        objects->gearCurve->setSamples(xaxis.data() + startingIndex, objects->smoothGear.data() + startingIndex, totalPoints);
+        objects->gearCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothGear, startingIndex, totalPoints));
     }
 
     if (!objects->smo2Array.empty()) {
-        objects->smo2Curve->setSamples(xaxis.data() + startingIndex, objects->smoothSmO2.data() + startingIndex, totalPoints);
+        objects->smo2Curve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothSmO2, startingIndex, totalPoints));
     }
 
     if (!objects->thbArray.empty()) {
-        objects->thbCurve->setSamples(xaxis.data() + startingIndex, objects->smoothtHb.data() + startingIndex, totalPoints);
+        objects->thbCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothtHb, startingIndex, totalPoints));
     }
 
     if (!objects->o2hbArray.empty()) {
-        objects->o2hbCurve->setSamples(xaxis.data() + startingIndex, objects->smoothO2Hb.data() + startingIndex, totalPoints);
+        objects->o2hbCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothO2Hb, startingIndex, totalPoints));
     }
 
     if (!objects->hhbArray.empty()) {
-        objects->hhbCurve->setSamples(xaxis.data() + startingIndex, objects->smoothHHb.data() + startingIndex, totalPoints);
+        objects->hhbCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothHHb, startingIndex, totalPoints));
     }
 
     if (!objects->npArray.empty()) {
-        objects->npCurve->setSamples(xaxis.data() + startingIndex, objects->smoothNP.data() + startingIndex, totalPoints);
+        objects->npCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothNP, startingIndex, totalPoints));
     }
 
     if (!objects->xpArray.empty()) {
-        objects->xpCurve->setSamples(xaxis.data() + startingIndex, objects->smoothXP.data() + startingIndex, totalPoints);
+        objects->xpCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothXP, startingIndex, totalPoints));
     }
 
     if (!objects->apArray.empty()) {
-        objects->apCurve->setSamples(xaxis.data() + startingIndex, objects->smoothAP.data() + startingIndex, totalPoints);
+        objects->apCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothAP, startingIndex, totalPoints));
     }
 
     if (!objects->hrArray.empty()) {
-        objects->hrCurve->setSamples(xaxis.data() + startingIndex, objects->smoothHr.data() + startingIndex, totalPoints);
+        objects->hrCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothHr, startingIndex, totalPoints));
     }
 
     if (!objects->tcoreArray.empty()) {
-        objects->tcoreCurve->setSamples(xaxis.data() + startingIndex, objects->smoothTcore.data() + startingIndex, totalPoints);
+        objects->tcoreCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothTcore, startingIndex, totalPoints));
     }
 
     if (!objects->speedArray.empty()) {
-        objects->speedCurve->setSamples(xaxis.data() + startingIndex, objects->smoothSpeed.data() + startingIndex, totalPoints);
+        objects->speedCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothSpeed, startingIndex, totalPoints));
     }
 
     if (!objects->accelArray.empty()) {
-        objects->accelCurve->setSamples(xaxis.data() + startingIndex, objects->smoothAccel.data() + startingIndex, totalPoints);
+        objects->accelCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothAccel, startingIndex, totalPoints));
     }
 
     if (!objects->wattsDArray.empty()) {
-        objects->wattsDCurve->setSamples(xaxis.data() + startingIndex, objects->smoothWattsD.data() + startingIndex, totalPoints);
+        objects->wattsDCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothWattsD, startingIndex, totalPoints));
     }
 
     if (!objects->cadDArray.empty()) {
-        objects->cadDCurve->setSamples(xaxis.data() + startingIndex, objects->smoothCadD.data() + startingIndex, totalPoints);
+        objects->cadDCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothCadD, startingIndex, totalPoints));
     }
 
     if (!objects->nmDArray.empty()) {
-        objects->nmDCurve->setSamples(xaxis.data() + startingIndex, objects->smoothNmD.data() + startingIndex, totalPoints);
+        objects->nmDCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothNmD, startingIndex, totalPoints));
     }
 
     if (!objects->hrDArray.empty()) {
-        objects->hrDCurve->setSamples(xaxis.data() + startingIndex, objects->smoothHrD.data() + startingIndex, totalPoints);
+        objects->hrDCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothHrD, startingIndex, totalPoints));
     }
 
     if (!objects->cadArray.empty()) {
-        objects->cadCurve->setSamples(xaxis.data() + startingIndex, objects->smoothCad.data() + startingIndex, totalPoints);
+        objects->cadCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothCad, startingIndex, totalPoints));
     }
 
     if (!objects->altArray.empty()) {
-        objects->altCurve->setSamples(xaxis.data() + startingIndex, objects->smoothAltitude.data() + startingIndex, totalPoints);
+        objects->altCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothAltitude, startingIndex, totalPoints));
         objects->altSlopeCurve->setSamples(xaxis.data() + startingIndex, objects->smoothAltitude.data() + startingIndex, totalPoints);
     }
     if (!objects->slopeArray.empty()) {
-        objects->slopeCurve->setSamples(xaxis.data() + startingIndex, objects->smoothSlope.data() + startingIndex, totalPoints);
+        objects->slopeCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothSlope, startingIndex, totalPoints));
     }
 
     if (!objects->tempArray.empty()) {
-        objects->tempCurve->setSamples(xaxis.data() + startingIndex, objects->smoothTemp.data() + startingIndex, totalPoints);
+        objects->tempCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothTemp, startingIndex, totalPoints));
     }
 
 
@@ -2480,29 +2198,21 @@ AllPlot::recalc(AllPlotObject *objects)
     }
 
     if (!objects->torqueArray.empty()) {
-        objects->torqueCurve->setSamples(xaxis.data() + startingIndex, objects->smoothTorque.data() + startingIndex, totalPoints);
+        objects->torqueCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothTorque, startingIndex, totalPoints));
     }
 
     // left/right pedals
     if (!objects->balanceArray.empty()) {
-        objects->balanceLCurve->setSamples(xaxis.data() + startingIndex, 
-                                           objects->smoothBalanceL.data() + startingIndex, totalPoints);
-        objects->balanceRCurve->setSamples(xaxis.data() + startingIndex, 
-                                           objects->smoothBalanceR.data() + startingIndex, totalPoints);
-    }
-    if (!objects->lteArray.empty()) objects->lteCurve->setSamples(xaxis.data() + startingIndex, 
-                                             objects->smoothLTE.data() + startingIndex, totalPoints);
-    if (!objects->rteArray.empty()) objects->rteCurve->setSamples(xaxis.data() + startingIndex, 
-                                             objects->smoothRTE.data() + startingIndex, totalPoints);
-    if (!objects->lpsArray.empty()) objects->lpsCurve->setSamples(xaxis.data() + startingIndex, 
-                                             objects->smoothLPS.data() + startingIndex, totalPoints);
-    if (!objects->rpsArray.empty()) objects->rpsCurve->setSamples(xaxis.data() + startingIndex, 
-                                             objects->smoothRPS.data() + startingIndex, totalPoints);
-
-    if (!objects->lpcoArray.empty()) objects->lpcoCurve->setSamples(xaxis.data() + startingIndex,
-                                             objects->smoothLPCO.data() + startingIndex, totalPoints);
-    if (!objects->rpcoArray.empty()) objects->rpcoCurve->setSamples(xaxis.data() + startingIndex,
-                                             objects->smoothRPCO.data() + startingIndex, totalPoints);
+        objects->balanceLCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothBalanceL, startingIndex, totalPoints));
+        objects->balanceRCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothBalanceR, startingIndex, totalPoints));
+    }
+    if (!objects->lteArray.empty()) objects->lteCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothLTE, startingIndex, totalPoints));
+    if (!objects->rteArray.empty()) objects->rteCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothRTE, startingIndex, totalPoints));
+    if (!objects->lpsArray.empty()) objects->lpsCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothLPS, startingIndex, totalPoints));
+    if (!objects->rpsArray.empty()) objects->rpsCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothRPS, startingIndex, totalPoints));
+
+    if (!objects->lpcoArray.empty()) objects->lpcoCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothLPCO, startingIndex, totalPoints));
+    if (!objects->rpcoArray.empty()) objects->rpcoCurve->setData(new AllPlotDecimatedData(this, xaxis, objects->smoothRPCO, startingIndex, totalPoints));
     if (!objects->lppbArray.empty()) {
         objects->lppCurve->setSamples(new QwtIntervalSeriesData(objects->smoothLPP));
     }
@@ -4092,17 +3802,14 @@ AllPlot::setDataFromPlot(AllPlot *plot)
             ourCurve->setVisible(true);
             ourCurve->attach(this);
 
-            // lets clone the data
-            QVector<QPointF> array;
-            for (size_t i=0; i<thereCurve->data()->size(); i++) array << thereCurve->data()->sample(i);
-
-            ourCurve->setSamples(array);
+            // lets clone the data, any decimation is shared
+            ourCurve->setData(AllPlotDecimatedData::copy(this, thereCurve->data()));
             ourCurve->setYAxis(yLeft);
             ourCurve->setBaseline(thereCurve->baseline());
             ourCurve->setStyle(thereCurve->style());
 
             // symbol when zoomed in super close
-            if (array.size() < 150) {
+            if (AllPlotDecimatedData::fullSize(thereCurve->data()) < 150) {
                 QwtSymbol *sym = new QwtSymbol;
                 sym->setPen(QPen(GColor(CPLOTMARKER)));
                 sym->setStyle(QwtSymbol::Ellipse);
@@ -4121,16 +3828,13 @@ AllPlot::setDataFromPlot(AllPlot *plot)
             ourCurve2->setVisible(true);
             ourCurve2->attach(this);
 
-            // lets clone the data
-            QVector<QPointF> array;
-            for (size_t i=0; i<thereCurve2->data()->size(); i++) array << thereCurve2->data()->sample(i);
-
-            ourCurve2->setSamples(array);
+            // lets clone the data, any decimation is shared
+            ourCurve2->setData(AllPlotDecimatedData::copy(this, thereCurve2->data()));
             ourCurve2->setYAxis(yLeft);
             ourCurve2->setBaseline(thereCurve2->baseline());
 
             // symbol when zoomed in super close
-            if (array.size() < 150) {
+            if (AllPlotDecimatedData::fullSize(thereCurve2->data()) < 150) {
                 QwtSymbol *sym = new QwtSymbol;
                 sym->setPen(QPen(GColor(CPLOTMARKER)));
                 sym->setStyle(QwtSymbol::Ellipse);
@@ -4162,11 +3866,8 @@ AllPlot::setDataFromPlot(AllPlot *plot)
             ourASCurve->setVisible(true);
             ourASCurve->attach(this);
 
-            // lets clone the data
-            QVector<QPointF> array;
-            for (size_t i=0; i<thereASCurve->data()->size(); i++) array << thereASCurve->data()->sample(i);
-
-            ourASCurve->setSamples(array);
+            // lets clone the data, any decimation is shared
+            ourASCurve->setData(AllPlotDecimatedData::copy(this, thereASCurve->data()));
             ourASCurve->setYAxis(yLeft);
             ourASCurve->setBaseline(thereASCurve->baseline());
             ourASCurve->setStyle(thereASCurve->style());
@@ -4194,9 +3895,10 @@ AllPlot::setDataFromPlot(AllPlot *plot)
 
             // minimum non-zero value... worst case its zero !
             double minNZ = 0.00f;
-            for (size_t i=0; i<thereCurve->data()->size(); i++) {
-                if (!minNZ) minNZ = thereCurve->data()->sample(i).y();
-                else if (thereCurve->data()->sample(i).y()<minNZ) minNZ = thereCurve->data()->sample(i).y();
+            QVector<QPointF> array = AllPlotDecimatedData::samples(thereCurve->data());
+            for (int i=0; i<array.count(); i++) {
+                if (!minNZ) minNZ = array[i].y();
+                else if (array[i].y()<minNZ) minNZ = array[i].y();
             }
             setAxisScale(QwtPlot::yLeft, minNZ, thereCurve->maxYValue() + 0.10f);
 
@@ -4854,14 +4556,8 @@ AllPlot::setDataFromPlots(QList<AllPlot *> plots)
                     ourCurve->setVisible(true);
                     ourCurve->attach(this);
 
-                    // lets clone the data
-                    QVector<double> x,y;
-                    for (size_t i=0; i<thereCurve->data()->size(); i++) {
-                        x << thereCurve->data()->sample(i).x();
-                        y << thereCurve->data()->sample(i).y();
-                    }
-
-                    ourCurve->setSamples(x,y);
+                    // lets clone the data, any decimation is shared
+                    ourCurve->setData(AllPlotDecimatedData::copy(this, thereCurve->data()));
                     ourCurve->setYAxis(yLeft);
                     ourCurve->setBaseline(thereCurve->baseline());
 
@@ -4869,7 +4565,7 @@ AllPlot::setDataFromPlots(QList<AllPlot *> plots)
                     if (ourCurve->minYValue() < MINY) MINY = ourCurve->minYValue();
 
                     // symbol when zoomed in super close
-                    if (x.size() < 150) {
+                    if (AllPlotDecimatedData::fullSize(thereCurve->data()) < 150) {
                         QwtSymbol *sym = new QwtSymbol;
                         sym->setPen(QPen(GColor(CPLOTMARKER)));
                         sym->setStyle(QwtSymbol::Ellipse);
@@ -4895,11 +4591,8 @@ AllPlot::setDataFromPlots(QList<AllPlot *> plots)
                     pen.setColor(context->compareIntervals[index].color);
                     ourCurve2->setPen(pen);
 
-                    // lets clone the data
-                    QVector<QPointF> array;
-                    for (size_t i=0; i<thereCurve2->data()->size(); i++) array << thereCurve2->data()->sample(i);
-
-                    ourCurve2->setSamples(array);
+                    // lets clone the data, any decimation is shared
+                    ourCurve2->setData(AllPlotDecimatedData::copy(this, thereCurve2->data()));
                     ourCurve2->setYAxis(yLeft);
                     ourCurve2->setBaseline(thereCurve2->baseline());
 
@@ -4907,7 +4600,7 @@ AllPlot::setDataFromPlots(QList<AllPlot *> plots)
                     if (ourCurve2->minYValue() < MINY) MINY = ourCurve2->minYValue();
 
                     // symbol when zoomed in super close
-                    if (array.size() < 150) {
+                    if (AllPlotDecimatedData::fullSize(thereCurve2->data()) < 150) {
                         QwtSymbol *sym = new QwtSymbol;
                         sym->setPen(QPen(GColor(CPLOTMARKER)));
                         sym->setStyle(QwtSymbol::Ellipse);
@@ -4954,11 +4647,8 @@ AllPlot::setDataFromPlots(QList<AllPlot *> plots)
                     ourASCurve->setVisible(true);
                     ourASCurve->attach(this);
 
-                    // lets clone the data
-                    QVector<QPointF> array;
-                    for (size_t i=0; i<thereASCurve->data()->size(); i++) array << thereASCurve->data()->sample(i);
-
-                    ourASCurve->setSamples(array);
+                    // lets clone the data, any decimation is shared
+                    ourASCurve->setData(AllPlotDecimatedData::copy(this, thereASCurve->data()));
                     ourASCurve->setYAxis(yLeft);
                     ourASCurve->setBaseline(thereASCurve->baseline());
                     setAltSlopePlotStyle (ourASCurve);
@@ -5484,6 +5174,8 @@ AllPlot::setDataFromRide(RideItem *_rideItem, QList<UserData*>user)
 void
 AllPlot::setDataFromRideFile(RideFile *ride, AllPlotObject *here, QList<UserData*>user)
 {
+    here->ride = ride;
+
     if (ride && ride->dataPoints().size()) {
         const RideFileDataPresent *dataPresent = ride->areDataPresent();
         int npoints = ride->dataPoints().size();
@@ -545,6 +545,9 @@ class AllPlotObject : public QObject
     // the plot we work for
     AllPlot *plot;
 
+    // the ride the source data came from
+    RideFile *ride;
+
     // some handy stuff
     double maxSECS, maxKM;
 };
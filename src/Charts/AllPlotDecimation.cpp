@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "AllPlotDecimation.h"
+
+#include "qwt_plot.h"
+
+#include <QWidget>
+#include <algorithm>
+
+AllPlotDecimatedData::AllPlotDecimatedData(const QwtPlot *plot, const QVector<double> &x,
+                                           const QVector<double> &y, int from, int count) :
+    plot(plot), x(x.mid(from, count)), y(y.mid(from, count)), decimated(false), first(0), count(0)
+{
+    // bounds are always the full series, so autoscaling
+    // doesn't change as the view is decimated
+    bounds = QRectF(1.0, 1.0, -2.0, -2.0);
+    if (this->x.count()) {
+        double minX = this->x.first(), maxX = this->x.last();
+        double minY = 0, maxY = 0;
+        bool have = false;
+        for (int i=0; i<this->y.count(); i++) {
+            double v = this->y[i];
+            if (v != v) continue; // NaN
+            if (!have || v < minY) minY = v;
+            if (!have || v > maxY) maxY = v;
+            have = true;
+        }
+        if (have) bounds = QRectF(minX, minY, maxX-minX, maxY-minY);
+    }
+
+    buildPyramid();
+
+    // everything until we're told what is visible
+    this->count = this->x.count();
+}
+
+AllPlotDecimatedData::AllPlotDecimatedData(const QwtPlot *plot, const AllPlotDecimatedData &other) :
+    plot(plot), x(other.x), y(other.y), levels(other.levels), bounds(other.bounds),
+    decimated(false), first(0), count(other.x.count())
+{
+}
+
+void
+AllPlotDecimatedData::buildPyramid()
+{
+    int n = x.count();
+    if (n < 4) return;
+
+    // first level from the raw samples
+    QVector<int> level((n+1)/2 * 2);
+    for (int b=0; b < (n+1)/2; b++) {
+        int i = b*2;
+        int j = i+1 < n ? i+1 : i;
+        if (y[j] < y[i]) { level[b*2] = j; level[b*2+1] = i; }
+        else { level[b*2] = i; level[b*2+1] = j; }
+    }
+    levels << level;
+
+    // then each level halves the one below it
+    while (levels.last().count() > 2) {
+        const QVector<int> &below = levels.last();
+        int buckets = below.count() / 2;
+        QVector<int> next((buckets+1)/2 * 2);
+        for (int b=0; b < (buckets+1)/2; b++) {
+            int l = b*2;
+            int r = l+1 < buckets ? l+1 : l;
+            int lmin = below[l*2], lmax = below[l*2+1];
+            int rmin = below[r*2], rmax = below[r*2+1];
+            next[b*2] = y[rmin] < y[lmin] ? rmin : lmin;
+            next[b*2+1] = y[rmax] > y[lmax] ? rmax : lmax;
+        }
+        levels << next;
+    }
+}
+
+int
+AllPlotDecimatedData::pixels() const
+{
+    if (plot && plot->canvas()) return plot->canvas()->width();
+    return 0;
+}
+
+size_t
+AllPlotDecimatedData::size() const
+{
+    return decimated ? view.count() : count;
+}
+
+QPointF
+AllPlotDecimatedData::sample(size_t i) const
+{
+    int index = decimated ? view[i] : first + int(i);
+    return QPointF(x[index], y[index]);
+}
+
+QRectF
+AllPlotDecimatedData::boundingRect() const
+{
+    return bounds;
+}
+
+void
+AllPlotDecimatedData::setRectOfInterest(const QRectF &rect)
+{
+    int n = x.count();
+    int width = pixels();
+
+    // not visible yet, or nothing to decimate
+    if (n == 0 || width <= 0 || !rect.isValid()) {
+        decimated = false;
+        first = 0;
+        count = n;
+        return;
+    }
+
+    // visible range, plus a sample either side so the
+    // line runs off the edge of the canvas
+    int from = std::lower_bound(x.constBegin(), x.constEnd(), rect.left()) - x.constBegin();
+    int to = std::upper_bound(x.constBegin(), x.constEnd(), rect.right()) - x.constBegin();
+    if (from > 0) from--;
+    if (to >= n) to = n-1;
+    if (to < from) to = from;
+
+    // zoomed in close enough to draw everything
+    int visible = to - from + 1;
+    if (visible <= width * 2 || levels.isEmpty()) {
+        decimated = false;
+        first = from;
+        count = visible;
+        return;
+    }
+
+    // smallest level with no more than a bucket per pixel
+    int k = 0;
+    while (k < levels.count()-1 && (visible >> (k+1)) > width) k++;
+    const QVector<int> &level = levels[k];
+
+    decimated = true;
+    view.resize(0);
+    view.reserve((visible >> k) * 2 + 4);
+
+    // always keep the end points so the line spans the view
+    view << from;
+    int b1 = to >> (k+1);
+    for (int b = from >> (k+1); b <= b1; b++) {
+        int lo = level[b*2], hi = level[b*2+1];
+        if (lo > hi) std::swap(lo, hi);
+        if (lo > view.last()) view << lo;
+        if (hi > view.last()) view << hi;
+    }
+    if (to > view.last()) view << to;
+}
+
+int
+AllPlotDecimatedData::fullSize(const QwtSeriesData<QPointF> *data)
+{
+    if (!data) return 0;
+    const AllPlotDecimatedData *d = dynamic_cast<const AllPlotDecimatedData*>(data);
+    if (d) return d->fullSize();
+    return data->size();
+}
+
+QVector<QPointF>
+AllPlotDecimatedData::samples(const QwtSeriesData<QPointF> *data)
+{
+    QVector<QPointF> returning;
+    if (!data) return returning;
+
+    const AllPlotDecimatedData *d = dynamic_cast<const AllPlotDecimatedData*>(data);
+    if (d) {
+        returning.resize(d->fullSize());
+        for (int i=0; i<d->fullSize(); i++) returning[i] = d->fullSample(i);
+    } else {
+        returning.resize(data->size());
+        for (size_t i=0; i<data->size(); i++) returning[i] = data->sample(i);
+    }
+    return returning;
+}
+
+QwtSeriesData<QPointF> *
+AllPlotDecimatedData::copy(const QwtPlot *plot, const QwtSeriesData<QPointF> *data)
+{
+    const AllPlotDecimatedData *d = dynamic_cast<const AllPlotDecimatedData*>(data);
+    if (d) return new AllPlotDecimatedData(plot, *d);
+    return new QwtPointSeriesData(samples(data));
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_AllPlotDecimation_h
+#define _GC_AllPlotDecimation_h 1
+
+#include "qwt_series_data.h"
+
+#include <QVector>
+#include <QPointF>
+#include <QRectF>
+
+class QwtPlot;
+
+//
+// Series data for the AllPlot curves that only hands Qwt the points
+// that can actually be seen. A ride recorded at 1s runs to tens of
+// thousands of samples per series, but the canvas is only ever a
+// thousand or two pixels wide, so drawing every sample is wasted work.
+//
+// When the series is set we build a pyramid of min/max sample indexes
+// for buckets of 2, 4, 8 ... samples. Qwt calls setRectOfInterest with
+// the visible area whenever the axes change (zoom, scroll, resize), we
+// then pick the pyramid level that gives no more than one bucket per
+// pixel and emit the min and max sample of each bucket in time order,
+// so peaks and troughs are never lost. When zoomed in far enough the
+// raw samples are used as they are.
+//
+// The data is shared, so copying a curve onto another plot is cheap.
+//
+class AllPlotDecimatedData : public QwtSeriesData<QPointF>
+{
+    public:
+        // x must be ascending, from and count select the samples to use
+        AllPlotDecimatedData(const QwtPlot *plot, const QVector<double> &x, const QVector<double> &y,
+                             int from, int count);
+
+        // share the samples and pyramid with another plot
+        AllPlotDecimatedData(const QwtPlot *plot, const AllPlotDecimatedData &other);
+
+        // the decimated view Qwt draws from
+        size_t size() const;
+        QPointF sample(size_t i) const;
+        QRectF boundingRect() const;
+        void setRectOfInterest(const QRectF &rect);
+
+        // the full resolution samples
+        int fullSize() const { return x.count(); }
+        QPointF fullSample(int i) const { return QPointF(x[i], y[i]); }
+
+        // full resolution samples from any point series, decimated or not
+        static int fullSize(const QwtSeriesData<QPointF> *data);
+        static QVector<QPointF> samples(const QwtSeriesData<QPointF> *data);
+
+        // a copy of any point series for another plot, keeps decimation
+        static QwtSeriesData<QPointF> *copy(const QwtPlot *plot, const QwtSeriesData<QPointF> *data);
+
+    private:
+        void buildPyramid();
+        int pixels() const;
+
+        const QwtPlot *plot;
+
+        QVector<double> x, y;
+
+        // levels[k] holds min,max sample index pairs for buckets
+        // of 2^(k+1) samples, implicitly shared between copies
+        QVector<QVector<int> > levels;
+        QRectF bounds;
+
+        // current view; either a range of raw samples or a
+        // list of sample indexes when decimated
+        bool decimated;
+        int first, count;
+        QVector<int> view;
+};
+
+#endif // _GC_AllPlotDecimation_h
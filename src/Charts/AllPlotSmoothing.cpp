@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "AllPlotSmoothing.h"
+#include "RideFile.h"
+
+// rides we keep smoothed data for, compare mode
+// will cycle through more than this but that's ok
+static const int MAX_RIDES = 16;
+
+AllPlotSmoothing *
+AllPlotSmoothing::instance()
+{
+    static AllPlotSmoothing *smoothing = new AllPlotSmoothing();
+    return smoothing;
+}
+
+AllPlotSmoothing::Entry &
+AllPlotSmoothing::entry(RideFile *ride)
+{
+    if (!entries.contains(ride)) {
+
+        // make room
+        while (recent.count() >= MAX_RIDES) invalidate(recent.first());
+
+        // drop when the ride changes or goes away
+        if (ride) {
+            connect(ride, SIGNAL(modified()), this, SLOT(invalidate()));
+            connect(ride, SIGNAL(reverted()), this, SLOT(invalidate()));
+            connect(ride, SIGNAL(destroyed(QObject*)), this, SLOT(invalidate(QObject*)));
+        }
+        entries.insert(ride, Entry());
+        recent << ride;
+
+    } else if (recent.last() != ride) {
+        recent.removeOne(ride);
+        recent << ride;
+    }
+    return entries[ride];
+}
+
+void
+AllPlotSmoothing::invalidate()
+{
+    invalidate(sender());
+}
+
+void
+AllPlotSmoothing::invalidate(QObject *object)
+{
+    // may be called from the destructor, so no casting via QObject
+    RideFile *ride = static_cast<RideFile*>(object);
+    if (!entries.contains(ride)) return;
+
+    if (ride) disconnect(ride, 0, this, 0);
+    entries.remove(ride);
+    recent.removeOne(ride);
+}
+
+void
+AllPlotSmoothing::setWindow(RideFile *ride, const QVector<double> &time, int window, int secs)
+{
+    Entry &e = entry(ride);
+
+    // different samples, nothing we have is any use
+    if (e.time != time) {
+        e.series.clear();
+        e.time = time;
+        e.window = -1;
+    }
+
+    if (e.window == window && e.secs == secs) return;
+    e.window = window;
+    e.secs = secs;
+
+    // samples recorded in (secs-window, secs] for each second, both
+    // ends only ever move forward so this is a single pass
+    e.from.resize(secs + 1);
+    e.to.resize(secs + 1);
+    int n = time.count();
+    int from = 0, to = 0;
+    for (int s = 0; s <= secs; s++) {
+        while (to < n && time[to] <= s) to++;
+        while (from < to && time[from] < s - window) from++;
+        e.from[s] = from;
+        e.to[s] = to;
+    }
+
+    // smoothed values are now stale
+    QMutableHashIterator<int, Series> i(e.series);
+    while (i.hasNext()) {
+        i.next();
+        i.value().window = -1;
+        i.value().smoothed.clear();
+    }
+}
+
+QVector<double>
+AllPlotSmoothing::smooth(RideFile *ride, int series, const QVector<double> &values, Treatment treatment)
+{
+    Entry &e = entry(ride);
+    Series &s = e.series[series];
+
+    // prefix sums, only when the values change
+    if (s.prefix.isEmpty() || s.treatment != treatment || s.values != values) {
+
+        s.values = values;
+        s.treatment = treatment;
+        s.window = -1;
+
+        int n = e.time.count();
+        s.prefix.resize(n + 1);
+        s.prefix[0] = 0;
+        double last = 0;
+        for (int i=0; i<n; i++) {
+
+            // series can be shorter than time (e.g. user data)
+            double v = i < values.count() ? values[i] : 0;
+
+            switch (treatment) {
+            case Positive: if (v < 0) v = 0; break;
+            case Balance: if (v <= 0) v = 50; break;
+            case LastKnown: if (v == RideFile::NA) v = last; last = v; break;
+            default: break;
+            }
+            s.prefix[i+1] = s.prefix[i] + v;
+        }
+    }
+
+    // average over the window for each second
+    if (s.window != e.window) {
+        s.window = e.window;
+        s.smoothed.resize(e.secs + 1);
+        for (int secs = 0; secs <= e.secs; secs++) {
+            int count = e.to[secs] - e.from[secs];
+            if (count) s.smoothed[secs] = (s.prefix[e.to[secs]] - s.prefix[e.from[secs]]) / double(count);
+            else s.smoothed[secs] = 0;
+        }
+    }
+
+    return s.smoothed;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_AllPlotSmoothing_h
+#define _GC_AllPlotSmoothing_h 1
+
+#include <QObject>
+#include <QVector>
+#include <QHash>
+#include <QList>
+
+class RideFile;
+
+//
+// Rolling average smoothing for the AllPlot series, shared by every
+// AllPlot instance (full plot, stacked, overview and compare) so the
+// same ride is only smoothed once for a given window.
+//
+// For each second of the ride the average is of the samples recorded
+// in the preceding "window" seconds. Rather than maintaining running
+// totals for every series as we walk through the ride we keep a prefix
+// sum of each series, so any window is O(n) and changing the smoothing
+// slider only needs a pass over the prefix sums.
+//
+// Entries are keyed by ride and series, the window depends upon the
+// ride's recording interval and smoothing setting. The source values
+// are remembered and compared on every lookup (implicitly shared, so
+// usually just a pointer check) so an edit to the ride is always seen,
+// but we also drop a ride's entry when it is modified or deleted.
+//
+class AllPlotSmoothing : public QObject
+{
+    Q_OBJECT
+
+    public:
+
+        // shared by all plots
+        static AllPlotSmoothing *instance();
+
+        // how samples are treated before they are averaged
+        enum treatment { Raw,           // as recorded
+                         Positive,      // negative values count as zero
+                         Balance,       // no value counts as 50/50
+                         LastKnown };   // NA repeats the last known value
+        typedef enum treatment Treatment;
+
+        // set the smoothing window for a ride, must be called before
+        // smoothing any of its series. returns the range of samples
+        // [from, to) that are averaged for each second 0 - secs
+        void setWindow(RideFile *ride, const QVector<double> &time, int window, int secs);
+        const QVector<int> &from(RideFile *ride) { return entry(ride).from; }
+        const QVector<int> &to(RideFile *ride) { return entry(ride).to; }
+
+        // smoothed series, one value per second. seconds with no
+        // samples in the window are zero. series is a RideFile::SeriesType
+        // or any other id unique to the values for this ride
+        QVector<double> smooth(RideFile *ride, int series, const QVector<double> &values,
+                               Treatment treatment = Raw);
+
+    public slots:
+
+        // drop cached data for a ride
+        void invalidate();
+        void invalidate(QObject *ride);
+
+    private:
+        AllPlotSmoothing() {}
+
+        struct Series {
+            Series() : treatment(Raw), window(-1) {}
+
+            QVector<double> values;
+            Treatment treatment;
+            QVector<double> prefix;     // sum of the first i samples
+
+            int window;                 // window smoothed was computed for
+            QVector<double> smoothed;
+        };
+
+        struct Entry {
+            Entry() : window(-1), secs(-1) {}
+
+            QVector<double> time;
+            int window, secs;
+            QVector<int> from, to;
+
+            QHash<int, Series> series;
+        };
+
+        Entry &entry(RideFile *ride);
+
+        QHash<RideFile*, Entry> entries;
+        QList<RideFile*> recent; // most recently used last
+};
+
+#endif // _GC_AllPlotSmoothing_h
@@ -2669,18 +2669,103 @@ LTMPlot::createMetricData(Context *context, LTMSettings *settings, MetricDetail
     //
     double ymean_prev=0.0;
 
-    foreach (RideItem *ride, context->athlete->rideCache->rides()) { 
+    // work from the column store rather than symbol lookups per ride
+    const RideCacheColumns &table = context->athlete->rideCache->columns();
+    int index = RideCacheColumns::metricIndex(metricDetail.symbol);
+    const QVector<double> &values = table.column(index);
+    const QVector<double> &counts = table.counts(index);
+    bool columnar = metricDetail.type != METRIC_META && values.count() == table.count();
+    QBitArray rows = table.mask(spec);
+
+    // totals, averages, peaks and lows are aggregated per group over the
+    // column and converted once per group, as long as the conversion is
+    // only a scale; anything else goes ride by ride below
+    int type = metricDetail.metric ? metricDetail.metric->type() : RideMetric::Average;
+    if (metricDetail.uunits == "Ramp" || metricDetail.uunits == tr("Ramp")) type = RideMetric::Total;
+    bool convert = metricDetail.metric && context->athlete->useMetricUnits == false;
+
+    if (columnar && metricDetail.metric && metricDetail.metric->index() == index &&
+        (!convert || metricDetail.metric->conversionSum() == 0) &&
+        (type == RideMetric::Total || type == RideMetric::Average ||
+         type == RideMetric::Low || type == RideMetric::Peak)) {
+
+        // unavailable values are skipped, and zeroes unless we want them
+        for (int row=0; row < table.count(); row++) {
+            if (!rows.testBit(row)) continue;
+            double value = values[row];
+            if (std::isnan(value) || std::isinf(value)) value = 0;
+            if (value == RideFile::NA || (!value && !wantZero)) rows.clearBit(row);
+        }
+
+        RideCacheColumns::Aggregation how = RideCacheColumns::WeightedAverage;
+        if (type == RideMetric::Total) how = RideCacheColumns::Sum;
+        else if (type == RideMetric::Low) how = RideCacheColumns::Min;
+        else if (type == RideMetric::Peak) how = RideCacheColumns::Max;
+
+        RideCacheColumns::GroupBy groupBy = RideCacheColumns::Day;
+        switch (settings->groupBy) {
+        case LTM_WEEK: groupBy = RideCacheColumns::Week; break;
+        case LTM_MONTH: groupBy = RideCacheColumns::Month; break;
+        case LTM_YEAR: groupBy = RideCacheColumns::Year; break;
+        case LTM_ALL: groupBy = RideCacheColumns::All; break;
+        default: break;
+        }
+
+        QVector<int> groups;
+        QVector<double> totals;
+        table.aggregate(index, how, groupBy, rows, groups, totals, aggZero, settings->start.date());
+
+        int first = groupForDate(settings->start.date(), settings->groupBy);
+        bool hours = metricDetail.metric->units(true) == "seconds" ||
+                     metricDetail.metric->units(true) == tr("seconds");
+
+        for (int i=0; i<groups.count(); i++) {
+
+            int currentDay = groups[i];
+
+            // convert from stored metric value to imperial, seconds to hours
+            double value = totals[i];
+            if (convert) value *= metricDetail.metric->conversion();
+            if (hours) value /= 3600;
+
+            if (lastDay && wantZero) {
+                while (lastDay<currentDay && n<=maxdays) {
+                    lastDay++;
+                    n++;
+                    x[n]=lastDay - first;
+                    y[n]=0;
+                }
+            } else {
+                n++;
+            }
+
+            // drop out of range
+            if (n>maxdays) break;
+            // first time thru
+            if (n<0) n=0;
+
+            y[n] = value;
+            x[n] = currentDay - first;
+            lastDay = currentDay;
+        }
+        return;
+    }
+
+    for (int row=0; row < table.count(); row++) {
 
         // filter out unwanted stuff
-        if (!spec.pass(ride)) continue;
+        if (!rows.testBit(row)) continue;
+        RideItem *ride = table.items[row];
 
         // day we are on
-        int currentDay = groupForDate(ride->dateTime.date(), settings->groupBy);
+        int currentDay = groupForDate(table.dates[row], settings->groupBy);
 
         // value for day
         double value;
         if (metricDetail.type == METRIC_META)
             value = ride->getText(metricDetail.name, "0.0").toDouble();
+        else if (columnar)
+            value = values[row];
         else
             value = ride->getForSymbol(metricDetail.symbol);
 
@@ -2709,7 +2794,7 @@ LTMPlot::createMetricData(Context *context, LTMSettings *settings, MetricDetail
         }
 
         if (value || wantZero) {
-            unsigned long seconds = metricDetail.metric ? ride->getCountForSymbol(metricDetail.metric->symbol()) : 1;
+            unsigned long seconds = metricDetail.metric ? ((columnar && metricDetail.metric->index() == index) ? counts[row] : ride->getCountForSymbol(metricDetail.metric->symbol())) : 1;
             if (currentDay > lastDay) {
                 if (lastDay && wantZero) {
                     while (lastDay<currentDay && n<=maxdays) {
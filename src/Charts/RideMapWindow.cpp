@@ -48,8 +48,20 @@
 #include "IntervalSummaryWindow.h"
 #include <QDebug>
 
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+// the route is simplified for each of these zoom levels
+#define ROUTE_MAXZOOM 21
+
+// encoded co-ordinates are kept to 1e6 of a degree rather than the
+// usual 1e5, close enough in at the highest zooms to tell apart
+#define ROUTE_PRECISION 1e6
+
 RideMapWindow::RideMapWindow(Context *context, int mapType) : GcChartWindow(context), context(context),
-                                                       range(-1), current(NULL), firstShow(true), stale(false)
+                                                       range(-1), current(NULL), firstShow(true),
+                                                       routeFile(NULL), routeCount(0), routeScale(1), zoom(0), stale(false)
 {
     //
     // Chart settings
@@ -377,14 +389,16 @@ void RideMapWindow::createHtml()
     minLat = minLon = 1000;
     maxLat = maxLon = -1000; // larger than 360
 
+    // new ride, or the same one replotted after editing
+    routeFile = NULL;
+    simplifyRoute();
+
     // get bounding co-ordinates for ride
-    foreach(RideFilePoint *rfp, myRideItem->ride()->dataPoints()) {
-        if (rfp->lat || rfp->lon) {
-            minLat = std::min(minLat,rfp->lat);
-            maxLat = std::max(maxLat,rfp->lat);
-            minLon = std::min(minLon,rfp->lon);
-            maxLon = std::max(maxLon,rfp->lon);
-        }
+    foreach(RideFilePoint *rfp, route) {
+        minLat = std::min(minLat,rfp->lat);
+        maxLat = std::max(maxLat,rfp->lat);
+        minLon = std::min(minLon,rfp->lon);
+        maxLon = std::max(maxLon,rfp->lon);
     }
 
     // No GPS data, so sorry no map
@@ -455,21 +469,58 @@ void RideMapWindow::createHtml()
     "var markerList;\n"  // array of markers
     "var polyList;\n"  // array of polylines
     "var tmpIntervalHighlighter;\n"  // temp interval
+    "var routeYellow;\n"  // the route
+    "var zoom;\n"  // the zoom the route was drawn for
+
+    // routes arrive as encoded polylines (the google polyline
+    // algorithm to 1e6 of a degree), decode into [lat, lon] pairs
+    "function decodePath(encoded) {\n"
+    "    var path = [];\n"
+    "    var index = 0, lat = 0, lon = 0;\n"
+    "    while (index < encoded.length) {\n"
+    "        var b, shift = 0, result = 0;\n"
+    "        do {\n"
+    "            b = encoded.charCodeAt(index++) - 63;\n"
+    "            result |= (b & 0x1f) << shift;\n"
+    "            shift += 5;\n"
+    "        } while (b >= 0x20);\n"
+    "        lat += (result & 1) ? ~(result >> 1) : (result >> 1);\n"
+    "        shift = result = 0;\n"
+    "        do {\n"
+    "            b = encoded.charCodeAt(index++) - 63;\n"
+    "            result |= (b & 0x1f) << shift;\n"
+    "            shift += 5;\n"
+    "        } while (b >= 0x20);\n"
+    "        lon += (result & 1) ? ~(result >> 1) : (result >> 1);\n"
+    "        path.push([lat / 1e6, lon / 1e6]);\n"
+    "    }\n"
+    "    return path;\n"
+    "}\n"
 
     // Draw the entire route, we use a local webbridge
     // to supply the data to a) reduce bandwidth and
     // b) allow local manipulation. This makes the UI
-    // considerably more 'snappy'
+    // considerably more 'snappy'. The route is simplified
+    // for the zoom, so it is fetched again when that changes
     "function drawRoute() {\n"
+    "   zoom = map.getZoom() || 0;\n"
 #ifdef NOWEBKIT
     // load the GPS co-ordinates
-    "   webBridge.getLatLons(0, drawRouteForLatLons);\n"
+    "   webBridge.getRoute(0, zoom, drawRouteForLatLons);\n"
 #else
     // load the GPS co-ordinates
-    "    var latlons = webBridge.getLatLons(0);\n" // interval "0" is the entire route
+    "    var latlons = webBridge.getRoute(0, zoom);\n" // interval "0" is the entire route
     "   drawRouteForLatLons(latlons);\n"
 #endif
     "}\n"
+
+    // redraw everything simplified for the new zoom
+    "function zoomChanged() {\n"
+    "   if ((map.getZoom() || 0) == zoom) return;\n"
+    "   drawRoute();\n"
+    "   drawIntervals();\n"
+    "   webBridge.drawShading();\n"
+    "}\n"
     "\n");
 
     if (mapCombo->currentIndex() == OSM) {
@@ -489,14 +540,8 @@ void RideMapWindow::createHtml()
             "    };\n"
 
             // lastly, populate the route path
-            "    var path = [];\n"
-            "    var j=0;\n"
-            "    while (j < latlons.length) { \n"
-            "        path.push(new L.LatLng(latlons[j], latlons[j+1]));\n"
-            "        j += 2;\n"
-            "    };\n"
-
-            "    var routeYellow = new L.Polyline(path, routeOptionsYellow).addTo(map);\n"
+            "    if (routeYellow) map.removeLayer(routeYellow);\n"
+            "    routeYellow = new L.Polyline(decodePath(latlons), routeOptionsYellow).addTo(map);\n"
 
             // Listen mouse events
             "routeYellow.on('mousedown', function(event) { map.dragging.disable();L.DomEvent.stopPropagation(event);webBridge.clickPath(event.latlng.lat, event.latlng.lng); });\n" // map.setOptions({draggable: false, zoomControl: false, scrollwheel: false, disableDoubleClickZoom: true});
@@ -506,6 +551,43 @@ void RideMapWindow::createHtml()
 
             "}\n").arg(styleoptions == "" ? "#FFFF00" : GColor(CPLOTMARKER).name())
                   .arg(styleoptions == "" ? 0.4 : 1.0);
+
+        // the shaded route, a polyline for each minute, see drawShadedRoute
+        currentPage += QString("function drawShade(color, encoded) {\n"
+            "    var polyOptions = {\n"
+            "        stroke: true,\n"
+            "        color: color,\n"
+            "        weight: 3,\n"
+            "        opacity: %1,\n" // for out and backs, we need both
+            "        zIndex: 0\n"
+            "    };\n"
+            "    var polyline = new L.Polyline(decodePath(encoded), polyOptions).addTo(map);\n"
+            "    polyline.on('mousedown', function(event) { map.dragging.disable();L.DomEvent.stopPropagation(event);webBridge.clickPath(event.latlng.lat, event.latlng.lng); });\n"
+            "    polyline.on('mouseup',   function(event) { map.dragging.enable();L.DomEvent.stopPropagation(event);webBridge.mouseup(); });\n"
+            "    polyline.on('mouseover', function(event) { webBridge.hoverPath(event.latlng.lat, event.latlng.lng); });\n"
+            "    polyList.push(polyline);\n"
+            "}\n"
+
+            "function clearShading() {\n"
+            "    while (polyList.length) map.removeLayer(polyList.pop());\n"
+            "}\n"
+
+            // the interval being dragged out on the map, see drawTempInterval
+            "function drawTempInterval(encoded) {\n"
+            "    var polyOptions = {\n"
+            "        stroke: true,\n"
+            "        color: '#00FFFF',\n"
+            "        opacity: 0.6,\n"
+            "        weight: 10,\n"
+            "        zIndex: -1\n"  // put at the bottom
+            "    };\n"
+            "    if (!tmpIntervalHighlighter) {\n"
+            "       tmpIntervalHighlighter = new L.Polyline([], polyOptions);\n"
+            "       tmpIntervalHighlighter.addTo(map);\n"
+            "       tmpIntervalHighlighter.on('mouseup',   function(event) { map.dragging.enable();L.DomEvent.stopPropagation(event); webBridge.mouseup(); });\n"
+            "    }\n"
+            "    tmpIntervalHighlighter.setLatLngs(decodePath(encoded));\n"
+            "}\n").arg(styleoptions == "" ? 0.5 : 1.0);
     }
     else if (mapCombo->currentIndex() == GOOGLE) {
 
@@ -523,16 +605,12 @@ void RideMapWindow::createHtml()
            "    };\n"
 
            // create the route Polyline
-           "    var routeYellow = new google.maps.Polyline(routeOptionsYellow);\n"
+           "    if (routeYellow) routeYellow.setMap(null);\n"
+           "    routeYellow = new google.maps.Polyline(routeOptionsYellow);\n"
            "    routeYellow.setMap(map);\n"
 
            // lastly, populate the route path
-           "    var path = routeYellow.getPath();\n"
-           "    var j=0;\n"
-           "    while (j < latlons.length) { \n"
-           "        path.push(new google.maps.LatLng(latlons[j], latlons[j+1]));\n"
-           "        j += 2;\n"
-           "    }\n"
+           "    routeYellow.setPath(googlePath(latlons));\n"
 
            // Listen mouse events
            "    google.maps.event.addListener(routeYellow, 'mousedown', function(event) { map.setOptions({draggable: false, zoomControl: false, scrollwheel: false, disableDoubleClickZoom: true}); webBridge.clickPath(event.latLng.lat(), event.latLng.lng()); });\n"
@@ -541,6 +619,50 @@ void RideMapWindow::createHtml()
 
            "}\n").arg(styleoptions == "" ? "#FFFF00" : GColor(CPLOTMARKER).name())
                  .arg(styleoptions == "" ? 0.4f : 1.0f);
+
+       // decoded for google, which wants its own LatLng objects
+       currentPage += QString("function googlePath(encoded) {\n"
+           "    var path = decodePath(encoded);\n"
+           "    for (var j=0; j<path.length; j++) path[j] = new google.maps.LatLng(path[j][0], path[j][1]);\n"
+           "    return path;\n"
+           "}\n"
+
+           // the shaded route, a polyline for each minute, see drawShadedRoute
+           "function drawShade(color, encoded) {\n"
+           "    var polyOptions = {\n"
+           "        strokeColor: color,\n"
+           "        strokeWeight: 3,\n"
+           "        strokeOpacity: %1,\n" // for out and backs, we need both
+           "        zIndex: 0,\n"
+           "    }\n"
+           "    var polyline = new google.maps.Polyline(polyOptions);\n"
+           "    polyline.setPath(googlePath(encoded));\n"
+           "    polyline.setMap(map);\n"
+           "    google.maps.event.addListener(polyline, 'mousedown', function(event) { map.setOptions({draggable: false, zoomControl: false, scrollwheel: false, disableDoubleClickZoom: true}); webBridge.clickPath(event.latLng.lat(), event.latLng.lng()); });\n"
+           "    google.maps.event.addListener(polyline, 'mouseup',   function(event) { map.setOptions({draggable: true, zoomControl: true, scrollwheel: true, disableDoubleClickZoom: false}); webBridge.mouseup(); });\n"
+           "    google.maps.event.addListener(polyline, 'mouseover', function(event) { webBridge.hoverPath(event.latLng.lat(), event.latLng.lng()); });\n"
+           "    polyList.push(polyline);\n"
+           "}\n"
+
+           "function clearShading() {\n"
+           "    while (polyList.length) polyList.pop().setMap(null);\n"
+           "}\n"
+
+           // the interval being dragged out on the map, see drawTempInterval
+           "function drawTempInterval(encoded) {\n"
+           "    var polyOptions = {\n"
+           "        strokeColor: '#00FFFF',\n"
+           "        strokeOpacity: 0.6,\n"
+           "        strokeWeight: 10,\n"
+           "        zIndex: -1\n"  // put at the bottom
+           "    }\n"
+           "    if (!tmpIntervalHighlighter) {\n"
+           "       tmpIntervalHighlighter = new google.maps.Polyline(polyOptions);\n"
+           "       tmpIntervalHighlighter.setMap(map);\n"
+           "       google.maps.event.addListener(tmpIntervalHighlighter, 'mouseup',   function(event) { map.setOptions({draggable: true, zoomControl: true, scrollwheel: true, disableDoubleClickZoom: false}); webBridge.mouseup(); });\n"
+           "    }\n"
+           "    tmpIntervalHighlighter.setPath(googlePath(encoded));\n"
+           "}\n").arg(styleoptions == "" ? 0.5f : 1.0f);
     }
 
     currentPage += QString("function drawIntervals() { \n"
@@ -573,9 +695,9 @@ void RideMapWindow::createHtml()
 
     "   while (intervals > 0) {\n"
 #ifdef NOWEBKIT
-    "       webBridge.getLatLons(intervals, drawInterval);\n"
+    "       webBridge.getRoute(intervals, zoom, drawInterval);\n"
 #else
-    "       drawInterval(webBridge.getLatLons(intervals));\n"
+    "       drawInterval(webBridge.getRoute(intervals, zoom));\n"
 #endif
     "       intervals--;\n"
     "   }\n"
@@ -591,14 +713,7 @@ void RideMapWindow::createHtml()
                                "       weight: 10,\n"
                                "       zIndex: -1\n"  // put at the bottom
                                "   }\n"
-                               "   var path = [];\n"
-                               "   var j=0;\n"
-                               "   while (j<latlons.length) {\n"
-                               "       path.push([latlons[j], latlons[j+1]]);\n"
-                               "       j += 2;\n"
-                               "   }\n"
-
-                               "   var intervalHighlighter = L.polyline(path, polyOptions).addTo(map);\n"
+                               "   var intervalHighlighter = L.polyline(decodePath(latlons), polyOptions).addTo(map);\n"
                                "   intervalList.push(intervalHighlighter);\n"
                                "}\n"
 
@@ -655,6 +770,7 @@ void RideMapWindow::createHtml()
 
                                // Liste mouse events
                                "    map.on('mouseup', function(event) { map.dragging.enable();L.DomEvent.stopPropagation(event); webBridge.mouseup(); });\n"
+                               "    map.on('zoomend', zoomChanged);\n"
 
 
                                "}\n"
@@ -671,12 +787,7 @@ void RideMapWindow::createHtml()
             "   var intervalHighlighter = new google.maps.Polyline(polyOptions);\n"
             "   intervalHighlighter.setMap(map);\n"
             "   intervalList.push(intervalHighlighter);\n"
-            "   var path = intervalHighlighter.getPath();\n"
-            "   var j=0;\n"
-            "   while (j<latlons.length) {\n"
-            "       path.push(new google.maps.LatLng(latlons[j], latlons[j+1]));\n"
-            "       j += 2;\n"
-            "   }\n"
+            "   intervalHighlighter.setPath(googlePath(latlons));\n"
             "}\n"
 
             // initialise function called when map loaded
@@ -759,6 +870,7 @@ void RideMapWindow::createHtml()
 
             // Liste mouse events
             "    google.maps.event.addListener(map, 'mouseup', function(event) { map.setOptions({draggable: true, zoomControl: true, scrollwheel: true, disableDoubleClickZoom: false}); webBridge.mouseup(); });\n"
+            "    google.maps.event.addListener(map, 'zoom_changed', zoomChanged);\n"
 
 
             "}\n"
@@ -790,34 +902,17 @@ RideMapWindow::drawShadedRoute()
     int rwatts=0; // running total of watts
     double prevtime=0; // time for previous point
 
-    QString code;
+    simplifyRoute();
 
+    // a call for each segment, all run in one go
+    QString code = "clearShading();\n";
+
+    int from=0, to=0; // the segment's points on the route
     foreach(RideFilePoint *rfp, myRideItem->ride()->dataPoints()) {
-        if (mapCombo->currentIndex() == OSM) {
-            // Get GPS coordinates.
-            if (count == 0) {
-                // Start of segment.
-                code = QString("{\n"
-                               "var latLons = [");
-            }
 
-            if (rfp->lat || rfp->lon)
-                code += QString("[%1, %2], ").arg(rfp->lat,0,'g',GPS_COORD_TO_STRING).arg(rfp->lon,0,'g',GPS_COORD_TO_STRING);
-        } else if (mapCombo->currentIndex() == GOOGLE) {
-            if (count == 0) {
-                code = QString("{\nvar polyline = new google.maps.Polyline();\n"
-                       "   polyline.setMap(map);\n"
-                       "   path = polyline.getPath();\n");
-
-                // Listen mouse events
-                code += QString("google.maps.event.addListener(polyline, 'mousedown', function(event) { map.setOptions({draggable: false, zoomControl: false, scrollwheel: false, disableDoubleClickZoom: true}); webBridge.clickPath(event.latLng.lat(), event.latLng.lng()); });\n"
-                                "google.maps.event.addListener(polyline, 'mouseup',   function(event) { map.setOptions({draggable: true, zoomControl: true, scrollwheel: true, disableDoubleClickZoom: false}); webBridge.mouseup(); });\n"
-                                "google.maps.event.addListener(polyline, 'mouseover', function(event) { webBridge.hoverPath(event.latLng.lat(), event.latLng.lng()); });\n");
-            } else {
-                if (rfp->lat || rfp->lon)
-                    code += QString("path.push(new google.maps.LatLng(%1,%2));\n").arg(rfp->lat,0,'g',GPS_COORD_TO_STRING).arg(rfp->lon,0,'g',GPS_COORD_TO_STRING);
-            }
-        }
+        // Start of segment.
+        if (count == 0) from = to;
+        if (rfp->lat || rfp->lon) to++;
 
         // running total of time
         rtime += rfp->secs - prevtime;
@@ -827,56 +922,26 @@ RideMapWindow::drawShadedRoute()
 
         // end of segment
         if (rtime >= intervalTime) {
-            if (mapCombo->currentIndex() == OSM) {
-                // Finalize variable "latLons" for the segment.
-                if (code.endsWith(", "))
-                    code.resize(code.length() - 2);
-                code += QString("];\n");
-            }
 
             int avgWatts = rwatts / count;
             QColor color = GetColor(avgWatts);
-            // thats this segment done, so finish off and
-            // add tooltip junk
             count = rwatts = rtime = 0;
 
-            if (mapCombo->currentIndex() == OSM) {
-                // Create and color a polyline for the segment.
-                code += QString("var polyOptions = {\n"
-                                "    stroke: true,\n"
-                                "    color: '%1',\n"
-                                "    weight: 3,\n"
-                                "    opacity: %2,\n" // for out and backs, we need both
-                                "    zIndex: 0\n"
-                                "};\n"
-                                "var polyline = new L.Polyline(latLons, polyOptions).addTo(map);\n"
-                                "polyline.on('mousedown', function(event) { map.dragging.disable();L.DomEvent.stopPropagation(event);webBridge.clickPath(event.latlng.lat, event.latlng.lng); });\n" // map.setOptions({draggable: false, zoomControl: false, scrollwheel: false, disableDoubleClickZoom: true});
-                                "polyline.on('mouseup',   function(event) { map.dragging.enable();L.DomEvent.stopPropagation(event);webBridge.mouseup(); });\n" // setOptions ?
-                                "polyline.on('mouseover', function(event) { webBridge.hoverPath(event.latlng.lat, event.latlng.lng); });\n"
-                                "path = polyline.getLatLngs();\n"
-                                "}\n").arg(styleoptions == "" ? color.name() : GColor(CPLOTMARKER).name())
-                                .arg(styleoptions == "" ? 0.5 : 1.0);
-            } else if (mapCombo->currentIndex() == GOOGLE) {
-                // color the polyline
-                code += QString("var polyOptions = {\n"
-                                "    strokeColor: '%1',\n"
-                                "    strokeWeight: 3,\n"
-                                "    strokeOpacity: %2,\n" // for out and backs, we need both
-                                "    zIndex: 0,\n"
-                                "}\n"
-                                "polyline.setOptions(polyOptions);\n"
-                                "}\n").arg(styleoptions == "" ? color.name() : GColor(CPLOTMARKER).name())
-                                      .arg(styleoptions == "" ? 0.5f : 1.0f);
-
+            // join up with the start of the next segment
+            int last = std::min(to, route.count()-1);
+            if (last > from) {
+                code += QString("drawShade('%1', '%2');\n")
+                        .arg(styleoptions == "" ? color.name() : GColor(CPLOTMARKER).name())
+                        .arg(jsString(encodeRoute(from, last, zoom)));
             }
-#ifdef NOWEBKIT
-            view->page()->runJavaScript(code);
-#else
-            view->page()->mainFrame()->evaluateJavaScript(code);
-#endif
         }
     }
 
+#ifdef NOWEBKIT
+    view->page()->runJavaScript(code);
+#else
+    view->page()->mainFrame()->evaluateJavaScript(code);
+#endif
 }
 
 void
@@ -902,81 +967,185 @@ RideMapWindow::clearTempInterval() {
 
 void
 RideMapWindow::drawTempInterval(IntervalItem *current) {
-    QString code;
+    QString code = QString("drawTempInterval('%1');\n")
+                   .arg(jsString(encodedRoute(current->start, current->stop, zoom)));
 
-    if (mapCombo->currentIndex() == OSM) {
-        code = QString( "{ \n"
-                    // interval will be drawn with these options
-                    "    var polyOptions = {\n"
-                    "        stroke: true,\n"
-                    "        color: '#00FFFF',\n"
-                    "        opacity: 0.6,\n"
-                    "        weight: 10,\n"
-                    "        zIndex: -1\n"  // put at the bottom
-                    "    };\n"
-
-                    "    if (!tmpIntervalHighlighter) {\n"
-                    "       tmpIntervalHighlighter = new L.Polyline([], polyOptions);\n"
-                    "       tmpIntervalHighlighter.addTo(map);\n"
-                    "       tmpIntervalHighlighter.on('mouseup',   function(event) { map.dragging.enable();L.DomEvent.stopPropagation(event); webBridge.mouseup(); });\n" // map.setOptions({draggable: true, zoomControl: true, scrollwheel: true, disableDoubleClickZoom: false});
-                    "    } \n"
-                    "    tmpIntervalHighlighter.setLatLngs([]);\n"
-                    "    var latLons = ["
-                    "\n");
-    } else if (mapCombo->currentIndex() == GOOGLE) {
-        code = QString( "{ \n"
-                    // interval will be drawn with these options
-                    "    var polyOptions = {\n"
-                    "        strokeColor: '#00FFFF',\n"
-                    "        strokeOpacity: 0.6,\n"
-                    "        strokeWeight: 10,\n"
-                    "        zIndex: -1\n"  // put at the bottom
-                    "    }\n"
-
-                    "    if (!tmpIntervalHighlighter) {\n"
-                    "       tmpIntervalHighlighter = new google.maps.Polyline(polyOptions);\n"
-                    "       tmpIntervalHighlighter.setMap(map);\n"
-                    "       google.maps.event.addListener(tmpIntervalHighlighter, 'mouseup',   function(event) { map.setOptions({draggable: true, zoomControl: true, scrollwheel: true, disableDoubleClickZoom: false}); webBridge.mouseup(); });\n"
-                    "    } \n"
-
-                    "    var path = tmpIntervalHighlighter.getPath();\n"
-                    "    path.clear();\n");
+#ifdef NOWEBKIT
+    view->page()->runJavaScript(code);
+#else
+    view->page()->mainFrame()->evaluateJavaScript(code);
+#endif
+
+    overlayIntervals->intervalSelected();
+}
+
+//
+// Route simplification
+//
+// Douglas-Peucker, but rather than simplifying to a single tolerance each point
+// is marked with the largest tolerance it survives, so the route for any zoom
+// is just the points marked above its tolerance. A point is never marked above
+// the segment it was split from, so every zoom gets a proper simplification.
+// Distances are in degrees of latitude, with longitude scaled to match at the
+// middle of the ride.
+//
+
+// half a pixel at a zoom, in degrees of latitude scaled as above
+static double zoomTolerance(int zoom, double scale)
+{
+    zoom = std::max(0, std::min(zoom, ROUTE_MAXZOOM));
+    return 0.5 * 360.0 / (256.0 * double(1 << zoom)) * scale;
+}
+
+// a value in the google encoded polyline format
+static void encodeValue(QByteArray &out, int value)
+{
+    uint v = uint(value) << 1;
+    if (value < 0) v = ~v;
+    while (v >= 0x20) {
+        out += char((0x20 | (v & 0x1f)) + 63);
+        v >>= 5;
     }
+    out += char(v + 63);
+}
 
-    foreach(RideFilePoint *rfp, myRideItem->ride()->dataPoints()) {
-        if (rfp->secs+myRideItem->ride()->recIntSecs() > current->start
-            && rfp->secs< current->stop) {
+// safe to put between single quotes in javascript
+QString RideMapWindow::jsString(QString x)
+{
+    return x.replace("\\", "\\\\");
+}
 
-            if (rfp->lat || rfp->lon) {
-                if (mapCombo->currentIndex() == OSM) {
-                    code += QString("[%1, %2], ").arg(rfp->lat,0,'g',GPS_COORD_TO_STRING).arg(rfp->lon,0,'g',GPS_COORD_TO_STRING);
-                }
-            } else if (mapCombo->currentIndex() == GOOGLE) {
-                code += QString("    path.push(new google.maps.LatLng(%1,%2));\n").arg(rfp->lat,0,'g',GPS_COORD_TO_STRING).arg(rfp->lon,0,'g',GPS_COORD_TO_STRING);
-            }
+static bool secsBeforePoint(double secs, const RideFilePoint *p) { return secs < p->secs; }
+static bool pointBeforeSecs(const RideFilePoint *p, double secs) { return p->secs < secs; }
+
+void
+RideMapWindow::simplifyRoute()
+{
+    RideFile *ride = myRideItem ? myRideItem->ride() : NULL;
+
+    // still good?
+    if (ride == routeFile && (!ride || ride->dataPoints().count() == routeCount)) return;
+
+    routeFile = ride;
+    routeCount = ride ? ride->dataPoints().count() : 0;
+    route.clear();
+    significance.clear();
+    encoded.clear();
+    if (!ride) return;
+
+    double minLat = 90, maxLat = -90;
+    foreach(RideFilePoint *p, ride->dataPoints()) {
+        if (p->lat || p->lon) {
+            route << p;
+            minLat = std::min(minLat, p->lat);
+            maxLat = std::max(maxLat, p->lat);
         }
     }
+    int n = route.count();
+    if (n == 0) return;
+
+    routeScale = cos((minLat + maxLat) / 2.0 * M_PI / 180.0);
+
+    // the ends are always drawn
+    significance.fill(0, n);
+    significance[0] = significance[n-1] = std::numeric_limits<double>::max();
+
+    // anything closer than this can't be seen at any zoom
+    double finest = zoomTolerance(ROUTE_MAXZOOM, routeScale);
+
+    // no recursion, a long ride would go deep
+    struct Span { int from, to; double most; };
+    QVector<Span> spans;
+    Span all = { 0, n-1, std::numeric_limits<double>::max() };
+    spans << all;
+
+    while (spans.count()) {
+
+        Span span = spans.last();
+        spans.removeLast();
+        if (span.to - span.from < 2) continue;
+
+        double ax = route[span.from]->lon * routeScale, ay = route[span.from]->lat;
+        double dx = route[span.to]->lon * routeScale - ax, dy = route[span.to]->lat - ay;
+        double length = dx*dx + dy*dy;
+
+        // furthest point from the segment
+        int furthest = -1;
+        double distance = 0;
+        for (int i=span.from+1; i<span.to; i++) {
+            double px = route[i]->lon * routeScale - ax, py = route[i]->lat - ay;
+            double t = length > 0 ? (px*dx + py*dy) / length : 0;
+            t = std::max(0.0, std::min(1.0, t));
+            double ex = px - t*dx, ey = py - t*dy;
+            double d = ex*ex + ey*ey;
+            if (d > distance) {
+                distance = d;
+                furthest = i;
+            }
+        }
+        distance = sqrt(distance);
+        if (furthest < 0 || distance < finest) continue;
 
-    if (mapCombo->currentIndex() == OSM) {
-        // Finalize variable "latLons" for the segment.
-        if (code.endsWith(", "))
-            code.resize(code.length() - 2);
-        code += QString("];\n"
-                        "path = latLons\n"  // Set the path to the current interval.
-                        "}\n" );
-    } else if (mapCombo->currentIndex() == GOOGLE) {
-        code += QString("}\n" );
+        significance[furthest] = std::min(distance, span.most);
+
+        Span before = { span.from, furthest, significance[furthest] };
+        Span after = { furthest, span.to, significance[furthest] };
+        spans << before << after;
     }
-#ifdef NOWEBKIT
-    view->page()->runJavaScript(code);
-#else
-    view->page()->mainFrame()->evaluateJavaScript(code);
-#endif
+}
 
-    overlayIntervals->intervalSelected();
+QString
+RideMapWindow::encodeRoute(int from, int to, int zoom) const
+{
+    double tolerance = zoomTolerance(zoom, routeScale);
+
+    QByteArray out;
+    int lastLat = 0, lastLon = 0;
+    for (int i=from; i<=to; i++) {
+
+        // the ends of a section are always kept
+        if (i != from && i != to && significance[i] <= tolerance) continue;
+
+        int lat = qRound(route[i]->lat * ROUTE_PRECISION);
+        int lon = qRound(route[i]->lon * ROUTE_PRECISION);
+        encodeValue(out, lat - lastLat);
+        encodeValue(out, lon - lastLon);
+        lastLat = lat;
+        lastLon = lon;
+    }
+    return QString::fromLatin1(out);
 }
 
+QString
+RideMapWindow::encodedRoute(double start, double stop, int zoom)
+{
+    simplifyRoute();
+    if (route.isEmpty()) return QString();
+
+    zoom = std::max(0, std::min(zoom, ROUTE_MAXZOOM));
+
+    // the whole route is asked for again and again
+    if (stop < 0) {
+        if (!encoded.contains(zoom)) encoded.insert(zoom, encodeRoute(0, route.count()-1, zoom));
+        return encoded.value(zoom);
+    }
+
+    // points in the section, as selected for intervals elsewhere
+    int from = std::upper_bound(route.constBegin(), route.constEnd(),
+                                start - routeFile->recIntSecs(), secsBeforePoint) - route.constBegin();
+    int to = std::lower_bound(route.constBegin(), route.constEnd(),
+                              stop, pointBeforeSecs) - route.constBegin() - 1;
+    if (from > to) return QString();
 
+    return encodeRoute(from, to, zoom);
+}
+
+double
+RideMapWindow::routeTolerance() const
+{
+    // in degrees of longitude, which are the wider
+    return zoomTolerance(zoom, 1.0);
+}
 
 //
 // Static helper - havervine formula for calculating the distance
@@ -1260,42 +1429,31 @@ MapWebBridge::intervalCount()
     return 0;
 }
 
-// get a latlon array for the i'th selected interval
-QVariantList
-MapWebBridge::getLatLons(int i)
+// get the encoded route for the i'th selected interval, or the
+// whole route when i is 0, simplified for the map's zoom
+QString
+MapWebBridge::getRoute(int i, int zoom)
 {
-    QVariantList latlons;
     RideItem *rideItem = mw->property("ride").value<RideItem*>();
+    if (!rideItem || !rideItem->ride()) return QString();
 
-    if (rideItem && i > 0 && rideItem->intervalsSelected().count() >= i) {
+    // the shaded route and hovers follow the zoom
+    mw->setZoom(zoom);
 
+    if (i > 0 && rideItem->intervalsSelected().count() >= i) {
         IntervalItem *current = rideItem->intervalsSelected().at(i-1);
+        return mw->encodedRoute(current->start, current->stop, zoom);
+    }
 
-        // so this one is the interval we need.. lets
-        // snaffle up the points in this section
-        foreach (RideFilePoint *p1, rideItem->ride()->dataPoints()) {
-            if (p1->secs+rideItem->ride()->recIntSecs() > current->start
-                && p1->secs< current->stop) {
-
-                if (p1->lat || p1->lon) {
-                    latlons << p1->lat;
-                    latlons << p1->lon;
-                }
-            }
-        }
-        return latlons;
-
-    } else if (rideItem) {
+    // get the entire route
+    return mw->encodedRoute(0, -1, zoom);
+}
 
-        // get latlons for entire route
-        foreach (RideFilePoint *p1, rideItem->ride()->dataPoints()) {
-            if (p1->lat || p1->lon) {
-                latlons << p1->lat;
-                latlons << p1->lon;
-            }
-        }
-    }
-    return latlons;
+// redraw the shaded route, after a zoom
+void
+MapWebBridge::drawShading()
+{
+    if (mw->getStyleOptions() == "") mw->drawShadedRoute();
 }
 
 // once the basic map and route have been marked, overlay markers, shaded areas etc
@@ -1306,7 +1464,7 @@ MapWebBridge::drawOverlays()
     mw->createMarkers();
 
     // overlay a shaded route
-    if (mw->getStyleOptions() == "") mw->drawShadedRoute();
+    drawShading();
 
     // Get the latest new selection lap number.
     RideItem *rideItem = mw->property("ride").value<RideItem*>();
@@ -1373,13 +1531,16 @@ MapWebBridge::searchPoint(double lat, double lng)
 
     RideItem *rideItem = mw->property("ride").value<RideItem*>();
 
+    // the route drawn is simplified so can be a little way off the points
+    double tolerance = std::max(0.0001, mw->routeTolerance());
+
     RideFilePoint *candidat = NULL;
     foreach (RideFilePoint *p1, rideItem->ride()->dataPoints()) {
         if (p1->lat == 0 && p1->lon == 0)
             continue;
 
-        if (((p1->lat-lat> 0 && p1->lat-lat< 0.0001) || (p1->lat-lat< 0 && p1->lat-lat> -0.0001)) &&
-            ((p1->lon-lng> 0 && p1->lon-lng< 0.0001) || (p1->lon-lng< 0 && p1->lon-lng> -0.0001))) {
+        if (((p1->lat-lat> 0 && p1->lat-lat< tolerance) || (p1->lat-lat< 0 && p1->lat-lat> -tolerance)) &&
+            ((p1->lon-lng> 0 && p1->lon-lng< tolerance) || (p1->lon-lng< 0 && p1->lon-lng> -tolerance))) {
             // Verifie distance avec dernier candidat
             candidat = p1;
         } else if (candidat)  {
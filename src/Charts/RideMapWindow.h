@@ -95,12 +95,13 @@ class MapWebBridge : public QObject
 
         // drawing basic route, and interval polylines
         Q_INVOKABLE int intervalCount();
-        Q_INVOKABLE QVariantList getLatLons(int i); // get array of latitudes for highlighted n
+        Q_INVOKABLE QString getRoute(int i, int zoom); // encoded route for highlighted n
 
         // once map and basic route is loaded
         // this slot is called to draw additional
         // overlays e.g. shaded route, markers
         Q_INVOKABLE void drawOverlays();
+        Q_INVOKABLE void drawShading();
 
         // display/toggle interval on map
         Q_INVOKABLE void toggleInterval(int);
@@ -170,6 +171,12 @@ class RideMapWindow : public GcChartWindow
         QString googleKey() const { return gkey->text(); }
         void setGoogleKey(QString x) { gkey->setText(x); }
 
+        // the route simplified for the map's zoom, as an encoded polyline
+        // for the points between start and stop, or all of it if stop < 0
+        QString encodedRoute(double start, double stop, int zoom);
+        void setZoom(int x) { zoom = x; }
+        double routeTolerance() const; // how far the drawn route strays
+
 
     public slots:
         void mapTypeSelected(int x);
@@ -227,6 +234,19 @@ class RideMapWindow : public GcChartWindow
         QColor GetColor(int watts);
         void createHtml();
 
+        // the route simplified for display, cached until the ride changes
+        RideFile *routeFile;
+        int routeCount;
+        double routeScale;              // longitude to latitude, mid ride
+        QVector<RideFilePoint*> route;  // the points with a position
+        QVector<double> significance;   // tolerance each is dropped above
+        QMap<int, QString> encoded;     // the whole route by zoom
+        int zoom;
+
+        void simplifyRoute();
+        QString encodeRoute(int from, int to, int zoom) const;
+        static QString jsString(QString x);
+
     private slots:
         void loadRide();
         void updateFrame();
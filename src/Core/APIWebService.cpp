@@ -31,16 +31,64 @@
 #include "PaceZones.h"
 #include "Measures.h"
 
-#include <QTemporaryFile>
+#include "httplistener.h"
+
 #include <QFile>
+#include <QElapsedTimer>
+
+const int APIRouteStats::bucketLimit[APIRouteStats::BUCKETS-1] = { 1, 2, 5, 10, 25, 50, 100, 250, 500, 1000, 2500 };
 
 void
-APIWebService::service(HttpRequest &request, HttpResponse &response)
+APIRouteStats::add(qint64 nsecs)
+{
+    count++;
+    total += nsecs;
+    if (nsecs > max) max = nsecs;
+
+    // anything beyond the last limit goes in the last bucket
+    int i=0;
+    while (i < BUCKETS-1 && nsecs > qint64(bucketLimit[i]) * 1000000) i++;
+    histogram[i]++;
+}
+
+APIResponseDevice::APIResponseDevice(HttpResponse &response) :
+    response(response), decoder(QTextCodec::codecForName("UTF-8")->makeDecoder()), bytes(0)
+{
+}
+
+APIResponseDevice::~APIResponseDevice()
+{
+    delete decoder;
+}
+
+qint64
+APIResponseDevice::writeData(const char *data, qint64 len)
 {
-    // remove trailing '/' from request, just to be consistent
-    QString fullPath = request.getPath();
-    while (fullPath.endsWith("/")) fullPath.chop(1);
+    // the decoder drops the byte order mark
+    QByteArray local = decoder->toUnicode(data, int(len)).toLocal8Bit();
+    if (local.size()) response.bwrite(local);
+    bytes += len;
+    return len;
+}
+
+void
+APIResponseDevice::close()
+{
+    if (!isOpen()) return;
+    QIODevice::close();
+    response.flush();
+}
+
+void
+APIWebService::enableStats(HttpListener *listener)
+{
+    this->listener = listener;
+    stats = true;
+}
 
+void
+APIWebService::service(HttpRequest &request, HttpResponse &response)
+{
     // get the paths, strip empty stuff
     QStringList paths = QString(request.getPath()).split("/");
     while (paths.count() && paths[paths.count()-1] == "") paths.removeLast();
@@ -49,12 +97,41 @@ APIWebService::service(HttpRequest &request, HttpResponse &response)
     // we don't have a fave icon
     if (paths.count() && paths[0] == "favicon.ico") return;
 
+    if (!stats) {
+        despatch(paths, request, response);
+        return;
+    }
+
+    // despatch consumes the paths as it goes
+    QString route = routeFor(paths);
+
+    QElapsedTimer timer;
+    timer.start();
+    despatch(paths, request, response);
+    qint64 elapsed = timer.nsecsElapsed();
+
+    statsLock.lock();
+    routeStats[route].add(elapsed);
+    statsLock.unlock();
+}
+
+void
+APIWebService::despatch(QStringList &paths, HttpRequest &request, HttpResponse &response)
+{
     // ROOT PATH RETURNS A LIST OF ATHLETES
     if (paths.count() == 0) {
         listAthletes(request, response); // return csv list of all athlete and their characteristics
         return;
     }
 
+    // SERVER STATISTICS, ONLY WHEN ENABLED
+    // http://localhost:12021/_server/stats
+    // two levels down so it can't shadow an athlete's own routes
+    if (stats && paths.count() == 2 && paths[0] == "_server" && paths[1] == "stats") {
+        listStats(request, response);
+        return;
+    }
+
     // Call to retreive athlete data, downstream will resolve
     // which functions to call for different data requests
     athleteData(paths, request, response);
@@ -159,6 +236,65 @@ APIWebService::athleteData(QStringList &paths, HttpRequest &request, HttpRespons
     response.write("malformed url");
 }
 
+// the routes we collect stats for, athlete and filenames are wildcarded
+QString
+APIWebService::routeFor(const QStringList &paths) const
+{
+    switch (paths.count()) {
+    case 0:
+        return "/";
+    case 1:
+        return "/athlete";
+    case 2:
+        if (paths[0] == "_server") return "/_server/" + paths[1];
+        if (paths[1] == "zones" || paths[1] == "measures") return "/athlete/" + paths[1];
+        break;
+    case 3:
+        if (paths[1] == "meanmax" && paths[2] == "bests") return "/athlete/meanmax/bests";
+        if (paths[1] == "activity" || paths[1] == "meanmax" || paths[1] == "measures") return "/athlete/" + paths[1] + "/*";
+        break;
+    }
+    return "other";
+}
+
+void
+APIWebService::listStats(HttpRequest &, HttpResponse &response)
+{
+    response.setHeader("Content-Type", "text; charset=ISO-8859-1");
+
+    // header line, times are in milliseconds
+    QString header = "route,count,mean,max";
+    for(int i=0; i<APIRouteStats::BUCKETS-1; i++) header += QString(",le%1").arg(APIRouteStats::bucketLimit[i]);
+    header += QString(",gt%1\n").arg(APIRouteStats::bucketLimit[APIRouteStats::BUCKETS-2]);
+    response.bwrite(header.toLocal8Bit());
+
+    // take a copy so we don't hold up requests whilst writing
+    statsLock.lock();
+    QMap<QString, APIRouteStats> current = routeStats;
+    statsLock.unlock();
+
+    QMapIterator<QString, APIRouteStats> it(current);
+    while (it.hasNext()) {
+        it.next();
+        const APIRouteStats &route = it.value();
+
+        QString line = QString("%1,%2,%3,%4").arg(it.key())
+                                             .arg(route.count)
+                                             .arg(route.count ? double(route.total) / route.count / 1000000.0 : 0, 0, 'f', 3)
+                                             .arg(double(route.max) / 1000000.0, 0, 'f', 3);
+        for(int i=0; i<APIRouteStats::BUCKETS; i++) line += QString(",%1").arg(route.histogram[i]);
+        line += "\n";
+        response.bwrite(line.toLocal8Bit());
+    }
+
+    // and how busy the connection handlers are
+    int threads=0, busy=0, maxThreads=0, rejected=0;
+    if (listener) rejected = listener->getLoad(threads, busy, maxThreads);
+    response.bwrite(QString("\nthreads,busy,maxThreads,rejected\n%1,%2,%3,%4\n")
+                    .arg(threads).arg(busy).arg(maxThreads).arg(rejected).toLocal8Bit());
+    response.flush();
+}
+
 void
 APIWebService::listAthletes(HttpRequest &, HttpResponse &response)
 {
@@ -191,104 +327,96 @@ APIWebService::listAthletes(HttpRequest &, HttpResponse &response)
 }
 
 
-void 
-APIWebService::writeRideLine(RideItem &item, HttpRequest *request, HttpResponse *response)
+void
+APIRideSnapshot::addRide(RideItem &item)
 {
+    Ride ride;
+    ride.date = item.dateTime.date();
+
+    // date, time, filename
+    ride.row = item.dateTime.date().toString("yyyy/MM/dd").toLocal8Bit();
+    ride.row += ",";
+    ride.row += item.dateTime.time().toString("hh:mm:ss").toLocal8Bit();
+    ride.row += ",";
+    ride.row += item.fileName.toLocal8Bit();
+
+    // all the metrics, remembering where each one starts
+    ride.offsets.reserve(item.metrics().count() + 1);
+    foreach(double value, item.metrics()) {
+        ride.offsets << ride.row.size();
+        ride.row += ",";
+        ride.row += QString("%1").arg(value, 'f').simplified().toLocal8Bit();
+    }
+    ride.offsets << ride.row.size();
 
-    // honour the since parameter
-    QString sincep(request->getParameter("since"));
-    QDate since(1900,01,01);
-    if (sincep != "") since = QDate::fromString(sincep,"yyyy/MM/dd");
+    // all the metadata, ready to write
+    QMapIterator<QString, QString> i(item.metadata());
+    while (i.hasNext()) {
+        i.next();
 
-    // before parameter
-    QString beforep(request->getParameter("before"));
-    QDate before(3000,01,01);
-    if (beforep != "") before = QDate::fromString(beforep,"yyyy/MM/dd");
+        QString text = i.value();
+        text.replace("\"","'");   // don't use double quotes...
+        text.replace("\n","\\n"); // newlines
+        text.replace("\r","\\r"); // carriage returns
+        text.replace("\t","\\t"); // tabs
 
-    // in range?
-    if (item.dateTime.date() < since) return;
-    if (item.dateTime.date() > before) return;
-
-    // are we doing rides or intervals?
-    listRideSettings *settings = static_cast<listRideSettings *>(response->userData());
-
-    if (settings->intervals == true) {
-
-        // loop through all available intervals for this ride item
-        foreach(IntervalItem *interval, item.intervals()){ 
-
-            // date, time, filename
-            response->bwrite(item.dateTime.date().toString("yyyy/MM/dd").toLocal8Bit());
-            response->bwrite(", ");
-            response->bwrite(item.dateTime.time().toString("hh:mm:ss").toLocal8Bit());;
-            response->bwrite(", ");
-            response->bwrite(item.fileName.toLocal8Bit());
-
-            // now the interval name and type
-            response->bwrite(", \"");
-            response->bwrite(interval->name.toLocal8Bit());
-            response->bwrite("\", ");
-            response->bwrite(QString("%1").arg(static_cast<int>(interval->type)).toLocal8Bit());
-
-            // essentially the same as below .. cut and paste (refactor?XXX)
-            if (settings->wanted.count()) {
-                // specific metrics
-                foreach(int index, settings->wanted) {
-                    double value = interval->metrics()[index];
-                    response->bwrite(",");
-                    response->bwrite(QString("%1").arg(value, 'f').simplified().toLocal8Bit());
-                }
-            } else {
-    
-                // all metrics...
-                foreach(double value, interval->metrics()) {
-                    response->bwrite(",");
-                    response->bwrite(QString("%1").arg(value, 'f').simplified().toLocal8Bit());
-                }
-            }
-            response->bwrite("\n");
+        ride.metadata.insert(i.key(), ",\"" + text.toLocal8Bit() + "\"");
+    }
+
+    rides << ride;
+}
+
+bool
+APIWebService::notModified(HttpRequest &request, HttpResponse &response, QByteArray etag)
+{
+    response.setHeader("ETag", etag);
+
+    // does the caller already have it ?
+    foreach(QByteArray match, request.getHeader("If-None-Match").split(',')) {
+        match = match.trimmed();
+        if (match.startsWith("W/")) match = match.mid(2);
+
+        if (match == etag || match == "*") {
+            response.setStatus(304, "Not Modified");
+            response.write(QByteArray(), true);
+            return true;
         }
+    }
+    return false;
+}
+
+void 
+APIWebService::writeRideLine(const APIRideSnapshot::Ride &ride, listRideSettings &settings, HttpResponse &response)
+{
+    // in range?
+    if (ride.date < settings.since) return;
+    if (ride.date > settings.before) return;
+
+    QByteArray line;
+    int metrics = ride.offsets.count() - 1;
+
+    if (settings.wanted.count() == metrics) {
+
+        // all metrics, just the precomputed row
+        line = ride.row;
 
     } else {
 
         // date, time, filename
-        response->bwrite(item.dateTime.date().toString("yyyy/MM/dd").toLocal8Bit());
-        response->bwrite(",");
-        response->bwrite(item.dateTime.time().toString("hh:mm:ss").toLocal8Bit());;
-        response->bwrite(",");
-        response->bwrite(item.fileName.toLocal8Bit());
-
-        if (settings->wanted.count()) {
-            // specific metrics
-            foreach(int index, settings->wanted) {
-                double value = item.metrics()[index];
-                response->bwrite(",");
-                response->bwrite(QString("%1").arg(value, 'f').simplified().toLocal8Bit());
-            }
-        } else {
-    
-            // all metrics...
-            foreach(double value, item.metrics()) {
-                response->bwrite(",");
-                response->bwrite(QString("%1").arg(value, 'f').simplified().toLocal8Bit());
-            }
-        }
+        line = ride.row.left(ride.offsets[0]);
 
-        // all the metadata asked for
-        foreach(QString name, settings->metawanted) {
-            QString text = item.getText(name,"");
-            text.replace("\"","'");   // don't use double quotes...
-            text.replace("\n","\\n"); // newlines
-            text.replace("\r","\\r"); // carriage returns
-            text.replace("\t","\\t"); // tabs
-
-            response->bwrite(",\"");
-            response->bwrite(text.toLocal8Bit());
-            response->bwrite("\"");
+        // specific metrics
+        foreach(int index, settings.wanted) {
+            if (index >= metrics) continue;
+            line.append(ride.row.constData() + ride.offsets[index], ride.offsets[index+1] - ride.offsets[index]);
         }
-
-        response->bwrite("\n");
     }
+
+    // all the metadata asked for
+    foreach(QString name, settings.metawanted) line += ride.metadata.value(name, ",\"\"");
+
+    line += "\n";
+    response.bwrite(line);
 }
 
 void
@@ -297,7 +425,6 @@ APIWebService::listActivity(QString athlete, QStringList paths, HttpRequest &req
     // does it exist ?
     QString filename = QString("%1/%2/activities/%3").arg(home.absolutePath()).arg(athlete).arg(paths[0]);
 
-    QString contents;
     QFile file(filename);
     if (file.exists() && file.open(QFile::ReadOnly | QFile::Text)) {
 
@@ -366,44 +493,28 @@ APIWebService::listActivity(QString athlete, QStringList paths, HttpRequest &req
             return;
         }
 
-        // write out to a temporary file in
-        // the format requested
+        // stream out in the format requested, the writers go straight
+        // into the response so we never hold the whole thing in memory
         bool success;
-        QTemporaryFile tempfile; // deletes file when goes out of scope
-        QString tempname;
-        if (tempfile.open()) tempname = tempfile.fileName();
-        else {
-            response.setStatus(500);
-            response.write("error opening temporary file");
-            return;
-        }
-        QFile out(tempname);
+        APIResponseDevice out(response);
+        out.open(QIODevice::WriteOnly);
 
         if (format == "csv") {
             CsvFileReader writer;
-            success = writer.writeRideFile(NULL, f, out, CsvFileReader::gc);
+            success = writer.writeRideStream(NULL, f, out, CsvFileReader::gc);
         } else {
-            success = RideFileFactory::instance().writeRideFile(NULL, f, out, format);
+            success = RideFileFactory::instance().writeRideStream(NULL, f, out, format);
         }
+        delete f;
 
-        if (success) {
-
-            // read in the whole thing
-            out.open(QFile::ReadOnly | QFile::Text);
-            QTextStream in(&out);
-            in.setCodec ("UTF-8");
-            contents = in.readAll();
-            out.close();
-
-            // write back in one hit
-            response.write(contents.toLocal8Bit(), true);
-            return;
-
-        } else {
+        // too late to change the status if we got started
+        if (!success && out.written() == 0) {
             response.setStatus(500);
             response.write("unable to write output, internal error.\n");
             return;
         }
+        out.close();
+        return;
 
     } else {
 
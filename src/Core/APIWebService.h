@@ -23,12 +23,83 @@
 #include "RideItem.h"
 #include "RideMetadata.h"
 #include <QDir>
+#include <QDateTime>
+#include <QMutex>
+#include <QHash>
+#include <QSharedPointer>
+#include <QIODevice>
+#include <QTextCodec>
+#include <QMap>
+
+class HttpListener;
 
 struct listRideSettings {
     bool intervals;
     QList<int> wanted; // metrics to list
     QList<FieldDefinition> metafields;
     QList<QString> metawanted; // metadata to list
+    QDate since, before; // date range to list
+};
+
+// A parsed copy of an athlete's cache/rideDB.json with the csv for each
+// ride prepared up front, so listing rides doesn't need to parse anything.
+// Shared by all the connection handler threads and replaced when the
+// modified time or size of rideDB.json changes.
+class APIRideSnapshot
+{
+    public:
+        APIRideSnapshot() : size(0) {}
+
+        struct Ride {
+            QDate date;
+            QByteArray row;                     // date,time,filename then ",value" for each metric
+            QVector<int> offsets;               // start of each metric in row, then the end
+            QMap<QString, QByteArray> metadata; // ,"text" for each field
+        };
+
+        // called by the rideDB parser for each ride
+        void addRide(RideItem &item);
+
+        QDateTime modified;
+        qint64 size;
+        QByteArray etag;
+        QList<Ride> rides;
+};
+
+// A write only device that streams into a http response a buffer at a
+// time (chunked when it gets large), converting the UTF-8 written by the
+// ride file writers to the local 8 bit encoding we advertise.
+class APIResponseDevice : public QIODevice
+{
+    public:
+        APIResponseDevice(HttpResponse &response);
+        ~APIResponseDevice();
+
+        bool isSequential() const { return true; }
+        void close(); // sends the last of it
+        qint64 written() const { return bytes; }
+
+    protected:
+        qint64 readData(char *, qint64) { return -1; }
+        qint64 writeData(const char *data, qint64 len);
+
+    private:
+        HttpResponse &response;
+        QTextDecoder *decoder; // utf-8 sequences may be split across writes
+        qint64 bytes;
+};
+
+// Latency seen by each route, collected when stats=true in httpserver.ini
+// so the server can be load tested and its pool sized from /_server/stats
+struct APIRouteStats {
+    static const int BUCKETS = 12;
+    static const int bucketLimit[BUCKETS-1]; // upper bound in ms of each bucket but the last
+
+    APIRouteStats() : count(0), total(0), max(0) { for(int i=0; i<BUCKETS; i++) histogram[i]=0; }
+    void add(qint64 nsecs);
+
+    qint64 count, total, max; // total and max in nanoseconds
+    qint64 histogram[BUCKETS];
 };
 
 class APIWebService : public HttpRequestHandler
@@ -37,10 +108,14 @@ class APIWebService : public HttpRequestHandler
     public:
 
         // nothing to do in constructor
-        APIWebService(QDir home, QObject *parent=NULL) : HttpRequestHandler(parent), home(home) {}
+        APIWebService(QDir home, QObject *parent=NULL) : HttpRequestHandler(parent), home(home), listener(NULL), stats(false) {}
+
+        // collect per route latency and serve it from /_server/stats
+        void enableStats(HttpListener *listener);
 
         // request despatchers
         void service(HttpRequest &request, HttpResponse &response);
+        void despatch(QStringList &paths, HttpRequest &request, HttpResponse &response);
         void athleteData(QStringList &paths, HttpRequest &request, HttpResponse &response);
 
         // Discrete API endpoints
@@ -50,12 +125,26 @@ class APIWebService : public HttpRequestHandler
         void listMMP(QString athlete, QStringList paths, HttpRequest &request, HttpResponse &response);
         void listZones(QString athlete, QStringList paths, HttpRequest &request, HttpResponse &response);
         void listMeasures(QString athlete, QStringList paths, HttpRequest &request, HttpResponse &response);
+        void listStats(HttpRequest &request, HttpResponse &response);
 
         // utility
-        void writeRideLine(RideItem &item, HttpRequest *request, HttpResponse *response);
+        void writeRideLine(const APIRideSnapshot::Ride &ride, listRideSettings &settings, HttpResponse &response);
+        bool notModified(HttpRequest &request, HttpResponse &response, QByteArray etag);
+        QString routeFor(const QStringList &paths) const;
+
+        // current snapshot of the athlete's rideDB.json, parsed if needed
+        QSharedPointer<APIRideSnapshot> rideSnapshot(QString athlete);
 
     private:
         QDir home;
+
+        QMutex snapshotLock;
+        QHash<QString, QSharedPointer<APIRideSnapshot> > snapshots;
+
+        HttpListener *listener;
+        bool stats;
+        QMutex statsLock;
+        QMap<QString, APIRouteStats> routeStats;
 };
 
 #endif
@@ -224,6 +224,9 @@ Athlete::loadCharts()
 
 Athlete::~Athlete()
 {
+    // drop our aggregates, waiting for any still being read
+    RideFileCache::invalidate(context);
+
     // close the ride cache down first
     delete rideCache;
 
@@ -286,13 +289,7 @@ Athlete::removeCurrentRide()
 void
 Athlete::checkCPX(RideItem*ride)
 {
-    QList<RideFileCache*> newList;
-
-    foreach(RideFileCache *p, cpxCache) {
-        if (ride->dateTime.date() < p->start || ride->dateTime.date() > p->end)
-            newList.append(p);
-    }
-    cpxCache = newList;
+    RideFileCache::invalidate(context, ride->dateTime.date());
 }
 
 void
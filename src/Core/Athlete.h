@@ -96,7 +96,6 @@ class Athlete : public QObject
         // Data
         Seasons *seasons;
         Routes *routes;
-        QList<RideFileCache*> cpxCache;
         RideCache *rideCache;
         Measures *measures;
 
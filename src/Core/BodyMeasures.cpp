@@ -174,6 +174,13 @@ BodyMeasures::setBodyMeasures(QList<BodyMeasure>&x)
 {
     bodyMeasures_ = x;
     qSort(bodyMeasures_); // date order
+
+    // we only look for weight readings at present
+    // some readings may not include this so skip them
+    QSharedPointer<MeasuresTimeline<BodyMeasure> > readings(new MeasuresTimeline<BodyMeasure>);
+    for (int i=0; i<bodyMeasures_.count(); i++)
+        if (bodyMeasures_[i].weightkg > 0) readings->append(bodyMeasures_[i]);
+    timeline.set(readings);
 }
 
 QStringList
@@ -213,45 +220,31 @@ BodyMeasures::getFieldUnits(int field, bool useMetricUnits) const {
 
 void
 BodyMeasures::getBodyMeasure(QDate date, BodyMeasure &here) const {
-    // the optimisation below is not thread safe and should be encapsulated
-    // by a mutex, but this kind of defeats to purpose of the optimisation!
-
-    //if (withings_.count() && withings_.last().when.date() <= date) here = withings_.last();
-    //if (!withings_.count() || withings_.first().when.date() > date) here = WithingsReading();
-
-    // always set to not found before searching
-    here = BodyMeasure();
-
-    // loop
-    foreach(BodyMeasure x, bodyMeasures_) {
-
-        // we only look for weight readings at present
-        // some readings may not include this so skip them
-        if (x.weightkg <= 0) continue;
-
-        if (x.when.date() <= date) here = x;
-        if (x.when.date() > date) break;
-    }
+    // safe to call from the refresh threads, we search whichever
+    // timeline was current and it can't change whilst we do
+    QSharedPointer<const MeasuresTimeline<BodyMeasure> > readings = timeline.get();
+    const BodyMeasure *found = readings->before(date);
 
     // will be empty if none found
-    return;
+    here = found ? *found : BodyMeasure();
 }
 
 double
 BodyMeasures::getFieldValue(QDate date, int field, bool useMetricUnits) const {
     const double units_factor = useMetricUnits ? 1.0 : LB_PER_KG;
-    BodyMeasure weight;
-    getBodyMeasure(date, weight);
+    QSharedPointer<const MeasuresTimeline<BodyMeasure> > readings = timeline.get();
+    const BodyMeasure *weight = readings->before(date);
+    if (!weight) return 0;
 
     // return what was asked for!
     switch(field) {
 
         default:
-        case BodyMeasure::WeightKg : return weight.weightkg * units_factor;
-        case BodyMeasure::FatKg : return weight.fatkg * units_factor;
-        case BodyMeasure::MuscleKg : return weight.musclekg * units_factor;
-        case BodyMeasure::BonesKg : return weight.boneskg * units_factor;
-        case BodyMeasure::LeanKg : return weight.leankg * units_factor;
-        case BodyMeasure::FatPercent : return weight.fatpercent;
+        case BodyMeasure::WeightKg : return weight->weightkg * units_factor;
+        case BodyMeasure::FatKg : return weight->fatkg * units_factor;
+        case BodyMeasure::MuscleKg : return weight->musclekg * units_factor;
+        case BodyMeasure::BonesKg : return weight->boneskg * units_factor;
+        case BodyMeasure::LeanKg : return weight->leankg * units_factor;
+        case BodyMeasure::FatPercent : return weight->fatpercent;
     }
 }
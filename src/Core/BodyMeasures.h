@@ -65,7 +65,7 @@ public:
     BodyMeasures(QDir dir=QDir(), bool withData=false);
     ~BodyMeasures() {}
     void write();
-    QList<BodyMeasure>& bodyMeasures() { return bodyMeasures_; }
+    const QList<BodyMeasure>& bodyMeasures() const { return bodyMeasures_; }
     void setBodyMeasures(QList<BodyMeasure>&x);
     void getBodyMeasure(QDate date, BodyMeasure&) const;
 
@@ -82,6 +82,7 @@ private:
     QDir dir;
     bool withData;
     QList<BodyMeasure> bodyMeasures_;
+    MeasuresTimelineRef<BodyMeasure> timeline;
 };
 
 
@@ -23,6 +23,7 @@
 #include "UserMetricSettings.h"
 #include "UserMetricParser.h"
 #include "DataFilter.h"
+#include "Settings.h"
 
 #include <QXmlInputSource>
 #include <QXmlSimpleReader>
@@ -93,6 +94,11 @@ Context::notifyConfigChanged(qint32 state)
     //if (state & CONFIG_APPEARANCE) qDebug()<<"Appearance config changed!";
     //if (state & CONFIG_NOTECOLOR) qDebug()<<"Note color config changed!";
     //if (state & CONFIG_FIELDS) qDebug()<<"Metadata config changed!";
+
+    // worker threads read settings from the snapshot, refresh it
+    // before anyone reacts to the change
+    appsettings->publishSnapshot();
+
     if (state & CONFIG_USERMETRICS) {
         userMetricsConfigChanged();
 
@@ -30,6 +30,8 @@
 #include "DataProcessor.h"
 #include <QDebug>
 #include <QMutex>
+#include <QThread>
+#include <QtConcurrent>
 
 #ifdef GC_WANT_PYTHON
 #include "PythonEmbed.h"
@@ -261,6 +263,65 @@ Leaf::isDynamic(Leaf *leaf)
     return false;
 }
 
+bool
+Leaf::isPure(Leaf *leaf)
+{
+    switch(leaf->type) {
+    case Leaf::Float :
+    case Leaf::Integer :
+    case Leaf::String :
+    case Leaf::Symbol :
+        return true;
+    case Leaf::UnaryOperation :
+        return leaf->isPure(leaf->lvalue.l);
+    case Leaf::Logical  :
+        if (leaf->op == 0)
+            return leaf->isPure(leaf->lvalue.l);
+        // intentional fallthrough
+    case Leaf::BinaryOperation :
+        return (leaf->isPure(leaf->lvalue.l) &&
+                leaf->isPure(leaf->rvalue.l));
+    case Leaf::Operation :
+        // assigning to user symbols carries state from one ride to the next
+        if (leaf->op == ASSIGN) return false;
+        return (leaf->isPure(leaf->lvalue.l) &&
+                leaf->isPure(leaf->rvalue.l));
+    case Leaf::Function :
+        {
+            // these use (or change) more than the ride in hand; other rides,
+            // the season, settings, measures or the ride files themselves
+            static const QStringList impure = QStringList() << "set" << "unset"
+                << "autoprocess" << "postprocess" << "print" << "lts" << "sts"
+                << "sb" << "rr" << "estimate" << "banister" << "measure"
+                << "config" << "daterange";
+            if (impure.contains(leaf->function)) return false;
+
+            if (leaf->series && leaf->lvalue.l && !leaf->isPure(leaf->lvalue.l)) return false;
+            foreach(Leaf *parm, leaf->fparms)
+                if (!leaf->isPure(parm)) return false;
+            return true;
+        }
+    case Leaf::Conditional :
+        return (leaf->isPure(leaf->cond.l) &&
+                leaf->isPure(leaf->lvalue.l) &&
+                (!leaf->rvalue.l || leaf->isPure(leaf->rvalue.l)));
+    case Leaf::Vector :
+    case Leaf::Index :
+        if (!leaf->isPure(leaf->lvalue.l)) return false;
+        foreach(Leaf *parm, leaf->fparms)
+            if (!leaf->isPure(parm)) return false;
+        return true;
+    case Leaf::Compound :
+        foreach(Leaf *statement, *(leaf->lvalue.b))
+            if (!leaf->isPure(statement)) return false;
+        return true;
+    default:
+    case Leaf::Script :
+        return false;
+    }
+    return false;
+}
+
 void
 DataFilter::setSignature(QString &query)
 {
@@ -1658,18 +1719,8 @@ QStringList DataFilter::parseFilter(Context *context, QString query, QStringList
         //treeRoot->print(0,NULL);
         emit parseGood();
 
-        // clear current filter list
-        filenames.clear();
-
-        // get all fields...
-        foreach(RideItem *item, context->athlete->rideCache->rides()) {
-
-            // evaluate each ride...
-            Result result = treeRoot->eval(&rt, treeRoot, 0, item, NULL);
-            if (result.isNumber && result.number) {
-                filenames << item->fileName;
-            }
-        }
+        // evaluate against all the rides
+        filterRides();
         emit results(filenames);
         if (list) *list = filenames;
     }
@@ -1683,21 +1734,95 @@ DataFilter::dynamicParse()
 {
     if (rt.isdynamic) {
         // need to reapply on current state
+        filterRides();
+        emit results(filenames);
+        if (list) *list = filenames;
+    }
+}
+
+// how many filters we keep results for
+#define FILTERCACHE 8
 
-        // clear current filter list
-        filenames.clear();
+// rides to evaluate with a runtime of their own
+struct DataFilterBatch {
+    DataFilterRuntime rt;
+    Leaf *root;
+    QList<RideItem*> rides;
+    QList<bool> pass;
+};
 
-        // get all fields...
-        foreach(RideItem *item, context->athlete->rideCache->rides()) {
+static void filterBatch(DataFilterBatch &batch)
+{
+    foreach(RideItem *item, batch.rides) {
+        batch.rt.stack = 0;
+        Result result = batch.root->eval(&batch.rt, batch.root, 0, item, NULL);
+        batch.pass << (result.isNumber && result.number);
+    }
+}
+
+void
+DataFilter::filterRides()
+{
+    // clear current filter list
+    filenames.clear();
+
+    const QVector<RideItem*> &rides = context->athlete->rideCache->rides();
+
+    // filters that depend on the current ride, or on anything other than
+    // the ride being evaluated, are evaluated one ride after another as
+    // they always were and the results are not kept
+    if (rt.isdynamic || !treeRoot->isPure(treeRoot)) {
+        foreach(RideItem *item, rides) {
 
             // evaluate each ride...
             Result result = treeRoot->eval(&rt, treeRoot, 0, item, NULL);
             if (result.isNumber && result.number)
                 filenames << item->fileName;
         }
-        emit results(filenames);
-        if (list) *list = filenames;
+        return;
     }
+
+    // most recently used last, forget the oldest
+    cachedsigs.removeAll(sig);
+    cachedsigs << sig;
+    while (cachedsigs.count() > FILTERCACHE) cached.remove(cachedsigs.takeFirst());
+    QHash<QString, FilterResult> previous = cached.value(sig);
+
+    // share the rides that have changed since we last looked (or that
+    // are being edited) out across a runtime per thread
+    QVector<DataFilterBatch> batches(QThread::idealThreadCount());
+    for (int i=0; i<batches.count(); i++) {
+        batches[i].rt = rt;
+        batches[i].root = treeRoot;
+    }
+
+    int stale = 0;
+    foreach(RideItem *item, rides) {
+        QHash<QString, FilterResult>::const_iterator it = previous.find(item->fileName);
+        if (item->isDirty() || it == previous.end() ||
+            it.value().fingerprint != item->fingerprint || it.value().crc != item->crc ||
+            it.value().metacrc != item->metacrc || it.value().timestamp != item->timestamp) {
+            batches[stale++ % batches.count()].rides << item;
+        }
+    }
+    if (stale) QtConcurrent::blockingMap(batches, filterBatch);
+
+    // remember the results, for the rides we have now
+    QHash<QString, FilterResult> current;
+    current.reserve(rides.count());
+    foreach(RideItem *item, rides) {
+        FilterResult add = { item->fingerprint, item->crc, item->metacrc, item->timestamp, false };
+        add.pass = previous.value(item->fileName, add).pass;
+        current.insert(item->fileName, add);
+    }
+    foreach(const DataFilterBatch &batch, batches)
+        for (int i=0; i<batch.rides.count(); i++)
+            current[batch.rides[i]->fileName].pass = batch.pass[i];
+    cached.insert(sig, current);
+
+    // in ride order
+    foreach(RideItem *item, rides)
+        if (current.value(item->fileName).pass) filenames << item->fileName;
 }
 
 void DataFilter::clearFilter()
@@ -1712,6 +1837,10 @@ void DataFilter::clearFilter()
 
 void DataFilter::configChanged(qint32)
 {
+    // symbols may mean something else now
+    cachedsigs.clear();
+    cached.clear();
+
     rt.lookupMap.clear();
     rt.lookupType.clear();
 
@@ -76,6 +76,7 @@ class Leaf {
         void print(int level, DataFilterRuntime*);  // print leaf and all children
         void color(Leaf *, QTextDocument *);  // update the document to match
         bool isDynamic(Leaf *);
+        bool isPure(Leaf *); // only depends on the ride it is evaluated for
         void validateFilter(Context *context, DataFilterRuntime *, Leaf*); // validate
         bool isNumber(DataFilterRuntime *df, Leaf *leaf);
         void clear(Leaf*);
@@ -193,6 +194,7 @@ class DataFilter : public QObject
 
     private:
         void setSignature(QString &query);
+        void filterRides(); // set filenames from the current filter
 
         Leaf *treeRoot;
         QStringList errors;
@@ -200,6 +202,15 @@ class DataFilter : public QObject
         QStringList filenames;
         QStringList *list;
         QString sig;
+
+        // results for the most recently used filters, by signature
+        // then filename, kept until the ride is changed or refreshed
+        struct FilterResult {
+            unsigned long fingerprint, crc, metacrc, timestamp;
+            bool pass;
+        };
+        QStringList cachedsigs;
+        QHash<QString, QHash<QString, FilterResult> > cached;
 };
 
 extern int DataFilterdebug;
@@ -180,6 +180,10 @@ HrvMeasures::setHrvMeasures(QList<HrvMeasure>&x)
 {
     hrvMeasures_ = x;
     qSort(hrvMeasures_); // date order
+
+    QSharedPointer<MeasuresTimeline<HrvMeasure> > readings(new MeasuresTimeline<HrvMeasure>);
+    for (int i=0; i<hrvMeasures_.count(); i++) readings->append(hrvMeasures_[i]);
+    timeline.set(readings);
 }
 
 QStringList
@@ -219,37 +223,32 @@ HrvMeasures::getFieldUnits(int field, bool useMetricUnits) const {
 
 void
 HrvMeasures::getHrvMeasure(QDate date, HrvMeasure &here) const {
-    // always set to not found before searching
-    here = HrvMeasure();
-
-    // loop
-    foreach(HrvMeasure x, hrvMeasures_) {
-
-        if (x.when.date() == date) here = x;
-        if (x.when.date() > date) break;
-    }
+    // safe to call from the refresh threads, see getBodyMeasure
+    QSharedPointer<const MeasuresTimeline<HrvMeasure> > readings = timeline.get();
+    const HrvMeasure *found = readings->on(date);
 
     // will be empty if none found
-    return;
+    here = found ? *found : HrvMeasure();
 }
 
 double
 HrvMeasures::getFieldValue(QDate date, int field, bool useMetricUnits) const {
     Q_UNUSED(useMetricUnits);
-    HrvMeasure hrv;
-    getHrvMeasure(date, hrv);
+    QSharedPointer<const MeasuresTimeline<HrvMeasure> > readings = timeline.get();
+    const HrvMeasure *hrv = readings->on(date);
+    if (!hrv) return 0;
 
     // return what was asked for!
     switch(field) {
 
         default:
-        case HrvMeasure::HR : return hrv.hr;
-        case HrvMeasure::AVNN : return hrv.avnn;
-        case HrvMeasure::SDNN : return hrv.sdnn;
-        case HrvMeasure::RMSSD : return hrv.rmssd;
-        case HrvMeasure::PNN50 : return hrv.pnn50;
-        case HrvMeasure::LF : return hrv.lf;
-        case HrvMeasure::HF : return hrv.hf;
-        case HrvMeasure::RECOVERY_POINTS : return hrv.recovery_points;
+        case HrvMeasure::HR : return hrv->hr;
+        case HrvMeasure::AVNN : return hrv->avnn;
+        case HrvMeasure::SDNN : return hrv->sdnn;
+        case HrvMeasure::RMSSD : return hrv->rmssd;
+        case HrvMeasure::PNN50 : return hrv->pnn50;
+        case HrvMeasure::LF : return hrv->lf;
+        case HrvMeasure::HF : return hrv->hf;
+        case HrvMeasure::RECOVERY_POINTS : return hrv->recovery_points;
     }
 }
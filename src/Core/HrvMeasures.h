@@ -67,7 +67,7 @@ public:
     HrvMeasures(QDir dir=QDir(), bool withData=false);
     ~HrvMeasures() {}
     void write();
-    QList<HrvMeasure>& hrvMeasures() { return hrvMeasures_; }
+    const QList<HrvMeasure>& hrvMeasures() const { return hrvMeasures_; }
     void setHrvMeasures(QList<HrvMeasure>&x);
     void getHrvMeasure(QDate date, HrvMeasure&) const;
 
@@ -84,6 +84,7 @@ private:
     QDir dir;
     bool withData;
     QList<HrvMeasure> hrvMeasures_;
+    MeasuresTimelineRef<HrvMeasure> timeline;
 };
 
 #endif
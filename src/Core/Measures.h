@@ -25,6 +25,10 @@
 #include <QDir>
 #include <QString>
 #include <QStringList>
+#include <QVector>
+#include <QMutex>
+#include <QSharedPointer>
+#include <algorithm>
 
 class Measure {
     Q_DECLARE_TR_FUNCTIONS(Measure)
@@ -54,6 +58,56 @@ public:
     virtual QString getSourceDescription() const;
 };
 
+// A date ordered copy of a group's measures for lookups by date, it
+// is never changed once built. When the measures change a new one is
+// built and swapped in, so the ride refresh threads can hold on to
+// the one they got without any locking whilst they search it.
+template <class T>
+class MeasuresTimeline {
+
+public:
+    // must be added in date order
+    void append(const T &x) { days << x.when.date().toJulianDay(); values << x; }
+
+    // the last reading on or before the date, or NULL if none
+    const T *before(QDate date) const {
+        int i = std::upper_bound(days.constBegin(), days.constEnd(), date.toJulianDay()) - days.constBegin();
+        return i > 0 ? &values[i-1] : NULL;
+    }
+
+    // the last reading on the date, or NULL if none
+    const T *on(QDate date) const {
+        const T *here = before(date);
+        return (here && here->when.date() == date) ? here : NULL;
+    }
+
+private:
+    QVector<qint64> days;
+    QVector<T> values;
+};
+
+// holds the current timeline, only the swap is locked
+template <class T>
+class MeasuresTimelineRef {
+
+public:
+    MeasuresTimelineRef() : timeline(new MeasuresTimeline<T>) {}
+
+    QSharedPointer<const MeasuresTimeline<T> > get() const {
+        QMutexLocker locker(&lock);
+        return timeline;
+    }
+
+    void set(QSharedPointer<const MeasuresTimeline<T> > x) {
+        QMutexLocker locker(&lock);
+        timeline = x;
+    }
+
+private:
+    mutable QMutex lock;
+    QSharedPointer<const MeasuresTimeline<T> > timeline;
+};
+
 class MeasuresGroup {
 
 public:
@@ -56,6 +56,7 @@ RideCache::RideCache(Context *context) : context(context)
 
     progress_ = 100;
     exiting = false;
+    columnsStale = true;
     estimator = new Estimator(context);
 
     // initial load of user defined metrics - do once we have an initial context
@@ -144,12 +145,16 @@ RideCache::RideCache(Context *context) : context(context)
     connect(context, SIGNAL(configChanged(qint32)), this, SLOT(configChanged(qint32)));
 
 
-    // future watching
-    connect(&watcher, SIGNAL(finished()), this, SLOT(garbageCollect()));
-    connect(&watcher, SIGNAL(finished()), this, SLOT(save()));
-    connect(&watcher, SIGNAL(finished()), context, SLOT(notifyRefreshEnd()));
+    // future watching, the metrics are refreshed first and
+    // are available to the charts whilst intervals are discovered
+    connect(&watcher, SIGNAL(finished()), this, SLOT(invalidateColumns()));
+    connect(&watcher, SIGNAL(finished()), this, SLOT(discover()));
     connect(&watcher, SIGNAL(started()), context, SLOT(notifyRefreshStart()));
     connect(&watcher, SIGNAL(progressValueChanged(int)), this, SLOT(progressing(int)));
+    connect(&discoveryWatcher, SIGNAL(finished()), this, SLOT(garbageCollect()));
+    connect(&discoveryWatcher, SIGNAL(finished()), this, SLOT(invalidateColumns()));
+    connect(&discoveryWatcher, SIGNAL(finished()), this, SLOT(save()));
+    connect(&discoveryWatcher, SIGNAL(finished()), context, SLOT(notifyRefreshEnd()));
 }
 
 RideCache::~RideCache()
@@ -218,6 +223,11 @@ RideCache::itemChanged()
     // BECAUSE IT IS ASSUMED BELOW THE SENDER IS A RIDEITEM
     RideItem *item = static_cast<RideItem*>(QObject::sender());
 
+    // keep the column store in step
+    columnsLock.lock();
+    if (!columnsStale && !columns_.update(item)) columnsStale = true;
+    columnsLock.unlock();
+
     // the model is particularly interested in ANY item that changes
     emit itemChanged(item);
 
@@ -261,6 +271,9 @@ RideCache::addRide(QString name, bool dosignal, bool select, bool useTempActivit
         }
     }
 
+    // columns need rebuilding
+    invalidateColumns();
+
     // add and sort, model needs to know !
     if (!added) {
         model_->beginReset();
@@ -335,6 +348,7 @@ RideCache::removeCurrentRide()
     // but model needs to know about this!
     model_->startRemove(index);
     rides_.remove(index, 1);
+    invalidateColumns();
     delete_<<todelete;
     model_->endRemove(index);
 
@@ -449,7 +463,9 @@ itemRefresh(RideItem *&item)
 {
     // need parser to be reentrant !item->refresh();
     if (item->isstale) {
-        item->refresh();
+
+        // intervals are found in the discovery pass
+        item->refresh(false);
 
         // and trap changes during refresh to current ride
         if (item == item->context->currentRideItem())
@@ -458,9 +474,21 @@ itemRefresh(RideItem *&item)
 #ifdef SLOW_REFRESH
         sleep(1);
 #endif
+    } else if (item->routestale && !item->discoverystale) {
+
+        // just the routes changed, metrics are still good
+        item->refreshRoutes();
     }
 }
 
+void
+itemDiscover(RideItem *&item)
+{
+    // the metrics are up to date, routes are searched
+    // for along with everything else
+    if (item->discoverystale) item->refreshDiscovery();
+}
+
 void
 RideCache::progressing(int value)
 {
@@ -480,6 +508,20 @@ RideCache::cancel()
         future.cancel();
         future.waitForFinished();
     }
+    if (discoveryFuture.isRunning()) {
+        discoveryFuture.cancel();
+        discoveryFuture.waitForFinished();
+    }
+}
+
+// the metrics are refreshed, now discover intervals
+void
+RideCache::discover()
+{
+    if (exiting) return;
+
+    discoveryFuture = QtConcurrent::map(reverse_, itemDiscover);
+    discoveryWatcher.setFuture(discoveryFuture);
 }
 
 // check if we need to refresh the metrics then start the thread if needed
@@ -487,15 +529,15 @@ void
 RideCache::refresh()
 {
     // already on it !
-    if (future.isRunning()) return;
+    if (isRunning()) return;
 
     // how many need refreshing ?
     int staleCount = 0;
 
     foreach(RideItem *item, rides_) {
 
-        // ok set stale so we refresh
-        if (item->checkStale())
+        // ok set stale so we refresh, or just discover intervals or search for routes
+        if (item->checkStale() || item->checkDiscovery() || item->checkRoutes())
             staleCount++;
     }
 
@@ -531,67 +573,59 @@ RideCache::getAggregate(QString name, Specification spec, bool useMetricUnits, b
     double rvalue = 0;
     double rcount = 0; // using double to avoid rounding issues with int when dividing
 
-    // loop through and aggregate
-    foreach (RideItem *item, rides()) {
+    // columns for the metric and duration, for averaging
+    const RideCacheColumns &table = columns();
+    const QVector<double> &values = table.column(metric->index());
+    int duration = RideCacheColumns::metricIndex("workout_time");
+    const QVector<double> &durations = table.column(duration);
+    QBitArray rows = table.mask(spec);
+    if (values.count() != table.count() || durations.count() != table.count()) rows.fill(false);
 
-        // skip filtered rides
-        if (!spec.pass(item)) continue;
+    // no values for temperature are not averaged in
+    if (metric->symbol() == "average_temp")
+        for (int i=0; i<table.count(); i++)
+            if (rows.testBit(i) && values[i] == RideFile::NA) rows.clearBit(i);
 
-        // get this value
-        double value = item->getForSymbol(name);
-        double count = item->getForSymbol("workout_time"); // for averaging
+    // all but the mean square root aggregate over the column in one go,
+    // peaks and lows are against zero, as they always have been
+    if (metric->type() != RideMetric::MeanSquareRoot) {
 
-        // check values are bounded, just in case
-        if (std::isnan(value) || std::isinf(value)) value = 0;
+        RideCacheColumns::Aggregation how = RideCacheColumns::WeightedAverage;
+        switch (metric->type()) {
+        case RideMetric::RunningTotal:
+        case RideMetric::Total: how = RideCacheColumns::Sum; break;
+        case RideMetric::Low: how = RideCacheColumns::Min; break;
+        case RideMetric::Peak: how = RideCacheColumns::Max; break;
+        default: break;
+        }
 
-        // do we aggregate zero values ?
-        bool aggZero = metric->aggregateZero();
+        QVector<int> groups;
+        QVector<double> totals;
+        table.aggregate(metric->index(), how, RideCacheColumns::All, rows, groups, totals,
+                        metric->aggregateZero(), QDate(), duration);
 
-        // set aggZero to false and value to zero if is temperature and -255
-        if (metric->symbol() == "average_temp" && value == RideFile::NA) {
-            value = 0;
-            aggZero = false;
+        if (totals.count()) {
+            rvalue = totals[0];
+            if (how == RideCacheColumns::Min && rvalue > 0) rvalue = 0;
+            if (how == RideCacheColumns::Max && rvalue < 0) rvalue = 0;
         }
+    } else {
 
-        switch (metric->type()) {
-        case RideMetric::RunningTotal:
-        case RideMetric::Total:
-            rvalue += value;
-            break;
-        default:
-        case RideMetric::Average:
-            {
-            // average should be calculated taking into account
-            // the duration of the ride, otherwise high value but
-            // short rides will skew the overall average
-            if (value || aggZero) {
-                rvalue += value*count;
-                rcount += count;
-            }
-            break;
-            }
-        case RideMetric::Low:
-            {
-            if (value < rvalue) rvalue = value;
-            break;
-            }
-        case RideMetric::Peak:
-            {
-            if (value > rvalue) rvalue = value;
-            break;
-            }
-        case RideMetric::MeanSquareRoot:
-            {
-                rvalue = sqrt((pow(rvalue, 2)*rcount + pow(value,2)*count)/(rcount + count));
-                rcount += count;
-                break;
-            }
-        }
-    }
+        // mean square root, weighted by duration
+        for (int i=0; i<table.count(); i++) {
 
-    // now compute the average
-    if (metric->type() == RideMetric::Average) {
-        if (rcount) rvalue = rvalue / rcount;
+            // skip filtered rides
+            if (!rows.testBit(i)) continue;
+
+            double value = values[i];
+            double count = durations[i];
+
+            // check values are bounded, just in case
+            if (std::isnan(value) || std::isinf(value)) value = 0;
+
+            rvalue = sqrt((pow(rvalue, 2)*rcount + pow(value,2)*count)/(rcount + count));
+            rcount += count;
+        }
     }
 
     const_cast<RideMetric*>(metric)->setValue(rvalue);
@@ -629,15 +663,19 @@ RideCache::getBests(QString symbol, int n, Specification specification, bool use
     if (!metric) return results;
 
     // loop through and aggregate
-    foreach (RideItem *ride, rides_) {
+    const RideCacheColumns &table = columns();
+    const QVector<double> &values = table.column(metric->index());
+    QBitArray rows = table.mask(specification);
+
+    for (int i=0; i<table.count(); i++) {
 
         // skip filtered rides
-        if (!specification.pass(ride)) continue;
+        if (!rows.testBit(i)) continue;
 
         // get this value
         AthleteBest add;
-        add.nvalue = ride->getForSymbol(symbol, true);
-        add.date = ride->dateTime.date();
+        add.nvalue = values[i];
+        add.date = table.dates[i];
 
         const_cast<RideMetric*>(metric)->setValue(add.nvalue);
         add.value = metric->toString(useMetricUnits);
@@ -784,3 +822,214 @@ RideCache::isMetricRelevantForRides(Specification specification,
 
     return false;
 }
+
+RideCacheColumns
+RideCache::columns() const
+{
+    // rebuild lazily, rides may have been added or refreshed; rides being
+    // refreshed in the background are picked up when the refresh ends
+    // rather than rebuilding on every progress update whilst they change
+    columnsLock.lock();
+    if (columnsStale || columns_.count() != rides_.count()) {
+        columns_.rebuild(rides_);
+        columnsStale = false;
+    }
+    RideCacheColumns returning = columns_;
+    columnsLock.unlock();
+
+    return returning;
+}
+
+void
+RideCache::invalidateColumns()
+{
+    columnsLock.lock();
+    columnsStale = true;
+    columnsLock.unlock();
+}
+
+//
+// Column store
+//
+void
+RideCacheColumns::rebuild(const QVector<RideItem*> &rides)
+{
+    int metrics = RideMetricFactory::instance().metricCount();
+    int n = rides.count();
+
+    items = rides;
+    dates.resize(n);
+    sports.resize(n);
+    planned.resize(n);
+    rows.clear();
+    names.clear();
+
+    values_.resize(metrics);
+    counts_.resize(metrics);
+    for (int i=0; i<metrics; i++) {
+        values_[i].fill(0, n);
+        counts_[i].fill(1, n);
+    }
+
+    for (int row=0; row<n; row++) {
+        rows.insert(rides[row], row);
+        names.insert(rides[row]->fileName, row);
+        setRow(row, rides[row]);
+    }
+}
+
+bool
+RideCacheColumns::update(RideItem *item)
+{
+    int index = row(item);
+    if (index < 0) return false;
+
+    // metrics added/removed or ride moved, order is no longer valid
+    if (values_.count() != RideMetricFactory::instance().metricCount()) return false;
+    if (item->dateTime.date() != dates[index]) return false;
+
+    setRow(index, item);
+    return true;
+}
+
+void
+RideCacheColumns::setRow(int row, RideItem *item)
+{
+    dates[row] = item->dateTime.date();
+    sports[row] = item->isSwim ? Swim : (item->isRun ? Run : Bike);
+    planned[row] = item->planned;
+
+    // same rules as RideItem::getForSymbol, stale items are zero
+    int metrics = values_.count();
+    const QVector<double> &values = item->metrics();
+    const QVector<double> &counts = item->counts();
+    bool valid = values.count() == metrics;
+    bool validcounts = counts.count() == metrics;
+
+    for (int i=0; i<metrics; i++) {
+        values_[i][row] = valid ? values[i] : 0;
+        counts_[i][row] = (valid && validcounts && counts[i]) ? counts[i] : 1;
+    }
+}
+
+int
+RideCacheColumns::metricIndex(QString symbol)
+{
+    const RideMetric *m = RideMetricFactory::instance().rideMetric(symbol);
+    return m ? m->index() : -1;
+}
+
+const QVector<double> &
+RideCacheColumns::column(int index) const
+{
+    if (index < 0 || index >= values_.count()) return empty;
+    return values_[index];
+}
+
+const QVector<double> &
+RideCacheColumns::counts(int index) const
+{
+    if (index < 0 || index >= counts_.count()) return empty;
+    return counts_[index];
+}
+
+QBitArray
+RideCacheColumns::mask(Specification spec, unsigned char sport) const
+{
+    QBitArray returning(count());
+
+    // rows are in date order, so the date range is a single run of them
+    DateRange range = spec.dateRange();
+    int from = range.from.isValid() ? qLowerBound(dates.begin(), dates.end(), range.from) - dates.begin() : 0;
+    int to = range.to.isValid() ? qUpperBound(dates.begin(), dates.end(), range.to) - dates.begin() : count();
+    if (from < to) returning.fill(true, from, to);
+
+    // each filter is a list of names, look them up rather than
+    // searching every list for every ride
+    foreach(const QStringList &filter, spec.filterSet().filters()) {
+        QBitArray pass(count());
+        foreach(const QString &name, filter) {
+            int row = names.value(name, -1);
+            if (row >= 0) pass.setBit(row);
+        }
+        returning &= pass;
+    }
+
+    if ((sport & AnySport) != AnySport)
+        for (int i=from; i<to; i++)
+            if (!(sports[i] & sport)) returning.clearBit(i);
+
+    return returning;
+}
+
+int
+RideCacheColumns::group(QDate date, GroupBy groupBy, QDate origin)
+{
+    switch (groupBy) {
+    case Week: return 1 + ((date.toJulianDay() - origin.toJulianDay()) / 7);
+    case Month: return (date.year()*12) + date.month();
+    case Year: return date.year();
+    case All: return 1;
+    default:
+    case Day: return date.toJulianDay();
+    }
+}
+
+void
+RideCacheColumns::aggregate(int index, Aggregation how, GroupBy groupBy, const QBitArray &mask,
+                            QVector<int> &groups, QVector<double> &values, bool aggZero, QDate origin,
+                            int weightIndex) const
+{
+    groups.resize(0);
+    values.resize(0);
+
+    const QVector<double> &column = this->column(index);
+    const QVector<double> &weights = weightIndex < 0 ? this->counts(index) : this->column(weightIndex);
+    if (column.count() != count() || weights.count() != count() || mask.count() != count()) return;
+
+    double sum=0, weight=0;
+    int current=0;
+    for (int i=0; i<count(); i++) {
+
+        if (!mask.testBit(i)) continue;
+
+        double value = column[i];
+        if (std::isnan(value) || std::isinf(value)) value = 0;
+
+        // rows are in date order, so a new group means the last is done
+        int g = group(dates[i], groupBy, origin);
+        if (groups.isEmpty() || g != current) {
+            if (!groups.isEmpty() && (how == Average || how == WeightedAverage))
+                values.last() = weight ? sum / weight : 0;
+
+            groups << g;
+            values << value;
+            current = g;
+            sum = weight = 0;
+            if (value || aggZero) {
+                double w = how == WeightedAverage ? weights[i] : 1;
+                sum = value * w;
+                weight = w;
+            }
+            continue;
+        }
+
+        switch (how) {
+        case Sum: values.last() += value; break;
+        case Max: if (value > values.last()) values.last() = value; break;
+        case Min: if (value < values.last()) values.last() = value; break;
+        case Average:
+        case WeightedAverage:
+            if (value || aggZero) {
+                double w = how == WeightedAverage ? weights[i] : 1;
+                sum += value * w;
+                weight += w;
+            }
+            break;
+        }
+    }
+
+    // close the last group
+    if (!groups.isEmpty() && (how == Average || how == WeightedAverage))
+        values.last() = weight ? sum / weight : 0;
+}
@@ -26,7 +26,9 @@
 #include "PDModel.h"
 
 #include <QVector>
+#include <QBitArray>
 #include <QThread>
+#include <QMutex>
 
 #include <QFuture>
 #include <QFutureWatcher>
@@ -45,6 +47,67 @@ class RideCacheModel;
 class Estimator;
 class Banister;
 
+// Column store view of the ride cache; one contiguous column of doubles
+// per metric index, rows in the same (date) order as RideCache::rides().
+// Charts that aggregate over the whole cache (LTM, PMC, summaries) make
+// a few passes over these vectors instead of looking up every metric by
+// symbol for every ride.
+class RideCacheColumns
+{
+    public:
+
+        // how to aggregate and group rows
+        enum aggregation { Sum, Average, WeightedAverage, Max, Min };
+        typedef enum aggregation Aggregation;
+
+        enum groupby { Day, Week, Month, Year, All };
+        typedef enum groupby GroupBy;
+
+        // sport flags
+        enum sport { Bike = 0x01, Run = 0x02, Swim = 0x04, AnySport = 0x07 };
+
+        // (re)build from the ride list, or update a single row in place
+        // returns false if the row cannot be updated and a rebuild is needed
+        void rebuild(const QVector<RideItem*> &rides);
+        bool update(RideItem *item);
+
+        // rows
+        int count() const { return items.count(); }
+        int row(RideItem *item) const { return rows.value(item, -1); }
+
+        // metric columns by factory index, or -1 for unknown symbol
+        static int metricIndex(QString symbol);
+        const QVector<double> &column(int index) const;
+        const QVector<double> &counts(int index) const; // never zero, see RideItem::getCountForSymbol
+
+        // bitmap of rows that pass the specification and sport filter
+        QBitArray mask(Specification spec, unsigned char sport=AnySport) const;
+
+        // aggregate a column over the rows in mask, groups and values are
+        // returned in date order; weighted average uses the metric counts
+        // or the column given as weights
+        void aggregate(int index, Aggregation how, GroupBy groupBy, const QBitArray &mask,
+                       QVector<int> &groups, QVector<double> &values,
+                       bool aggZero=true, QDate origin=QDate(), int weightIndex=-1) const;
+
+        // group number for a date, weeks count from origin
+        static int group(QDate date, GroupBy groupBy, QDate origin);
+
+        // per row data
+        QVector<RideItem*> items;
+        QVector<QDate> dates;
+        QVector<unsigned char> sports;
+        QVector<bool> planned;
+
+    private:
+        void setRow(int row, RideItem *item);
+
+        QVector<QVector<double> > values_, counts_;
+        QHash<RideItem*, int> rows;
+        QHash<QString, int> names; // filename to row, for filters
+        QVector<double> empty;
+};
+
 class RideCache : public QObject
 {
     Q_OBJECT
@@ -84,11 +147,15 @@ class RideCache : public QObject
                                       SportRestriction sport=AnySport);
 
         // is running ?
-        bool isRunning() { return future.isRunning(); }
+        bool isRunning() { return future.isRunning() || discoveryFuture.isRunning(); }
 
         // the ride list
 	    QVector<RideItem*>&rides() { return rides_; } 
 
+        // column store view of rides(), rebuilt lazily after changes; it is
+        // a shallow copy so it stays valid if rebuilt whilst being used
+        RideCacheColumns columns() const;
+
         // add/remove a ride to the list
         void addRide(QString name, bool dosignal, bool select, bool useTempActivities, bool planned);
         void removeCurrentRide();
@@ -115,12 +182,18 @@ class RideCache : public QObject
         // cancel background processing because about to exit
         void cancel();
 
+        // second pass of the refresh, once the metrics are done
+        void discover();
+
         // item telling us it changed
         void itemChanged();
 
         // clear deleted objects
         void garbageCollect();
 
+        // rides added, removed or refreshed
+        void invalidateColumns();
+
         // first run to initialise estimates
         void initEstimates();
 
@@ -143,12 +216,15 @@ class RideCache : public QObject
         QDir directory, plannedDirectory;
 
         QVector<RideItem*> rides_, reverse_, delete_;
+        mutable QMutex columnsLock;
+        mutable RideCacheColumns columns_;
+        mutable bool columnsStale;
         RideCacheModel *model_;
         bool exiting;
 	    double progress_; // percent
 
-        QFuture<void> future;
-        QFutureWatcher<void> watcher;
+        QFuture<void> future, discoveryFuture;
+        QFutureWatcher<void> watcher, discoveryWatcher;
 
         Estimator *estimator;
         bool first; // updated when estimates are marked stale
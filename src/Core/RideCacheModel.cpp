@@ -62,7 +62,10 @@ RideCacheModel::flags(const QModelIndex &index) const
 QVariant 
 RideCacheModel::data(const QModelIndex &index, int role) const
 {
-    Q_UNUSED(role);
+    // the view asks for fonts, alignment, decorations and more
+    // for every cell, we only have values so don't work them out
+    if (role != Qt::DisplayRole && role != Qt::EditRole &&
+        role != Qt::ToolTipRole && role != SortRole) return QVariant();
 
     if (!index.isValid() || index.row() < 0 || index.row() >= rideCache->count() ||
         index.column() < 0 || index.column() >= columns_) return QVariant();
@@ -86,24 +89,25 @@ RideCacheModel::data(const QModelIndex &index, int role) const
                 // is a metric
                 int i=index.column()-5;
 
-                // unpack metric value into ridemetric and use it to get a stringified
-                // version using the right metric/imperial conversion
-                RideMetric *m = const_cast<RideMetric*>(factory->rideMetric(factory->metricName(i)));
+                const RideMetric *m = factory->rideMetric(factory->metricName(i));
+                double value = item->metrics_[m->index()];
+
+                // sorting and ranking don't need it formatted
+                if (role == SortRole) return value;
 
                 // bit of a kludge, but will return times as QTime,
                 // stuff with no decimal places as a number,
-                // but not if high precision, which means
-                // metrics with high precision don't sort this is crap XXX
+                // but not if high precision, the string is
+                // formatted from the value using the right
+                // metric/imperial conversion
                 if (m->isTime()) {
-                    return QTime(0,0,0).addSecs(rideCache->rides().at(index.row())->metrics_[m->index()]);
+                    return QTime(0,0,0).addSecs(value);
                 } else if (m->units(true) != "km" && m->precision() > 0) {
-                    m->setValue(rideCache->rides().at(index.row())->metrics_[m->index()]);
-                    return m->toString(context->athlete->useMetricUnits); // string
+                    return m->toString(context->athlete->useMetricUnits, value); // string
                 } else {
 
-                    // make low precision numbers sort, including distance which we picked
+                    // low precision numbers, including distance which we picked
                     // up as a special case. not sure about pace ....
-                    double value = rideCache->rides().at(index.row())->metrics_[m->index()];
 
                     // convert to imperial if needed
                     if (context->athlete->useMetricUnits == false) 
@@ -116,6 +120,8 @@ RideCacheModel::data(const QModelIndex &index, int role) const
 
                 // is a metadata
                 int i = index.column() -5 - factory->metricCount();
+                if (role == SortRole && (metadata[i].type == FIELD_INTEGER || metadata[i].type == FIELD_DOUBLE))
+                    return item->getText(metadata[i].name, "").toDouble();
                 return item->getText(metadata[i].name, "");
             }
         }
@@ -38,6 +38,10 @@ class RideCacheModel : public QAbstractTableModel
     Q_OBJECT
 
     public:
+        // typed values to sort and rank by, metrics are returned as
+        // doubles straight from the ride rather than formatted
+        enum { SortRole = Qt::UserRole + 16 };
+
         RideCacheModel(Context *, RideCache *);
 
         // must reimplement these
@@ -46,8 +46,7 @@
 #define RIDEDB_VERSION "1.9"
 
 class APIWebService;
-class HttpResponse;
-class HttpRequest;
+class APIRideSnapshot;
 
 // using context (we are reentrant)
 struct RideDBContext {
@@ -58,8 +57,7 @@ struct RideDBContext {
 
     // api parms
     APIWebService *api;
-    HttpRequest *request;
-    HttpResponse *response;
+    APIRideSnapshot *snapshot;
 
     // the scanner
     void *scanner;
@@ -78,8 +78,8 @@ ride: '{' rideelement_list '}'                                  {
                                                                     // a binary search, but suspect this ok < 10000 rides
                                                                     if (jc->api != NULL) {
                                                                     #ifdef GC_WANT_HTTP
-                                                                        // we're listing rides in the api
-                                                                        jc->api->writeRideLine(jc->item, jc->request, jc->response);
+                                                                        // we're taking a snapshot for the api
+                                                                        jc->snapshot->addRide(jc->item);
                                                                     #endif
                                                                     } else {
 
@@ -149,6 +149,8 @@ rideelement: ride_tuple
 ride_tuple: string ':' string                                   { 
                                                                      if ($1 == "filename") jc->item.fileName = $3;
                                                                      else if ($1 == "fingerprint") jc->item.fingerprint = $3.toULongLong();
+                                                                     else if ($1 == "routeprint") jc->item.routeprint = $3.toULongLong();
+                                                                     else if ($1 == "discoveryprint") jc->item.discoveryprint = $3.toULongLong();
                                                                      else if ($1 == "crc") jc->item.crc = $3.toULongLong();
                                                                      else if ($1 == "metacrc") jc->item.metacrc = $3.toULongLong();
                                                                      else if ($1 == "timestamp") jc->item.timestamp = $3.toULongLong();
@@ -497,6 +499,9 @@ void RideCache::save(bool opendata, QString filename)
                 // we don't send this info when sharing as opendata
                 stream << "\t\t\"filename\":\"" <<item->fileName <<"\",\n";
                 stream << "\t\t\"fingerprint\":\"" <<item->fingerprint <<"\",\n";
+                stream << "\t\t\"routeprint\":\"" <<item->routeprint <<"\",\n";
+                // not discovered yet, so make sure it is next time
+                stream << "\t\t\"discoveryprint\":\"" <<(item->discoverystale ? 0 : item->discoveryprint) <<"\",\n";
                 stream << "\t\t\"crc\":\"" <<item->crc <<"\",\n";
                 stream << "\t\t\"metacrc\":\"" <<item->metacrc <<"\",\n";
                 stream << "\t\t\"timestamp\":\"" <<item->timestamp <<"\",\n";
@@ -811,6 +816,77 @@ void RideCache::save(bool opendata, QString filename)
 
 #ifdef GC_WANT_HTTP
 #include "RideMetadata.h"
+#include <QFileInfo>
+
+QSharedPointer<APIRideSnapshot>
+APIWebService::rideSnapshot(QString athlete)
+{
+    QFileInfo info(QString("%1/%2/cache/rideDB.json").arg(home.absolutePath()).arg(athlete));
+    if (!info.exists()) return QSharedPointer<APIRideSnapshot>();
+
+    // still current ?
+    snapshotLock.lock();
+    QSharedPointer<APIRideSnapshot> current = snapshots.value(athlete);
+    snapshotLock.unlock();
+    if (current && current->modified == info.lastModified() && current->size == info.size()) return current;
+
+    // parse outside the lock, so other athletes aren't held up, if two
+    // requests arrive together they may both parse, but that's harmless
+    QSharedPointer<APIRideSnapshot> snapshot(new APIRideSnapshot);
+    snapshot->modified = info.lastModified();
+    snapshot->size = info.size();
+    snapshot->etag = QString("%1-%2").arg(snapshot->modified.toMSecsSinceEpoch(), 0, 16)
+                                     .arg(snapshot->size, 0, 16).toLatin1();
+
+    QFile rideDB(info.absoluteFilePath());
+    if (rideDB.open(QFile::ReadOnly)) {
+
+        // ok, lets read it in
+        QTextStream stream(&rideDB);
+        stream.setCodec("UTF-8");
+
+        // Read the entire file into a QString -- we avoid using fopen since it
+        // doesn't handle foreign characters well. Instead we use QFile and parse
+        // from a QString
+        QString contents = stream.readAll();
+        rideDB.close();
+
+        // create scanner context for reentrant parsing
+        RideDBContext *jc = new RideDBContext;
+        jc->cache = NULL;
+        jc->api = this;
+        jc->snapshot = snapshot.data();
+        jc->old = false;
+
+        // clean item
+        jc->item.path = home.absolutePath() + "/activities";
+        jc->item.context = NULL;
+        jc->item.isstale = jc->item.isdirty = jc->item.isedit = false;
+
+        RideDBlex_init(&scanner);
+
+        // inform the parser/lexer we have a new file
+        RideDB_setString(contents, scanner);
+
+        // setup
+        jc->errors.clear();
+
+        // parse it
+        RideDBparse(jc);
+
+        // clean up
+        RideDBlex_destroy(scanner);
+
+        // regardless of errors we're done !
+        delete jc;
+    }
+
+    snapshotLock.lock();
+    snapshots.insert(athlete, snapshot);
+    snapshotLock.unlock();
+
+    return snapshot;
+}
 
 void
 APIWebService::listRides(QString athlete, HttpRequest &request, HttpResponse &response)
@@ -836,8 +912,15 @@ APIWebService::listRides(QString athlete, HttpRequest &request, HttpResponse &re
     if (intervalsp.toUpper() == "TRUE") settings.intervals = true;
     else settings.intervals = false;
 
-    // set user data
-    response.setUserData(&settings);
+    // honour the since parameter
+    QString sincep(request.getParameter("since"));
+    settings.since = QDate(1900,01,01);
+    if (sincep != "") settings.since = QDate::fromString(sincep,"yyyy/MM/dd");
+
+    // before parameter
+    QString beforep(request.getParameter("before"));
+    settings.before = QDate(3000,01,01);
+    if (beforep != "") settings.before = QDate::fromString(beforep,"yyyy/MM/dd");
 
     // write headings
     const RideMetricFactory &factory = RideMetricFactory::instance();
@@ -858,23 +941,17 @@ APIWebService::listRides(QString athlete, HttpRequest &request, HttpResponse &re
     QStringList wantedNames;
     if (metrics != "") wantedNames = metrics.split(",");
 
-    // write headings
-    response.bwrite("date, time, filename");
-
     // don't want metrics, so do it fast by traversing the ride directory
     if (wantedNames.count() == 1 && wantedNames[0].toUpper() == "NONE") nometrics = true;
 
-    // if intervals, add interval name
-    if (settings.intervals == true) response.bwrite(", interval name, interval type");
-
     // get metadata definitions into settings
     QString metadata = request.getParameter("metadata");
+    QDir config(home.absolutePath() + "/" + athlete + "/config");
+    QString metaConfig = config.canonicalPath()+"/metadata.xml";
     bool nometa = true;
     if (metadata.toUpper() != "NONE" && metadata != "") {
 
         // first lets read in meta config
-        QDir config(home.absolutePath() + "/" + athlete + "/config");
-        QString metaConfig = config.canonicalPath()+"/metadata.xml";
         if (QFile(metaConfig).exists()) {
 
             // params to readXML - we ignore them
@@ -918,9 +995,25 @@ APIWebService::listRides(QString athlete, HttpRequest &request, HttpResponse &re
         if(settings.metawanted.count()) nometa = false;
     }
 
-    // list 'em by reading the ride cache from disk
+    // list 'em from the snapshot of the ride cache
     if ((nometa == false || nometrics == false) && settings.intervals == false) {
 
+        QSharedPointer<APIRideSnapshot> snapshot = rideSnapshot(athlete);
+        if (snapshot.isNull()) {
+            response.setStatus(404);
+            response.write("malformed URL or unknown athlete.\n");
+            return;
+        }
+
+        // the rides only change when rideDB.json does, but the fields
+        // listed also depend upon the metadata config
+        QByteArray etag = snapshot->etag;
+        if (nometa == false) etag += "-" + QByteArray::number(QFileInfo(metaConfig).lastModified().toMSecsSinceEpoch(), 16);
+        if (notModified(request, response, "\"" + etag + "\"")) return;
+
+        // write headings
+        response.bwrite("date, time, filename");
+
         int i=0;
         foreach(const RideMetric *m, indexed) {
 
@@ -950,61 +1043,17 @@ APIWebService::listRides(QString athlete, HttpRequest &request, HttpResponse &re
         }
         response.bwrite("\n");
 
-        // parse the rideDB and write a line for each entry
-        if (rideDB.exists() && rideDB.open(QFile::ReadOnly)) {
-
-            // ok, lets read it in
-            QTextStream stream(&rideDB);
-            stream.setCodec("UTF-8");
-
-            // Read the entire file into a QString -- we avoid using fopen since it
-            // doesn't handle foreign characters well. Instead we use QFile and parse
-            // from a QString
-            QString contents = stream.readAll();
-            rideDB.close();
-
-            // create scanner context for reentrant parsing
-            RideDBContext *jc = new RideDBContext;
-            jc->cache = NULL;
-            jc->api = this;
-            jc->response = &response;
-            jc->request = &request;
-            jc->old = false;
-
-            // clean item
-            jc->item.path = home.absolutePath() + "/activities";
-            jc->item.context = NULL;
-            jc->item.isstale = jc->item.isdirty = jc->item.isedit = false;
-
-            RideDBlex_init(&scanner);
-
-            // inform the parser/lexer we have a new file
-            RideDB_setString(contents, scanner);
-
-            // setup
-            jc->errors.clear();
-
-            // parse it
-            RideDBparse(jc);
-
-            // clean up
-            RideDBlex_destroy(scanner);
-
-            // regardless of errors we're done !
-            delete jc;
-        }
+        // a line for each ride
+        foreach(const APIRideSnapshot::Ride &ride, snapshot->rides)
+            writeRideLine(ride, settings, response);
 
     } else {
 
-        // honour the since parameter
-        QString sincep(request.getParameter("since"));
-        QDate since(1900,01,01);
-        if (sincep != "") since = QDate::fromString(sincep,"yyyy/MM/dd");
+        // write headings
+        response.bwrite("date, time, filename");
 
-        // before parameter
-        QString beforep(request.getParameter("before"));
-        QDate before(3000,01,01);
-        if (beforep != "") before = QDate::fromString(beforep,"yyyy/MM/dd");
+        // if intervals, add interval name
+        if (settings.intervals == true) response.bwrite(", interval name, interval type");
 
         // fast list of rides by traversing the directory
         response.bwrite("\n"); // headings have no metric columns
@@ -1023,7 +1072,7 @@ APIWebService::listRides(QString athlete, HttpRequest &request, HttpResponse &re
             if (!RideFile::parseRideFileName(name, &dateTime)) continue; 
 
             // in range?
-            if (dateTime.date() < since || dateTime.date() > before) continue;
+            if (dateTime.date() < settings.since || dateTime.date() > settings.before) continue;
 
             // is it a backup ?
             if (name.endsWith(".bak")) continue;
@@ -29,11 +29,11 @@
 #include "PaceZones.h"
 #include "Settings.h"
 #include "Colors.h" // for ColorEngine
-#include "AddIntervalDialog.h" // till we fixup ridefilecache to have offsets
 #include "TimeUtils.h" // time_to_string()
 #include "WPrime.h" // for matches
 
 #include <cmath>
+#include <algorithm>
 #include <QtAlgorithms>
 #include <QMap>
 #include <QMapIterator>
@@ -44,16 +44,16 @@
 // merge wizard and interval navigator
 RideItem::RideItem() 
     : 
-    ride_(NULL), fileCache_(NULL), context(NULL), isdirty(false), isstale(true), isedit(false), skipsave(false), path(""), fileName(""),
-    color(QColor(1,1,1)), isRun(false), isSwim(false), samples(false), zoneRange(-1), hrZoneRange(-1), paceZoneRange(-1), fingerprint(0), metacrc(0), crc(0), timestamp(0), dbversion(0), udbversion(0), weight(0) {
+    ride_(NULL), fileCache_(NULL), context(NULL), isdirty(false), isstale(true), isedit(false), skipsave(false), routestale(false), discoverystale(false), path(""), fileName(""),
+    color(QColor(1,1,1)), isRun(false), isSwim(false), samples(false), zoneRange(-1), hrZoneRange(-1), paceZoneRange(-1), fingerprint(0), routeprint(0), discoveryprint(0), metacrc(0), crc(0), timestamp(0), dbversion(0), udbversion(0), weight(0) {
     metrics_.fill(0, RideMetricFactory::instance().metricCount());
     count_.fill(0, RideMetricFactory::instance().metricCount());
 }
 
 RideItem::RideItem(RideFile *ride, Context *context) 
     : 
-    ride_(ride), fileCache_(NULL), context(context), isdirty(false), isstale(true), isedit(false), skipsave(false), path(""), fileName(""),
-    color(QColor(1,1,1)), isRun(false), isSwim(false), samples(false), zoneRange(-1), hrZoneRange(-1), paceZoneRange(-1), fingerprint(0), metacrc(0), crc(0), timestamp(0), dbversion(0), udbversion(0), weight(0) 
+    ride_(ride), fileCache_(NULL), context(context), isdirty(false), isstale(true), isedit(false), skipsave(false), routestale(false), discoverystale(false), path(""), fileName(""),
+    color(QColor(1,1,1)), isRun(false), isSwim(false), samples(false), zoneRange(-1), hrZoneRange(-1), paceZoneRange(-1), fingerprint(0), routeprint(0), discoveryprint(0), metacrc(0), crc(0), timestamp(0), dbversion(0), udbversion(0), weight(0) 
 {
     metrics_.fill(0, RideMetricFactory::instance().metricCount());
     count_.fill(0, RideMetricFactory::instance().metricCount());
@@ -61,8 +61,8 @@ RideItem::RideItem(RideFile *ride, Context *context)
 
 RideItem::RideItem(QString path, QString fileName, QDateTime &dateTime, Context *context, bool planned)
     :
-    ride_(NULL), fileCache_(NULL), context(context), isdirty(false), isstale(true), isedit(false), skipsave(false), path(path), fileName(fileName),
-    dateTime(dateTime), color(QColor(1,1,1)), planned(planned), isRun(false), isSwim(false), samples(false), zoneRange(-1), hrZoneRange(-1), paceZoneRange(-1), fingerprint(0),
+    ride_(NULL), fileCache_(NULL), context(context), isdirty(false), isstale(true), isedit(false), skipsave(false), routestale(false), discoverystale(false), path(path), fileName(fileName),
+    dateTime(dateTime), color(QColor(1,1,1)), planned(planned), isRun(false), isSwim(false), samples(false), zoneRange(-1), hrZoneRange(-1), paceZoneRange(-1), fingerprint(0), routeprint(0), discoveryprint(0),
     metacrc(0), crc(0), timestamp(0), dbversion(0), udbversion(0), weight(0) 
 {
     metrics_.fill(0, RideMetricFactory::instance().metricCount());
@@ -73,8 +73,8 @@ RideItem::RideItem(QString path, QString fileName, QDateTime &dateTime, Context
 // pre-computed metrics and storing ride metadata
 RideItem::RideItem(RideFile *ride, QDateTime &dateTime, Context *context)
     :
-    ride_(ride), fileCache_(NULL), context(context), isdirty(true), isstale(true), isedit(false), skipsave(false), dateTime(dateTime),
-    zoneRange(-1), hrZoneRange(-1), paceZoneRange(-1), fingerprint(0), metacrc(0), crc(0), timestamp(0), dbversion(0), udbversion(0), weight(0)
+    ride_(ride), fileCache_(NULL), context(context), isdirty(true), isstale(true), isedit(false), skipsave(false), routestale(false), discoverystale(false), dateTime(dateTime),
+    zoneRange(-1), hrZoneRange(-1), paceZoneRange(-1), fingerprint(0), routeprint(0), discoveryprint(0), metacrc(0), crc(0), timestamp(0), dbversion(0), udbversion(0), weight(0)
 {
     metrics_.fill(0, RideMetricFactory::instance().metricCount());
     count_.fill(0, RideMetricFactory::instance().metricCount());
@@ -114,6 +114,8 @@ RideItem::setFrom(RideItem&here, bool temp) // used when loading cache/rideDB.js
     hrZoneRange = here.hrZoneRange;
     paceZoneRange = here.paceZoneRange;
     fingerprint = here.fingerprint;
+    routeprint = here.routeprint;
+    discoveryprint = here.discoveryprint;
     metacrc = here.metacrc;
     crc = here.crc;
     timestamp = here.timestamp;
@@ -482,22 +484,36 @@ RideItem::checkStale()
 
         } else {
 
-            // or have cp / zones or routes fingerprints changed ?
+            // or have cp / zones fingerprints changed ?
             // note we now get the fingerprint from the zone range
             // and not the entire config so that if you add a new
             // range (e.g. set CP from today) but none of the other
             // ranges change then there is no need to recompute the
             // metrics for older rides !
             // HRV fingerprint added to detect changes on HRV Measures
+            // routes and discovery are left out, see checkRoutes() and checkDiscovery()
 
             // get the new zone configuration fingerprint that applies for the ride date
             unsigned long rfingerprint = static_cast<unsigned long>(context->athlete->zones(isRun)->getFingerprint(dateTime.date()))
                         + (appsettings->cvalue(context->athlete->cyclist, context->athlete->zones(isRun)->useCPforFTPSetting(), 0).toInt() ? 1 : 0)
                         + static_cast<unsigned long>(context->athlete->paceZones(isSwim)->getFingerprint(dateTime.date()))
                         + static_cast<unsigned long>(context->athlete->hrZones(isRun)->getFingerprint(dateTime.date()))
-                        + static_cast<unsigned long>(context->athlete->routes->getFingerprint())
-                        + static_cast<unsigned long>(getHrvFingerprint())
-                        + appsettings->cvalue(context->athlete->cyclist, GC_DISCOVERY, 57).toInt(); // 57 does not include search for PEAKS
+                        + static_cast<unsigned long>(getHrvFingerprint());
+
+            // caches written before routes and discovery had their own
+            // fingerprints folded both into this one, rather than rebuild
+            // every ride once accept that and take the prints from it
+            if (fingerprint != rfingerprint && routeprint == 0 && discoveryprint == 0) {
+
+                unsigned long routes = context->athlete->routes->getFingerprint();
+                unsigned long discovery = appsettings->cvalue(context->athlete->cyclist, GC_DISCOVERY, 57).toInt(); // 57 does not include search for PEAKS
+
+                if (fingerprint == rfingerprint + routes + discovery) {
+                    fingerprint = rfingerprint;
+                    routeprint = routes;
+                    discoveryprint = discovery;
+                }
+            }
 
             if (fingerprint != rfingerprint) {
 
@@ -539,8 +555,346 @@ RideItem::checkStale()
     return isstale;
 }
 
+// check if the routes have changed since we last looked for them, only
+// the route intervals need updating for that so the metrics are left alone
+bool
+RideItem::checkRoutes()
+{
+    if (!routestale) routestale = routeprint != context->athlete->routes->getFingerprint();
+    return routestale;
+}
+
+// power aggregated into 1 second samples and integrated, so the energy
+// of any window is the difference between two entries; rides longer
+// than a day are skipped and get an empty series
+static QVector<long>
+integratedWatts(RideFile *f)
+{
+    QVector<long> integrated;
+
+    const int SAMPLERATE = 1000; // 1000ms samplerate = 1 second samples
+
+    RideFilePoint sample;        // we reuse this to aggregate all values
+    long time = 0L;              // current time accumulates as we run through data
+    double lastT = 0.0f;         // last sample time seen in seconds
+
+    // set the array size
+    int arraySize = f->dataPoints().last()->secs + f->recIntSecs();
+
+    // anything longer than a day or negative is skipped
+    if (arraySize < 0 || arraySize >= (24*3600)) return integrated;
+
+    integrated.reserve(arraySize);
+    long rtot = 0;
+
+    foreach(RideFilePoint *p, f->dataPoints()) {
+
+        // increment secs by recIntSecs as the time series
+        // always starts at zero, normalized by the file reader
+        double psecs = p->secs + f->recIntSecs();
+
+        // whats the dt in microseconds
+        int dt = (psecs * 1000) - (lastT * 1000);
+        lastT = psecs;
+
+
+        // ignore time goes backwards
+        if (dt < 0) continue;
+
+        //
+        // AGGREGATE INTO SAMPLES
+        //
+        while (integrated.count() < arraySize && dt) {
+
+            // we keep track of how much time has been aggregated
+            // into sample, so 'need' is whats left to aggregate 
+            // for the full sample
+            int need = SAMPLERATE - sample.secs;
+
+            // aggregate
+            if (dt < need) {
+
+                // the entire sample read is less than we need
+                // so aggregate the whole lot and wait fore more
+                // data to be read. If there is no more data then
+                // this will be lost, we don't keep incomplete samples
+                sample.secs += dt;
+                sample.watts += float(dt) * p->watts;
+                dt = 0;
+
+            } else {
+
+                // dt is more than we need to fill and entire sample
+                // so lets just take the fraction we need
+                dt -= need;
+
+                // accumulating time and distance
+                sample.secs = time; time += double(SAMPLERATE) / 1000.0f;
+
+                // averaging sample data
+                sample.watts += float(need) * p->watts;
+                sample.watts /= 1000;
+
+                // integrate
+                rtot += sample.watts;
+                integrated << rtot;
+
+                // reset back to zero so we can aggregate
+                // the next sample
+                sample.secs = 0;
+                sample.watts = 0;
+            }
+        }
+    }
+    return integrated;
+}
+
+// running totals of the ride samples built once per ride, so every
+// detector and the metrics of every interval they find are sums over
+// a range of samples instead of another pass through the ride
+class DiscoverySeries
+{
+    public:
+
+        DiscoverySeries(RideFile *f) : f(f), delta(f->recIntSecs()) {
+
+            int n = f->dataPoints().count();
+            peakWatts.resize(n+1); peakKph.resize(n+1);
+            watts.resize(n+1); wattsCount.resize(n+1);
+            hr.resize(n+1); hrCount.resize(n+1);
+            cad.resize(n+1); cadCount.resize(n+1);
+            moving.resize(n+1); riding.resize(n+1);
+            secs.resize(n); km.resize(n); alt.resize(n);
+
+            peakWatts[0] = peakKph[0] = watts[0] = hr[0] = cad[0] = 0;
+            wattsCount[0] = hrCount[0] = cadCount[0] = moving[0] = riding[0] = 0;
+
+            for (int i=0; i<n; i++) {
+                const RideFilePoint *p = f->dataPoints().at(i);
+
+                // as AddIntervalDialog::findPeaks totals them
+                peakWatts[i+1] = peakWatts[i] + p->watts;
+                peakKph[i+1] = peakKph[i] + p->kph;
+
+                // as the basic metrics count them
+                watts[i+1] = watts[i] + (p->watts >= 0 ? p->watts : 0);
+                wattsCount[i+1] = wattsCount[i] + (p->watts >= 0 ? 1 : 0);
+                hr[i+1] = hr[i] + (p->hr > 0 ? p->hr : 0);
+                hrCount[i+1] = hrCount[i] + (p->hr > 0 ? 1 : 0);
+                cad[i+1] = cad[i] + (p->cad > 0 ? p->cad : 0);
+                cadCount[i+1] = cadCount[i] + (p->cad > 0 ? 1 : 0);
+                moving[i+1] = moving[i] + (p->kph > 0 ? 1 : 0);
+                riding[i+1] = riding[i] + ((p->kph > 0 || p->cad > 0) ? 1 : 0);
+
+                secs[i] = p->secs;
+                km[i] = p->km;
+                alt[i] = p->alt;
+            }
+
+            // efforts and sprints work in whole seconds
+            if (n && f->isDataPresent(RideFile::watts)) integrated = integratedWatts(f);
+        }
+
+        // best average over a duration, the same search and the same
+        // interval as AddIntervalDialog::findPeaks with one result
+        bool peak(RideFile::SeriesType series, double duration, double &start, double &stop, double &avg) const {
+
+            const QVector<double> &total = series == RideFile::watts ? peakWatts : peakKph;
+            int n = secs.count();
+            bool found = false;
+
+            // ride is shorter than the window size!
+            if (n == 0 || duration > secs[n-1] + delta) return false;
+
+            for (int i=0, j=0; j<n; j++) {
+
+                // discard samples until the window is shorter than duration + delta
+                while (i < j && secs[j] - secs[i] + delta >= duration + delta) i++;
+
+                double length = secs[j] - secs[i] + delta;
+                if (length >= duration) {
+
+                    // ties go to the earliest
+                    double mean = (total[j+1] - total[i]) * delta / length;
+                    if (!found || mean > avg) {
+                        found = true;
+                        start = secs[i];
+                        stop = secs[j];
+                        avg = mean;
+                    }
+                }
+            }
+            return found;
+        }
+
+        // the basic metrics for an interval, from the same samples a
+        // Specification for it would iterate over; the rest are zero
+        void metrics(IntervalItem *interval, const Zones *zones, int range) const {
+
+            RideMetricFactory &factory = RideMetricFactory::instance();
+            interval->metrics().fill(0, factory.metricCount());
+            interval->counts().fill(0, factory.metricCount());
+
+            if (secs.isEmpty()) return;
+            int from = f->timeIndex(interval->start);
+            int to = f->timeIndex(interval->stop);
+            if (to < from) return;
+
+            const RideFilePoint *first = f->dataPoints().at(from);
+            double duration = secs[to] - secs[from] + delta;
+
+            double distance = 0;
+            if (f->isDataPresent(RideFile::km)) {
+                distance = km[to] - km[from];
+                if (f->isDataPresent(RideFile::kph)) distance += first->kph / 3600.0 * delta;
+            }
+
+            double timeriding = 0;
+            if (f->isDataPresent(RideFile::kph) || f->isDataPresent(RideFile::cad))
+                timeriding = (riding[to+1] - riding[from]) * delta;
+
+            double secsmoving = duration;
+            if (f->isDataPresent(RideFile::kph)) secsmoving = (moving[to+1] - moving[from]) * delta;
+
+            int pcount = wattsCount[to+1] - wattsCount[from];
+            double ap = pcount ? (watts[to+1] - watts[from]) / pcount : 0;
+
+            int hcount = hrCount[to+1] - hrCount[from];
+            int ccount = cadCount[to+1] - cadCount[from];
+
+            set(interval, "workout_time", duration);
+            set(interval, "time_riding", timeriding);
+            set(interval, "total_distance", distance);
+            set(interval, "average_speed", secsmoving ? distance / secsmoving * 3600.0 : 0);
+
+            if (f->isDataPresent(RideFile::watts)) {
+                set(interval, "total_work", (watts[to+1] - watts[from]) * delta / 1000.0);
+                set(interval, "average_power", ap, pcount);
+
+                // fractional zone, as the power_zone metric
+                if (zones && range >= 0) {
+                    int zone = zones->whichZone(range, ap) + 1;
+                    double percent = 0;
+                    if (zone) {
+                        QString name, description;
+                        int low, high;
+                        zones->zoneInfo(range, zone-1, name, description, low, high);
+                        high = std::max(high, zones->getPmax(range));
+                        percent = double(ap-low) / double(high-low);
+                        if (percent > 0.9f && percent < 1.00f) percent = 0.9f;
+                    }
+                    set(interval, "power_zone", double(zone) + percent);
+                }
+            }
+            if (f->isDataPresent(RideFile::hr))
+                set(interval, "average_hr", hcount ? (hr[to+1] - hr[from]) / hcount : 0, hcount);
+            if (f->isDataPresent(RideFile::cad))
+                set(interval, "average_cad", ccount ? (cad[to+1] - cad[from]) / ccount : 0, ccount);
+        }
+
+        RideFile *f;
+        double delta;
+
+        // per sample, for the climb search
+        QVector<double> secs, km, alt;
+
+        // whole seconds of energy, for the effort and sprint searches
+        QVector<long> integrated;
+
+    private:
+
+        static void set(IntervalItem *interval, QString symbol, double value, double count=1) {
+            const RideMetric *m = RideMetricFactory::instance().rideMetric(symbol);
+            if (!m || std::isinf(value) || std::isnan(value)) return;
+            interval->metrics()[m->index()] = value;
+            interval->counts()[m->index()] = count;
+        }
+
+        QVector<double> peakWatts, peakKph, watts, hr, cad;
+        QVector<int> wattsCount, hrCount, cadCount, moving, riding;
+};
+
+void
+RideItem::refreshRoutes()
+{
+    if (!routestale) return;
+
+    routestale = false;
+    routeprint = context->athlete->routes->getFingerprint();
+
+    int discovery = appsettings->cvalue(context->athlete->cyclist, GC_DISCOVERY, 57).toInt(); // 57 does not include search for PEAKS
+
+    QList<IntervalItem*> deletelist = intervals(RideFileInterval::ROUTE);
+    QList<IntervalItem*> here;
+
+    // no gps, no routes, no need to open the file
+    if (samples && present.contains('G') && (discovery & RideFileInterval::intervalTypeBits(RideFileInterval::ROUTE))) {
+
+        bool doclose = !isOpen();
+        RideFile *f = ride();
+
+        if (f && f->isDataPresent(RideFile::lon)) {
+            context->athlete->routes->search(this, f, here);
+
+            DiscoverySeries series(f);
+            foreach(IntervalItem *add, here) {
+                add->rideInterval = NULL;
+                series.metrics(add, context->athlete->zones(isRun), zoneRange);
+            }
+        }
+
+        if (f && doclose) close();
+    }
+
+    // nothing found and nothing to lose
+    if (deletelist.isEmpty() && here.isEmpty()) return;
+
+    // swap in the new ones, leaving the rest as they were
+    QList<IntervalItem*> replace;
+    foreach(IntervalItem *x, intervals_)
+        if (x->type != RideFileInterval::ROUTE) replace << x;
+    intervals_ = replace + here;
+
+    // tell the world we changed
+    context->notifyIntervalsUpdate(this);
+
+    // wipe them away now
+    foreach(IntervalItem *x, deletelist) delete x;
+}
+
+// check if the discovery settings have changed since the intervals were
+// last discovered, only the discovered intervals need updating for that
+bool
+RideItem::checkDiscovery()
+{
+    unsigned long discovery = appsettings->cvalue(context->athlete->cyclist, GC_DISCOVERY, 57).toInt(); // 57 does not include search for PEAKS
+    if (!discoverystale) discoverystale = discoveryprint != discovery;
+    return discoverystale;
+}
+
+void
+RideItem::refreshDiscovery()
+{
+    if (!discoverystale) return;
+
+    // found with the current settings even if the file can't be read,
+    // otherwise checkDiscovery() would queue it again on every refresh
+    discoverystale = false;
+    discoveryprint = appsettings->cvalue(context->athlete->cyclist, GC_DISCOVERY, 57).toInt(); // 57 does not include search for PEAKS
+
+    // no samples, nothing to find and no need to open the file
+    bool doclose = samples && !isOpen();
+    if (samples && ride() == NULL) return;
+
+    // the intervals kept from the file depend on what is discovered
+    updateIntervals();
+    discoverIntervals();
+
+    if (doclose) close();
+}
+
 void
-RideItem::refresh()
+RideItem::refresh(bool discover)
 {
     if (!isstale) return;
 
@@ -633,17 +987,22 @@ RideItem::refresh()
                 count_[j] = 0.00f;
             }
 
-        // Update auto intervals AFTER ridefilecache as used for bests
-        updateIntervals();
+        // Update auto intervals AFTER ridefilecache as used for bests,
+        // the ones in the file first and then those we discover, unless
+        // the ride cache is going to find them in its discovery pass
+        if (discover) {
+            updateIntervals();
+            discoverIntervals();
+        } else {
+            discoverystale = true;
+        }
 
         // update fingerprints etc, crc done above
         fingerprint = static_cast<unsigned long>(context->athlete->zones(isRun)->getFingerprint(dateTime.date()))
                     + (appsettings->cvalue(context->athlete->cyclist, context->athlete->zones(isRun)->useCPforFTPSetting(), 0).toInt() ? 1 : 0)
                     + static_cast<unsigned long>(context->athlete->paceZones(isSwim)->getFingerprint(dateTime.date()))
                     + static_cast<unsigned long>(context->athlete->hrZones(isRun)->getFingerprint(dateTime.date()))
-                    + static_cast<unsigned long>(context->athlete->routes->getFingerprint()) +
-                    + static_cast<unsigned long>(getHrvFingerprint())
-                    + appsettings->cvalue(context->athlete->cyclist, GC_DISCOVERY, 57).toInt(); // 57 does not include search for PEAKS
+                    + static_cast<unsigned long>(getHrvFingerprint());
 
         dbversion = DBSchemaVersion;
         udbversion = UserMetricSchemaVersion;
@@ -844,34 +1203,10 @@ RideItem::updateIntervals()
 
     // no ride data available ?
     if (!samples) {
-        context->notifyIntervalsUpdate(this);
+        foreach(IntervalItem *x, deletelist) delete x;
         return;
     }
 
-    // Get CP and W' estimates for date of ride
-    double CP = 0;
-    double WPRIME = 0;
-    double PMAX = 0;
-    bool zoneok = false;
-
-    if (context->athlete->zones(isRun)) {
-
-        // if range is -1 we need to fall back to a default value
-        CP = zoneRange >= 0 ? context->athlete->zones(isRun)->getCP(zoneRange) : 0;
-        WPRIME = zoneRange >= 0 ? context->athlete->zones(isRun)->getWprime(zoneRange) : 0;
-        PMAX = zoneRange >= 0 ? context->athlete->zones(isRun)->getPmax(zoneRange) : 0;
-
-        // did we override CP in metadata ?
-        int oCP = getText("CP","0").toInt();
-        int oW = getText("W'","0").toInt();
-        int oPMAX = getText("Pmax","0").toInt();
-        if (oCP) CP=oCP;
-        if (oW) WPRIME=oW;
-        if (oPMAX) PMAX=oPMAX;
-
-        if (zoneRange >= 0 && context->athlete->zones(isRun)) zoneok=true;
-    }
-
     // USER / DEVICE INTERVALS
     // first we create interval items for all intervals
     // that are in the ridefile, but ignore Peaks since we
@@ -942,6 +1277,73 @@ RideItem::updateIntervals()
         //qDebug()<<"interval:"<<interval.name<<interval.start<<interval.stop<<"f:"<<begin->secs<<end->secs;
     }
 
+    // wipe them away now
+    foreach(IntervalItem *x, deletelist) delete x;
+}
+
+void
+RideItem::discoverIntervals()
+{
+    // what do we need ?
+    int discovery = appsettings->cvalue(context->athlete->cyclist, GC_DISCOVERY, 57).toInt(); // 57 does not include search for PEAKS
+
+    // DO NOT USE ride() since it will call a refresh !
+    RideFile *f = ride_;
+
+    // only the discovered intervals are replaced, the ones
+    // from the file and the entire activity are left alone
+    QList<IntervalItem*> deletelist;
+    QList<IntervalItem*> keep;
+    foreach(IntervalItem *x, intervals_) {
+        if (x->type == RideFileInterval::USER || x->type == RideFileInterval::ALL) keep << x;
+        else deletelist << x;
+    }
+    intervals_ = keep;
+
+    // found with the current settings, routes are searched for too
+    discoveryprint = discovery;
+    discoverystale = false;
+    routeprint = context->athlete->routes->getFingerprint();
+    routestale = false;
+
+    // no ride data available ?
+    if (!samples || f == NULL) {
+        context->notifyIntervalsUpdate(this);
+        foreach(IntervalItem *x, deletelist) delete x;
+        return;
+    }
+
+    // discovered intervals follow on from those in the file
+    int count = intervals(RideFileInterval::USER).count();
+
+    // Get CP and W' estimates for date of ride
+    double CP = 0;
+    double WPRIME = 0;
+    double PMAX = 0;
+    bool zoneok = false;
+
+    if (context->athlete->zones(isRun)) {
+
+        // if range is -1 we need to fall back to a default value
+        CP = zoneRange >= 0 ? context->athlete->zones(isRun)->getCP(zoneRange) : 0;
+        WPRIME = zoneRange >= 0 ? context->athlete->zones(isRun)->getWprime(zoneRange) : 0;
+        PMAX = zoneRange >= 0 ? context->athlete->zones(isRun)->getPmax(zoneRange) : 0;
+
+        // did we override CP in metadata ?
+        int oCP = getText("CP","0").toInt();
+        int oW = getText("W'","0").toInt();
+        int oPMAX = getText("Pmax","0").toInt();
+        if (oCP) CP=oCP;
+        if (oW) WPRIME=oW;
+        if (oPMAX) PMAX=oPMAX;
+
+        if (zoneRange >= 0 && context->athlete->zones(isRun)) zoneok=true;
+    }
+
+    // built once and shared by all the searches below
+    DiscoverySeries series(f);
+    const Zones *zones = context->athlete->zones(isRun);
+
     // DISCOVERY
 
     //qDebug() << "SEARCH PEAK POWERS"
@@ -957,22 +1359,21 @@ RideItem::updateIntervals()
         for(int i=0; durations[i] != 0; i++) {
 
             // go hunting for best peak
-            QList<AddIntervalDialog::AddedInterval> results;
-            AddIntervalDialog::findPeaks(context, true, f, Specification(), RideFile::watts, RideFile::original, durations[i], 1, results, "", "");
+            double start, stop, avg;
 
             // did we get one ?
-            if (results.count() > 0 && results[0].avg > 0 && results[0].stop > 0) {
-                // qDebug()<<"found"<<names[i]<<"peak power"<<results[0].start<<"-"<<results[0].stop<<"of"<<results[0].avg<<"watts";
-                IntervalItem *intervalItem = new IntervalItem(this, QString(tr("%1 (%2 watts)")).arg(names[i]).arg(int(results[0].avg)),
-                                                            results[0].start, results[0].stop, 
-                                                            f->timeToDistance(results[0].start),
-                                                            f->timeToDistance(results[0].stop),
+            if (series.peak(RideFile::watts, durations[i], start, stop, avg) && avg > 0 && stop > 0) {
+                // qDebug()<<"found"<<names[i]<<"peak power"<<start<<"-"<<stop<<"of"<<avg<<"watts";
+                IntervalItem *intervalItem = new IntervalItem(this, QString(tr("%1 (%2 watts)")).arg(names[i]).arg(int(avg)),
+                                                            start, stop, 
+                                                            f->timeToDistance(start),
+                                                            f->timeToDistance(stop),
                                                             count++,
                                                             QColor(Qt::gray),
                                                             false,
                                                             RideFileInterval::PEAKPOWER);
                 intervalItem->rideInterval = NULL;
-                intervalItem->refresh();        // XXX will get called in constructore when refactor
+                series.metrics(intervalItem, zones, zoneRange);
                 intervals_ << intervalItem;
             }
         }
@@ -992,24 +1393,23 @@ RideItem::updateIntervals()
         for(int i=0; durations[i] != 0; i++) {
 
             // go hunting for best peak
-            QList<AddIntervalDialog::AddedInterval> results;
-            AddIntervalDialog::findPeaks(context, true, f, Specification(), RideFile::kph, RideFile::original, durations[i], 1, results, "", "");
+            double start, stop, avg;
 
             // did we get one ?
-            if (results.count() > 0 && results[0].avg > 0 && results[0].stop > 0) {
-                // qDebug()<<"found"<<names[i]<<"peak pace"<<results[0].start<<"-"<<results[0].stop<<"of"<<results[0].avg<<"kph";
+            if (series.peak(RideFile::kph, durations[i], start, stop, avg) && avg > 0 && stop > 0) {
+                // qDebug()<<"found"<<names[i]<<"peak pace"<<start<<"-"<<stop<<"of"<<avg<<"kph";
                 IntervalItem *intervalItem = new IntervalItem(this, QString(tr("%1 (%2 %3)")).arg(names[i])
-                               .arg(context->athlete->paceZones(f->isSwim())->kphToPaceString(results[0].avg, metric))
+                               .arg(context->athlete->paceZones(f->isSwim())->kphToPaceString(avg, metric))
                                .arg(context->athlete->paceZones(f->isSwim())->paceUnits(metric)),
-                                                            results[0].start, results[0].stop, 
-                                                            f->timeToDistance(results[0].start),
-                                                            f->timeToDistance(results[0].stop),
+                                                            start, stop, 
+                                                            f->timeToDistance(start),
+                                                            f->timeToDistance(stop),
                                                             count++,
                                                             QColor(Qt::gray),
                                                             false,
                                                             RideFileInterval::PEAKPACE);
                 intervalItem->rideInterval = NULL;
-                intervalItem->refresh();        // XXX will get called in constructore when refactor
+                series.metrics(intervalItem, zones, zoneRange);
                 intervals_ << intervalItem;
             }
         }
@@ -1023,86 +1423,9 @@ RideItem::updateIntervals()
     if ((discovery & RideFileInterval::intervalTypeBits(RideFileInterval::EFFORT)) &&
         CP > 0 && WPRIME > 0 && PMAX > 0 && !f->isRun() && !f->isSwim() && f->isDataPresent(RideFile::watts)) {
 
-        const int SAMPLERATE = 1000; // 1000ms samplerate = 1 second samples
-
-        RideFilePoint sample;        // we reuse this to aggregate all values
-        long time = 0L;              // current time accumulates as we run through data
-        double lastT = 0.0f;         // last sample time seen in seconds
-
-        // set the array size
-        int arraySize = f->dataPoints().last()->secs + f->recIntSecs();
-
-        // anything longer than a day or negative is skipped
-        if (arraySize >= 0 && arraySize < (24*3600)) { // no indent, as added late
-
-        QTime timer;
-        timer.start();
-
-        // setup an integrated series
-        long *integrated_series = (long*)malloc(sizeof(long) * arraySize);
-        long *pi = integrated_series;
-        long rtot = 0;
-
-        long secs = 0;
-        foreach(RideFilePoint *p, f->dataPoints()) {
-
-            // increment secs by recIntSecs as the time series
-            // always starts at zero, normalized by the file reader
-            double psecs = p->secs + f->recIntSecs();
-
-            // whats the dt in microseconds
-            int dt = (psecs * 1000) - (lastT * 1000);
-            lastT = psecs;
-
-
-            // ignore time goes backwards
-            if (dt < 0) continue;
-
-            //
-            // AGGREGATE INTO SAMPLES
-            //
-            while (secs < arraySize && dt) {
-
-                // we keep track of how much time has been aggregated
-                // into sample, so 'need' is whats left to aggregate 
-                // for the full sample
-                int need = SAMPLERATE - sample.secs;
-
-                // aggregate
-                if (dt < need) {
-
-                    // the entire sample read is less than we need
-                    // so aggregate the whole lot and wait fore more
-                    // data to be read. If there is no more data then
-                    // this will be lost, we don't keep incomplete samples
-                    sample.secs += dt;
-                    sample.watts += float(dt) * p->watts;
-                    dt = 0;
-
-                } else {
-
-                    // dt is more than we need to fill and entire sample
-                    // so lets just take the fraction we need
-                    dt -= need;
-
-                    // accumulating time and distance
-                    sample.secs = time; time += double(SAMPLERATE) / 1000.0f;
-
-                    // averaging sample data
-                    sample.watts += float(need) * p->watts;
-                    sample.watts /= 1000;
-
-                    // integrate
-                    rtot += sample.watts;
-                    *pi++ = rtot;
-                    secs++;
-                    // reset back to zero so we can aggregate
-                    // the next sample
-                    sample.secs = 0;
-                    sample.watts = 0;
-                }
-            }
-        }
+        // shared by the effort and sprint searches below
+        const long *integrated_series = series.integrated.constData();
+        long secs = series.integrated.count();
 
         // now the data is integrated we can look at the 
         // accumulated energy for each ride
@@ -1296,7 +1619,7 @@ RideItem::updateIntervals()
             }
 
             intervalItem->rideInterval = NULL;
-            intervalItem->refresh();        // XXX will get called in constructore when refactor
+            series.metrics(intervalItem, zones, zoneRange);
             intervals_ << intervalItem;
 
             //qDebug()<<fileName<<"IS EFFORT"<<x.quality<<"at"<<x.start<<"duration"<<x.duration;
@@ -1317,123 +1640,117 @@ RideItem::updateIntervals()
 
 
             intervalItem->rideInterval = NULL;
-            intervalItem->refresh();        // XXX will get called in constructore when refactor
+            series.metrics(intervalItem, zones, zoneRange);
             intervals_ << intervalItem;
 
             //qDebug()<<fileName<<"IS EFFORT"<<x.quality<<"at"<<x.start<<"duration"<<x.duration;
 
         }
-
-        free(integrated_series);
-
-    // we skipped for whatever reason
-        //qDebug()<<fileName<<"of"<<secs<<"seconds took "<<timer.elapsed()<<"ms to find"<<candidates.count();
     }
-    } // if arraySize is in bounds, no indent from above
 
     //qDebug() << "SEARCH HILLS";
     if ((discovery & RideFileInterval::intervalTypeBits(RideFileInterval::CLIMB)) &&
         !f->isSwim() && f->isDataPresent(RideFile::alt)) {
 
-        // log of progress
+#ifdef GC_DEBUG
+        // log of progress, only when debugging as every ride is searched
         QFile log(context->athlete->home->logs().canonicalPath() + "/" + "climb.log");
-        log.open(QIODevice::ReadWrite);
-        log.atEnd();
+        log.open(QIODevice::WriteOnly | QIODevice::Append);
         QTextStream out(&log);
 
-        //qDebug() << "SEARCH CLIMB STARTS: " << fileName;
         out << "SEARCH CLIMB STARTS: " << fileName << "\r\n";
         out << "START" << QDateTime::currentDateTime().toString() + "\r\n";
+#endif
 
-        // Initialisation
+        // Initialisation, by sample index into the series
         int hills = 0;
+        int last = series.secs.count() - 1;
 
-        RideFilePoint *pstart = f->dataPoints().at(0);
-        RideFilePoint *pstop = f->dataPoints().at(0);
+        int pstart = 0;
+        int pstop = 0;
 
-        foreach(RideFilePoint *p, f->dataPoints()) {
+        for (int p=0; p<=last; p++) {
             // new min altitude
-            if (pstart->alt > p->alt) {
+            if (series.alt[pstart] > series.alt[p]) {
                 //update start
                 pstart = p;
                 // update stop
                 pstop = p;
             }
             // Update max altitude
-            if (pstop->alt < p->alt) {
+            if (series.alt[pstop] < series.alt[p]) {
                 // update stop
                 pstop = p;
             }
 
-            bool downhill = (pstop->alt > p->alt+0.2*(pstop->alt-pstart->alt));
-            bool flat = (!downhill && (p->km - pstop->km)>1/3.0*(p->km - pstart->km));
-            bool end = (p == f->dataPoints().last() );
+            bool downhill = (series.alt[pstop] > series.alt[p]+0.2*(series.alt[pstop]-series.alt[pstart]));
+            bool flat = (!downhill && (series.km[p] - series.km[pstop])>1/3.0*(series.km[p] - series.km[pstart]));
+            bool end = (p == last);
 
 
 
             if (flat || downhill || end ) {
-                double distance =  pstop->km - pstart->km;
+                double distance =  series.km[pstop] - series.km[pstart];
 
 
                 if (distance >= 0.5) {
                     // Candidat
 
                     // Check groundrise at end
-                    int start = f->dataPoints().indexOf(pstart);
-                    int stop = f->dataPoints().indexOf(pstop);
+                    int start = pstart;
+                    int stop = pstop;
 
                     for (int i=stop;i>start;i--) {
-                        RideFilePoint *p2 = f->dataPoints().at(i);
-                        double distance2 =  pstop->km - p2->km;
+                        double distance2 =  series.km[pstop] - series.km[i];
                         if (distance2>0.1) {
-                            if ((pstop->alt-p2->alt)/distance2<20.0) {
-                                //qDebug() << "        correct stop " << (pstop->alt-p2->alt)/distance2;
-                                pstop = p2;
+                            if ((series.alt[pstop]-series.alt[i])/distance2<20.0) {
+                                //qDebug() << "        correct stop " << (series.alt[pstop]-series.alt[i])/distance2;
+                                pstop = i;
                             } else
                                 i = start;
                         }
                     }
 
                     for (int i=start;i<stop;i++) {
-                        RideFilePoint *p2 = f->dataPoints().at(i);
-                        double distance2 = p2->km-pstart->km;
+                        double distance2 = series.km[i]-series.km[pstart];
                         if (distance2>0.1) {
-                            if ((p2->alt-pstart->alt)/distance2<20.0) {
-                                //qDebug() << "        correct start " << (p2->alt-pstart->alt)/distance2;
-                                pstart = p2;
+                            if ((series.alt[i]-series.alt[pstart])/distance2<20.0) {
+                                //qDebug() << "        correct start " << (series.alt[i]-series.alt[pstart])/distance2;
+                                pstart = i;
                             } else
                                 i = stop;
                         }
                     }
 
-                    distance =  pstop->km - pstart->km;
-                    double height = pstop->alt - pstart->alt;
+                    distance =  series.km[pstop] - series.km[pstart];
+                    double height = series.alt[pstop] - series.alt[pstart];
 
                     if (distance >= 0.5) {
 
                         if ((distance < 4.0 && height/distance >= 60-10*distance) ||
                             (distance >= 4.0 && height/distance >= 20)) {
 
-                            //qDebug() << "    NEW HILL " << (hills+1) << " at " << pstart->km  << "km " << pstart->secs/60.0 <<"-"<< pstop->secs/60.0 << "min " << distance << "km " << height/distance/10.0 << "%";
-                            out << "    NEW HILL " << (hills+1) << " at " << pstart->km << "km " << pstart->secs/60.0 <<"-"<< pstop->secs/60.0 << "min " << distance << "km " << height/distance/10.0 << "%\r\n";
+#ifdef GC_DEBUG
+                            out << "    NEW HILL " << (hills+1) << " at " << series.km[pstart] << "km " << series.secs[pstart]/60.0 <<"-"<< series.secs[pstop]/60.0 << "min " << distance << "km " << height/distance/10.0 << "%\r\n";
+#endif
 
 
                             // create a new interval item
                             IntervalItem *intervalItem = new IntervalItem(this, QString(tr("Climb %1")).arg(++hills),
-                                                                          pstart->secs, pstop->secs,
-                                                                          pstart->km,
-                                                                          pstop->km,
+                                                                          series.secs[pstart], series.secs[pstop],
+                                                                          series.km[pstart],
+                                                                          series.km[pstop],
                                                                           count++,
                                                                           QColor(Qt::green),
                                                                           false,
                                                                           RideFileInterval::CLIMB);
                             intervalItem->rideInterval = NULL;
-                            intervalItem->refresh();        // XXX will get called in constructore when refactor
+                            series.metrics(intervalItem, zones, zoneRange);
                             intervals_ << intervalItem;
                         } else {
-                            out << "        NOT HILL " << "at " << pstart->km << "km " << pstart->secs/60.0 <<"-"<< pstop->secs/60.0 << "min " << distance << "km " << height/distance/10.0 << "%\r\n";
-
-                            //qDebug() << "        NOT HILL " << "at " << pstart->km << "km " <<  pstart->secs/60.0 <<"-"<< pstop->secs/60.0 << "min " <<  distance  << "km" << height/distance/10.0 << "%";
+#ifdef GC_DEBUG
+                            out << "        NOT HILL " << "at " << series.km[pstart] << "km " << series.secs[pstart]/60.0 <<"-"<< series.secs[pstop]/60.0 << "min " << distance << "km " << height/distance/10.0 << "%\r\n";
+#endif
                         }
                     }
                 }
@@ -1441,8 +1758,10 @@ RideItem::updateIntervals()
                 pstart = pstop;
             }
         }
+#ifdef GC_DEBUG
         out << "STOP" << QDateTime::currentDateTime().toString() + "\r\n";
         log.close();
+#endif
     }
 
 
@@ -1456,7 +1775,7 @@ RideItem::updateIntervals()
         // add to ride !
         foreach(IntervalItem *add, here) {
             add->rideInterval = NULL;
-            add->refresh();
+            series.metrics(add, zones, zoneRange);
             intervals_ << add;
         }
     }
@@ -1480,7 +1799,7 @@ RideItem::updateIntervals()
                                                             false, // XXX FIXME should this be a test if to exhaustion ??? XXX
                                                             RideFileInterval::EFFORT);
                 intervalItem->rideInterval = NULL;
-                intervalItem->refresh();        // XXX will get called in constructore when refactor
+                series.metrics(intervalItem, zones, zoneRange);
 
                 // now all the metrics are computed update the name to
                 // reflect the AP which was calculated for it, and duration
@@ -1509,14 +1828,12 @@ RideItem::updateIntervals()
 
     // aggregate in this array before updating the metric
     QList<IntervalItem *> efforts = intervals(RideFileInterval::EFFORT);
+    double stiz[10];
+    for (int j=0; j<10; j++) stiz[j] = 0.00f;
 
     // if not discovering then there won't be any!
     if (efforts.count()) {
 
-        // we have some efforts so some time was in a sustained effort
-        double stiz[10];
-        for (int j=0; j<10; j++) stiz[j] = 0.00f;
-
         // get and sort the intervals by zone high to low
         qSort(efforts.begin(), efforts.end(), intervalGreaterThanZone);
 
@@ -1532,15 +1849,16 @@ RideItem::updateIntervals()
                 }
             }
         }
+    }
 
-        // pack the values into the metric array
-        RideMetricFactory &factory = RideMetricFactory::instance();
-        for (int j=0; j<10; j++) {
-            QString symbol = QString("l%1_sustain").arg(j+1);
-            const RideMetric *m = factory.rideMetric(symbol);
+    // pack the values into the metric array, zero when there
+    // are none since the last search may have found some
+    RideMetricFactory &factory = RideMetricFactory::instance();
+    for (int j=0; j<10; j++) {
+        QString symbol = QString("l%1_sustain").arg(j+1);
+        const RideMetric *m = factory.rideMetric(symbol);
 
-            metrics()[m->index()] = stiz[j];
-        }
+        metrics()[m->index()] = stiz[j];
     }
 
     // tell the world we changed
@@ -102,6 +102,8 @@ class RideItem : public QObject
         bool isstale;     // metric data is out of date and needs recomputing
         bool isedit;      // is being edited at the moment
         bool skipsave;    // on exit we don't save the state to force rebuild at startup
+        bool routestale;  // just the route intervals are out of date
+        bool discoverystale; // just the discovered intervals are out of date
 
         // set from another, e.g. during load of rideDB.json
         void setFrom(RideItem&, bool temp=false);
@@ -149,6 +151,8 @@ class RideItem : public QObject
 
         // context the item was updated to
         unsigned long fingerprint; // zones
+        unsigned long routeprint; // routes last searched for
+        unsigned long discoveryprint; // discovery settings intervals were last found with
         unsigned long metacrc, crc, timestamp; // file content
         int dbversion; // metric version
         int udbversion; // user metric version
@@ -205,8 +209,17 @@ class RideItem : public QObject
         bool checkStale(); // check if we need to refresh
         bool isStale() { return isstale; }
 
-        // refresh when stale
-        void refresh();
+        // refresh when stale, the ride cache discovers intervals
+        // in a pass of its own once all the metrics are refreshed
+        void refresh(bool discover=true);
+
+        // search for routes again when they have changed
+        bool checkRoutes();
+        void refreshRoutes();
+
+        // discover intervals again when the discovery settings have changed
+        bool checkDiscovery();
+        void refreshDiscovery();
 
         // get/set
         void setRide(RideFile *);
@@ -218,7 +231,8 @@ class RideItem : public QObject
         bool operator>(RideItem right) const { return dateTime < right.dateTime; }
 
     private:
-        void updateIntervals();
+        void updateIntervals();   // the intervals in the file and the entire activity
+        void discoverIntervals(); // peaks, efforts, climbs, routes and matches
 };
 
 #endif // _GC_RideItem_h
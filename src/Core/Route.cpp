@@ -32,11 +32,38 @@
 #include <QXmlInputSource>
 #include <QXmlSimpleReader>
 
+#include <algorithm>
+#include <cmath>
+
 
 #define tr(s) QObject::tr(s)
 
 #define pi 3.14159265358979323846
 
+// grid sizes in degrees, cells for ride points and the
+// much larger areas for matching segments to rides
+#define TRACK_CELL 0.002
+#define TRACK_AREA 0.1
+
+static quint64 gridKey(int row, int col)
+{
+    return (quint64(quint32(row)) << 32) | quint32(col);
+}
+
+static int gridRow(double degrees, double size)
+{
+    return int(floor(degrees / size));
+}
+
+static bool validGPS(const RideFilePoint *point)
+{
+    return point->lat != 0 && point->lon !=0 &&
+           ceil(point->lat) != 180 && ceil(point->lon) != 180 &&
+           ceil(point->lat) != 540 && ceil(point->lon) != 540;
+}
+
+static double distanceKm(double lat1, double lon1, double lat2, double lon2);
+
 /*
  * RouteSegment
  *
@@ -102,10 +129,6 @@ RouteSegment::setMaxLon(double _maxLon) {
     maxLon = _maxLon;
 }
 
-QList<RoutePoint> RouteSegment::getPoints() {
-    return points;
-}
-
 int
 RouteSegment::addPoint(RoutePoint _point)
 {
@@ -125,7 +148,7 @@ RouteSegment::addPoint(RoutePoint _point)
 }
 
 void 
-RouteSegment::search(RideItem *item, RideFile*ride, QList<IntervalItem*>&here)
+RouteSegment::search(RideItem *item, RideFile*ride, const RouteTrack &track, QList<IntervalItem*>&here)
 {
     //qDebug() << "Opening ride: " << item->fileName << " for " << name;
 
@@ -142,13 +165,20 @@ RouteSegment::search(RideItem *item, RideFile*ride, QList<IntervalItem*>&here)
     int lastpoint = -1; // Last point to match
     double start = -1, stop = -1; // Start and stop secs
 
-    for (int n=0; n< this->getPoints().count();n++) {
-        RoutePoint routepoint = this->getPoints().at(n);
+    for (int n=0; n< points.count();n++) {
+        const RoutePoint &routepoint = points.at(n);
 
         bool present = false;
-        RideFilePoint* point;
+        RideFilePoint* point = NULL;
 
         for (int i=lastpoint+1; i<ride->dataPoints().count();i++) {
+
+            // looking for a start, go straight to the next
+            // ride point that is close enough to the route point
+            if (start == -1) {
+                i = track.next(routepoint.lat, routepoint.lon, minimumprecision, i-1);
+                if (i < 0) break;
+            }
             point = ride->dataPoints().at(i);
 
             double minimumdistance = -1;
@@ -166,15 +196,8 @@ RouteSegment::search(RideItem *item, RideFile*ride, QList<IntervalItem*>&here)
                     if (precision == -1 || _dist<precision)
                         precision = _dist;
 
-                    if (_dist>1) {
-                        // fare away from reference point
-                        i += 50;
-                    } else {
-                        if (_dist<minimumprecision) {
-                            start = 0; //try to start
-                            // qDebug() << "    Start point identified...";
-                        }
-                    }
+                    start = 0; //try to start
+                    // qDebug() << "    Start point identified...";
                 }
 
                 if (start != -1) {
@@ -248,7 +271,7 @@ RouteSegment::search(RideItem *item, RideFile*ride, QList<IntervalItem*>&here)
         
         stop = point->secs;
         
-        if (n == this->getPoints().count()-1) {
+        if (n == points.count()-1) {
 
             // Add the interval and continue search
             //qDebug() << "    >>> Route identified in ride: " << name << " start: " << start << " stop: " << stop << " (distance " << precision << "km)\r\n";
@@ -291,6 +314,11 @@ double rad2deg(double rad) {
 // lat2, lon2 = Latitude and Longitude of point 2
 double
 RouteSegment::distance(double lat1, double lon1, double lat2, double lon2) {
+  return distanceKm(lat1, lon1, lat2, lon2);
+}
+
+static double
+distanceKm(double lat1, double lon1, double lat2, double lon2) {
   double _theta, _dist;
   _theta = lon1 - lon2;
   if (_theta == 0 && (lat1 - lat2) == 0)
@@ -304,6 +332,62 @@ RouteSegment::distance(double lat1, double lon1, double lat2, double lon2) {
 
 
 
+/*
+ * RouteTrack
+ *
+ */
+RouteTrack::RouteTrack(RideFile *ride) : minLat(180), maxLat(-180), minLon(180), maxLon(-180), ride(ride)
+{
+    for (int i=0; i<ride->dataPoints().count(); i++) {
+        const RideFilePoint *point = ride->dataPoints().at(i);
+        if (!validGPS(point)) continue;
+
+        cells[gridKey(gridRow(point->lat, TRACK_CELL), gridRow(point->lon, TRACK_CELL))] << i;
+        areas_.insert(gridKey(gridRow(point->lat, TRACK_AREA), gridRow(point->lon, TRACK_AREA)));
+
+        minLat = std::min(minLat, point->lat);
+        maxLat = std::max(maxLat, point->lat);
+        minLon = std::min(minLon, point->lon);
+        maxLon = std::max(maxLon, point->lon);
+    }
+}
+
+int
+RouteTrack::next(double lat, double lon, double km, int after) const
+{
+    // how many cells km spans, a degree of longitude shrinks away from the equator
+    double degrees = km / (6371 * pi / 180);
+    double scale = std::max(0.01, cos(lat * pi / 180));
+    int rows = ceil(degrees / TRACK_CELL);
+    int cols = std::min(100, int(ceil(degrees / scale / TRACK_CELL)));
+
+    int row = gridRow(lat, TRACK_CELL);
+    int col = gridRow(lon, TRACK_CELL);
+
+    int found = -1;
+    for (int r=row-rows; r<=row+rows; r++) {
+        for (int c=col-cols; c<=col+cols; c++) {
+
+            QHash<quint64, QVector<int> >::const_iterator cell = cells.find(gridKey(r, c));
+            if (cell == cells.end()) continue;
+
+            // earliest in this cell that is close enough
+            const QVector<int> &indexes = cell.value();
+            QVector<int>::const_iterator it = std::upper_bound(indexes.begin(), indexes.end(), after);
+            for (; it != indexes.end(); ++it) {
+                if (found >= 0 && *it >= found) break;
+
+                const RideFilePoint *point = ride->dataPoints().at(*it);
+                if (distanceKm(lat, lon, point->lat, point->lon) < km) {
+                    found = *it;
+                    break;
+                }
+            }
+        }
+    }
+    return found;
+}
+
 /*
  * Routes (list of RouteSegment)
  *
@@ -345,6 +429,26 @@ Routes::readRoutes()
     xmlReader.setErrorHandler(&handler);
     xmlReader.parse( source );
     routes = handler.getRoutes();
+    index();
+}
+
+void
+Routes::index()
+{
+    grid.clear();
+
+    for (int i=0; i<routes.count(); i++) {
+        RouteSegment &segment = routes[i];
+        if (segment.getPoints().isEmpty()) continue;
+
+        // every area the segment's box touches, with
+        // room for the slack allowed when matching
+        int top = gridRow(segment.getMaxLat() + 0.001, TRACK_AREA);
+        int right = gridRow(segment.getMaxLon() + 0.001, TRACK_AREA);
+        for (int r=gridRow(segment.getMinLat() - 0.001, TRACK_AREA); r<=top; r++)
+            for (int c=gridRow(segment.getMinLon() - 0.001, TRACK_AREA); c<=right; c++)
+                grid[gridKey(r, c)] << i;
+    }
 }
 
 int
@@ -374,6 +478,7 @@ Routes::deleteRoute(int index)
 {
     // now delete!
     routes.removeAt(index);
+    this->index();
     writeRoutes();
 }
 
@@ -404,19 +509,31 @@ Routes::writeRoutes()
 void
 Routes::search(RideItem *item, RideFile*ride, QList<IntervalItem*>&here)
 {
-    if (ride) {
+    if (ride && routes.count()) {
+
+        // index the track once for all the segments
+        RouteTrack track(ride);
+        if (track.isEmpty()) return;
+
+        // only segments in the areas the ride went through
+        QSet<int> nearby;
+        foreach(quint64 area, track.areas())
+            foreach(int routecount, grid.value(area))
+                nearby.insert(routecount);
+
+        QList<int> candidates = nearby.toList();
+        qSort(candidates);
 
-        // search all segments
-        for (int routecount=0;routecount<routes.count();routecount++) {
+        foreach(int routecount, candidates) {
             RouteSegment *segment = &routes[routecount];
 
             // The third decimal place is worth up to 110 m
-            if (ride->getMinPoint(RideFile::lat).toDouble()<segment->getMinLat()+0.001 &&
-                ride->getMaxPoint(RideFile::lat).toDouble()>segment->getMaxLat()-0.001 &&
-                ride->getMinPoint(RideFile::lon).toDouble()<segment->getMinLon()+0.001 &&
-                ride->getMaxPoint(RideFile::lon).toDouble()>segment->getMaxLon()-0.001   )
+            if (track.minLat<segment->getMinLat()+0.001 &&
+                track.maxLat>segment->getMaxLat()-0.001 &&
+                track.minLon<segment->getMinLon()+0.001 &&
+                track.maxLon>segment->getMaxLon()-0.001   )
 
-            segment->search(item, ride, here);
+            segment->search(item, ride, track, here);
         }
     }
 }
@@ -475,8 +592,10 @@ Routes::createRouteFromInterval(IntervalItem *activeInterval)
     }
 
     // update on disk
+    context->athlete->routes->index();
     context->athlete->routes->writeRoutes();
 
-    // now go and refresh !
+    // now go and refresh, only the route intervals
+    // are searched for again, see RideItem::checkRoutes
     context->athlete->rideCache->refresh();
 }
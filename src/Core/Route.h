@@ -25,11 +25,15 @@
 #include <QString>
 #include <QDate>
 #include <QFile>
+#include <QHash>
+#include <QSet>
+#include <QVector>
 
 #include "Context.h"
 
 class  RideFile;
 class  Routes;
+class  RouteTrack;
 struct RoutePoint;
 
 class RouteSegment // represents a segment we match against
@@ -43,7 +47,7 @@ class RouteSegment // represents a segment we match against
         QString getName();
         void setName(QString _name);
         QUuid id() const { return _id; }
-        QList<RoutePoint> getPoints();
+        const QList<RoutePoint> &getPoints() const { return points; }
         void setId(QUuid x) { _id = x; }
 
         double getMinLat();
@@ -60,7 +64,7 @@ class RouteSegment // represents a segment we match against
         double distance(double lat1, double lon1, double lat2, double lon2);
 
         // find segments in ridefiles
-        void search(RideItem *, RideFile*, QList<IntervalItem*>&);
+        void search(RideItem *, RideFile*, const RouteTrack &, QList<IntervalItem*>&);
 
     private:
 
@@ -82,6 +86,30 @@ struct RoutePoint // represents a point within a segment
     double lon, lat;
 };
 
+// A ride's GPS track bucketed into a grid of small cells, so the ride points
+// near a route point are found without scanning the whole ride. It also notes
+// the larger areas the track passes through to pick out candidate segments.
+class RouteTrack
+{
+    public:
+        RouteTrack(RideFile *ride);
+
+        bool isEmpty() const { return cells.isEmpty(); }
+
+        // first point after index 'after' that is within km of lat/lon, or -1
+        int next(double lat, double lon, double km, int after) const;
+
+        // the areas visited, see Routes::index
+        const QSet<quint64> &areas() const { return areas_; }
+
+        double minLat, maxLat, minLon, maxLon;
+
+    private:
+        RideFile *ride;
+        QHash<quint64, QVector<int> > cells; // point indexes in ride order
+        QSet<quint64> areas_;
+};
+
 
 class Routes : public QObject { // top-level object with API and map of segments/rides
 
@@ -112,9 +140,15 @@ class Routes : public QObject { // top-level object with API and map of segments
     protected:
         QList<RouteSegment> routes;
 
+        // rebuild the grid after the segments change
+        void index();
+
     private:
         QDir home;
         Context *context;
+
+        // segments by the areas they cover, see RouteTrack
+        QHash<quint64, QList<int> > grid;
 };
 
 #endif // ROUTE_H
@@ -112,12 +112,141 @@ GSettings::GSettings(QString file, QSettings::Format format) : newFormat(false){
 
 GSettings::~GSettings() {
     syncQSettings();
+
+    // nobody is reading now
+    delete current.fetchAndStoreOrdered(NULL);
+    foreach(GSettingsSnapshot *old, retired) delete old;
+}
+
+GSettingsValues::GSettingsValues(QSettings *settings, const QString &prefix)
+{
+    foreach(QString key, settings->allKeys())
+        values.insert(prefix+key, settings->value(key));
+}
+
+GSettingsValues::GSettingsValues(const GSettingsValues &from, const QString &key, const QVariant &value)
+    : values(from.values)
+{
+    values.insert(key, value);
+}
+
+const QVariant *
+GSettingsValues::find(const QString &key) const
+{
+    QHash<QString, QVariant>::const_iterator i = values.constFind(key);
+    if (i == values.constEnd()) return NULL;
+    return &i.value();
+}
+
+const GSettingsValues *
+GSettingsSnapshot::values(const QString &athleteName) const
+{
+    if (athleteName.isEmpty()) return global.data();
+
+    QHash<QString, QSharedPointer<const GSettingsValues> >::const_iterator i = athletes.constFind(athleteName);
+    if (i == athletes.constEnd()) return NULL;
+    return i.value().data();
+}
+
+bool
+GSettings::snapshotValue(const QString &athleteName, const QString &key, const QVariant &def, QVariant &value)
+{
+    bool found = false;
+
+    // counted in before looking at current, see swapSnapshot
+    readers.ref();
+#if QT_VERSION >= 0x050000
+    const GSettingsSnapshot *snap = current.loadAcquire();
+#else
+    const GSettingsSnapshot *snap = current;
+#endif
+
+    const GSettingsValues *values = snap ? snap->values(athleteName) : NULL;
+    if (values) {
+        found = true;
+        const QVariant *v = values->find(key);
+        value = v ? *v : def;
+    }
+
+    readers.deref();
+    return found;
+}
+
+void
+GSettings::swapSnapshot(GSettingsSnapshot *next)
+{
+    // caller holds snapshotLock
+    GSettingsSnapshot *old = current.fetchAndStoreOrdered(next);
+    if (old) retired << old;
+
+    // readers count themselves in before loading current, so if there
+    // are none now any that arrive will only ever see the new one
+    if (readers.fetchAndAddOrdered(0) == 0) {
+        foreach(GSettingsSnapshot *snap, retired) delete snap;
+        retired.clear();
+    }
+}
+
+void
+GSettings::publishSnapshot()
+{
+    if (!newFormat) return;
+
+    QMutexLocker locker(&snapshotLock);
+
+    // settings not initialised yet, or being reset
+    if (global->size() != 2) {
+        swapSnapshot(NULL);
+        return;
+    }
+
+    GSettingsSnapshot *next = new GSettingsSnapshot();
+    next->global = QSharedPointer<const GSettingsValues>(new GSettingsValues(global->at(GLOBAL_GENERAL), GC_QSETTINGS_GLOBAL_GENERAL));
+
+    QHashIterator<QString, AthleteQSettings*> i(athlete);
+    while (i.hasNext()) {
+        i.next();
+        QSettings *preferences = i.value()->getQSettings(ATHLETE_PREFERENCES);
+        next->athletes.insert(i.key(), QSharedPointer<const GSettingsValues>(new GSettingsValues(preferences, GC_QSETTINGS_ATHLETE_PREFERENCES)));
+    }
+
+    swapSnapshot(next);
+}
+
+void
+GSettings::updateSnapshot(const QString &athleteName, const QString &key, const QVariant &value)
+{
+    // writers are serialised, readers never are
+    QMutexLocker locker(&snapshotLock);
+
+#if QT_VERSION >= 0x050000
+    const GSettingsSnapshot *snap = current.loadAcquire();
+#else
+    const GSettingsSnapshot *snap = current;
+#endif
+
+    // not published yet, readers fall back to QSettings
+    const GSettingsValues *values = snap ? snap->values(athleteName) : NULL;
+    if (values == NULL) return;
+
+    // the file written to is copied, the others are shared
+    GSettingsSnapshot *next = new GSettingsSnapshot(*snap);
+    QSharedPointer<const GSettingsValues> changed(new GSettingsValues(*values, key, value));
+    if (athleteName.isEmpty()) next->global = changed;
+    else next->athletes.insert(athleteName, changed);
+
+    swapSnapshot(next);
 }
 
 
 QVariant
 GSettings::value(const QObject * /*me*/, const QString key, const QVariant def) {
 
+    // hot path for worker threads; no key rewriting
+    QVariant snapped;
+    if (key.startsWith(GC_QSETTINGS_GLOBAL_GENERAL) && snapshotValue("", key, def, snapped))
+        return snapped;
+
     QString keyVar = QString(key);
     if (newFormat) {
         int store;
@@ -156,6 +285,7 @@ GSettings::setValue(QString key, QVariant value)
             break;
         case SETTINGS_GLOBAL:
             global->at(file)->setValue(keyVar,value);
+            if (file == GLOBAL_GENERAL) updateSnapshot("", key, value);
             break;
         case SETTINGS_ATHLETE:
             qDebug() << "SetValue key, keyVar, store:" << key << ":" << keyVar  << ": " << store; // error cases on code configuration
@@ -175,6 +305,11 @@ GSettings::cvalue(QString athleteName, QString key, QVariant def) {
 
     if (athleteName.isNull() || athleteName.isEmpty()) return def;
 
+    // hot path for worker threads; no key rewriting
+    QVariant snapped;
+    if (key.startsWith(GC_QSETTINGS_ATHLETE_PREFERENCES) && snapshotValue(athleteName, key, def, snapped))
+        return snapped;
+
     QString keyVar = QString(key);
     if (newFormat) {
         int store;
@@ -223,6 +358,7 @@ GSettings::setCValue(QString athleteName, QString key, QVariant value) {
                 break;
             case SETTINGS_ATHLETE:
                 i.value()->getQSettings(file)->setValue(keyVar, value);
+                if (file == ATHLETE_PREFERENCES) updateSnapshot(athleteName, key, value);
                 break;
             }
         } // if we do have have the athlete - then we do not store anything
@@ -349,6 +485,7 @@ GSettings::initializeQSettingsGlobal(QString athletesRootDir) {
         upgradeGlobal();
     }
     syncQSettingsGlobal();
+    publishSnapshot();
 
 }
 
@@ -387,6 +524,7 @@ GSettings::initializeQSettingsAthlete(QString athletesRootDir, QString athleteNa
             }
         }
         syncQSettingsAllAthletes();
+        publishSnapshot();
     }
 }
 
@@ -404,6 +542,8 @@ GSettings::initializeQSettingsNewAthlete(QString athletesRootDir, QString athlet
     athleteSettings->setQSettings(new QSettings(baseName+settingFileNamesAthlete[ATHLETE_PRIVATE], QSettings::IniFormat), ATHLETE_PRIVATE );
     athlete.insert(athleteName, athleteSettings);
 
+    // cvalue() answers from the snapshot, so it must hold the new athlete
+    publishSnapshot();
 }
 
 
@@ -450,6 +590,7 @@ GSettings::clearGlobalAndAthletes() {
     syncQSettings();
     global->clear();
     athlete.clear();
+    publishSnapshot();
 }
 
 
@@ -221,6 +221,7 @@
 #define TRAIN_AUTOCONNECT               "<global-trainmode>train/autoconnect"
 #define TRAIN_AUTOHIDE                  "<global-trainmode>train/autohide"
 #define TRAIN_LAPALERT                  "<global-trainmode>train/lapalert"
+#define TRAIN_SAMPLERATE                "<global-trainmode>train/samplerate"
 #define GC_REMOTE_START                 "<global-trainmode>remote/start"
 #define GC_REMOTE_STOP                  "<global-trainmode>remote/stop"
 #define GC_REMOTE_LAP                   "<global-trainmode>remote/lap"
@@ -275,6 +276,7 @@
 #define GC_AUTOBACKUP_FOLDER            "<athlete-preferences>autobackup/folder"
 #define GC_AUTOBACKUP_PERIOD            "<athlete-preferences>autobackup/period"                  // how often is the Athlete Folder backuped up / 0 == never
 #define GC_AUTOBACKUP_COUNTER           "<athlete-preferences>autobackup/counter"                 // counts to the next backup
+#define GC_AUTOBACKUP_INCREMENTAL       "<athlete-preferences>autobackup/incremental"             // only backup new and changed files
 
 #define GC_CLOUDDB_TC_ACCEPTANCE       "<athlete-preferences>clouddb/acceptance"                  // bool
 #define GC_CLOUDDB_TC_ACCEPTANCE_DATE  "<athlete-preferences>clouddb/acceptancedate"              // date/time string of acceptance
@@ -384,6 +386,9 @@
 // --------------------------------------------------------------------------------
 #include <QSettings>
 #include <QFileInfo>
+#include <QAtomicPointer>
+#include <QSharedPointer>
+#include <QMutex>
 
 // Helper Class for the Athlete QSettings
 
@@ -402,6 +407,41 @@ class AthleteQSettings {
 };
 
 
+// Immutable copy of one read-mostly settings file, keyed on the
+// full key including the prefix, e.g. "<athlete-preferences>cp"
+class GSettingsValues {
+    public:
+
+      GSettingsValues() {}
+      GSettingsValues(QSettings *settings, const QString &prefix);
+
+      // a copy with one value changed, the original is left alone
+      GSettingsValues(const GSettingsValues &from, const QString &key, const QVariant &value);
+
+      // NULL when the file doesn't hold the key
+      const QVariant *find(const QString &key) const;
+
+    private:
+      QHash<QString, QVariant> values;
+};
+
+// Immutable copy of the <global-general> and <athlete-preferences>
+// files. A new snapshot is published whenever they are written or
+// config changes and it is never modified once published, so worker
+// threads (ride refresh, data processors, chart painting) can read
+// it without taking any locks. Snapshots share the files they did
+// not change, so a write only copies the file it went to.
+class GSettingsSnapshot {
+    public:
+
+      // global-general, or the athlete-preferences of athleteName,
+      // NULL if the snapshot doesn't hold them
+      const GSettingsValues *values(const QString &athleteName) const;
+
+      QSharedPointer<const GSettingsValues> global;
+      QHash<QString, QSharedPointer<const GSettingsValues> > athletes;
+};
+
 // wrap the standard QSettings so we can offer members
 // to get global or atheleteName specific settings
 // via value() and cvalue()
@@ -443,6 +483,9 @@ public:
     // Cleanup if AthleteDir is changed
     void clearGlobalAndAthletes();
 
+    // rebuild and publish the lock-free snapshot, called when config changes
+    void publishSnapshot();
+
 private:
     bool newFormat;
     QSettings *systemsettings;
@@ -450,6 +493,20 @@ private:
     QVector<QSettings*> *global;
     QHash<QString, AthleteQSettings*> athlete;
 
+    // the snapshot is swapped atomically, old ones are retired and only
+    // deleted once no reader is inside any snapshot (readers counts them)
+    QAtomicPointer<GSettingsSnapshot> current;
+    QList<GSettingsSnapshot*> retired;
+    QAtomicInt readers;
+    QMutex snapshotLock;
+    void swapSnapshot(GSettingsSnapshot *next);
+
+    // publish a copy of the snapshot holding a value just written
+    void updateSnapshot(const QString &athleteName, const QString &key, const QVariant &value);
+
+    // answer from the snapshot, false if it doesn't hold the file
+    bool snapshotValue(const QString &athleteName, const QString &key, const QVariant &def, QVariant &value);
+
     // special methods for Migration/Upgrade
     void migrateValue(QString key);
     void migrateCValue(QString athleteName, QString key);
@@ -71,6 +71,9 @@ class FilterSet
         }
 
         int count() { return filters_.count(); }
+
+        // the lists, a name must be in all of them
+        const QVector<QStringList> &filters() const { return filters_; }
 };
 
 class RideFileIterator;
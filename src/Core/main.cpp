@@ -628,7 +628,11 @@ main(int argc, char *argv[])
                 // close first to avoid errors
                 listener->close();
             }
-            listener=new HttpListener(settings,new APIWebService(home, application),application);
+            APIWebService *api = new APIWebService(home, application);
+            listener=new HttpListener(settings,api,application);
+
+            // per route latency and pool occupancy served from /_server/stats
+            if (settings->value("stats", false).toBool()) api->enableStats(listener);
 
             // if not going on to launch a gui...
             if (nogui) {
@@ -19,6 +19,11 @@
 #include <QProgressDialog>
 #include <QMessageBox>
 #include <QFileDialog>
+#include <QCryptographicHash>
+#include <QtConcurrent>
+#include <QFutureWatcher>
+#include <QEventLoop>
+#include <QSet>
 #if QT_VERSION > 0x050400
 #include <QStorageInfo>
 #endif
@@ -31,7 +36,57 @@
 #include "../qzip/zipwriter.h"
 #include "../qzip/zipreader.h"
 
+// stored in every backup, and alongside them for the next backup to start from
+#define MANIFEST_NAME "GC_backup.manifest"
+#define MANIFEST_HEADER "GoldenCheetah backup manifest 1"
 
+// files are read and compressed in parallel a batch at a time,
+// the batches are limited so memory use stays reasonable
+#define BATCH_FILES 256
+#define BATCH_BYTES (64*1024*1024)
+
+// a file that is new or has changed since the last backup
+struct AthleteBackupJob {
+    AthleteBackupEntry entry;
+    QString source;     // file on disk
+
+    // contents we already have in the backups, by hash
+    const QHash<QByteArray, AthleteBackupEntry> *known;
+
+    // results
+    bool ok, store;     // read ok, and needs storing in the archive
+    QByteArray data;    // compressed contents
+    uint crc;
+};
+
+// runs on the thread pool
+static AthleteBackupJob
+compressJob(const AthleteBackupJob &job)
+{
+    AthleteBackupJob returning = job;
+    returning.ok = returning.store = false;
+
+    QFile file(job.source);
+    if (!file.open(QIODevice::ReadOnly)) return returning;
+    QByteArray contents = file.readAll();
+    file.close();
+
+    returning.ok = true;
+    returning.entry.size = contents.size();
+    returning.entry.hash = QCryptographicHash::hash(contents, QCryptographicHash::Md5).toHex();
+
+    // same contents as something already backed up (just touched, or renamed)
+    if (job.known->contains(returning.entry.hash)) {
+        AthleteBackupEntry have = job.known->value(returning.entry.hash);
+        returning.entry.archive = have.archive;
+        returning.entry.stored = have.stored;
+        return returning;
+    }
+
+    returning.store = true;
+    returning.data = ZipWriter::compress(contents, &returning.crc);
+    return returning;
+}
 
 AthleteBackup::AthleteBackup(QDir athleteHome)
 {
@@ -114,21 +169,51 @@ AthleteBackup::backupImmediate()
 bool
 AthleteBackup::backup(QString progressText)
 {
+    // an incremental backup starts from the last one, any file whose size
+    // and modification time are unchanged is taken as it was recorded then
+    QHash<QString, AthleteBackupEntry> last;
+    QHash<QByteArray, AthleteBackupEntry> known;
+    if (appsettings->cvalue(athlete, GC_AUTOBACKUP_INCREMENTAL, false).toBool()) {
+        foreach(AthleteBackupEntry entry, lastManifest()) {
+            last.insert(entry.path, entry);
+            known.insert(entry.hash, entry);
+        }
+    }
 
     // backup requested so lets see if we have something to backup and if yes, how much
+    QList<AthleteBackupEntry> manifest;
+    QList<AthleteBackupJob> jobs;
     int fileCount = 0;
     qint64 fileSize = 0;
-    // count the files for the progress bar and the calculate the overall size
+    // work out what needs backing up, and the overall size for the progress bar
     foreach (QDir folder, sourceFolderList) {
         // get all files
         foreach (QFileInfo fileName, folder.entryInfoList(QDir::Files | QDir::NoDotAndDotDot | QDir::NoSymLinks)) {
-           fileCount++;
-           fileSize += fileName.size();
+            AthleteBackupEntry entry;
+            entry.path = folder.dirName()+"/"+fileName.fileName();
+            entry.size = fileName.size();
+            entry.modified = fileName.lastModified().toMSecsSinceEpoch();
+
+            if (last.contains(entry.path)) {
+                AthleteBackupEntry was = last.value(entry.path);
+                if (was.size == entry.size && was.modified == entry.modified) {
+                    manifest << was;
+                    continue;
+                }
+            }
+
+            AthleteBackupJob job;
+            job.entry = entry;
+            job.source = fileName.canonicalFilePath();
+            job.known = &known;
+            jobs << job;
 
+            fileCount++;
+            fileSize += entry.size;
         }
     }
 
-    if (fileCount == 0) {
+    if (fileCount == 0 && manifest.count() == 0) {
        QMessageBox::information(NULL, tr("Athlete Backup"), tr("No files found for athlete %1 - all athlete sub-directories are empty.").arg(athlete));
        return false;
     }
@@ -178,29 +263,56 @@ AthleteBackup::backup(QString progressText)
     QProgressDialog progress(tr("Adding files to backup %1 for athlete %2 ...").arg(targetFileName).arg(athlete), progressText, 0, fileCount, NULL);
     progress.setWindowModality(Qt::WindowModal);
 
-    // now do the Zipping
+    foreach (QDir folder, sourceFolderList) writer.addDirectory(folder.dirName());
+
+    // now do the Zipping, reading and compressing on the thread pool
+    // and adding to the archive here as each batch completes
     bool userCanceled = false;
     int fileCounter = 0;
-    foreach (QDir folder, sourceFolderList) {
-        // get all files
-        writer.addDirectory(folder.dirName());
-        foreach (QFileInfo fileName, folder.entryInfoList(QDir::Files | QDir::NoDotAndDotDot | QDir::NoSymLinks)) {
-            QFile file(fileName.canonicalFilePath());
-            if (file.open(QIODevice::ReadOnly)) {
-                if (progress.wasCanceled()) {
-                    userCanceled = true;
-                    break;
+    while (fileCounter < jobs.count()) {
+
+        QList<AthleteBackupJob> batch;
+        qint64 batchSize = 0;
+        while (fileCounter + batch.count() < jobs.count() && batch.count() < BATCH_FILES && batchSize < BATCH_BYTES) {
+            batch << jobs.at(fileCounter + batch.count());
+            batchSize += batch.last().entry.size;
+        }
+
+        QFutureWatcher<AthleteBackupJob> watcher;
+        QEventLoop loop;
+        connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+        watcher.setFuture(QtConcurrent::mapped(batch, compressJob));
+        loop.exec();
+
+        foreach (AthleteBackupJob job, watcher.future().results()) {
+            fileCounter++;
+            if (!job.ok) continue;
+
+            if (job.store) {
+                // may have been duplicated within this batch
+                if (known.contains(job.entry.hash)) {
+                    job.entry.archive = known.value(job.entry.hash).archive;
+                    job.entry.stored = known.value(job.entry.hash).stored;
+                } else {
+                    writer.addCompressedFile(job.entry.path, job.data, job.crc, job.entry.size);
+                    job.entry.archive = targetFileName;
+                    job.entry.stored = job.entry.path;
+                    known.insert(job.entry.hash, job.entry);
                 }
-                writer.addFile(folder.dirName()+"/"+fileName.fileName(), file.readAll());
-                progress.setValue(fileCounter);
-                fileCounter++;
-                file.close();
             }
+            manifest << job.entry;
+        }
+        progress.setValue(fileCounter);
+
+        if (progress.wasCanceled()) {
+            userCanceled = true;
+            break;
         }
-        if (userCanceled) break;
     }
 
     // final processing
+    QByteArray manifestContents = writeManifest(manifest);
+    if (!userCanceled) writer.addFile(MANIFEST_NAME, manifestContents);
     writer.close();
 
     // delete the .ZIP file if the user canceled the backup
@@ -209,10 +321,152 @@ AthleteBackup::backup(QString progressText)
         return false;
     }
 
+    // where the next backup starts from
+    QFile manifestFile(QString("%1/GC_%2.manifest").arg(backupFolder).arg(athlete));
+    if (manifestFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        manifestFile.write(manifestContents);
+        manifestFile.close();
+    }
+
     // we are done, full progress
     progress.setValue(fileCount);
     return true;
 
 }
 
+QList<AthleteBackupEntry>
+AthleteBackup::lastManifest()
+{
+    QList<AthleteBackupEntry> returning;
+
+    QFile manifestFile(QString("%1/GC_%2.manifest").arg(backupFolder).arg(athlete));
+    if (!manifestFile.open(QIODevice::ReadOnly)) return returning;
+    returning = readManifest(manifestFile.readAll());
+    manifestFile.close();
+
+    // if any of the backups it refers to have gone we start again
+    // with a full backup, rather than one that can't be restored
+    QSet<QString> archives;
+    foreach(AthleteBackupEntry entry, returning) archives << entry.archive;
+    foreach(QString archive, archives) {
+        if (!QFile(backupFolder + "/" + archive).exists()) return QList<AthleteBackupEntry>();
+    }
+    return returning;
+}
+
+QList<AthleteBackupEntry>
+AthleteBackup::readManifest(QByteArray contents)
+{
+    QList<AthleteBackupEntry> returning;
+
+    QList<QByteArray> lines = contents.split('\n');
+    if (lines.isEmpty() || lines.first() != MANIFEST_HEADER) return returning;
+
+    for (int i=1; i<lines.count(); i++) {
+        QList<QByteArray> fields = lines.at(i).split('\t');
+        if (fields.count() != 6) continue;
+
+        AthleteBackupEntry entry;
+        entry.path = QString::fromUtf8(fields.at(0));
+        entry.size = fields.at(1).toLongLong();
+        entry.modified = fields.at(2).toLongLong();
+        entry.hash = fields.at(3);
+        entry.archive = QString::fromUtf8(fields.at(4));
+        entry.stored = QString::fromUtf8(fields.at(5));
+        returning << entry;
+    }
+    return returning;
+}
+
+QByteArray
+AthleteBackup::writeManifest(QList<AthleteBackupEntry> entries)
+{
+    // one line per file, tab separated
+    QByteArray returning = MANIFEST_HEADER;
+    returning += "\n";
+    foreach(AthleteBackupEntry entry, entries) {
+        returning += entry.path.toUtf8() + "\t" + QByteArray::number(entry.size) + "\t" +
+                     QByteArray::number(entry.modified) + "\t" + entry.hash + "\t" +
+                     entry.archive.toUtf8() + "\t" + entry.stored.toUtf8() + "\n";
+    }
+    return returning;
+}
+
+void
+AthleteBackup::restoreImmediate()
+{
+    QString archive = QFileDialog::getOpenFileName(NULL, tr("Select Backup"), QDir::homePath(), tr("Athlete Backup (*.zip)"));
+    if (archive == "") return;
+
+    QString target = QFileDialog::getExistingDirectory(NULL, tr("Select Directory to Restore to"),
+                            QDir::homePath(), QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
+    if (target == "") return;
+    if (QDir(target).entryList(QDir::AllEntries | QDir::NoDotAndDotDot).count()) {
+        QMessageBox::warning(NULL, tr("Athlete Restore"), tr("Directory %1 is not empty - restore aborted").arg(target));
+        return;
+    }
+
+    QStringList errors;
+    if (restore(archive, target, errors)) {
+        QMessageBox::information(NULL, tr("Athlete Restore"), tr("Backup successfully restored to \n%1").arg(target));
+    } else {
+        QMessageBox::warning(NULL, tr("Athlete Restore"), errors.join("\n"));
+    }
+}
+
+bool
+AthleteBackup::restore(QString archive, QString target, QStringList &errors)
+{
+    QDir targetDir(target);
+    QDir backupDir = QFileInfo(archive).absoluteDir();
 
+    ZipReader reader(archive);
+    if (!reader.isReadable()) {
+        errors << tr("Backup file %1 cannot be read.").arg(archive);
+        return false;
+    }
+
+    // backups from before there were manifests have everything in them
+    QByteArray contents = reader.fileData(MANIFEST_NAME);
+    if (contents.isEmpty()) return reader.extractAll(target);
+
+    QList<AthleteBackupEntry> manifest = readManifest(contents);
+
+    QProgressDialog progress(tr("Restoring files from backup %1 ...").arg(QFileInfo(archive).fileName()), tr("Abort Restore"), 0, manifest.count(), NULL);
+    progress.setWindowModality(Qt::WindowModal);
+
+    // each file comes from whichever backup holds its contents
+    QHash<QString, ZipReader*> readers;
+    int fileCounter = 0;
+    foreach(AthleteBackupEntry entry, manifest) {
+
+        if (progress.wasCanceled()) {
+            errors << tr("Restore aborted.");
+            break;
+        }
+        progress.setValue(fileCounter++);
+
+        ZipReader *from = readers.value(entry.archive, NULL);
+        if (from == NULL) {
+            from = new ZipReader(backupDir.absoluteFilePath(entry.archive));
+            readers.insert(entry.archive, from);
+        }
+
+        QByteArray data = from->fileData(entry.stored);
+        if (data.size() != entry.size) {
+            errors << tr("%1 is missing from backup %2.").arg(entry.path).arg(entry.archive);
+            continue;
+        }
+
+        targetDir.mkpath(QFileInfo(entry.path).path());
+        QFile file(targetDir.absoluteFilePath(entry.path));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(data) != data.size()) {
+            errors << tr("%1 cannot be written.").arg(file.fileName());
+        }
+        file.close();
+    }
+    qDeleteAll(readers);
+
+    progress.setValue(manifest.count());
+    return errors.isEmpty();
+}
@@ -20,9 +20,22 @@
 #define _GC_AthleteBackup_h 1
 
 #include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QHash>
 
 #include "Athlete.h"
 
+// a file as recorded in the manifest of a backup, every backup lists
+// all the files at the time and where in the backups their contents are
+struct AthleteBackupEntry {
+    QString path;       // folder/name
+    qint64 size;
+    qint64 modified;    // msecs since epoch
+    QByteArray hash;    // md5 of the contents, as hex
+    QString archive;    // backup .zip holding the contents
+    QString stored;     // and the name they are stored under in there
+};
 
 class AthleteBackup : public QObject
 {
@@ -34,6 +47,13 @@ class AthleteBackup : public QObject
         void backupOnClose();
         void backupImmediate();
 
+        // ask for a backup .zip and an empty folder to restore into
+        static void restoreImmediate();
+
+        // put back the files as they were when archive was created, any
+        // unchanged files are taken from the earlier backups it refers to
+        static bool restore(QString archive, QString target, QStringList &errors);
+
     private:
         AthleteDirectoryStructure *athleteDirs;
         QString athlete;
@@ -41,6 +61,11 @@ class AthleteBackup : public QObject
         QList<QDir> sourceFolderList;
         bool backup(QString progressText);
 
+        // the manifest of the last backup in backupFolder
+        QList<AthleteBackupEntry> lastManifest();
+
+        static QList<AthleteBackupEntry> readManifest(QByteArray contents);
+        static QByteArray writeManifest(QList<AthleteBackupEntry> entries);
 };
 
 
@@ -1354,16 +1354,25 @@ RideFile *CsvFileReader::openRideFile(QFile &file, QStringList &errors, QList<Ri
 }
 
 bool
-CsvFileReader::writeRideFile(Context *, const RideFile *ride, QFile &file, CsvType format) const
+CsvFileReader::writeRideFile(Context *context, const RideFile *ride, QFile &file, CsvType format) const
 {
     if (!file.open(QIODevice::WriteOnly)) return(false);
+    bool success = writeRideStream(context, ride, file, format);
+    file.close();
+    return success;
+}
+
+bool
+CsvFileReader::writeRideStream(Context *, const RideFile *ride, QIODevice &device, CsvType format) const
+{
+    if (!device.isWritable()) return(false);
 
     // always save CSV in metric format
     bool bIsMetric = true;
 
     // Use the column headers that make WKO+ happy.
     double convertUnit;
-    QTextStream out(&file);
+    QTextStream out(&device);
 
     if (format == gc) {
         // CSV File header
@@ -1476,6 +1485,6 @@ CsvFileReader::writeRideFile(Context *, const RideFile *ride, QFile &file, CsvTy
         }
     }
 
-    file.close();
+    out.flush();
     return true;
 }
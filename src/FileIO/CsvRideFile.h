@@ -34,6 +34,11 @@ struct CsvFileReader : public RideFileReader {
 
     // write but able to select format
     bool writeRideFile(Context *context, const RideFile *ride, QFile &file, CsvType format) const;
+
+    // and the same to any open device
+    bool writeRideStream(Context *context, const RideFile *ride, QIODevice &device) const
+    { return writeRideStream(context, ride, device, powertap); }
+    bool writeRideStream(Context *context, const RideFile *ride, QIODevice &device, CsvType format) const;
     bool hasWrite() const { return true; }
 };
 
@@ -26,6 +26,25 @@
 #include <stdlib.h>
 #include <cmath>
 
+// sample attributes convert straight from the reader's buffer
+static int fitlogInt(const QStringRef &value)
+{
+#if QT_VERSION >= 0x050100
+    return value.toInt();
+#else
+    return value.toString().toInt();
+#endif
+}
+
+static float fitlogFloat(const QStringRef &value)
+{
+#if QT_VERSION >= 0x050100
+    return value.toFloat();
+#else
+    return value.toString().toFloat();
+#endif
+}
+
 FitlogParser::FitlogParser (RideFile* rideFile, QList<RideFile*> *rides)
    : rideFile(rideFile), rides(rides)
 {
@@ -36,13 +55,37 @@ FitlogParser::FitlogParser (RideFile* rideFile, QList<RideFile*> *rides)
 }
 
 bool
-FitlogParser::startElement( const QString&, const QString&,
-			 const QString& qName,
-			 const QXmlAttributes& qAttributes)
+FitlogParser::parse(QIODevice &device)
 {
-    buffer.clear();
+    QXmlStreamReader xml(&device);
+    xml.setNamespaceProcessing(false);
+
+    while (!xml.atEnd()) {
+        switch (xml.readNext()) {
+        case QXmlStreamReader::StartElement:
+            startElement(xml);
+            break;
+        case QXmlStreamReader::EndElement:
+            endElement(xml.qualifiedName());
+            break;
+        case QXmlStreamReader::Characters:
+            buffer.append(xml.text());
+            break;
+        default:
+            break;
+        }
+    }
+    return !xml.hasError();
+}
+
+void
+FitlogParser::startElement(QXmlStreamReader &xml)
+{
+    QStringRef qName = xml.qualifiedName();
+    QXmlStreamAttributes attributes = xml.attributes();
+    buffer.resize(0);
 
-    if (qName == "Activity") {
+    if (qName == QLatin1String("Activity")) {
 
         lap = 0;
 
@@ -55,49 +98,49 @@ FitlogParser::startElement( const QString&, const QString&,
             rideFile->setFileFormat("SportTracks (*.fitlog)");
         }
 
-        rideFile->setStartTime(start_time = convertToLocalTime(qAttributes.value("StartTime")));
+        rideFile->setStartTime(start_time = convertToLocalTime(attributes.value(QLatin1String("StartTime")).toString()));
 
         // if caller is looking for rides...
         if (rides) rides->append(rideFile);
 
-    } else if (qName == "Lap") {
+    } else if (qName == QLatin1String("Lap")) {
 
         lap++;
-        double start = start_time.secsTo(convertToLocalTime(qAttributes.value("StartTime")));
-        double stop = start + qAttributes.value("DurationSeconds").toDouble();
+        double start = start_time.secsTo(convertToLocalTime(attributes.value(QLatin1String("StartTime")).toString()));
+        double stop = start + attributes.value(QLatin1String("DurationSeconds")).toString().toDouble();
         rideFile->addInterval(RideFileInterval::DEVICE, start, stop, QString("%1").arg(lap));
 
-    } else if (qName == "Track") {
+    } else if (qName == QLatin1String("Track")) {
 
 	    // Use the time of the first lap as the time of the activity.
-        track_offset = start_time.secsTo(convertToLocalTime(qAttributes.value("StartTime")));
+        track_offset = start_time.secsTo(convertToLocalTime(attributes.value(QLatin1String("StartTime")).toString()));
 
-    } else if (qName == "Category") {
+    } else if (qName == QLatin1String("Category")) {
 
-        rideFile->setTag("Sport", qAttributes.value("Name"));
+        rideFile->setTag("Sport", attributes.value(QLatin1String("Name")).toString());
 
-    } else if (qName == "Metadata") {
+    } else if (qName == QLatin1String("Metadata")) {
 
-        QString source = qAttributes.value("Source");
+        QString source = attributes.value(QLatin1String("Source")).toString();
         if (source != "") rideFile->setDeviceType(source);
 
-    } else if (qName == "pt") {
+    } else if (qName == QLatin1String("pt")) {
 
         // set point values to zero
         RideFilePoint point;
 
         // extract from the attributes
-        for (int i=0; i<qAttributes.count(); i++) {
-            QString m = qAttributes.qName(i);
-
-            if (m == "tm") point.secs = track_offset + qAttributes.value(i).toInt();
-            else if (m == "dist") point.km = qAttributes.value(i).toFloat() / 1000.00; // meters to km
-            else if (m == "ele") point.alt = qAttributes.value(i).toFloat();
-            else if (m == "hr") point.hr = qAttributes.value(i).toFloat();
-            else if (m == "cadence") point.cad = qAttributes.value(i).toFloat();
-            else if (m == "power") point.watts = qAttributes.value(i).toFloat();
-            else if (m == "lat") point.lat = qAttributes.value(i).toFloat();
-            else if (m == "lon") point.lon = qAttributes.value(i).toFloat();
+        foreach(const QXmlStreamAttribute &attribute, attributes) {
+            QStringRef m = attribute.qualifiedName();
+
+            if (m == QLatin1String("tm")) point.secs = track_offset + fitlogInt(attribute.value());
+            else if (m == QLatin1String("dist")) point.km = fitlogFloat(attribute.value()) / 1000.00; // meters to km
+            else if (m == QLatin1String("ele")) point.alt = fitlogFloat(attribute.value());
+            else if (m == QLatin1String("hr")) point.hr = fitlogFloat(attribute.value());
+            else if (m == QLatin1String("cadence")) point.cad = fitlogFloat(attribute.value());
+            else if (m == QLatin1String("power")) point.watts = fitlogFloat(attribute.value());
+            else if (m == QLatin1String("lat")) point.lat = fitlogFloat(attribute.value());
+            else if (m == QLatin1String("lon")) point.lon = fitlogFloat(attribute.value());
         }
 
         // now add
@@ -113,13 +156,12 @@ FitlogParser::startElement( const QString&, const QString&,
                               0.0, //tcore
                               point.interval);
     }
-    return true;
 }
 
-bool
-FitlogParser::endElement( const QString&, const QString&, const QString& qName)
+void
+FitlogParser::endElement(const QStringRef &qName)
 {
-    if (qName == "Activity") {
+    if (qName == QLatin1String("Activity")) {
 
         // DERIVE DISTANCE FROM GPS
         if (!rideFile->areDataPresent()->km &&
@@ -213,17 +255,10 @@ FitlogParser::endElement( const QString&, const QString&, const QString& qName)
         }
         rideFile->setRecIntSecs(populardelta);
 
-    } else if (qName == "Notes") {
+    } else if (qName == QLatin1String("Notes")) {
 
         rideFile->setTag("Notes", buffer);
     }
-
-    return true;
-}
-bool FitlogParser::characters( const QString& str )
-{
-    buffer += str;
-    return true;
 }
 
 static const double EARTH_RADIUS = 6378.140; // in km
@@ -23,18 +23,16 @@
 #include "RideFile.h"
 #include <QString>
 #include <QDateTime>
-#include <QXmlDefaultHandler>
+#include <QXmlStreamReader>
 #include "Settings.h"
 
-class FitlogParser : public QXmlDefaultHandler
+class FitlogParser
 {
 public:
     FitlogParser(RideFile* rideFile, QList<RideFile*>*rides);
 
-    bool startElement( const QString&, const QString&, const QString&,
-		       const QXmlAttributes& );
-    bool endElement( const QString&, const QString&, const QString& );
-    bool characters( const QString& );
+    // pull the whole file through, false if it wasn't well formed
+    bool parse(QIODevice &device);
 
     // for deriving distance from GPS
     double distanceBetween(double lat1, double lon1, double lat2, double lon2);
@@ -46,6 +44,9 @@ public:
 
 private:
 
+    void startElement(QXmlStreamReader &xml);
+    void endElement(const QStringRef &qName);
+
     QString	buffer;
 
     QDateTime start_time; // when the ride started
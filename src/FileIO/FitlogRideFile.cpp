@@ -35,18 +35,19 @@ static int fitlogFileReaderRegistered =
 
 RideFile *FitlogFileReader::openRideFile(QFile &file, QStringList &errors, QList<RideFile*>*list) const
 {
-    (void) errors;
+    if (!file.open(QIODevice::ReadOnly)) {
+        errors << "Could not open file.";
+        return NULL;
+    }
+
     RideFile *rideFile = new RideFile();
     rideFile->setRecIntSecs(1.0);
     //rideFile->setDeviceType("SportTracks Fitlog");
     rideFile->setFileFormat("SportTracks (*.fitlog)");
 
     FitlogParser handler(rideFile, list);
-
-    QXmlInputSource source (&file);
-    QXmlSimpleReader reader;
-    reader.setContentHandler (&handler);
-    reader.parse (source);
+    handler.parse(file);
+    file.close();
 
     return rideFile;
 }
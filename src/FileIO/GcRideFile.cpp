@@ -19,6 +19,7 @@
 #include "GcRideFile.h"
 #include <algorithm> // for std::sort
 #include <QDomDocument>
+#include <QXmlStreamReader>
 #include <QVector>
 
 #include <QDebug>
@@ -29,139 +30,178 @@ static int gcFileReaderRegistered =
     RideFileFactory::instance().registerReader(
         "gc", "GoldenCheetah XML", new GcFileReader());
 
+// an attribute as a number, converted straight from the reader's buffer
+static double
+gcNumber(const QXmlStreamAttributes &attributes, const char *name)
+{
+#if QT_VERSION >= 0x050100
+    return attributes.value(QLatin1String(name)).toDouble();
+#else
+    return attributes.value(QLatin1String(name)).toString().toDouble();
+#endif
+}
+
 RideFile *
 GcFileReader::openRideFile(QFile &file, QStringList &errors, QList<RideFile*>*) const
 {
-    QDomDocument doc("GoldenCheetah");
     if (!file.open(QIODevice::ReadOnly)) {
         errors << "Could not open file.";
         return NULL;
     }
 
-    bool parsed = doc.setContent(&file);
-    file.close();
-    if (!parsed) {
-        errors << "Could not parse file.";
-        return NULL;
-    }
-
+    // pulled through a stream reader, rather than building a document
+    // tree of every sample before we start
+    QXmlStreamReader xml(&file);
     RideFile *rideFile = new RideFile();
-    QDomElement root = doc.documentElement();
-    QDomNode attributes = root.firstChildElement("attributes");
-
-    for (QDomElement attr = attributes.firstChildElement("attribute");
-         !attr.isNull(); attr = attr.nextSiblingElement("attribute")) {
-        QString key = attr.attribute("key");
-        QString value = attr.attribute("value");
-        if (key == "Device type")
-            rideFile->setDeviceType(value);
-        else if (key == "File Format")
-            rideFile->setFileFormat(value);
-        if (key == "Start time") {
-            // by default QDateTime is localtime - the source however is UTC
-            QDateTime aslocal = QDateTime::fromString(value, DATETIME_FORMAT);
-            // construct in UTC so we can honour the conversion to localtime
-            QDateTime asUTC = QDateTime(aslocal.date(), aslocal.time(), Qt::UTC);
-            // now set in localtime
-            rideFile->setStartTime(asUTC.toLocalTime());
-        }
-        if (key == "Identifier") {
-            rideFile->setId(value);
-        }
-    }
-
-    // read in metric overrides:
-    //  <override>
-    //    <metric name="skiba_bike_score" value="100"/>
-    //    <metric name="average_speed" secs="3600" km="30"/>
-    //  </override>
-
-    QDomNode overrides = root.firstChildElement("override");
-    if (!overrides.isNull()) {
-
-        for (QDomElement override = overrides.firstChildElement("metric");
-            !override.isNull();
-            override = override.nextSiblingElement("metric")) {
-
-            // setup the metric overrides QMap
-            QMap<QString, QString> bsm;
-
-            // for now only value is known to be maintained
-            bsm.insert("value", override.attribute("value"));
-
-            // insert into the rideFile overrides
-            rideFile->metricOverrides.insert(override.attribute("name"), bsm);
-        }
-    }
-
-    // read in the name/value metadata pairs
-    QDomNode tags = root.firstChildElement("tags");
-    if (!tags.isNull()) {
-
-        for (QDomElement tag = tags.firstChildElement("tag");
-             !tag.isNull();
-             tag = tag.nextSiblingElement("tag")) {
-
-            rideFile->setTag(tag.attribute("name"), tag.attribute("value"));
-        }
-    }
 
     QVector<double> intervalStops; // used to set the interval number for each point
     RideFileInterval add;          // used to add each named interval to RideFile
-    QDomNode intervals = root.firstChildElement("intervals");
-    if (!intervals.isNull()) {
-        for (QDomElement interval = intervals.firstChildElement("interval");
-             !interval.isNull(); interval = interval.nextSiblingElement("interval")) {
-
-            // record the stops for old-style datapoint interval numbering
-            double stop = interval.attribute("stop").toDouble();
-            intervalStops.append(stop);
-
-            // add a new interval to the new-style interval ranges
-            add.stop = stop;
-            add.start = interval.attribute("start").toDouble();
-            add.name = interval.attribute("name");
-            rideFile->addInterval(RideFileInterval::DEVICE, add.start, add.stop, add.name);
+    bool recIntSet = false;
+    bool hasSamples = false;
+
+    // into the ride element, then each section in turn
+    if (xml.readNextStartElement()) while (xml.readNextStartElement()) {
+
+        QStringRef section = xml.name();
+
+        if (section == QLatin1String("attributes")) {
+
+            while (xml.readNextStartElement()) {
+                if (xml.name() == QLatin1String("attribute")) {
+                    QString key = xml.attributes().value("key").toString();
+                    QString value = xml.attributes().value("value").toString();
+                    if (key == "Device type")
+                        rideFile->setDeviceType(value);
+                    else if (key == "File Format")
+                        rideFile->setFileFormat(value);
+                    if (key == "Start time") {
+                        // by default QDateTime is localtime - the source however is UTC
+                        QDateTime aslocal = QDateTime::fromString(value, DATETIME_FORMAT);
+                        // construct in UTC so we can honour the conversion to localtime
+                        QDateTime asUTC = QDateTime(aslocal.date(), aslocal.time(), Qt::UTC);
+                        // now set in localtime
+                        rideFile->setStartTime(asUTC.toLocalTime());
+                    }
+                    if (key == "Identifier") {
+                        rideFile->setId(value);
+                    }
+                }
+                xml.skipCurrentElement();
+            }
+
+        } else if (section == QLatin1String("override")) {
+
+            // read in metric overrides:
+            //  <override>
+            //    <metric name="skiba_bike_score" value="100"/>
+            //    <metric name="average_speed" secs="3600" km="30"/>
+            //  </override>
+            while (xml.readNextStartElement()) {
+                if (xml.name() == QLatin1String("metric")) {
+
+                    // setup the metric overrides QMap
+                    QMap<QString, QString> bsm;
+
+                    // for now only value is known to be maintained
+                    bsm.insert("value", xml.attributes().value("value").toString());
+
+                    // insert into the rideFile overrides
+                    rideFile->metricOverrides.insert(xml.attributes().value("name").toString(), bsm);
+                }
+                xml.skipCurrentElement();
+            }
+
+        } else if (section == QLatin1String("tags")) {
+
+            // read in the name/value metadata pairs
+            while (xml.readNextStartElement()) {
+                if (xml.name() == QLatin1String("tag")) {
+                    rideFile->setTag(xml.attributes().value("name").toString(),
+                                     xml.attributes().value("value").toString());
+                }
+                xml.skipCurrentElement();
+            }
+
+        } else if (section == QLatin1String("intervals")) {
+
+            while (xml.readNextStartElement()) {
+                if (xml.name() == QLatin1String("interval")) {
+
+                    // record the stops for old-style datapoint interval numbering
+                    double stop = gcNumber(xml.attributes(), "stop");
+                    intervalStops.append(stop);
+
+                    // add a new interval to the new-style interval ranges
+                    add.stop = stop;
+                    add.start = gcNumber(xml.attributes(), "start");
+                    add.name = xml.attributes().value("name").toString();
+                    rideFile->addInterval(RideFileInterval::DEVICE, add.start, add.stop, add.name);
+                }
+                xml.skipCurrentElement();
+            }
+
+        } else if (section == QLatin1String("samples")) {
+
+            hasSamples = true;
+            while (xml.readNextStartElement()) {
+                if (xml.name() == QLatin1String("sample")) {
+                    QXmlStreamAttributes sample = xml.attributes();
+                    double secs, cad, hr, km, kph, nm, watts, alt, lon, lat;
+                    double headwind = 0.0;
+                    secs = gcNumber(sample, "secs");
+                    cad = gcNumber(sample, "cad");
+                    hr = gcNumber(sample, "hr");
+                    km = gcNumber(sample, "km");
+                    kph = gcNumber(sample, "kph");
+                    nm = gcNumber(sample, "nm");
+                    watts = gcNumber(sample, "watts");
+                    alt = gcNumber(sample, "alt");
+                    lon = gcNumber(sample, "lon");
+                    lat = gcNumber(sample, "lat");
+                    // interval numbers are set once all intervals are known
+                    rideFile->appendPoint(secs, cad, hr, km, kph, nm, watts, alt, lon, lat, headwind, 0.0,
+                                           RideFile::NA, RideFile::NA,
+                                          0.0, 0.0, 0.0, 0.0,
+                                          0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0);
+                    if (!recIntSet) {
+                        rideFile->setRecIntSecs(gcNumber(sample, "len"));
+                        recIntSet = true;
+                    }
+                }
+                xml.skipCurrentElement();
+            }
+
+        } else {
+            xml.skipCurrentElement();
         }
     }
-    std::sort(intervalStops.begin(), intervalStops.end()); // just in case
-    int interval = 0;
 
-    QDomElement samples = root.firstChildElement("samples");
-    if (samples.isNull()) return rideFile; // manual file will have no samples
-
-    bool recIntSet = false;
-    for (QDomElement sample = samples.firstChildElement("sample");
-         !sample.isNull(); sample = sample.nextSiblingElement("sample")) {
-        double secs, cad, hr, km, kph, nm, watts, alt, lon, lat;
-        double headwind = 0.0;
-        secs = sample.attribute("secs", "0.0").toDouble();
-        cad = sample.attribute("cad", "0.0").toDouble();
-        hr = sample.attribute("hr", "0.0").toDouble();
-        km = sample.attribute("km", "0.0").toDouble();
-        kph = sample.attribute("kph", "0.0").toDouble();
-        nm = sample.attribute("nm", "0.0").toDouble();
-        watts = sample.attribute("watts", "0.0").toDouble();
-        alt = sample.attribute("alt", "0.0").toDouble();
-        lon = sample.attribute("lon", "0.0").toDouble();
-        lat = sample.attribute("lat", "0.0").toDouble();
-        while ((interval < intervalStops.size()) && (secs >= intervalStops[interval]))
-            ++interval;
-        rideFile->appendPoint(secs, cad, hr, km, kph, nm, watts, alt, lon, lat, headwind, 0.0,
-                               RideFile::NA, RideFile::NA,
-                              0.0, 0.0, 0.0, 0.0,
-                              0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, interval);
-        if (!recIntSet) {
-            rideFile->setRecIntSecs(sample.attribute("len").toDouble());
-            recIntSet = true;
-        }
+    bool parsed = !xml.hasError();
+    file.close();
+    if (!parsed) {
+        errors << "Could not parse file.";
+        delete rideFile;
+        return NULL;
     }
 
+    if (!hasSamples) return rideFile; // manual file will have no samples
+
     if (!recIntSet) {
         errors << "no samples in ride file";
+        delete rideFile;
         return NULL;
     }
 
+    // old-style datapoint interval numbering
+    std::sort(intervalStops.begin(), intervalStops.end()); // just in case
+    int interval = 0;
+    foreach(RideFilePoint *point, rideFile->dataPoints()) {
+        while ((interval < intervalStops.size()) && (point->secs >= intervalStops[interval]))
+            ++interval;
+        point->interval = interval;
+    }
+    if (interval) rideFile->setDataPresent(RideFile::interval, true);
+
     return rideFile;
 }
 
@@ -52,42 +52,74 @@ GpxParser::GpxParser (RideFile* rideFile)
 
 }
 
-bool GpxParser::startElement( const QString&, const QString&,
-    const QString& qName,
-    const QXmlAttributes& qAttributes)
+// attribute values convert straight from the reader's buffer
+static double gpxNumber(const QStringRef &value)
 {
-    buffer.clear();
+#if QT_VERSION >= 0x050100
+    return value.toDouble();
+#else
+    return value.toString().toDouble();
+#endif
+}
+
+bool GpxParser::parse(QIODevice &device)
+{
+    // names are matched as written, prefix and all, like the SAX
+    // handler did; text is gathered into one reused string
+    QXmlStreamReader xml(&device);
+    xml.setNamespaceProcessing(false);
+
+    while (!xml.atEnd()) {
+        switch (xml.readNext()) {
+        case QXmlStreamReader::StartElement:
+            startElement(xml);
+            break;
+        case QXmlStreamReader::EndElement:
+            endElement(xml.qualifiedName());
+            break;
+        case QXmlStreamReader::Characters:
+            buffer.append(xml.text());
+            break;
+        default:
+            break;
+        }
+    }
+    return !xml.hasError();
+}
+
+void GpxParser::startElement(QXmlStreamReader &xml)
+{
+    QStringRef qName = xml.qualifiedName();
+    buffer.resize(0);
 
     if(metadata)
-        return true;
+        return;
 
-    if(qName == "metadata")
+    if(qName == QLatin1String("metadata"))
     {
         metadata = true;
 
     }
-    else if(qName == "trkpt")
+    else if(qName == QLatin1String("trkpt"))
     {
-        int i = qAttributes.index("lat");
-        if(i >= 0)
+        QXmlStreamAttributes attributes = xml.attributes();
+        if(attributes.hasAttribute(QLatin1String("lat")))
         {
-            lat = qAttributes.value(i).toDouble();
+            lat = gpxNumber(attributes.value(QLatin1String("lat")));
         }
         else
         {
             lat = lastLat;
         }
-        i = qAttributes.index("lon");
-        if( i >= 0)
+        if(attributes.hasAttribute(QLatin1String("lon")))
         {
-            lon = qAttributes.value(i).toDouble();
+            lon = gpxNumber(attributes.value(QLatin1String("lon")));
         }
         else
         {
             lon = lastLon;
         }
     }
-    return true;
 }
 
 #define PI 3.14159265
@@ -97,18 +129,18 @@ inline double toRadians(double degrees)
 
 }
 
-bool
-        GpxParser::endElement( const QString&, const QString&, const QString& qName)
+void
+GpxParser::endElement(const QStringRef &qName)
 {
-    if(qName == "metadata")
+    if(qName == QLatin1String("metadata"))
     {
         metadata = false;
     }
     else if(metadata == true)
     {
-        return true;
+        return;
     }
-    else if (qName == "time")
+    else if (qName == QLatin1String("time"))
     {
 
         time = convertToLocalTime(buffer);
@@ -119,33 +151,33 @@ bool
             firstTime = false;
         }
     }
-    else if (qName == "ele")
+    else if (qName == QLatin1String("ele"))
     {
         alt = buffer.toDouble();  // metric
     }
-    else if (qName == "gpxtpx:hr" || qName == "heartrate")
+    else if (qName == QLatin1String("gpxtpx:hr") || qName == QLatin1String("heartrate"))
     {
         hr = buffer.toInt();
     }
-    else if (qName == "gpxdata:hr")
+    else if (qName == QLatin1String("gpxdata:hr"))
     {
         hr = buffer.toDouble(); // on suunto ambit export file, there are sometimes double values
     }
-    else if (qName == "gpxdata:temp" || (qName == "gpxtpx:atemp"))
+    else if (qName == QLatin1String("gpxdata:temp") || (qName == QLatin1String("gpxtpx:atemp")))
     {
         temp = buffer.toDouble();
     }
-    else if ((qName == "gpxdata:cadence") || (qName == "gpxtpx:cad") || qName == "cadence")
+    else if ((qName == QLatin1String("gpxdata:cadence")) || (qName == QLatin1String("gpxtpx:cad")) || qName == QLatin1String("cadence"))
     {
         cad = buffer.toDouble();
     }
-    else if (qName == "power" || qName == "gpxdata:power") // from suunto ambit export file
+    else if (qName == QLatin1String("power") || qName == QLatin1String("gpxdata:power")) // from suunto ambit export file
     {
         watts = buffer.toDouble();
     }
 
 
-    else if (qName == "trkpt")
+    else if (qName == QLatin1String("trkpt"))
     {
         // Time from beginning of activity
         double secs = start_time.secsTo(time);
@@ -160,7 +192,7 @@ bool
             rideFile->appendPoint(secs, cad, hr, 0, 0, 0, watts, alt, lon, lat, 0, 0.0, temp, 0.0, 
                                   0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
                                   0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0);
-            return true;
+            return;
         }
         // we need to figure out the distance by using the lon,lat
         // using the haversine formula
@@ -261,12 +293,4 @@ bool
         lastLon = lon;
         lastLat = lat;
     }
-
-    return true;
-}
-
-bool GpxParser::characters( const QString& str )
-{
-    buffer += str;
-    return true;
 }
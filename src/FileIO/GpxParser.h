@@ -26,25 +26,25 @@
 #include "RideFile.h"
 #include <QString>
 #include <QDateTime>
-#include <QXmlDefaultHandler>
+#include <QXmlStreamReader>
 #include "Settings.h"
 
-class GpxParser : public QXmlDefaultHandler
+class GpxParser
 {
 public:
     GpxParser(RideFile* rideFile);
 
-    bool startElement( const QString&, const QString&, const QString&,
-		       const QXmlAttributes& );
-    bool endElement( const QString&, const QString&, const QString& );
-
-    bool characters( const QString& );
+    // pull the whole file through, false if it wasn't well formed
+    bool parse(QIODevice &device);
 
 private:
 
+    void startElement(QXmlStreamReader &xml);
+    void endElement(const QStringRef &qName);
+
     RideFile*   rideFile;
 
-    QString     buffer;
+    QString     buffer; // reused, keeps its capacity between elements
     QVariant    isGarminSmartRecording;
     QVariant    GarminHWM;
 
@@ -30,18 +30,20 @@ static int gpxFileReaderRegistered =
 
 RideFile *GpxFileReader::openRideFile(QFile &file, QStringList &errors, QList<RideFile*>*) const
 {
-    (void) errors;
+    if (!file.open(QIODevice::ReadOnly)) {
+        errors << "Could not open file.";
+        return NULL;
+    }
+
     RideFile *rideFile = new RideFile();
     rideFile->setRecIntSecs(1.0);
     //rideFile->setDeviceType("GPS Exchange Format");
     rideFile->setFileFormat("GPS Exchange Format (gpx)");
 
+    // like the SAX reader before it, a truncated file keeps what was read
     GpxParser handler(rideFile);
-
-    QXmlInputSource source (&file);
-    QXmlSimpleReader reader;
-    reader.setContentHandler (&handler);
-    reader.parse (source);
+    handler.parse(file);
+    file.close();
 
     return rideFile;
 }
@@ -35,6 +35,7 @@
 // in writeRideFile below, this is NOT a generic json parser.
 
 #include "JsonRideFile.h"
+#include <QBuffer>
 
 // now we have a reentrant parser we save context data
 // in a structure rather than in global variables -- so
@@ -464,10 +465,46 @@ JsonFileReader::openRideFile(QFile &file, QStringList &errors, QList<RideFile*>*
     }
 }
 
+// appends to a buffer like a QByteArray, but writes through to the
+// device as it fills so a long ride isn't held in memory all at once
+class JsonWriter
+{
+    public:
+        JsonWriter(QIODevice &device) : device(device) { buffer.reserve(BUFFERSIZE + 4096); }
+        ~JsonWriter() { flush(); }
+
+        JsonWriter &operator+=(const QByteArray &data) {
+            buffer += data;
+            if (buffer.size() >= BUFFERSIZE) flush();
+            return *this;
+        }
+        JsonWriter &operator+=(const QString &data) { return *this += data.toUtf8(); }
+        JsonWriter &operator+=(const char *data) { return *this += QByteArray(data); }
+
+        void flush() { if (buffer.size()) device.write(buffer); buffer.clear(); }
+
+    private:
+        static const int BUFFERSIZE = 65536;
+
+        QIODevice &device;
+        QByteArray buffer;
+};
+
 QByteArray
-JsonFileReader::toByteArray(Context *, const RideFile *ride, bool withAlt, bool withWatts, bool withHr, bool withCad) const
+JsonFileReader::toByteArray(Context *context, const RideFile *ride, bool withAlt, bool withWatts, bool withHr, bool withCad) const
 {
-    QByteArray out;
+    QByteArray returning;
+    QBuffer buffer(&returning);
+    buffer.open(QIODevice::WriteOnly);
+    toDevice(buffer, context, ride, withAlt, withWatts, withHr, withCad);
+    buffer.close();
+    return returning;
+}
+
+void
+JsonFileReader::toDevice(QIODevice &device, Context *, const RideFile *ride, bool withAlt, bool withWatts, bool withHr, bool withCad) const
+{
+    JsonWriter out(device);
 
     // start of document and ride
     out += "{\n\t\"RIDE\":{\n";
@@ -764,8 +801,6 @@ JsonFileReader::toByteArray(Context *, const RideFile *ride, bool withAlt, bool
 
     // end of ride and document
     out += "\n\t}\n}\n";
-
-    return out;
 }
 
 // Writes valid .json (validated at www.jsonlint.com)
@@ -778,19 +813,24 @@ JsonFileReader::writeRideFile(Context *context, const RideFile *ride, QFile &fil
     // truncate existing
     file.resize(0);
 
-    QByteArray xml = toByteArray(context, ride, true, true, true, true);
-
-    // setup streamer
-    QTextStream out(&file);
-    // unified codepage and BOM for identification on all platforms
-    out.setCodec("UTF-8");
-    out.setGenerateByteOrderMark(true);
-
-    out << xml;
-    out.flush();
+    bool success = writeRideStream(context, ride, file);
 
     // close
     file.close();
 
+    return success;
+}
+
+bool
+JsonFileReader::writeRideStream(Context *context, const RideFile *ride, QIODevice &device) const
+{
+    if (!device.isWritable()) return false;
+
+    // unified codepage and BOM for identification on all platforms
+    device.write("\xEF\xBB\xBF");
+
+    // written straight through, no copy of the whole document
+    toDevice(device, context, ride, true, true, true, true);
+
     return true;
 }
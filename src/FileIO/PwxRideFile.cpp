@@ -19,7 +19,8 @@
 #include "PwxRideFile.h"
 #include "Athlete.h"
 #include "Settings.h"
-#include <QDomDocument>
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
 #include <QVector>
 
 #include <QDebug>
@@ -28,32 +29,51 @@ static int pwxFileReaderRegistered =
     RideFileFactory::instance().registerReader(
         "pwx", "TrainingPeaks PWX", new PwxFileReader());
 
+// text of an element as a number, converted straight from the reader's
+// buffer rather than copying it into a QString first
+static double
+pwxNumber(QXmlStreamReader &xml)
+{
+    double returning = 0;
+    while (!xml.atEnd() && xml.readNext() != QXmlStreamReader::EndElement) {
+#if QT_VERSION >= 0x050100
+        if (xml.isCharacters()) returning = xml.text().toDouble();
+#else
+        if (xml.isCharacters()) returning = xml.text().toString().toDouble();
+#endif
+        else if (xml.isStartElement()) xml.skipCurrentElement();
+    }
+    return returning;
+}
+
+static QString
+pwxText(QXmlStreamReader &xml)
+{
+    return xml.readElementText(QXmlStreamReader::IncludeChildElements);
+}
+
 RideFile *
 PwxFileReader::openRideFile(QFile &file, QStringList &errors, QList<RideFile*>*) const
 {
-    QDomDocument doc("TrainingPeaks PWX");
     if (!file.open(QIODevice::ReadOnly)) {
         errors << "Could not open file.";
         return NULL;
     }
 
-    bool parsed = doc.setContent(&file);
+    RideFile *returning = PwxFromStream(file, errors);
     file.close();
-    if (!parsed) {
-        errors << "Could not parse file.";
-        return NULL;
-    }
 
-    return PwxFromDomDoc(doc, errors);
+    return returning;
 }
 
 RideFile *
-PwxFileReader::PwxFromDomDoc(QDomDocument doc, QStringList&) const
+PwxFileReader::PwxFromStream(QIODevice &device, QStringList &errors) const
 {
+    // pull the workout through a stream reader, so large files aren't
+    // turned into a document tree and then walked before we get the samples
+    QXmlStreamReader xml(&device);
+
     RideFile *rideFile = new RideFile();
-    QDomElement root = doc.documentElement();
-    QDomNode workout = root.firstChildElement("workout");
-    QDomNode node = workout.firstChild();
 
     // get the Smart Recording parameters
     QVariant isGarminSmartRecording = appsettings->value(NULL, GC_GARMIN_SMARTRECORD,Qt::Checked);
@@ -90,198 +110,166 @@ PwxFileReader::PwxFromDomDoc(QDomDocument doc, QStringList&) const
     swimXdata->valuename << "DURATION";
     swimXdata->valuename << "STROKES";
 
-    while (!node.isNull()) {
+    // into the root element, we only want the first workout in there
+    bool workout = false;
+    if (xml.readNextStartElement()) {
+        while (!workout && xml.readNextStartElement()) {
+            if (xml.name() == QLatin1String("workout")) workout = true;
+            else xml.skipCurrentElement();
+        }
+    }
 
-        // athlete
-        if (node.nodeName() == "athlete") {
+    while (workout && xml.readNextStartElement()) {
 
-            QDomElement name = node.firstChildElement("name");
-            if (!name.isNull()) {
-                rideFile->setTag("Athlete Name", name.text());
-            }
+        QStringRef node = xml.name();
+
+        // athlete
+        if (node == QLatin1String("athlete")) {
 
-            QDomElement weight = node.firstChildElement("weight");
-            if (!weight.isNull()) {
-                rideFile->setTag("Weight", weight.text());
+            while (xml.readNextStartElement()) {
+                if (xml.name() == QLatin1String("name")) rideFile->setTag("Athlete Name", pwxText(xml));
+                else if (xml.name() == QLatin1String("weight")) rideFile->setTag("Weight", pwxText(xml));
+                else xml.skipCurrentElement();
             }
 
         // workout code
-        } else if (node.nodeName() == "code") {
+        } else if (node == QLatin1String("code")) {
 
-            QDomElement code = node.toElement();
-            rideFile->setTag("Workout Code", code.text());
+            rideFile->setTag("Workout Code", pwxText(xml));
 
         // workout title
-        } else if (node.nodeName() == "title") {
+        } else if (node == QLatin1String("title")) {
 
-            QDomElement title = node.toElement();
-            rideFile->setTag("Workout Title", title.text());
+            rideFile->setTag("Workout Title", pwxText(xml));
 
         // goal / objective
-        } else if (node.nodeName() == "goal") {
+        } else if (node == QLatin1String("goal")) {
 
-            QDomElement goal = node.toElement();
-            rideFile->setTag("Objective", goal.text());
+            rideFile->setTag("Objective", pwxText(xml));
 
         // sport
-        } else if (node.nodeName() == "sportType") {
+        } else if (node == QLatin1String("sportType")) {
 
-            QDomElement sport = node.toElement();
-            rideFile->setTag("Sport", sport.text());
+            rideFile->setTag("Sport", pwxText(xml));
 
         // notes
-        } else if (node.nodeName() == "cmt") {
+        } else if (node == QLatin1String("cmt")) {
 
             // Add the PWX cmt tag as notes
-            QDomElement notes = node.toElement();
-            rideFile->setTag("Notes", notes.text());
+            rideFile->setTag("Notes", pwxText(xml));
 
         // device type and info
-        } else if (node.nodeName() == "device") {
-
-            QString devicetype;
-            // make and model
-            QDomElement make = node.firstChildElement("make");
-            if (!make.isNull()) devicetype = make.text();
-            QDomElement model = node.firstChildElement("model");
-            if (!model.isNull()) {
+        } else if (node == QLatin1String("device")) {
+
+            // make and model, and device settings data
+            QString make, model, deviceinfo;
+            while (xml.readNextStartElement()) {
+                if (xml.name() == QLatin1String("make")) make = pwxText(xml);
+                else if (xml.name() == QLatin1String("model")) model = pwxText(xml);
+                else if (xml.name() == QLatin1String("extension")) {
+                    while (xml.readNextStartElement()) {
+                        deviceinfo += xml.name().toString();
+                        deviceinfo += ": ";
+                        deviceinfo += pwxText(xml);
+                        deviceinfo += '\n';
+                    }
+                } else xml.skipCurrentElement();
+            }
+
+            QString devicetype = make;
+            if (model != "") {
                 if (devicetype != "") devicetype += " ";
-                devicetype += model.text();
+                devicetype += model;
             }
             rideFile->setDeviceType(devicetype);
             rideFile->setFileFormat("Peaksware Data File (pwx)");
-
-            // device settings data
-            QString deviceinfo;
-            QDomElement extension = node.firstChildElement("extension");
-            if (!extension.isNull()) {
-                for (QDomElement info=extension.firstChildElement();
-                    !info.isNull();
-                    info = info.nextSiblingElement()) {
-                    deviceinfo += info.tagName();
-                    deviceinfo += ": ";
-                    deviceinfo += info.text();
-                    deviceinfo += '\n';
-                }
-            }
             rideFile->setTag("Device Info", deviceinfo);
 
         // start date/time
-        } else if (node.nodeName() == "time") {
-            QDomElement date = node.toElement();
-            rideDate = QDateTime::fromString(date.text(), Qt::ISODate);
+        } else if (node == QLatin1String("time")) {
+            rideDate = QDateTime::fromString(pwxText(xml), Qt::ISODate);
             rideFile->setStartTime(rideDate);
 
         // interval data
-        } else if (node.nodeName() == "segment") {
+        } else if (node == QLatin1String("segment")) {
             RideFileInterval add;
+            bool named = false, summary = false;
+            bool beginning = false, duration = false;
+            double secs = 0;
+
+            while (xml.readNextStartElement()) {
+                if (xml.name() == QLatin1String("name")) {
+                    add.name = pwxText(xml);
+                    named = true;
+                } else if (xml.name() == QLatin1String("summarydata")) {
+                    summary = true;
+                    while (xml.readNextStartElement()) {
+                        if (xml.name() == QLatin1String("beginning")) {
+                            add.start = pwxNumber(xml);
+                            beginning = true;
+                        } else if (xml.name() == QLatin1String("duration")) {
+                            secs = pwxNumber(xml);
+                            duration = true;
+                        } else xml.skipCurrentElement();
+                    }
+                } else xml.skipCurrentElement();
+            }
 
             // name
-            QDomElement name = node.firstChildElement("name");
-            if (!name.isNull()) add.name = name.text();
-            else add.name = QString("Interval #%1").arg(++intervals);
-
-            QDomElement summary = node.firstChildElement("summarydata");
-            if (!summary.isNull()) {
-
-                // start
-                QDomElement beginning = summary.firstChildElement("beginning");
-                if (!beginning.isNull()) add.start = beginning.text().toDouble();
-                else add.start = -1;
-
-                // duration - convert to end
-                QDomElement duration = summary.firstChildElement("duration");
-                if (!duration.isNull() && add.start != -1)
-                    add.stop = duration.text().toDouble() + add.start;
-                else
-                    add.stop = -1;
-
-                // add interval
-                if (add.start != -1 && add.stop != -1) {
-                    rideFile->addInterval(RideFileInterval::DEVICE, round(add.start+1), round(add.stop+1), add.name);
-                }
+            if (!named) add.name = QString("Interval #%1").arg(++intervals);
+
+            // duration - convert to end, and add interval
+            if (summary && beginning && duration) {
+                add.stop = secs + add.start;
+                rideFile->addInterval(RideFileInterval::DEVICE, round(add.start+1), round(add.stop+1), add.name);
             }
 
         // data points: offset, hr, spd, pwr, torq, cad, dist, lat, lon, alt, temp
-        } else if (node.nodeName() == "sample") {
+        } else if (node == QLatin1String("sample")) {
             RideFilePoint add;
+            add.secs = add.hr = add.kph = add.watts = add.nm = add.cad = add.km = 0.0;
+            add.lat = add.lon = add.alt = 0.0;
+            add.lte = add.rte = add.lps = add.rps = 0.0;
+            add.temp = RideFile::NA;
+
+            bool hasRight = false;
+            double right = 0;
+
+            while (xml.readNextStartElement()) {
+                QStringRef name = xml.name();
+
+                if (name == QLatin1String("timeoffset")) add.secs = round(pwxNumber(xml)); // offset (secs)
+                else if (name == QLatin1String("hr")) add.hr = pwxNumber(xml);
+                else if (name == QLatin1String("spd")) add.kph = pwxNumber(xml) * 3.6; // spd in meters per second converted to kph
+                else if (name == QLatin1String("pwr")) add.watts = pwxNumber(xml);
+                else if (name == QLatin1String("pwrright")) { right = pwxNumber(xml); hasRight = true; }
+                else if (name == QLatin1String("torq")) add.nm = pwxNumber(xml);
+                else if (name == QLatin1String("cad")) add.cad = pwxNumber(xml);
+                else if (name == QLatin1String("dist")) add.km = pwxNumber(xml) / 1000;
+                else if (name == QLatin1String("lat")) add.lat = pwxNumber(xml);
+                else if (name == QLatin1String("lon")) add.lon = pwxNumber(xml);
+                else if (name == QLatin1String("alt")) add.alt = pwxNumber(xml);
+                else if (name == QLatin1String("temp")) add.temp = pwxNumber(xml);
+                else if (name == QLatin1String("torque_effectiveness_left")) add.lte = pwxNumber(xml);
+                else if (name == QLatin1String("torque_effectiveness_right")) add.rte = pwxNumber(xml);
+                else if (name == QLatin1String("pedal_smoothness_left")) add.lps = pwxNumber(xml);
+                else if (name == QLatin1String("pedal_smoothness_right")) add.rps = pwxNumber(xml);
+                else xml.skipCurrentElement();
+            }
+
+            // NOTE! undo the fudge to set zero values to
+            //       1 in the writer (below). This is to keep
+            //       the TP upload web-service happy with zero values
+            if (add.watts == 1) add.watts = 0.0;
 
-            // offset (secs)
-            QDomElement off = node.firstChildElement("timeoffset");
-            if (!off.isNull()) add.secs = round(off.text().toDouble());
-            else add.secs = 0.0;
-            // hr
-            QDomElement hr = node.firstChildElement("hr");
-            if (!hr.isNull()) add.hr = hr.text().toDouble();
-            else add.hr = 0.0;
-            // spd in meters per second converted to kph
-            QDomElement spd = node.firstChildElement("spd");
-            if (!spd.isNull()) add.kph = spd.text().toDouble() * 3.6;
-            else add.kph = 0.0;
-            // pwr
-            QDomElement pwr = node.firstChildElement("pwr");
-            if (!pwr.isNull()) {
-                add.watts = pwr.text().toDouble();
-                // NOTE! undo the fudge to set zero values to
-                //       1 in the writer (below). This is to keep
-                //       the TP upload web-service happy with zero values
-                if (add.watts == 1) add.watts = 0.0;
-            } else add.watts = 0.0;
             // lrbalance (pwrright)
-            QDomElement lrbalance = node.firstChildElement("pwrright");
-            if (!lrbalance.isNull()) {
+            if (hasRight) {
                 if (add.watts == 0) {
                    add.lrbalance = 50.0;
                 } else {
-                    add.lrbalance =(add.watts-lrbalance.text().toDouble())/add.watts*100.0;
+                    add.lrbalance =(add.watts-right)/add.watts*100.0;
                 }
             } else add.lrbalance = RideFile::NA;
-            // torq
-            QDomElement torq = node.firstChildElement("torq");
-            if (!torq.isNull()) add.nm = torq.text().toDouble();
-            else add.nm = 0.0;
-            // cad
-            QDomElement cad = node.firstChildElement("cad");
-            if (!cad.isNull()) add.cad = cad.text().toDouble();
-            else add.cad = 0.0;
-            // dist
-            QDomElement dist = node.firstChildElement("dist");
-            if (!dist.isNull()) add.km = dist.text().toDouble() /1000;
-            else add.km = 0.0;
-
-            // lat
-            QDomElement lat = node.firstChildElement("lat");
-            if (!lat.isNull()) add.lat = lat.text().toDouble();
-            else add.lat = 0.0;
-            // lon
-            QDomElement lon = node.firstChildElement("lon");
-            if (!lon.isNull()) add.lon = lon.text().toDouble();
-            else add.lon = 0.0;
-            // alt
-            QDomElement alt = node.firstChildElement("alt");
-            if (!alt.isNull()) add.alt = alt.text().toDouble();
-            else add.alt = 0.0;
-            // temp
-            QDomElement temp = node.firstChildElement("temp");
-            if (!temp.isNull()) add.temp = temp.text().toDouble();
-            else add.temp = RideFile::NA;
-
-            // torque_effectiveness_left
-            QDomElement lte = node.firstChildElement("torque_effectiveness_left");
-            if (!lte.isNull()) add.lte = lte.text().toDouble();
-            else add.lte = 0.0;
-            // torque_effectiveness_right
-            QDomElement rte = node.firstChildElement("torque_effectiveness_right");
-            if (!rte.isNull()) add.rte = rte.text().toDouble();
-            else add.rte = 0.0;
-            // pedal_smoothness_left
-            QDomElement lps = node.firstChildElement("pedal_smoothness_left");
-            if (!lps.isNull()) add.lps = lps.text().toDouble();
-            else add.lps = 0.0;
-            // pedal_smoothness_right
-            QDomElement rps = node.firstChildElement("pedal_smoothness_right");
-            if (!rps.isNull()) add.rps = rps.text().toDouble();
-            else add.rps = 0.0;
 
             // if there are data points && a time difference > 1sec && smartRecording processing is requested at all
             if ((!rideFile->dataPoints().empty()) && (add.secs > rtime + 1) && (isGarminSmartRecording.toInt() != 0)) {
@@ -425,7 +413,7 @@ PwxFileReader::PwxFromDomDoc(QDomDocument doc, QStringList&) const
                     add.interval);
             }
         
-        } else if (node.nodeName() == "summarydata") {
+        } else if (node == QLatin1String("summarydata")) {
 
             // get the summary data in case there are no samples
             // this is when there is a manual entry, so we can
@@ -442,43 +430,30 @@ PwxFileReader::PwxFromDomDoc(QDomDocument doc, QStringList&) const
             //<climbingelevation>14</climbingelevation>
             //</summarydata>
 
-            // duration
-            QDomElement off = node.firstChildElement("duration");
-            if (!off.isNull()) manualDuration = off.text().toDouble();
-
-            // work
-            off = node.firstChildElement("work");
-            if (!off.isNull()) manualWork = off.text().toDouble();
-
-            // tss
-            off = node.firstChildElement("tss");
-            if (!off.isNull()) manualTSS = off.text().toDouble();
-
-            // hr
-            off = node.firstChildElement("hr");
-            if (!off.isNull()) manualHR = off.text().toDouble();
-
-            // speed
-            off = node.firstChildElement("spd");
-            if (!off.isNull()) manualSpeed = off.text().toDouble();
-
-            // power
-            off = node.firstChildElement("pwr");
-            if (!off.isNull()) manualPower = off.text().toDouble();
-
-            // distance
-            off = node.firstChildElement("dist");
-            if (!off.isNull()) manualKM = off.text().toDouble();
-
-            // Elevation
-            off = node.firstChildElement("climbingelevation");
-            if (!off.isNull()) manualElevation = off.text().toDouble();
-
+            while (xml.readNextStartElement()) {
+                QStringRef name = xml.name();
+
+                if (name == QLatin1String("duration")) manualDuration = pwxNumber(xml);
+                else if (name == QLatin1String("work")) manualWork = pwxNumber(xml);
+                else if (name == QLatin1String("tss")) manualTSS = pwxNumber(xml);
+                else if (name == QLatin1String("hr")) manualHR = pwxNumber(xml);
+                else if (name == QLatin1String("spd")) manualSpeed = pwxNumber(xml); // speed
+                else if (name == QLatin1String("pwr")) manualPower = pwxNumber(xml); // power
+                else if (name == QLatin1String("dist")) manualKM = pwxNumber(xml); // distance
+                else if (name == QLatin1String("climbingelevation")) manualElevation = pwxNumber(xml); // Elevation
+                else xml.skipCurrentElement();
+            }
 
-        } else if (node.nodeName() == "extension") {
+        } else {
+            xml.skipCurrentElement();
         }
+    }
 
-        node = node.nextSibling();
+    if (xml.hasError()) {
+        errors << "Could not parse file.";
+        delete swimXdata;
+        delete rideFile;
+        return NULL;
     }
 
     // post-process and check
@@ -600,62 +575,76 @@ PwxFileReader::PwxFromDomDoc(QDomDocument doc, QStringList&) const
 bool
 PwxFileReader::writeRideFile(Context *context, const RideFile *ride, QFile &file) const
 {
-    QDomText text; // used all over
-    QDomDocument doc;
-    QDomProcessingInstruction hdr = doc.createProcessingInstruction("xml","version=\"1.0\"");
-    doc.appendChild(hdr);
+    if (!file.open(QIODevice::WriteOnly)) return(false);
+    file.resize(0);
+    bool success = writeRideStream(context, ride, file);
+    file.close();
+    return(success);
+}
+
+// channel summaries are left for TP to fill in
+static void
+writeEmptySummary(QXmlStreamWriter &xml, QString name)
+{
+    xml.writeStartElement(name);
+    xml.writeAttribute("max", "0");
+    xml.writeAttribute("min", "0");
+    xml.writeAttribute("avg", "0");
+    xml.writeEndElement();
+}
+
+bool
+PwxFileReader::writeRideStream(Context *context, const RideFile *ride, QIODevice &device) const
+{
+    if (!device.isWritable()) return(false);
+
+    // written straight to the device a sample at a time, there is
+    // no copy of the document in memory
+    device.write("\xEF\xBB\xBF"); // UTF-8 byte order mark
+    QXmlStreamWriter xml(&device);
+    xml.setCodec("UTF-8");
+    xml.setAutoFormatting(true);
+    xml.setAutoFormattingIndent(4);
+    xml.writeStartDocument();
 
     // pwx
-    QDomElement pwx = doc.createElementNS("http://www.peaksware.com/PWX/1/0", "pwx");
-    pwx.setAttribute("creator", "Golden Cheetah");
-    pwx.setAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-    pwx.setAttribute("xmlns:xsd", "http://www.w3.org/2001/XMLSchema");
-    pwx.setAttribute("xsi:schemaLocation", "http://www.peaksware.com/PWX/1/0 http://www.peaksware.com/PWX/1/0/pwx.xsd");
-    pwx.setAttribute("version", "1.0");
-    doc.appendChild(pwx);
+    xml.writeStartElement("pwx");
+    xml.writeAttribute("xmlns", "http://www.peaksware.com/PWX/1/0");
+    xml.writeAttribute("creator", "Golden Cheetah");
+    xml.writeAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
+    xml.writeAttribute("xmlns:xsd", "http://www.w3.org/2001/XMLSchema");
+    xml.writeAttribute("xsi:schemaLocation", "http://www.peaksware.com/PWX/1/0 http://www.peaksware.com/PWX/1/0/pwx.xsd");
+    xml.writeAttribute("version", "1.0");
 
     // workouts... we just serialise 1 at a time
-    QDomElement root = doc.createElement("workout");
-    pwx.appendChild(root);
+    xml.writeStartElement("workout");
 
     // athlete details
-    QDomElement athlete = doc.createElement("athlete");
-    QDomElement name = doc.createElement("name");
-    text = doc.createTextNode(context ? context->athlete->cyclist : "athlete"); name.appendChild(text);
-    athlete.appendChild(name);
+    xml.writeStartElement("athlete");
+    xml.writeTextElement("name", context ? context->athlete->cyclist : "athlete");
     double cyclistweight = ride->getTag("Weight", "0.0").toDouble();
     if (cyclistweight) {
-        QDomElement weight = doc.createElement("weight");
-        text = doc.createTextNode(QString("%1").arg(cyclistweight));
-        weight.appendChild(text);
-        athlete.appendChild(weight);
+        xml.writeTextElement("weight", QString("%1").arg(cyclistweight));
     }
-    root.appendChild(athlete);
+    xml.writeEndElement(); // athlete
 
     // sport
     QString sport = ride->getTag("Sport", "Bike");
     if (sport == QObject::tr("Biking") || sport == QObject::tr("Cycling") || sport == QObject::tr("Cycle") || sport == QObject::tr("Bike")) {
         sport = "Bike";
     }
-    QDomElement sportType = doc.createElement("sportType");
-    text = doc.createTextNode(sport); 
-    sportType.appendChild(text);
-    root.appendChild(sportType);
+    xml.writeTextElement("sportType", sport);
 
     // notes
     if (ride->getTag("Notes","") != "") {
-        QDomElement notes = doc.createElement("cmt");
-        text = doc.createTextNode(ride->getTag("Notes","")); notes.appendChild(text);
-        root.appendChild(notes);
+        xml.writeTextElement("cmt", ride->getTag("Notes",""));
     }
     
     
     // workout code
     if (ride->getTag("Workout Code", "") != "") {
         QString wcode = ride->getTag("Workout Code", "");
-        QDomElement code = doc.createElement("code");
-        text = doc.createTextNode(wcode); code.appendChild(text);
-        root.appendChild(code);
+        xml.writeTextElement("code", wcode);
     }
 
     // workout title
@@ -691,144 +680,63 @@ PwxFileReader::writeRideFile(Context *context, const RideFile *ride, QFile &file
     }
     // did we set it to /anything/ ?
     if (wtitle != "") {
-        QDomElement title = doc.createElement("title");
-        text = doc.createTextNode(wtitle); title.appendChild(text);
-        root.appendChild(title);
+        xml.writeTextElement("title", wtitle);
     }
 
     // goal
     if (ride->getTag("Objective", "") != "") {
         QString obj = ride->getTag("Objective", "");
-        QDomElement goal = doc.createElement("goal");
-        text = doc.createTextNode(obj); goal.appendChild(text);
-        root.appendChild(goal);
+        xml.writeTextElement("goal", obj);
     }
 
     // device type 
     if (ride->deviceType() != "") { 
 
-        QDomElement device = doc.createElement("device"); 
-        device.setAttribute("id", ride->deviceType());
-
-        QDomElement make = doc.createElement("make"); 
-        text = doc.createTextNode("Golden Cheetah"); 
-        make.appendChild(text); 
-        device.appendChild(make);
-
-        QDomElement model = doc.createElement("model"); 
-        text = doc.createTextNode(ride->deviceType());
-        model.appendChild(text); 
-        device.appendChild(model);
-
-        root.appendChild(device); 
+        xml.writeStartElement("device");
+        xml.writeAttribute("id", ride->deviceType());
+        xml.writeTextElement("make", "Golden Cheetah");
+        xml.writeTextElement("model", ride->deviceType());
+        xml.writeEndElement(); // device
     }
     
     // time
-    QDomElement time = doc.createElement("time");
-    text = doc.createTextNode(ride->startTime().toUTC().toString(Qt::ISODate));
-    time.appendChild(text);
-    root.appendChild(time);
+    xml.writeTextElement("time", ride->startTime().toUTC().toString(Qt::ISODate));
 
     // summary data
-    QDomElement summarydata = doc.createElement("summarydata");
-    root.appendChild(summarydata);
-    QDomElement beginning = doc.createElement("beginning");
-    text = doc.createTextNode(QString("%1").arg(ride->dataPoints().empty()
+    xml.writeStartElement("summarydata");
+    xml.writeTextElement("beginning", QString("%1").arg(ride->dataPoints().empty()
         ? 0 : ride->dataPoints().first()->secs));
-    beginning.appendChild(text);
-    summarydata.appendChild(beginning);
-
-    QDomElement duration = doc.createElement("duration");
-    text = doc.createTextNode(QString("%1").arg(ride->dataPoints().empty()
+    xml.writeTextElement("duration", QString("%1").arg(ride->dataPoints().empty()
         ? 0 : ride->dataPoints().last()->secs));
-    duration.appendChild(text);
-    summarydata.appendChild(duration);
 
     // the channels - min max avg get set by TP anyway
     // so we leave them blank to save time on calculating them
-    if (ride->areDataPresent()->hr) {
-        QDomElement s = doc.createElement("hr");
-        s.setAttribute("max", "0");
-        s.setAttribute("min", "0");
-        s.setAttribute("avg", "0");
-        summarydata.appendChild(s);
-    }
-    if (ride->areDataPresent()->kph) {
-        QDomElement s = doc.createElement("spd");
-        s.setAttribute("max", "0");
-        s.setAttribute("min", "0");
-        s.setAttribute("avg", "0");
-        summarydata.appendChild(s);
-    }
-    if (ride->areDataPresent()->watts) {
-        QDomElement s = doc.createElement("pwr");
-        s.setAttribute("max", "0");
-        s.setAttribute("min", "0");
-        s.setAttribute("avg", "0");
-        summarydata.appendChild(s);
-    }
-    if (ride->areDataPresent()->nm) {
-        QDomElement s = doc.createElement("torq");
-        s.setAttribute("max", "0");
-        s.setAttribute("min", "0");
-        s.setAttribute("avg", "0");
-        summarydata.appendChild(s);
-    }
-    if (ride->areDataPresent()->cad) {
-        QDomElement s = doc.createElement("cad");
-        s.setAttribute("max", "0");
-        s.setAttribute("min", "0");
-        s.setAttribute("avg", "0");
-        summarydata.appendChild(s);
-    }
-    QDomElement dist = doc.createElement("dist");
-    text = doc.createTextNode(QString("%1")
+    if (ride->areDataPresent()->hr) writeEmptySummary(xml, "hr");
+    if (ride->areDataPresent()->kph) writeEmptySummary(xml, "spd");
+    if (ride->areDataPresent()->watts) writeEmptySummary(xml, "pwr");
+    if (ride->areDataPresent()->nm) writeEmptySummary(xml, "torq");
+    if (ride->areDataPresent()->cad) writeEmptySummary(xml, "cad");
+    xml.writeTextElement("dist", QString("%1")
         .arg((int)(ride->dataPoints().empty() ? 0
             : ride->dataPoints().last()->km * 1000)));
-    dist.appendChild(text);
-    summarydata.appendChild(dist);
-
-    if (ride->areDataPresent()->alt) {
-        QDomElement s = doc.createElement("alt");
-        s.setAttribute("max", "0");
-        s.setAttribute("min", "0");
-        s.setAttribute("avg", "0");
-        summarydata.appendChild(s);
-    }
-
-    if (ride->areDataPresent()->temp) {
-        QDomElement s = doc.createElement("temp");
-        s.setAttribute("max", "0");
-        s.setAttribute("min", "0");
-        s.setAttribute("avg", "0");
-        summarydata.appendChild(s);
-    }  
+    if (ride->areDataPresent()->alt) writeEmptySummary(xml, "alt");
+    if (ride->areDataPresent()->temp) writeEmptySummary(xml, "temp");
+    xml.writeEndElement(); // summarydata
 
     // interval "segments"
     foreach (RideFileInterval *i, ride->intervals()) {
-        QDomElement segment = doc.createElement("segment");
-        root.appendChild(segment);
+        xml.writeStartElement("segment");
 
         // name
-        QDomElement name = doc.createElement("name");
-        text = doc.createTextNode(i->name); name.appendChild(text);
-        segment.appendChild(name);
+        xml.writeTextElement("name", i->name);
 
         // summarydata
-        QDomElement summarydata = doc.createElement("summarydata");
-        segment.appendChild(summarydata);
+        xml.writeStartElement("summarydata");
+        xml.writeTextElement("beginning", QString("%1").arg(i->start));
+        xml.writeTextElement("duration", QString("%1").arg(i->stop - i->start));
+        xml.writeEndElement(); // summarydata
 
-        // beginning
-        QDomElement beginning = doc.createElement("beginning");
-        text = doc.createTextNode(QString("%1").arg(i->start));
-        beginning.appendChild(text);
-        summarydata.appendChild(beginning);
-
-        // duration
-        QDomElement duration = doc.createElement("duration");
-        text = doc.createTextNode(QString("%1").arg(i->stop - i->start));
-        duration.appendChild(text);
-        summarydata.appendChild(duration);
+        xml.writeEndElement(); // segment
     }
 
     // samples
@@ -839,38 +747,24 @@ PwxFileReader::writeRideFile(Context *context, const RideFile *ride, QFile &file
         foreach (const RideFilePoint *point, ride->dataPoints()) {
             // if there was a gap, log time when this sample started:
             if( secs + ride->recIntSecs() < point->secs ){
-                QDomElement sample = doc.createElement("sample");
-                root.appendChild(sample);
-
-                QDomElement timeoffset = doc.createElement("timeoffset");
-                text = doc.createTextNode(QString("%1")
+                xml.writeStartElement("sample");
+                xml.writeTextElement("timeoffset", QString("%1")
                     .arg(point->secs - ride->recIntSecs() ));
-                timeoffset.appendChild(text);
-                sample.appendChild(timeoffset);
+                xml.writeEndElement(); // sample
             }
 
-            QDomElement sample = doc.createElement("sample");
-            root.appendChild(sample);
+            xml.writeStartElement("sample");
 
             // time
-            QDomElement timeoffset = doc.createElement("timeoffset");
-            text = doc.createTextNode(QString("%1").arg(point->secs));
-            timeoffset.appendChild(text);
-            sample.appendChild(timeoffset);
+            xml.writeTextElement("timeoffset", QString("%1").arg(point->secs));
 
             // hr
             if (ride->areDataPresent()->hr) {
-                QDomElement hr = doc.createElement("hr");
-                text = doc.createTextNode(QString("%1").arg((int)point->hr));
-                hr.appendChild(text);
-                sample.appendChild(hr);
+                xml.writeTextElement("hr", QString("%1").arg((int)point->hr));
             }
             // spd - meters per second
             if (ride->areDataPresent()->kph) {
-                QDomElement spd = doc.createElement("spd");
-                text = doc.createTextNode(QString("%1").arg(point->kph / 3.6));
-                spd.appendChild(text);
-                sample.appendChild(spd);
+                xml.writeTextElement("spd", QString("%1").arg(point->kph / 3.6));
             }
             // pwr
             if (ride->areDataPresent()->watts) {
@@ -880,39 +774,24 @@ PwxFileReader::writeRideFile(Context *context, const RideFile *ride, QFile &file
                 // we set 0 to 1 to at least get an upload
                 // and do the reverse in the reader above
                 int watts = point->watts ? point->watts : 1;
-                QDomElement pwr = doc.createElement("pwr");
-                text = doc.createTextNode(QString("%1").arg(watts));
-                pwr.appendChild(text);
-                sample.appendChild(pwr);
+                xml.writeTextElement("pwr", QString("%1").arg(watts));
             }
             // lrbalance
             if (ride->areDataPresent()->lrbalance) {
                 int rwatts = point->watts ? (point->watts - (point->watts * (point->lrbalance/100))) : 0;
-                QDomElement lrbalance = doc.createElement("pwrright");
-                text = doc.createTextNode(QString("%1").arg(rwatts));
-                lrbalance.appendChild(text);
-                sample.appendChild(lrbalance);
+                xml.writeTextElement("pwrright", QString("%1").arg(rwatts));
             }
             // torq
             if (ride->areDataPresent()->nm) {
-                QDomElement torq = doc.createElement("torq");
-                text = doc.createTextNode(QString("%1").arg(point->nm));
-                torq.appendChild(text);
-                sample.appendChild(torq);
+                xml.writeTextElement("torq", QString("%1").arg(point->nm));
             }
             // cad
             if (ride->areDataPresent()->cad) {
-                QDomElement cad = doc.createElement("cad");
-                text = doc.createTextNode(QString("%1").arg((int)(point->cad)));
-                cad.appendChild(text);
-                sample.appendChild(cad);
+                xml.writeTextElement("cad", QString("%1").arg((int)(point->cad)));
             }
 
             // distance - meters
-            QDomElement dist = doc.createElement("dist");
-            text = doc.createTextNode(QString("%1").arg((point->km*1000)));
-            dist.appendChild(text);
-            sample.appendChild(dist);
+            xml.writeTextElement("dist", QString("%1").arg((point->km*1000)));
 
 
             // lat/lon only if both non-zero and valid.
@@ -920,75 +799,47 @@ PwxFileReader::writeRideFile(Context *context, const RideFile *ride, QFile &file
 
                 // lon
                 if (ride->areDataPresent()->lat && point->lat > -90.0 && point->lat < 90.0) {
-                    QDomElement lat = doc.createElement("lat");
-                    text = doc.createTextNode(QString("%1").arg(point->lat, 0, 'g', 11));
-                    lat.appendChild(text);
-                    sample.appendChild(lat);
+                    xml.writeTextElement("lat", QString("%1").arg(point->lat, 0, 'g', 11));
                 }
                 // lon
                 if (ride->areDataPresent()->lon && point->lon > -180.00 && point->lon < 180.00) {
-                    QDomElement lon = doc.createElement("lon");
-                    text = doc.createTextNode(QString("%1").arg(point->lon, 0, 'g', 11));
-                    lon.appendChild(text);
-                    sample.appendChild(lon);
+                    xml.writeTextElement("lon", QString("%1").arg(point->lon, 0, 'g', 11));
                 }
             }
 
             // alt
             if (ride->areDataPresent()->alt) {
-                QDomElement alt = doc.createElement("alt");
-                text = doc.createTextNode(QString("%1").arg(point->alt));
-                alt.appendChild(text);
-                sample.appendChild(alt);
+                xml.writeTextElement("alt", QString("%1").arg(point->alt));
             }
 
             // temp
             if (ride->areDataPresent()->temp) {
-                QDomElement temp = doc.createElement("temp");
-                text = doc.createTextNode(QString("%1").arg(point->temp));
-                temp.appendChild(text);
-                sample.appendChild(temp);
+                xml.writeTextElement("temp", QString("%1").arg(point->temp));
             }
 
             // torque_effectiveness_left
             if (ride->areDataPresent()->lte) {
-                QDomElement lte = doc.createElement("torque_effectiveness_left");
-                text = doc.createTextNode(QString("%1").arg(point->lte));
-                lte.appendChild(text);
-                sample.appendChild(lte);
+                xml.writeTextElement("torque_effectiveness_left", QString("%1").arg(point->lte));
             }
             // torque_effectiveness_right
             if (ride->areDataPresent()->rte) {
-                QDomElement rte = doc.createElement("torque_effectiveness_right");
-                text = doc.createTextNode(QString("%1").arg(point->rte));
-                rte.appendChild(text);
-                sample.appendChild(rte);
+                xml.writeTextElement("torque_effectiveness_right", QString("%1").arg(point->rte));
             }
             // pedal_smoothness_left
             if (ride->areDataPresent()->lps) {
-                QDomElement lps = doc.createElement("pedal_smoothness_left");
-                text = doc.createTextNode(QString("%1").arg(point->lps));
-                lps.appendChild(text);
-                sample.appendChild(lps);
+                xml.writeTextElement("pedal_smoothness_left", QString("%1").arg(point->lps));
             }
             // pedal_smoothness_right
             if (ride->areDataPresent()->rps) {
-                QDomElement rps = doc.createElement("pedal_smoothness_right");
-                text = doc.createTextNode(QString("%1").arg(point->rps));
-                rps.appendChild(text);
-                sample.appendChild(rps);
+                xml.writeTextElement("pedal_smoothness_right", QString("%1").arg(point->rps));
             }
+
+            xml.writeEndElement(); // sample
         }
     }
 
-    QByteArray xml = doc.toByteArray(4);
-    if (!file.open(QIODevice::WriteOnly)) return(false);
-    file.resize(0);
-    QTextStream out(&file);
-    out.setCodec("UTF-8");
-    out.setGenerateByteOrderMark(true);
-    out << xml;
-    out.flush();
-    file.close();
-    return(true);
+    xml.writeEndElement(); // workout
+    xml.writeEndElement(); // pwx
+    xml.writeEndDocument();
+    return(!xml.hasError());
 }
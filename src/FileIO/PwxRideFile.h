@@ -27,7 +27,8 @@
 struct PwxFileReader : public RideFileReader {
     virtual RideFile *openRideFile(QFile &file, QStringList &errors, QList<RideFile*>* = 0) const; 
     bool writeRideFile(Context *, const RideFile *ride, QFile &file) const;
-    virtual RideFile *PwxFromDomDoc(QDomDocument doc, QStringList &errors) const;
+    bool writeRideStream(Context *, const RideFile *ride, QIODevice &device) const;
+    virtual RideFile *PwxFromStream(QIODevice &device, QStringList &errors) const;
     bool hasWrite() const { return true; }
 };
 
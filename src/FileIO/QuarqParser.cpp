@@ -59,33 +59,57 @@ QuarqParser::incrementTime( const double new_time )
 }
 
 bool
-QuarqParser::startElement( const QString&, const QString&,
-			 const QString& qName,
-			 const QXmlAttributes& qAttributes)
+QuarqParser::parse(QIODevice &device)
 {
-    buf.clear();
+    QXmlStreamReader xml(&device);
+    xml.setNamespaceProcessing(false);
+
+    while (!xml.atEnd()) {
+        switch (xml.readNext()) {
+        case QXmlStreamReader::StartElement:
+            startElement(xml);
+            break;
+        case QXmlStreamReader::EndElement:
+            endElement(xml.qualifiedName());
+            break;
+        case QXmlStreamReader::Characters:
+            buf.append(xml.text());
+            break;
+        default:
+            break;
+        }
+    }
+    return !xml.hasError();
+}
+
+void
+QuarqParser::startElement(QXmlStreamReader &xml)
+{
+    QStringRef qName = xml.qualifiedName();
+    QXmlStreamAttributes attributes = xml.attributes();
+    buf.resize(0);
 
-    if (qName == "Qollector") {
-      version = qAttributes.value("version");
+    if (qName == QLatin1String("Qollector")) {
+      version = attributes.value(QLatin1String("version")).toString();
 
       // reset the timer for a new <Qollector> tag
       seconds_from_start = 0.0;
       initial_seconds = -1;
 
-      return true;
+      return;
     }
 
 #define CheckQuarqXml(name,unit,dest)  do { 				\
-      if (qName== #name) {						\
-	QString name = qAttributes.value( #unit );			\
-	QString timestamp = qAttributes.value("timestamp");		\
+      if (qName == QLatin1String(#name)) {				\
+	QString name = attributes.value(QLatin1String(#unit)).toString(); \
+	QString timestamp = attributes.value(QLatin1String("timestamp")).toString(); \
 									\
 	if ((! name.isEmpty()) && (!timestamp.isEmpty()) &&		\
 	    ( name.toLower() != "nan")) {				\
 	  dest = name.toDouble();					\
 	  incrementTime(timestamp.toDouble());				\
 	}								\
-	return true;							\
+	return;							\
       }									\
     } while (0);
 
@@ -101,17 +125,16 @@ QuarqParser::startElement( const QString&, const QString&,
     // default case
 
     // only print the first time and unknown happens
-    if (!unknown_keys[qName]++)
-      std::cerr << "Unknown Element " << qPrintable(qName) << std::endl;
-    return true;
+    if (!unknown_keys[qName.toString()]++)
+      std::cerr << "Unknown Element " << qPrintable(qName.toString()) << std::endl;
 }
 
-bool
-QuarqParser::endElement( const QString&, const QString&, const QString& qName)
+void
+QuarqParser::endElement(const QStringRef &qName)
 {
 
     // flush one last data point
-    if (qName == "Qollector") {
+    if (qName == QLatin1String("Qollector")) {
       rideFile->appendPoint(seconds_from_start, cad, hr, km,
                             kph, nm, watts, 0, 0.0, 0.0, 0.0, 0.0,
                             RideFile::NA, RideFile::NA,
@@ -123,13 +146,4 @@ QuarqParser::endElement( const QString&, const QString&, const QString& qName)
                             0.0,0.0,0.0,0.0,
                             0);
     }
-
-    return true;
-}
-
-bool
-QuarqParser::characters( const QString& str )
-{
-    buf += str;
-    return true;
 }
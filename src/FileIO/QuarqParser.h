@@ -25,21 +25,21 @@
 #include <QHash>
 #include <QDateTime>
 #include <QProcess>
-#include <QXmlDefaultHandler>
+#include <QXmlStreamReader>
 
-class QuarqParser : public QXmlDefaultHandler
+class QuarqParser
 {
 public:
     QuarqParser(RideFile* rideFile);
 
-    bool startElement( const QString&, const QString&, const QString&,
-		       const QXmlAttributes& );
-    bool endElement( const QString&, const QString&, const QString& );
-
-    bool characters( const QString& );
+    // pull the whole file through, false if it wasn't well formed
+    bool parse(QIODevice &device);
 
 private:
 
+    void startElement(QXmlStreamReader &xml);
+    void endElement(const QStringRef &qName);
+
     void incrementTime( const double new_time ) ;
 
     RideFile*	rideFile;
@@ -121,10 +121,6 @@ RideFile *QuarqFileReader::openRideFile(QFile &file, QStringList &errors, QList<
 
     assert(antProcess);
 
-    QXmlInputSource source (antProcess);
-    QXmlSimpleReader reader;
-    reader.setContentHandler (&handler);
-
     // this could done be a loop to "save memory."
     file.open(QIODevice::ReadOnly);
     antProcess->write(file.readAll());
@@ -134,9 +130,8 @@ RideFile *QuarqFileReader::openRideFile(QFile &file, QStringList &errors, QList<
     assert(QProcess::NormalExit == antProcess->exitStatus());
     assert(0 == antProcess->exitCode());
 
-    reader.parse(source);
-
-    reader.parseContinue();
+    // the interpreter has finished, so all its output is waiting to be read
+    handler.parse(*antProcess);
 
     QRegExp rideTime("^.*/(\\d\\d\\d\\d)_(\\d\\d)_(\\d\\d)_"
                      "(\\d\\d)_(\\d\\d)_(\\d\\d)\\.qla$");
@@ -717,6 +717,17 @@ RideFileFactory::writeRideFile(Context *context, const RideFile *ride, QFile &fi
     else return reader->writeRideFile(context, ride, file);
 }
 
+bool
+RideFileFactory::writeRideStream(Context *context, const RideFile *ride, QIODevice &device, QString format) const
+{
+    // get the ride file writer for this format
+    RideFileReader *reader = readFuncs_.value(format.toLower());
+
+    // stream away, if it can
+    if (!reader) return false;
+    else return reader->writeRideStream(context, ride, device);
+}
+
 RideFileReader *RideFileFactory::readerForSuffix(QString suffix) const
 {
     return readFuncs_.value(suffix.toLower());
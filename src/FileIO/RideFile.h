@@ -599,6 +599,10 @@ struct RideFileReader {
     // if hasWrite capability should re-implement writeRideFile and hasWrite
     virtual bool hasWrite() const { return false; }
     virtual bool writeRideFile(Context *, const RideFile *, QFile &) const { return false; }
+
+    // writers that can stream to any open device (e.g. a network
+    // response) rather than only a file should re-implement this
+    virtual bool writeRideStream(Context *, const RideFile *, QIODevice &) const { return false; }
 };
 
 class MetricAggregator;
@@ -632,6 +636,7 @@ class RideFileFactory {
                            RideFileReader *reader);
         RideFile *openRideFile(Context *context, QFile &file, QStringList &errors, QList<RideFile*>* = 0) const;
         bool writeRideFile(Context *context, const RideFile *ride, QFile &file, QString format) const;
+        bool writeRideStream(Context *context, const RideFile *ride, QIODevice &device, QString format) const;
         QStringList suffixes() const;
         QStringList writeSuffixes() const;
         bool supportedFormat(QString filename) const;
@@ -32,8 +32,12 @@
 #include <QFileInfo>
 #include <QMessageBox>
 #include <QtAlgorithms> // for qStableSort
+#include <QCryptographicHash>
+#include <QMutex>
+#include <QFuture>
+#include <QtConcurrent>
 
-static const int maxcache = 25; // lets max out at 25 caches
+static const qint64 maxcachebytes = 64 * 1024 * 1024; // lets max out at 64MB of aggregates
 
 // cache from ride
 RideFileCache::RideFileCache(Context *context, QString fileName, double weight, RideFile *passedride, bool check, bool refresh) :
@@ -865,14 +869,7 @@ RideFileCache::refreshCache()
 
         // invalidate any incore cache of aggregate
         // that contains this ride in its date range
-        QDate date = ride->startTime().date();
-        for (int i=0; i<context->athlete->cpxCache.count();) {
-            if (date >= context->athlete->cpxCache.at(i)->start &&
-                date <= context->athlete->cpxCache.at(i)->end) {
-                delete context->athlete->cpxCache.at(i);
-                context->athlete->cpxCache.removeAt(i);
-            } else i++;
-        }
+        invalidate(context, ride->startTime().date());
 
 
     } else if (writeerror == false) {
@@ -1705,29 +1702,319 @@ static void distAggregate(QVector<double> &into, QVector<double> &other)
 
 }
 
+//
+// AGGREGATE STORE
+//
+// Aggregated date ranges are shared by every athlete and chart, so
+// comparing several seasons or toggling the series plotted doesn't
+// read every .cpx in the range each time. They are keyed on the
+// athlete, the range and the rides that went into them; a filter that
+// selects the same rides finds the same aggregate, and adding or
+// removing a ride in the range means it misses. When a ride changes
+// the aggregates holding it are dropped and the athlete's version is
+// bumped, so one still being aggregated in the background isn't kept.
+// The least recently used go first once over the memory budget.
+//
+struct RideFileCache::AggregateRide {
+    QString fileName; // full path
+    QDate date;
+    double weight;
+};
+
+struct RideFileCache::AggregateKey {
+
+    AggregateKey(Athlete *athlete, QDate start, QDate end, const QList<AggregateRide> &rides)
+        : athlete(athlete), start(start), end(end) {
+
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        foreach(const AggregateRide &ride, rides) hash.addData(ride.fileName.toUtf8());
+        signature = hash.result();
+    }
+
+    bool operator==(const AggregateKey &other) const {
+        return athlete == other.athlete && start == other.start && end == other.end && signature == other.signature;
+    }
+
+    Athlete *athlete;
+    QDate start, end;
+    QByteArray signature; // of the rides aggregated
+};
+
+class RideFileCacheStore
+{
+    public:
+        RideFileCacheStore() : bytes(0) {}
+
+        int version(Athlete *athlete);
+
+        // copies into the cache passed, waits if it's being prefetched
+        bool find(const RideFileCache::AggregateKey &key, RideFileCache *into);
+
+        // takes ownership, dropped if the version has moved on
+        void insert(const RideFileCache::AggregateKey &key, RideFileCache *cache, int version);
+
+        void prefetch(Context *context, const RideFileCache::AggregateKey &key, QList<RideFileCache::AggregateRide> rides);
+        void finished(const RideFileCache::AggregateKey &key);
+
+        void invalidate(Athlete *athlete, QDate date);
+
+    private:
+        struct Entry {
+            RideFileCache::AggregateKey key;
+            RideFileCache *cache;
+            qint64 bytes;
+        };
+        struct Pending {
+            RideFileCache::AggregateKey key;
+            QFuture<void> future;
+        };
+
+        void remove(int index);
+
+        QMutex lock;
+        QList<Entry> entries; // most recently used first
+        QList<Pending> pending;
+        QMap<Athlete*, int> versions;
+        qint64 bytes;
+};
+
+static RideFileCacheStore *store()
+{
+    static RideFileCacheStore store;
+    return &store;
+}
+
+int
+RideFileCacheStore::version(Athlete *athlete)
+{
+    lock.lock();
+    int returning = versions.value(athlete, 0);
+    lock.unlock();
+    return returning;
+}
+
+bool
+RideFileCacheStore::find(const RideFileCache::AggregateKey &key, RideFileCache *into)
+{
+    lock.lock();
+
+    // being aggregated in the background, wait for it to land
+    foreach(const Pending &p, pending) {
+        if (p.key == key) {
+            QFuture<void> future = p.future;
+            lock.unlock();
+            future.waitForFinished();
+            lock.lock();
+            break;
+        }
+    }
+
+    for (int i=0; i<entries.count(); i++) {
+        if (entries[i].key == key) {
+            entries.move(i, 0);
+            *into = *entries[0].cache; // arrays are shared, not copied
+            lock.unlock();
+            return true;
+        }
+    }
+
+    lock.unlock();
+    return false;
+}
+
+void
+RideFileCacheStore::insert(const RideFileCache::AggregateKey &key, RideFileCache *cache, int version)
+{
+    lock.lock();
+
+    // a ride changed whilst it was being aggregated
+    if (versions.value(key.athlete, 0) != version) {
+        lock.unlock();
+        delete cache;
+        return;
+    }
+
+    for (int i=0; i<entries.count(); i++) {
+        if (entries[i].key == key) {
+            remove(i);
+            break;
+        }
+    }
+
+    Entry add = { key, cache, cache->memoryUsed() };
+    entries.prepend(add);
+    bytes += add.bytes;
+
+    // least recently used first, but always keep the one just added
+    while (bytes > maxcachebytes && entries.count() > 1) remove(entries.count()-1);
+
+    lock.unlock();
+}
+
+void
+RideFileCacheStore::prefetch(Context *context, const RideFileCache::AggregateKey &key, QList<RideFileCache::AggregateRide> rides)
+{
+    lock.lock();
+
+    bool have = false;
+    foreach(const Entry &entry, entries) if (entry.key == key) have = true;
+    foreach(const Pending &p, pending) if (p.key == key) have = true;
+
+    // the worker can't get to finished() until we let go of the lock
+    if (!have) {
+        Pending add = { key, QtConcurrent::run(RideFileCache::aggregateInBackground, context, key, rides,
+                                               versions.value(key.athlete, 0)) };
+        pending << add;
+    }
+
+    lock.unlock();
+}
+
+void
+RideFileCacheStore::finished(const RideFileCache::AggregateKey &key)
+{
+    lock.lock();
+    for (int i=0; i<pending.count(); i++) {
+        if (pending[i].key == key) {
+            pending.removeAt(i);
+            break;
+        }
+    }
+    lock.unlock();
+}
+
+void
+RideFileCacheStore::invalidate(Athlete *athlete, QDate date)
+{
+    lock.lock();
+
+    versions[athlete]++;
+
+    // athlete is closing, wait for anything still using it
+    if (!date.isValid()) {
+        QList<QFuture<void> > waiting;
+        foreach(const Pending &p, pending) if (p.key.athlete == athlete) waiting << p.future;
+
+        lock.unlock();
+        foreach(QFuture<void> future, waiting) future.waitForFinished();
+        lock.lock();
+
+        versions.remove(athlete);
+    }
+
+    for (int i=0; i<entries.count();) {
+        const RideFileCache::AggregateKey &key = entries[i].key;
+        if (key.athlete == athlete && (!date.isValid() || (date >= key.start && date <= key.end))) remove(i);
+        else i++;
+    }
+
+    lock.unlock();
+}
+
+void
+RideFileCacheStore::remove(int index)
+{
+    bytes -= entries[index].bytes;
+    delete entries[index].cache;
+    entries.removeAt(index);
+}
+
 RideFileCache::RideFileCache(Context *context, QDate start, QDate end, bool filter, QStringList files, bool onhome, RideItem *rideItem)
                : start(start), end(end), incomplete(false), context(context), rideFileName(""), ride(0)
 {
+    // the rides that go into the aggregate, which is what it is keyed on
+    QList<AggregateRide> rides = aggregateRides(context, start, end, filter, files, onhome, rideItem);
+    AggregateKey key(context->athlete, start, end, rides);
+
+    // set cursor busy whilst we aggregate -- bit of feedback
+    // and less intrusive than a popup box
+    context->mainWindow->setCursor(Qt::WaitCursor);
+
+    // Oh lets get from the cache if we can, or wait for
+    // it to arrive if it is already being aggregated
+    int version = store()->version(context->athlete);
+    if (store()->find(key, this) == false) {
+
+        aggregate(rides);
+
+        // lets add to the cache for others to re-use -- but not if incomplete
+        if (incomplete == false) store()->insert(key, new RideFileCache(this), version);
+    }
+
+    // set the cursor back to normal
+    context->mainWindow->setCursor(Qt::ArrowCursor);
 
     // remember parameters for getting heat
     this->filter = filter;
     this->files = files;
     this->onhome = onhome;
+}
 
-    // Oh lets get from the cache if we can -- but not if filtered
-    if (!filter && !context->isfiltered && !rideItem) {
+void
+RideFileCache::prefetch(Context *context, QDate start, QDate end, bool onhome)
+{
+    // the filters are only safe to read here, so the rides are listed up front
+    QList<AggregateRide> rides = aggregateRides(context, start, end, false, QStringList(), onhome, NULL);
+    AggregateKey key(context->athlete, start, end, rides);
 
-        // oh and not if we're onhome and homefiltered
-        if ((onhome && !context->ishomefiltered) || !onhome) {
-            foreach(RideFileCache *p, context->athlete->cpxCache) {
-                if (p->start == start && p->end == end) {
-                    *this = *p;
-                    return;
-                }
-            }
+    store()->prefetch(context, key, rides);
+}
+
+void
+RideFileCache::aggregateInBackground(Context *context, AggregateKey key, QList<AggregateRide> rides, int version)
+{
+    RideFileCache *cache = new RideFileCache();
+    cache->context = context;
+    cache->start = key.start;
+    cache->end = key.end;
+    cache->aggregate(rides);
+
+    if (cache->incomplete == false) store()->insert(key, cache, version);
+    else delete cache;
+
+    store()->finished(key);
+}
+
+void
+RideFileCache::invalidate(Context *context, QDate date)
+{
+    store()->invalidate(context->athlete, date);
+}
+
+QList<RideFileCache::AggregateRide>
+RideFileCache::aggregateRides(Context *context, QDate start, QDate end, bool filter, QStringList files, bool onhome, RideItem *rideItem)
+{
+    QList<AggregateRide> returning;
+
+    // Iterate over the ride files (not the cpx files since they /might/ not
+    // exist, or /might/ be out of date.
+    foreach (RideItem *item, context->athlete->rideCache->rides()) {
+
+        QDate rideDate = item->dateTime.date();
+
+        if (((filter == true && files.contains(item->fileName)) || filter == false) &&
+            rideDate >= start && rideDate <= end) {
+
+            // skip globally filtered values
+            if (context->isfiltered && !context->filters.contains(item->fileName)) continue;
+            if (onhome && context->ishomefiltered && !context->homeFilters.contains(item->fileName)) continue;
+            // skip other sports if rideItem is given
+            if (rideItem && ((rideItem->isRun != item->isRun) || (rideItem->isSwim != item->isSwim))) continue;
+
+            AggregateRide add;
+            add.fileName = context->athlete->home->activities().canonicalPath() + "/" + item->fileName;
+            add.date = rideDate;
+            add.weight = item->getWeight();
+            returning << add;
         }
     }
+    return returning;
+}
 
+// no gui here, it runs in the background when prefetching
+void
+RideFileCache::aggregate(const QList<AggregateRide> &rides)
+{
     // resize all the arrays to zero - expand as neccessary
     xPowerMeanMax.resize(0);
     npMeanMax.resize(0);
@@ -1769,92 +2056,96 @@ RideFileCache::RideFileCache(Context *context, QDate start, QDate end, bool filt
     paceCPTimeInZone.resize(4);
     wbalTimeInZone.resize(4);
 
-    // set cursor busy whilst we aggregate -- bit of feedback
-    // and less intrusive than a popup box
-    context->mainWindow->setCursor(Qt::WaitCursor);
-
-    // Iterate over the ride files (not the cpx files since they /might/ not
-    // exist, or /might/ be out of date.
-    foreach (RideItem *item, context->athlete->rideCache->rides()) {
-
-        QDate rideDate = item->dateTime.date();
-
-        if (((filter == true && files.contains(item->fileName)) || filter == false) &&
-            rideDate >= start && rideDate <= end) {
+    foreach (const AggregateRide &ride, rides) {
 
-            // skip globally filtered values
-            if (context->isfiltered && !context->filters.contains(item->fileName)) continue;
-            if (onhome && context->ishomefiltered && !context->homeFilters.contains(item->fileName)) continue;
-            // skip other sports if rideItem is given
-            if (rideItem && ((rideItem->isRun != item->isRun) || (rideItem->isSwim != item->isSwim))) continue;
+        // get its cached values (will NOT! refresh if needed...)
+        // the true means it will check only
+        RideFileCache rideCache(context, ride.fileName, ride.weight, NULL, false, false);
+        if (rideCache.incomplete == true) {
+            // ack, data not available !
+            incomplete = true;
+        } else {
 
-            // get its cached values (will NOT! refresh if needed...)
-            // the true means it will check only
-            RideFileCache rideCache(context, context->athlete->home->activities().canonicalPath() + "/" + item->fileName, item->getWeight(), NULL, false, false);
-            if (rideCache.incomplete == true) {
-                // ack, data not available !
-                incomplete = true;
-            } else {
-
-                // lets aggregate
-                meanMaxAggregate(wattsMeanMaxDouble, rideCache.wattsMeanMaxDouble, wattsMeanMaxDate, rideDate);
-                meanMaxAggregate(hrMeanMaxDouble, rideCache.hrMeanMaxDouble, hrMeanMaxDate, rideDate);
-                meanMaxAggregate(cadMeanMaxDouble, rideCache.cadMeanMaxDouble, cadMeanMaxDate, rideDate);
-                meanMaxAggregate(nmMeanMaxDouble, rideCache.nmMeanMaxDouble, nmMeanMaxDate, rideDate);
-                meanMaxAggregate(kphMeanMaxDouble, rideCache.kphMeanMaxDouble, kphMeanMaxDate, rideDate);
-                meanMaxAggregate(kphdMeanMaxDouble, rideCache.kphdMeanMaxDouble, kphdMeanMaxDate, rideDate);
-                meanMaxAggregate(wattsdMeanMaxDouble, rideCache.wattsdMeanMaxDouble, wattsdMeanMaxDate, rideDate);
-                meanMaxAggregate(caddMeanMaxDouble, rideCache.caddMeanMaxDouble, caddMeanMaxDate, rideDate);
-                meanMaxAggregate(nmdMeanMaxDouble, rideCache.nmdMeanMaxDouble, nmdMeanMaxDate, rideDate);
-                meanMaxAggregate(hrdMeanMaxDouble, rideCache.hrdMeanMaxDouble, hrdMeanMaxDate, rideDate);
-                meanMaxAggregate(xPowerMeanMaxDouble, rideCache.xPowerMeanMaxDouble, xPowerMeanMaxDate, rideDate);
-                meanMaxAggregate(npMeanMaxDouble, rideCache.npMeanMaxDouble, npMeanMaxDate, rideDate);
-                meanMaxAggregate(vamMeanMaxDouble, rideCache.vamMeanMaxDouble, vamMeanMaxDate, rideDate);
-                meanMaxAggregate(wattsKgMeanMaxDouble, rideCache.wattsKgMeanMaxDouble, wattsKgMeanMaxDate, rideDate);
-                meanMaxAggregate(aPowerMeanMaxDouble, rideCache.aPowerMeanMaxDouble, aPowerMeanMaxDate, rideDate);
-                meanMaxAggregate(aPowerKgMeanMaxDouble, rideCache.aPowerKgMeanMaxDouble, aPowerKgMeanMaxDate, rideDate);
-
-                distAggregate(wattsDistributionDouble, rideCache.wattsDistributionDouble);
-                distAggregate(hrDistributionDouble, rideCache.hrDistributionDouble);
-                distAggregate(cadDistributionDouble, rideCache.cadDistributionDouble);
-                distAggregate(gearDistributionDouble, rideCache.gearDistributionDouble);
-                distAggregate(nmDistributionDouble, rideCache.nmDistributionDouble);
-                distAggregate(kphDistributionDouble, rideCache.kphDistributionDouble);
-                distAggregate(xPowerDistributionDouble, rideCache.xPowerDistributionDouble);
-                distAggregate(npDistributionDouble, rideCache.npDistributionDouble);
-                distAggregate(wattsKgDistributionDouble, rideCache.wattsKgDistributionDouble);
-                distAggregate(aPowerDistributionDouble, rideCache.aPowerDistributionDouble);
-                distAggregate(smo2DistributionDouble, rideCache.smo2DistributionDouble);
-                distAggregate(wbalDistributionDouble, rideCache.wbalDistributionDouble);
-
-                // cumulate timeinzones
-                for (int i=0; i<10; i++) {
-                    paceTimeInZone[i] += rideCache.paceTimeInZone[i];
-                    hrTimeInZone[i] += rideCache.hrTimeInZone[i];
-                    wattsTimeInZone[i] += rideCache.wattsTimeInZone[i];
-                    if (i<4) {
-                        paceCPTimeInZone[i] += rideCache.paceCPTimeInZone[i];
-                        hrCPTimeInZone[i] += rideCache.hrCPTimeInZone[i];
-                        wattsCPTimeInZone[i] += rideCache.wattsCPTimeInZone[i];
-                        wbalTimeInZone[i] += rideCache.wbalTimeInZone[i];
-                    }
+            // lets aggregate
+            meanMaxAggregate(wattsMeanMaxDouble, rideCache.wattsMeanMaxDouble, wattsMeanMaxDate, ride.date);
+            meanMaxAggregate(hrMeanMaxDouble, rideCache.hrMeanMaxDouble, hrMeanMaxDate, ride.date);
+            meanMaxAggregate(cadMeanMaxDouble, rideCache.cadMeanMaxDouble, cadMeanMaxDate, ride.date);
+            meanMaxAggregate(nmMeanMaxDouble, rideCache.nmMeanMaxDouble, nmMeanMaxDate, ride.date);
+            meanMaxAggregate(kphMeanMaxDouble, rideCache.kphMeanMaxDouble, kphMeanMaxDate, ride.date);
+            meanMaxAggregate(kphdMeanMaxDouble, rideCache.kphdMeanMaxDouble, kphdMeanMaxDate, ride.date);
+            meanMaxAggregate(wattsdMeanMaxDouble, rideCache.wattsdMeanMaxDouble, wattsdMeanMaxDate, ride.date);
+            meanMaxAggregate(caddMeanMaxDouble, rideCache.caddMeanMaxDouble, caddMeanMaxDate, ride.date);
+            meanMaxAggregate(nmdMeanMaxDouble, rideCache.nmdMeanMaxDouble, nmdMeanMaxDate, ride.date);
+            meanMaxAggregate(hrdMeanMaxDouble, rideCache.hrdMeanMaxDouble, hrdMeanMaxDate, ride.date);
+            meanMaxAggregate(xPowerMeanMaxDouble, rideCache.xPowerMeanMaxDouble, xPowerMeanMaxDate, ride.date);
+            meanMaxAggregate(npMeanMaxDouble, rideCache.npMeanMaxDouble, npMeanMaxDate, ride.date);
+            meanMaxAggregate(vamMeanMaxDouble, rideCache.vamMeanMaxDouble, vamMeanMaxDate, ride.date);
+            meanMaxAggregate(wattsKgMeanMaxDouble, rideCache.wattsKgMeanMaxDouble, wattsKgMeanMaxDate, ride.date);
+            meanMaxAggregate(aPowerMeanMaxDouble, rideCache.aPowerMeanMaxDouble, aPowerMeanMaxDate, ride.date);
+            meanMaxAggregate(aPowerKgMeanMaxDouble, rideCache.aPowerKgMeanMaxDouble, aPowerKgMeanMaxDate, ride.date);
+
+            distAggregate(wattsDistributionDouble, rideCache.wattsDistributionDouble);
+            distAggregate(hrDistributionDouble, rideCache.hrDistributionDouble);
+            distAggregate(cadDistributionDouble, rideCache.cadDistributionDouble);
+            distAggregate(gearDistributionDouble, rideCache.gearDistributionDouble);
+            distAggregate(nmDistributionDouble, rideCache.nmDistributionDouble);
+            distAggregate(kphDistributionDouble, rideCache.kphDistributionDouble);
+            distAggregate(xPowerDistributionDouble, rideCache.xPowerDistributionDouble);
+            distAggregate(npDistributionDouble, rideCache.npDistributionDouble);
+            distAggregate(wattsKgDistributionDouble, rideCache.wattsKgDistributionDouble);
+            distAggregate(aPowerDistributionDouble, rideCache.aPowerDistributionDouble);
+            distAggregate(smo2DistributionDouble, rideCache.smo2DistributionDouble);
+            distAggregate(wbalDistributionDouble, rideCache.wbalDistributionDouble);
+
+            // cumulate timeinzones
+            for (int i=0; i<10; i++) {
+                paceTimeInZone[i] += rideCache.paceTimeInZone[i];
+                hrTimeInZone[i] += rideCache.hrTimeInZone[i];
+                wattsTimeInZone[i] += rideCache.wattsTimeInZone[i];
+                if (i<4) {
+                    paceCPTimeInZone[i] += rideCache.paceCPTimeInZone[i];
+                    hrCPTimeInZone[i] += rideCache.hrCPTimeInZone[i];
+                    wattsCPTimeInZone[i] += rideCache.wattsCPTimeInZone[i];
+                    wbalTimeInZone[i] += rideCache.wbalTimeInZone[i];
                 }
             }
         }
     }
+}
 
-    // set the cursor back to normal
-    context->mainWindow->setCursor(Qt::ArrowCursor);
+template <class T> static qint64 arrayBytes(const QVector<T> &array)
+{
+    return array.capacity() * sizeof(T);
+}
 
-    // lets add to the cache for others to re-use -- but not if filtered or incomplete
-    if (incomplete == false && !context->isfiltered && (!context->ishomefiltered || !onhome) && !filter) {
+qint64
+RideFileCache::memoryUsed() const
+{
+    qint64 returning = sizeof(RideFileCache);
+
+    returning += arrayBytes(wattsMeanMax) + arrayBytes(hrMeanMax) + arrayBytes(cadMeanMax) + arrayBytes(nmMeanMax);
+    returning += arrayBytes(kphMeanMax) + arrayBytes(kphdMeanMax) + arrayBytes(wattsdMeanMax) + arrayBytes(caddMeanMax);
+    returning += arrayBytes(nmdMeanMax) + arrayBytes(hrdMeanMax) + arrayBytes(xPowerMeanMax) + arrayBytes(npMeanMax);
+    returning += arrayBytes(vamMeanMax) + arrayBytes(wattsKgMeanMax) + arrayBytes(aPowerMeanMax) + arrayBytes(aPowerKgMeanMax);
+    returning += arrayBytes(heatMeanMax) + arrayBytes(wattsMeanMaxDouble) + arrayBytes(hrMeanMaxDouble) + arrayBytes(cadMeanMaxDouble);
+    returning += arrayBytes(nmMeanMaxDouble) + arrayBytes(kphMeanMaxDouble) + arrayBytes(kphdMeanMaxDouble) + arrayBytes(wattsdMeanMaxDouble);
+    returning += arrayBytes(caddMeanMaxDouble) + arrayBytes(nmdMeanMaxDouble) + arrayBytes(hrdMeanMaxDouble) + arrayBytes(xPowerMeanMaxDouble);
+    returning += arrayBytes(npMeanMaxDouble) + arrayBytes(vamMeanMaxDouble) + arrayBytes(wattsKgMeanMaxDouble) + arrayBytes(aPowerMeanMaxDouble);
+    returning += arrayBytes(aPowerKgMeanMaxDouble) + arrayBytes(wattsMeanMaxDate) + arrayBytes(hrMeanMaxDate) + arrayBytes(cadMeanMaxDate);
+    returning += arrayBytes(nmMeanMaxDate) + arrayBytes(kphMeanMaxDate) + arrayBytes(kphdMeanMaxDate) + arrayBytes(wattsdMeanMaxDate);
+    returning += arrayBytes(caddMeanMaxDate) + arrayBytes(nmdMeanMaxDate) + arrayBytes(hrdMeanMaxDate) + arrayBytes(xPowerMeanMaxDate);
+    returning += arrayBytes(npMeanMaxDate) + arrayBytes(vamMeanMaxDate) + arrayBytes(wattsKgMeanMaxDate) + arrayBytes(aPowerMeanMaxDate);
+    returning += arrayBytes(aPowerKgMeanMaxDate) + arrayBytes(wattsDistribution) + arrayBytes(hrDistribution) + arrayBytes(gearDistribution);
+    returning += arrayBytes(cadDistribution) + arrayBytes(nmDistribution) + arrayBytes(kphDistribution) + arrayBytes(kphdDistribution);
+    returning += arrayBytes(xPowerDistribution) + arrayBytes(npDistribution) + arrayBytes(wattsKgDistribution) + arrayBytes(aPowerDistribution);
+    returning += arrayBytes(smo2Distribution) + arrayBytes(wbalDistribution) + arrayBytes(wattsDistributionDouble) + arrayBytes(hrDistributionDouble);
+    returning += arrayBytes(gearDistributionDouble) + arrayBytes(cadDistributionDouble) + arrayBytes(nmDistributionDouble) + arrayBytes(kphDistributionDouble);
+    returning += arrayBytes(xPowerDistributionDouble) + arrayBytes(npDistributionDouble) + arrayBytes(wattsKgDistributionDouble) + arrayBytes(aPowerDistributionDouble);
+    returning += arrayBytes(smo2DistributionDouble) + arrayBytes(wbalDistributionDouble) + arrayBytes(wattsTimeInZone) + arrayBytes(wattsCPTimeInZone);
+    returning += arrayBytes(hrTimeInZone) + arrayBytes(hrCPTimeInZone) + arrayBytes(paceTimeInZone) + arrayBytes(paceCPTimeInZone);
+    returning += arrayBytes(wbalTimeInZone);
 
-        if (context->athlete->cpxCache.count() > maxcache) {
-            delete(context->athlete->cpxCache.at(0));
-            context->athlete->cpxCache.removeAt(0);
-        }
-        context->athlete->cpxCache.append(new RideFileCache(this));
-    }
+    return returning;
 }
 
 //
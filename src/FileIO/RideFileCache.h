@@ -25,6 +25,7 @@
 #include <QThread>
 
 class Context;
+class Athlete;
 class RideFile;
 class RideBest;
 class MetricDetail;
@@ -163,6 +164,12 @@ class RideFileCache
         // across a date range. This is used to provide aggregated data.
         RideFileCache(Context *context, QDate start, QDate end, bool filter = false, QStringList files = QStringList(), bool onhome = true, RideItem *rideItem = NULL);
 
+        // aggregate a date range in the background so the constructor above
+        // finds it ready, drop aggregates holding a ride on the given date
+        // or, if the date is invalid, all of the athlete's aggregates
+        static void prefetch(Context *context, QDate start, QDate end, bool onhome = true);
+        static void invalidate(Context *context, QDate date = QDate());
+
         // once a cache is loaded we can refresh from in-memory if needed
         void refresh(RideFile*ride = NULL);
 
@@ -229,6 +236,9 @@ class RideFileCache
         // Best time for distance, used by metrics and Data Filter
         int bestTime(double km);
 
+        // bytes held by the arrays, aggregates are accounted against this
+        qint64 memoryUsed() const;
+
     protected:
 
         void refreshCache();              // compute arrays and update cache
@@ -244,6 +254,16 @@ class RideFileCache
 
     private:
 
+        // aggregating a date range, see RideFileCache.cpp
+        friend class RideFileCacheStore;
+        struct AggregateRide;
+        struct AggregateKey;
+        RideFileCache() : incomplete(false), context(NULL), ride(0), filter(false), onhome(true) {}
+        static QList<AggregateRide> aggregateRides(Context *context, QDate start, QDate end, bool filter,
+                                                   QStringList files, bool onhome, RideItem *rideItem);
+        static void aggregateInBackground(Context *context, AggregateKey key, QList<AggregateRide> rides, int version);
+        void aggregate(const QList<AggregateRide> &rides);
+
         Context *context;
         QString rideFileName; // filename of ride
         QString cacheFileName; // filename of cache file
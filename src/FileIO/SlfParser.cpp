@@ -24,100 +24,132 @@
 #include "TimeUtils.h"
 #include "Units.h"
 
+// an attribute as a number, converted straight from the reader's buffer
+static double
+slfNumber(const QXmlStreamAttributes &attributes, const char *name)
+{
+#if QT_VERSION >= 0x050100
+    return attributes.value(QLatin1String(name)).toDouble();
+#else
+    return attributes.value(QLatin1String(name)).toString().toDouble();
+#endif
+}
+
 SlfParser::SlfParser (RideFile* rideFile)
    : rideFile(rideFile)
 {
 }
 
 bool
-SlfParser::startElement( const QString&, const QString&,
-			 const QString& qName,
-			 const QXmlAttributes& qAttributes)
+SlfParser::parse(QIODevice &device)
 {
-    buffer.clear();
-    (void)qName;
-    (void)qAttributes;
+    QXmlStreamReader xml(&device);
+    xml.setNamespaceProcessing(false);
+
+    while (!xml.atEnd()) {
+        switch (xml.readNext()) {
+        case QXmlStreamReader::StartElement:
+            startElement(xml);
+            break;
+        case QXmlStreamReader::EndElement:
+            endElement(xml.qualifiedName());
+            break;
+        case QXmlStreamReader::Characters:
+            buffer.append(xml.text());
+            break;
+        default:
+            break;
+        }
+    }
+    return !xml.hasError();
+}
 
-    if (qName == "Activity")
+void
+SlfParser::startElement(QXmlStreamReader &xml)
+{
+    QStringRef qName = xml.qualifiedName();
+    QXmlStreamAttributes attributes = xml.attributes();
+    buffer.resize(0);
+
+    if (qName == QLatin1String("Activity"))
     {
         secs = 0.0;
         sampleCount = 0.0;
         sampleSecs = 0.0;
         distance = 0.0;
         lap = 0;
-    } else if (qName == "Computer")
+    } else if (qName == QLatin1String("Computer"))
     {
-        rideFile->setDeviceType(qAttributes.value("unit"));
+        rideFile->setDeviceType(attributes.value(QLatin1String("unit")).toString());
     }
-    else if (qName == "Log")
+    else if (qName == QLatin1String("Log"))
     {
         secs = 0.0;
         distance = 0.0;
         lap = 0;
     }
-    else if (qName == "Eintrag") {
+    else if (qName == QLatin1String("Eintrag")) {
         hr = 0.0;
         alt = 0.0;
         speed = 0.0;
         pauseSec = 0.0;
         restSec = 0.0;
-        if (qAttributes.value("wp").toULong() == 1)
+        if (attributes.value(QLatin1String("wp")).toString().toULong() == 1)
         {
             lap++;
         }
     }
-    else if (qName == "Pause")
+    else if (qName == QLatin1String("Pause"))
     {
-        pauseSec = qAttributes.value("zeit").toDouble();
+        pauseSec = slfNumber(attributes, "zeit");
     }
-    else if (qName == "Rest")
+    else if (qName == QLatin1String("Rest"))
     {
-        restSec = qAttributes.value("zeit").toDouble();
+        restSec = slfNumber(attributes, "zeit");
     }
     // Rox 10 Entries
-    else if (qName == "Entry")
+    else if (qName == QLatin1String("Entry"))
     {
-        double secs = qAttributes.value("trainingTimeAbsolute").toDouble()/100; 
-        double cadence = qAttributes.value("cadence").toDouble(); 
-        double hr = qAttributes.value("heartrate").toDouble();
-        double distance = qAttributes.value("distanceAbsolute").toDouble()/1000;
-        double speed = qAttributes.value("speed").toDouble()*3.6;
+        double secs = slfNumber(attributes, "trainingTimeAbsolute")/100; 
+        double cadence = slfNumber(attributes, "cadence"); 
+        double hr = slfNumber(attributes, "heartrate");
+        double distance = slfNumber(attributes, "distanceAbsolute")/1000;
+        double speed = slfNumber(attributes, "speed")*3.6;
         double torque = 0.0;
-        double power = qAttributes.value("power").toDouble();
-        double alt = qAttributes.value("altitude").toDouble()/1000;
-        double lon = qAttributes.value("longitude").toDouble();
-        double lat = qAttributes.value("latitude").toDouble();
+        double power = slfNumber(attributes, "power");
+        double alt = slfNumber(attributes, "altitude")/1000;
+        double lon = slfNumber(attributes, "longitude");
+        double lat = slfNumber(attributes, "latitude");
         double headwind = 0.0;
-        double temp = qAttributes.value("temperature").toDouble();
-        double slope = qAttributes.value("incline").toDouble();
+        double temp = slfNumber(attributes, "temperature");
+        double slope = slfNumber(attributes, "incline");
         rideFile->appendPoint(secs, cadence, hr, distance, speed, torque, power, alt, lon, lat, headwind, slope, temp, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, lap);
         sampleCount += 1.0;
         sampleSecs = secs;
 
     } 
-    return true;
 }
 
-bool
-SlfParser::endElement( const QString&, const QString&, const QString& qName)
+void
+SlfParser::endElement(const QStringRef &qName)
 {
-    if (qName == "startDate")
+    if (qName == QLatin1String("startDate"))
     {
         // Fri May 1 13:55:10 GMT+0200 2015
         QLocale local(QLocale::English);
         QString date = buffer.mid(0,buffer.indexOf("GMT")) + buffer.right(4);
         rideFile->setStartTime(local.toDateTime(date, "ddd MMM d HH:mm:ss yyyy"));
     }
-    else if (qName == "StartDatum")
+    else if (qName == QLatin1String("StartDatum"))
     {
         start_time.setDate(QDate::fromString(buffer, "dd.MM.yy").addYears(100));
         rideFile->setStartTime(start_time);
     }
-    else if (qName == "StartZeit")
+    else if (qName == QLatin1String("StartZeit"))
     {
         start_time.setTime(QTime::fromString(buffer, "hh:mm:ss"));
     }
-    else if (qName == "StoppDatum")
+    else if (qName == QLatin1String("StoppDatum"))
     {
         QMap<QString, QString> workout;
         stop_time.setDate(QDate::fromString(buffer, "dd.MM.yy").addYears(100));
@@ -125,64 +157,64 @@ SlfParser::endElement( const QString&, const QString&, const QString& qName)
         rideFile->metricOverrides.insert("workout_time", workout);
     }
     // ROX 10.0 format
-    else if (qName == "trainingTime")
+    else if (qName == QLatin1String("trainingTime"))
     {
         QMap<QString, QString> workout;
         workout.insert("value", QString("%1").arg(buffer.toDouble()/100));
         rideFile->metricOverrides.insert("workout_time", workout);
     }
-    else if (qName == "StoppZeit")
+    else if (qName == QLatin1String("StoppZeit"))
     {
         stop_time.setTime(QTime::fromString(buffer, "hh:mm:ss"));
     }
-    else if (qName == "RadGroesse")
+    else if (qName == QLatin1String("RadGroesse"))
     {
         wheelSize = buffer.toInt();
     }
-    else if (qName == "Einheit")
+    else if (qName == QLatin1String("Einheit"))
     {
         imperial = (buffer == "mph");
     }
-    else if (qName == "Kalorien")
+    else if (qName == QLatin1String("Kalorien"))
     {
         QMap<QString, QString> work;
         work.insert("value", QString("%1").arg(buffer.toDouble() / 0.239));
         rideFile->metricOverrides.insert("total_work", work);
     }
-    else if (qName == "SamplingRate")
+    else if (qName == QLatin1String("SamplingRate"))
     {
         //Seems like the sampling rate is rounded...
         samplingRate = buffer.toDouble() - 0.5;
         rideFile->setRecIntSecs(samplingRate);
     }
     // Rox 10.0 format
-    else if (qName == "samplingRate")
+    else if (qName == QLatin1String("samplingRate"))
     {
         samplingRate = buffer.toDouble();
         rideFile->setRecIntSecs(samplingRate);
     }
-    else if (qName == "Speed")
+    else if (qName == QLatin1String("Speed"))
     {
         speed = buffer.toDouble();
     }
-    else if (qName == "Puls")
+    else if (qName == QLatin1String("Puls"))
     {
         hr = buffer.toDouble();
     }
-    else if (qName == "Hoehe")
+    else if (qName == QLatin1String("Hoehe"))
     {
         alt = buffer.toDouble();
     }
-    else if (qName == "RPLAbs")
+    else if (qName == QLatin1String("RPLAbs"))
     {
         rotations = buffer.toDouble();
         distance += (rotations * (wheelSize) / 1000 / 1000);
     }
-    else if (qName == "Temp")
+    else if (qName == QLatin1String("Temp"))
     {
         temperature = buffer.toDouble();
     }
-    else if (qName == "Eintrag")
+    else if (qName == QLatin1String("Eintrag"))
     {
         double cadence = 0.0;
         double torque = 0.0;
@@ -214,7 +246,7 @@ SlfParser::endElement( const QString&, const QString&, const QString& qName)
             secs += samplingRate;
         }
     }
-    else if (qName == "Entries")
+    else if (qName == QLatin1String("Entries"))
     {
         // Rox 11 does not provide the samplingRate any more - if it's still Zero at the end of the file,
         // calculate the rate based on number of samples and last "secs" value - Rox 11 allows 1-2-5-10-20 secs sampling so round to integer
@@ -222,11 +254,4 @@ SlfParser::endElement( const QString&, const QString&, const QString& qName)
             rideFile->setRecIntSecs(double(qRound(sampleSecs / sampleCount)));  // strip of the decimals since Rox does not have any
         }
     }
-    return true;
-}
-
-bool SlfParser::characters( const QString& str )
-{
-    buffer += str;
-    return true;
 }
@@ -22,21 +22,21 @@
 #include "RideFile.h"
 #include <QString>
 #include <QDateTime>
-#include <QXmlDefaultHandler>
+#include <QXmlStreamReader>
 
-class SlfParser : public QXmlDefaultHandler
+class SlfParser
 {
 public:
     SlfParser(RideFile* rideFile);
 
-    bool startElement( const QString&, const QString&, const QString&,
-		       const QXmlAttributes& );
-    bool endElement( const QString&, const QString&, const QString& );
-
-    bool characters( const QString& );
+    // pull the whole file through, false if it wasn't well formed
+    bool parse(QIODevice &device);
 
 private:
 
+    void startElement(QXmlStreamReader &xml);
+    void endElement(const QStringRef &qName);
+
     RideFile*	rideFile;
 
     QString	buffer;
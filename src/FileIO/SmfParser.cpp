@@ -28,60 +28,72 @@ SmfParser::SmfParser (RideFile* rideFile)
 }
 
 bool
-SmfParser::startElement( const QString&, const QString&,
-			 const QString& qName,
-			 const QXmlAttributes& qAttributes)
+SmfParser::parse(QIODevice &device)
 {
-    buffer.clear();
-    (void)qName;
-    (void)qAttributes;
+    QXmlStreamReader xml(&device);
+    xml.setNamespaceProcessing(false);
 
-    return true;
+    while (!xml.atEnd()) {
+        switch (xml.readNext()) {
+        case QXmlStreamReader::StartElement:
+            buffer.resize(0);
+            break;
+        case QXmlStreamReader::EndElement:
+            endElement(xml.qualifiedName());
+            break;
+        case QXmlStreamReader::Characters:
+            buffer.append(xml.text());
+            break;
+        default:
+            break;
+        }
+    }
+    return !xml.hasError();
 }
 
-bool
-SmfParser::endElement( const QString&, const QString&, const QString& qName)
+void
+SmfParser::endElement(const QStringRef &qName)
 {
-    if (qName == "Datum")
+    if (qName == QLatin1String("Datum"))
     {
         start_time.setDate(QDate::fromString(buffer, "dd.MM.yy").addYears(100));
     }
-    else if (qName == "Einheit")
+    else if (qName == QLatin1String("Einheit"))
     {
         imperial = (buffer == "mph");
     }
-    else if (qName == "Uhrzeit")
+    else if (qName == QLatin1String("Uhrzeit"))
     {
         start_time.setTime(QTime::fromString(buffer, "hh:mm"));
 	rideFile->setStartTime(start_time);
     }
-    else if (qName == "DurchschnittHR")
+    else if (qName == QLatin1String("DurchschnittHR"))
     {
         QMap<QString, QString> avg_hr;
         avg_hr.insert("value", buffer);
         rideFile->metricOverrides.insert("average_hr", avg_hr);
     }
-    else if (qName == "MaximalHR")
+    else if (qName == QLatin1String("MaximalHR"))
     {
         QMap<QString, QString> max_hr;
         max_hr.insert("value", buffer);
         rideFile->metricOverrides.insert("max_heartrate", max_hr);
     }
-    else if (qName == "MinimalTemp")
+    else if (qName == QLatin1String("MinimalTemp"))
     {
         //min_temperature
     }
-    else if (qName == "MaximalTemp")
+    else if (qName == QLatin1String("MaximalTemp"))
     {
         //max_temperature
     }
-    else if (qName == "Kalorien")
+    else if (qName == QLatin1String("Kalorien"))
     {
         QMap<QString, QString> work;
         work.insert("value", QString("%1").arg(buffer.toDouble() / 0.239));
         rideFile->metricOverrides.insert("total_work", work);
     }
-    else if (qName == "Strecke")
+    else if (qName == QLatin1String("Strecke"))
     {
         double dist = buffer.toDouble();
         QMap<QString, QString> distance;
@@ -90,7 +102,7 @@ SmfParser::endElement( const QString&, const QString&, const QString& qName)
         distance.insert("value", QString("%1").arg(dist));
         rideFile->metricOverrides.insert("total_distance", distance);
     }
-    else if (qName == "Fahrzeit")
+    else if (qName == QLatin1String("Fahrzeit"))
     {
         QStringList durationParts;
         QMap<QString,QString> trm;
@@ -105,7 +117,7 @@ SmfParser::endElement( const QString&, const QString&, const QString& qName)
         rideFile->metricOverrides.insert("time_riding", trm);
         rideFile->setRecIntSecs(time_in_sec);
     }
-    else if (qName == "DurchGeschwindigkeit")
+    else if (qName == QLatin1String("DurchGeschwindigkeit"))
     {
         double avg = buffer.toDouble();
         QMap<QString, QString> avg_speed;
@@ -114,7 +126,7 @@ SmfParser::endElement( const QString&, const QString&, const QString& qName)
         avg_speed.insert("value", QString("%1").arg(avg));
         rideFile->metricOverrides.insert("average_speed", avg_speed);
     }
-    else if (qName == "MaxGeschwindigkeit")
+    else if (qName == QLatin1String("MaxGeschwindigkeit"))
     {
         double max = buffer.toDouble();
         QMap<QString, QString> max_speed;
@@ -123,19 +135,19 @@ SmfParser::endElement( const QString&, const QString&, const QString& qName)
         max_speed.insert("value", QString("%1").arg(max));
         rideFile->metricOverrides.insert("max_speed", max_speed);
     }
-    else if (qName == "DurchTrittfrequenz")
+    else if (qName == QLatin1String("DurchTrittfrequenz"))
     {
         QMap<QString, QString> avg_cad;
         avg_cad.insert("value", buffer);
         rideFile->metricOverrides.insert("average_cad", avg_cad);
     }
-    else if (qName == "MaxTrittfrequenz")
+    else if (qName == QLatin1String("MaxTrittfrequenz"))
     {
         QMap<QString, QString> max_cad;
         max_cad.insert("value", buffer);
         rideFile->metricOverrides.insert("max_cad", max_cad);
     }
-    else if (qName == "HoehenMeterBergauf")
+    else if (qName == QLatin1String("HoehenMeterBergauf"))
     {
         double g = buffer.toDouble();
         QMap<QString, QString> gain;
@@ -144,11 +156,4 @@ SmfParser::endElement( const QString&, const QString&, const QString& qName)
         gain.insert("value", QString("%1").arg(g));
         rideFile->metricOverrides.insert("elevation_gain", gain);
     }
-    return true;
-}
-
-bool SmfParser::characters( const QString& str )
-{
-    buffer += str;
-    return true;
 }
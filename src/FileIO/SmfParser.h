@@ -22,21 +22,20 @@
 #include "RideFile.h"
 #include <QString>
 #include <QDateTime>
-#include <QXmlDefaultHandler>
+#include <QXmlStreamReader>
 
-class SmfParser : public QXmlDefaultHandler
+class SmfParser
 {
 public:
     SmfParser(RideFile* rideFile);
 
-    bool startElement( const QString&, const QString&, const QString&,
-		       const QXmlAttributes& );
-    bool endElement( const QString&, const QString&, const QString& );
-
-    bool characters( const QString& );
+    // pull the whole file through, false if it wasn't well formed
+    bool parse(QIODevice &device);
 
 private:
 
+    void endElement(const QStringRef &qName);
+
     RideFile*	rideFile;
 
     QString	buffer;
@@ -25,17 +25,18 @@ static int smfFileReaderRegistered =
 
 RideFile *SmfFileReader::openRideFile(QFile &file, QStringList &errors, QList<RideFile*>*) const
 {
-    (void) errors;
+    if (!file.open(QIODevice::ReadOnly)) {
+        errors << "Could not open file.";
+        return NULL;
+    }
+
     RideFile *rideFile = new RideFile();
     rideFile->setDeviceType("Sigma ROX Memory");
     rideFile->setFileFormat("Sigma Memory File (smf)");
 
     SmfParser handler(rideFile);
-
-    QXmlInputSource source (&file);
-    QXmlSimpleReader reader;
-    reader.setContentHandler (&handler);
-    reader.parse (source);
+    handler.parse(file);
+    file.close();
 
     return rideFile;
 }
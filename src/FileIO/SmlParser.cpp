@@ -60,20 +60,43 @@ SmlParser::SmlParser(RideFile* rideFile) : rideFile(rideFile)
 }
 
 bool
-SmlParser::startElement(const QString&, const QString&,
-                        const QString& qName,
-                        const QXmlAttributes&)
+SmlParser::parse(QIODevice &device)
 {
-    buffer.clear();
+    QXmlStreamReader xml(&device);
+    xml.setNamespaceProcessing(false);
+
+    while (!xml.atEnd()) {
+        switch (xml.readNext()) {
+        case QXmlStreamReader::StartElement:
+            startElement(xml);
+            break;
+        case QXmlStreamReader::EndElement:
+            endElement(xml.qualifiedName());
+            break;
+        case QXmlStreamReader::Characters:
+            buffer.append(xml.text());
+            break;
+        default:
+            break;
+        }
+    }
+    return !xml.hasError();
+}
+
+void
+SmlParser::startElement(QXmlStreamReader &xml)
+{
+    QStringRef qName = xml.qualifiedName();
+    buffer.resize(0);
 
     if(header)
-        return true;
+        return;
 
-    if(qName == "Header")
+    if(qName == QLatin1String("Header"))
     {
         header = true;
     }
-    else if(qName == "Sample")
+    else if(qName == QLatin1String("Sample"))
     {
         cad = 0;
         speed = 0;
@@ -85,7 +108,6 @@ SmlParser::startElement(const QString&, const QString&,
         periodic = false;
         swimming = false;
     }
-    return true;
 }
 
 #define PI 3.14159265
@@ -99,20 +121,20 @@ inline double toDegrees(double radians)
     return radians * 180.0 / PI;
 }
 
-bool
-SmlParser::endElement(const QString&, const QString&, const QString& qName)
+void
+SmlParser::endElement(const QStringRef &qName)
 {
-    if(qName == "Header")
+    if(qName == QLatin1String("Header"))
     {
         header = false;
     }
     else if(header == true)
     {
-        if (qName == "DateTime")
+        if (qName == QLatin1String("DateTime"))
         {
             rideFile->setStartTime(convertToLocalTime(buffer));
         }
-        else if (qName == "Activity")
+        else if (qName == QLatin1String("Activity"))
         {
             if (buffer.contains("Biking", Qt::CaseInsensitive))
                 rideFile->setTag("Sport", "Bike");
@@ -121,67 +143,67 @@ SmlParser::endElement(const QString&, const QString&, const QString& qName)
             else if (buffer.contains("Swimming", Qt::CaseInsensitive))
                 rideFile->setTag("Sport", "Swim");
         }
-        else if (qName == "PoolLength")
+        else if (qName == QLatin1String("PoolLength"))
         {
             rideFile->setTag("Pool Length", buffer);
             rideFile->setTag("Sport", "Swim"); // Just in case Activity was renamed
         }
-        return true;
+        return;
     }
-    else if (qName == "Lap")
+    else if (qName == QLatin1String("Lap"))
     {
         lap++;
     }
-    else if (qName == "Time")
+    else if (qName == QLatin1String("Time"))
     {
         time = buffer.toDouble();
     }
-    else if (qName == "Latitude")
+    else if (qName == QLatin1String("Latitude"))
     {
         lat = toDegrees(buffer.toDouble());  // lat comes in radians
     }
-    else if (qName == "Longitude")
+    else if (qName == QLatin1String("Longitude"))
     {
         lon = toDegrees(buffer.toDouble());  // lat comes in radians
     }
-    else if (qName == "Altitude")
+    else if (qName == QLatin1String("Altitude"))
     {
         alt = buffer.toDouble();  // metric
     }
-    else if (qName == "HR")
+    else if (qName == QLatin1String("HR"))
     {
         hr = round(buffer.toDouble()*60.0); // HR comes per sec
     }
-    else if (qName == "Temperature")
+    else if (qName == QLatin1String("Temperature"))
     {
         temp = buffer.toDouble()-273.0; // Temperature comes in Kelvin unit
     }
-    else if (qName == "Cadence")
+    else if (qName == QLatin1String("Cadence"))
     {
         cad = round(buffer.toDouble()*60.0); // Cadence comes in per sec
     }
-    else if (qName == "Speed")
+    else if (qName == QLatin1String("Speed"))
     {
         speed = buffer.toDouble()*3.6; // Speed comes in m/s
     }
-    else if (qName == "Distance")
+    else if (qName == QLatin1String("Distance"))
     {
         distance = buffer.toDouble()/1000.0; // Distance comes in meters
     }
-    else if (qName == "BikePower")
+    else if (qName == QLatin1String("BikePower"))
     {
         watts = buffer.toDouble();
     }
-    else if (qName == "SampleType")
+    else if (qName == QLatin1String("SampleType"))
     {
         periodic = (buffer == "periodic");
         swimming = (buffer == "swimming");
     }
-    else if (qName == "Type")
+    else if (qName == QLatin1String("Type"))
     {
         if (buffer == "Stroke") strokes++;
     }
-    else if (qName == "PrevPoolLengthStyle")
+    else if (qName == QLatin1String("PrevPoolLengthStyle"))
     {
         // style is coded to be compatible with FIT files
         if (buffer == "Freestyle") style = 0;
@@ -193,7 +215,7 @@ SmlParser::endElement(const QString&, const QString&, const QString& qName)
     }
 
 
-    else if (qName == "Sample")
+    else if (qName == QLatin1String("Sample"))
     {
         if(time == 0 && periodic)
         {
@@ -206,7 +228,7 @@ SmlParser::endElement(const QString&, const QString&, const QString& qName)
                                   0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
                                   0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
                                   0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, lap);
-            return true;
+            return;
         }
 
         if (distance > 0 && speed == 0)
@@ -301,7 +323,7 @@ SmlParser::endElement(const QString&, const QString&, const QString& qName)
         }
     }
 
-    else if (qName == "Data")
+    else if (qName == QLatin1String("Data"))
     {   // R-R data: store in XData, when no HR in samples backfill
         // using EWMA filtered R-R
         double secs = 0.0;
@@ -335,7 +357,7 @@ SmlParser::endElement(const QString&, const QString&, const QString& qName)
             delete hrvXdata;
     }
 
-    else if (qName == "Samples")
+    else if (qName == QLatin1String("Samples"))
     {
         if (SMLdebug) qDebug()<<"Swim XData records"<<swimXdata->datapoints.count();
         // Add length-by-length Swim XData, if present
@@ -344,13 +366,4 @@ SmlParser::endElement(const QString&, const QString&, const QString& qName)
         else
             delete swimXdata;
     }
-
-    return true;
-}
-
-bool
-SmlParser::characters(const QString& str)
-{
-    buffer += str;
-    return true;
 }
@@ -29,18 +29,19 @@ static int smlFileReaderRegistered =
 
 RideFile *SmlFileReader::openRideFile(QFile &file, QStringList &errors, QList<RideFile*>*) const
 {
-    (void) errors;
+    if (!file.open(QIODevice::ReadOnly)) {
+        errors << "Could not open file.";
+        return NULL;
+    }
+
     RideFile *rideFile = new RideFile();
     rideFile->setRecIntSecs(1.0);
     rideFile->setDeviceType("Suunto");
     rideFile->setFileFormat("Suunto Markup Language Format (sml)");
 
     SmlParser handler(rideFile);
-
-    QXmlInputSource source (&file);
-    QXmlSimpleReader reader;
-    reader.setContentHandler (&handler);
-    reader.parse (source);
+    handler.parse(file);
+    file.close();
 
     return rideFile;
 }
@@ -24,27 +24,29 @@
 #include "RideFile.h"
 #include <QString>
 #include <QDateTime>
-#include <QXmlDefaultHandler>
+#include <QXmlStreamReader>
 #include "Settings.h"
 #include "locale.h" // for LC_LOCALE definition used in strtod
 
-class TcxParser : public QXmlDefaultHandler
+class TcxParser
 {
 
 public:
 
     TcxParser(RideFile* rideFile, QList<RideFile*>*rides);
 
-    bool startElement( const QString&, const QString&, const QString&, const QXmlAttributes& );
-    bool endElement( const QString&, const QString&, const QString& );
-    bool characters( const QString& );
+    // pull the whole file through, false if it wasn't well formed
+    bool parse(QIODevice &device);
 
     RideFile*	rideFile;
     QList<RideFile*> *rides; // when parsed multiple rides
 
 private:
 
-    QString	buffer;
+    void startElement(QXmlStreamReader &xml);
+    void endElement(const QStringRef &qName);
+
+    QString	buffer; // reused, keeps its capacity between elements
     QVariant isGarminSmartRecording;
     QVariant GarminHWM;
 
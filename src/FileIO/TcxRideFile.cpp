@@ -19,7 +19,8 @@
 
 #include "TcxRideFile.h"
 #include "TcxParser.h"
-#include <QDomDocument>
+#include <QXmlStreamWriter>
+#include <QBuffer>
 
 #include "Context.h"
 #include "Athlete.h"
@@ -36,18 +37,20 @@ static int tcxFileReaderRegistered =
 
 RideFile *TcxFileReader::openRideFile(QFile &file, QStringList &errors, QList<RideFile*>*list) const
 {
-    (void) errors;
+    if (!file.open(QIODevice::ReadOnly)) {
+        errors << "Could not open file.";
+        return NULL;
+    }
+
     RideFile *rideFile = new RideFile();
     rideFile->setRecIntSecs(1.0);
     rideFile->setDeviceType("Garmin");
     rideFile->setFileFormat("Garmin Training Centre (tcx)");
 
+    // like the SAX reader before it, a truncated file keeps what was read
     TcxParser handler(rideFile, list);
-
-    QXmlInputSource source (&file);
-    QXmlSimpleReader reader;
-    reader.setContentHandler (&handler);
-    reader.parse (source);
+    handler.parse(file);
+    file.close();
 
     return rideFile;
 }
@@ -55,17 +58,28 @@ RideFile *TcxFileReader::openRideFile(QFile &file, QStringList &errors, QList<Ri
 QByteArray
 TcxFileReader::toByteArray(Context *context, const RideFile *ride, bool withAlt, bool withWatts, bool withHr, bool withCad) const
 {
-    QDomText text;
-    QDomDocument doc;
-    QDomProcessingInstruction hdr = doc.createProcessingInstruction("xml","version=\"1.0\"");
-    doc.appendChild(hdr);
+    QByteArray returning;
+    QBuffer buffer(&returning);
+    buffer.open(QIODevice::WriteOnly);
+    QXmlStreamWriter xml(&buffer);
+    xml.setCodec("UTF-8");
+    xml.setAutoFormatting(true);
+    xml.setAutoFormattingIndent(4);
+    writeDocument(xml, context, ride, withAlt, withWatts, withHr, withCad);
+    return returning;
+}
+
+void
+TcxFileReader::writeDocument(QXmlStreamWriter &xml, Context *context, const RideFile *ride, bool withAlt, bool withWatts, bool withHr, bool withCad) const
+{
+    xml.writeStartDocument();
 
     // pwx
-    QDomElement tcx = doc.createElementNS("http://www.garmin.com/xmlschemas/TrainingCenterDatabase/v2", "TrainingCenterDatabase");
-    tcx.setAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-    tcx.setAttribute("xsi:schemaLocation", "http://www.garmin.com/xmlschemas/ActivityExtension/v2 http://www.garmin.com/xmlschemas/ActivityExtensionv2.xsd http://www.garmin.com/xmlschemas/TrainingCenterDatabase/v2 http://www.garmin.com/xmlschemas/TrainingCenterDatabasev2.xsd");
-    //tcx.setAttribute("version", "2.0");
-    doc.appendChild(tcx);
+    xml.writeStartElement("TrainingCenterDatabase");
+    xml.writeAttribute("xmlns", "http://www.garmin.com/xmlschemas/TrainingCenterDatabase/v2");
+    xml.writeAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
+    xml.writeAttribute("xsi:schemaLocation", "http://www.garmin.com/xmlschemas/ActivityExtension/v2 http://www.garmin.com/xmlschemas/ActivityExtensionv2.xsd http://www.garmin.com/xmlschemas/TrainingCenterDatabase/v2 http://www.garmin.com/xmlschemas/TrainingCenterDatabasev2.xsd");
+    //xml.writeAttribute("version", "2.0");
 
     // activities, we just serialise one ride
     QString sport = ride->getTag("Sport", "Biking");
@@ -76,70 +90,40 @@ TcxFileReader::toByteArray(Context *context, const RideFile *ride, bool withAlt,
     } else {
         sport = "Other";
     }
-    QDomElement activities = doc.createElement("Activities");
-    tcx.appendChild(activities);
-    QDomElement activity = doc.createElement("Activity");
-    activity.setAttribute("Sport", sport); // was ride->getTag("Sport", "Biking") but must be Biking, Running or Other
-    activities.appendChild(activity);
+    xml.writeStartElement("Activities");
+    xml.writeStartElement("Activity");
+    xml.writeAttribute("Sport", sport); // was ride->getTag("Sport", "Biking") but must be Biking, Running or Other
 
     // time
-    QDomElement id = doc.createElement("Id");
-    text = doc.createTextNode(ride->startTime().toUTC().toString(Qt::ISODate));
-    id.appendChild(text);
-    activity.appendChild(id);
+    xml.writeTextElement("Id", ride->startTime().toUTC().toString(Qt::ISODate));
 
     // notes if present
     if (ride->getTag("Notes","") != "") {
-        QDomElement notes = doc.createElement("Notes");
-        text = doc.createTextNode(ride->getTag("Notes",""));
-        notes.appendChild(text);
-        activity.appendChild(notes);
+        xml.writeTextElement("Notes", ride->getTag("Notes",""));
     }
 
     // always create as Garmin TCX (to allow import into other programs)
     // exception is "Zwift" - since some programs (e.g. Strava) interpret that as "virtual ride"
     // so let them still have the chance to identify a ride coming from Zwift
-    QDomElement creator = doc.createElement("Creator");
-    creator.setAttribute("xsi:type", "Device_t");
-    QDomElement creatorName = doc.createElement("Name");
+    xml.writeStartElement("Creator");
+    xml.writeAttribute("xsi:type", "Device_t");
     if (ride->deviceType().toLower().contains("zwift") ) {
-        text = doc.createTextNode("Zwift");
+        xml.writeTextElement("Name", "Zwift");
     } else {
-        text = doc.createTextNode("Garmin TCX");
+        xml.writeTextElement("Name", "Garmin TCX");
     }
-    creatorName.appendChild(text);
-    creator.appendChild(creatorName);
-    QDomElement unitid = doc.createElement("UnitId");
-    text = doc.createTextNode ("0");
-    unitid.appendChild(text);
-    creator.appendChild(unitid);
-    QDomElement productid = doc.createElement("ProductId");
-    text = doc.createTextNode ("20119");
-    productid.appendChild(text);
-    creator.appendChild(productid);
-    QDomElement version = doc.createElement("Version");
-    QDomElement versionMajor = doc.createElement("VersionMajor");
-    text = doc.createTextNode ("0");
-    versionMajor.appendChild(text);
-    version.appendChild(versionMajor);
-    QDomElement versionMinor = doc.createElement("VersionMinor");
-    text = doc.createTextNode ("0");
-    versionMinor.appendChild(text);
-    version.appendChild(versionMinor);
-    QDomElement buildMajor = doc.createElement("BuildMajor");
-    text = doc.createTextNode ("0");
-    buildMajor.appendChild(text);
-    version.appendChild(buildMajor);
-    QDomElement buildMinor = doc.createElement("BuildMinor");
-    text = doc.createTextNode ("0");
-    buildMinor.appendChild(text);
-    version.appendChild(buildMinor);
-    creator.appendChild(version);
-    activity.appendChild(creator);
-
-    QDomElement lap = doc.createElement("Lap");
-    lap.setAttribute("StartTime", ride->startTime().toUTC().toString(Qt::ISODate));
-    activity.appendChild(lap);
+    xml.writeTextElement("UnitId", "0");
+    xml.writeTextElement("ProductId", "20119");
+    xml.writeStartElement("Version");
+    xml.writeTextElement("VersionMajor", "0");
+    xml.writeTextElement("VersionMinor", "0");
+    xml.writeTextElement("BuildMajor", "0");
+    xml.writeTextElement("BuildMinor", "0");
+    xml.writeEndElement(); // Version
+    xml.writeEndElement(); // Creator
+
+    xml.writeStartElement("Lap");
+    xml.writeAttribute("StartTime", ride->startTime().toUTC().toString(Qt::ISODate));
 
     const char *metrics[] = {
         "total_distance",
@@ -163,108 +147,67 @@ TcxFileReader::toByteArray(Context *context, const RideFile *ride, bool withAlt,
         RideItem *tempItem = new RideItem(const_cast<RideFile*>(ride), context);
         QHash<QString,RideMetricPtr> computed = RideMetric::computeMetrics(tempItem, Specification(), worklist);
 
-        QDomElement lap_time = doc.createElement("TotalTimeSeconds");
-        text = doc.createTextNode(QString("%1").arg(computed.value("workout_time")->value(true)));
-        //text = doc.createTextNode(ride->dataPoints().last()->secs);
-        lap_time.appendChild(text);
-        lap.appendChild(lap_time);
+        xml.writeTextElement("TotalTimeSeconds", QString("%1").arg(computed.value("workout_time")->value(true)));
+        //xml.writeTextElement("TotalTimeSeconds", ride->dataPoints().last()->secs);
 
-        QDomElement lap_distance = doc.createElement("DistanceMeters");
-        text = doc.createTextNode(QString("%1").arg(1000*computed.value("total_distance")->value(true)));
-        //text = doc.createTextNode(ride->dataPoints().last()->km);
-        lap_distance.appendChild(text);
-        lap.appendChild(lap_distance);
+        xml.writeTextElement("DistanceMeters", QString("%1").arg(1000*computed.value("total_distance")->value(true)));
+        //xml.writeTextElement("DistanceMeters", ride->dataPoints().last()->km);
 
-        QDomElement max_speed = doc.createElement("MaximumSpeed");
-        text = doc.createTextNode(QString("%1")
+        xml.writeTextElement("MaximumSpeed", QString("%1")
             .arg(computed.value("max_speed")->value(true) / 3.6));
-        max_speed.appendChild(text);
-        lap.appendChild(max_speed);
 
-        QDomElement lap_calories = doc.createElement("Calories");
-        text = doc.createTextNode(QString("%1").arg((int)computed.value("total_work")->value(true)));
-        lap_calories.appendChild(text);
-        lap.appendChild(lap_calories);
+        xml.writeTextElement("Calories", QString("%1").arg((int)computed.value("total_work")->value(true)));
 
         // optional per XSD, so only generate them if the data is to be exported and is present
         if (withHr && ride->areDataPresent()->hr)
         {
-            QDomElement avg_heartrate = doc.createElement("AverageHeartRateBpm");
-            QDomElement value = doc.createElement("Value");
-            text = doc.createTextNode(QString("%1").arg((int)computed.value("average_hr")->value(true)));
-            value.appendChild(text);
-            avg_heartrate.appendChild(value);
-            lap.appendChild(avg_heartrate);
-
-            QDomElement max_heartrate = doc.createElement("MaximumHeartRateBpm");
-            value = doc.createElement("Value");
-            text = doc.createTextNode(QString("%1").arg((int)computed.value("max_heartrate")->value(true)));
-            value.appendChild(text);
-            max_heartrate.appendChild(value);
-            lap.appendChild(max_heartrate);
-        }
+            xml.writeStartElement("AverageHeartRateBpm");
+            xml.writeTextElement("Value", QString("%1").arg((int)computed.value("average_hr")->value(true)));
+            xml.writeEndElement();
 
-        QDomElement lap_intensity = doc.createElement("Intensity");
-        text = doc.createTextNode("Active");
-        lap_intensity.appendChild(text);
-        lap.appendChild(lap_intensity);
+            xml.writeStartElement("MaximumHeartRateBpm");
+            xml.writeTextElement("Value", QString("%1").arg((int)computed.value("max_heartrate")->value(true)));
+            xml.writeEndElement();
+        }
 
-        QDomElement lap_triggerMethod = doc.createElement("TriggerMethod");
-        text = doc.createTextNode("Manual");
-        lap_triggerMethod.appendChild(text);
-        lap.appendChild(lap_triggerMethod);
+        xml.writeTextElement("Intensity", "Active");
+        xml.writeTextElement("TriggerMethod", "Manual");
     }
 
     // samples
     // data points: timeoffset, dist, hr, spd, pwr, torq, cad, lat, lon, alt
     if (!ride->dataPoints().empty()) {
-        QDomElement track = doc.createElement("Track");
-        lap.appendChild(track);
+        xml.writeStartElement("Track");
 
         foreach (const RideFilePoint *point, ride->dataPoints()) {
-            QDomElement trackpoint = doc.createElement("Trackpoint");
-            track.appendChild(trackpoint);
+            xml.writeStartElement("Trackpoint");
 
             // time
-            QDomElement time = doc.createElement("Time");
-            text = doc.createTextNode(ride->startTime().toUTC().addSecs(point->secs).toString(Qt::ISODate));
-            time.appendChild(text);
-            trackpoint.appendChild(time);
+            xml.writeTextElement("Time", ride->startTime().toUTC().addSecs(point->secs).toString(Qt::ISODate));
 
             // position
             if (ride->areDataPresent()->lat && point->lat > -90.0 && point->lat < 90.0 && point->lat != 0.0 &&
                 ride->areDataPresent()->lon && point->lon > -180.00 && point->lon < 180.00 && point->lon != 0.0 ) {
-                QDomElement position = doc.createElement("Position");
-                trackpoint.appendChild(position);
+                xml.writeStartElement("Position");
 
                 // lat
-                QDomElement lat = doc.createElement("LatitudeDegrees");
-                text = doc.createTextNode(QString("%1").arg(point->lat, 0, 'g', 11));
-                lat.appendChild(text);
-                position.appendChild(lat);
+                xml.writeTextElement("LatitudeDegrees", QString("%1").arg(point->lat, 0, 'g', 11));
 
                 // lon
-                QDomElement lon = doc.createElement("LongitudeDegrees");
-                text = doc.createTextNode(QString("%1").arg(point->lon, 0, 'g', 11));
-                lon.appendChild(text);
-                position.appendChild(lon);
+                xml.writeTextElement("LongitudeDegrees", QString("%1").arg(point->lon, 0, 'g', 11));
+
+                xml.writeEndElement(); // Position
             }
 
 
             // alt
             if (withAlt && ride->areDataPresent()->alt && point->alt != 0.0) {
-                QDomElement alt = doc.createElement("AltitudeMeters");
-                text = doc.createTextNode(QString("%1").arg(point->alt));
-                alt.appendChild(text);
-                trackpoint.appendChild(alt);
+                xml.writeTextElement("AltitudeMeters", QString("%1").arg(point->alt));
             }
 
             // distance - meters
             if (ride->areDataPresent()->km) {
-                QDomElement dist = doc.createElement("DistanceMeters");
-                text = doc.createTextNode(QString("%1").arg((point->km*1000)));
-                dist.appendChild(text);
-                trackpoint.appendChild(dist);
+                xml.writeTextElement("DistanceMeters", QString("%1").arg((point->km*1000)));
             }
 
             if (withHr && ride->areDataPresent()->hr)  {
@@ -277,46 +220,38 @@ TcxFileReader::toByteArray(Context *context, const RideFile *ride, bool withAlt,
                 if (ride->areDataPresent()->hr && point->hr >0.00) {
                     tHr = (int)point->hr;
                 }
-                QDomElement hr = doc.createElement("HeartRateBpm");
-                hr.setAttribute("xsi:type", "HeartRateInBeatsPerMinute_t");
-                QDomElement value = doc.createElement("Value");
-                text = doc.createTextNode(QString("%1").arg(tHr));
-                value.appendChild(text);
-                hr.appendChild(value);
-                trackpoint.appendChild(hr);
+                xml.writeStartElement("HeartRateBpm");
+                xml.writeAttribute("xsi:type", "HeartRateInBeatsPerMinute_t");
+                xml.writeTextElement("Value", QString("%1").arg(tHr));
+                xml.writeEndElement();
             }
 
             // cad
             if (withCad && ride->areDataPresent()->cad && point->cad < 255) { //xsd maxInclusive value="254"
-                QDomElement cad = doc.createElement("Cadence");
-                text = doc.createTextNode(QString("%1").arg((int)(point->cad)));
-                cad.appendChild(text);
-                trackpoint.appendChild(cad);
+                xml.writeTextElement("Cadence", QString("%1").arg((int)(point->cad)));
             }
 
             if (ride->areDataPresent()->kph || ride->areDataPresent()->watts) {
-                QDomElement extension = doc.createElement("Extensions");
-                trackpoint.appendChild(extension);
-                QDomElement tpx = doc.createElement("TPX");
-                tpx.setAttribute("xmlns", "http://www.garmin.com/xmlschemas/ActivityExtension/v2");
-                extension.appendChild(tpx);
+                xml.writeStartElement("Extensions");
+                xml.writeStartElement("TPX");
+                xml.writeAttribute("xmlns", "http://www.garmin.com/xmlschemas/ActivityExtension/v2");
 
                 // spd - meters per second
                 if (ride->areDataPresent()->kph) {
-                    QDomElement spd = doc.createElement("Speed");
-                    text = doc.createTextNode(QString("%1").arg(point->kph / 3.6));
-                    spd.appendChild(text);
-                    tpx.appendChild(spd);
+                    xml.writeTextElement("Speed", QString("%1").arg(point->kph / 3.6));
                 }
                 // pwr
                 if (withWatts && ride->areDataPresent()->watts) {
-                    QDomElement pwr = doc.createElement("Watts");
-                    text = doc.createTextNode(QString("%1").arg((int)point->watts));
-                    pwr.appendChild(text);
-                    tpx.appendChild(pwr);
+                    xml.writeTextElement("Watts", QString("%1").arg((int)point->watts));
                 }
+                xml.writeEndElement(); // TPX
+                xml.writeEndElement(); // Extensions
             }
+
+            xml.writeEndElement(); // Trackpoint
         }
+
+        xml.writeEndElement(); // Track
     }
 
 #if 0 // REFACTOR METRICS
@@ -461,21 +396,35 @@ TcxFileReader::toByteArray(Context *context, const RideFile *ride, bool withAlt,
     }
 #endif
 
-    return doc.toByteArray(4);
+    xml.writeEndElement(); // Lap
+    xml.writeEndElement(); // Activity
+    xml.writeEndElement(); // Activities
+    xml.writeEndElement(); // TrainingCenterDatabase
+    xml.writeEndDocument();
 }
 
 bool
 TcxFileReader::writeRideFile(Context *context, const RideFile *ride, QFile &file) const
 {
-    QByteArray xml = toByteArray(context, ride, true, true, true, true);
-
     if (!file.open(QIODevice::WriteOnly)) return(false);
     file.resize(0);
-    QTextStream out(&file);
-    out.setCodec("UTF-8");
-    out.setGenerateByteOrderMark(true);
-    out << xml;
-    out.flush();
+    bool success = writeRideStream(context, ride, file);
     file.close();
-    return(true);
+    return(success);
+}
+
+bool
+TcxFileReader::writeRideStream(Context *context, const RideFile *ride, QIODevice &device) const
+{
+    if (!device.isWritable()) return(false);
+
+    // written straight to the device a sample at a time, there is
+    // no copy of the document in memory
+    device.write("\xEF\xBB\xBF"); // UTF-8 byte order mark
+    QXmlStreamWriter xml(&device);
+    xml.setCodec("UTF-8");
+    xml.setAutoFormatting(true);
+    xml.setAutoFormattingIndent(4);
+    writeDocument(xml, context, ride, true, true, true, true);
+    return(!xml.hasError());
 }
@@ -22,6 +22,7 @@
 #include "GoldenCheetah.h"
 
 #include "RideFile.h"
+#include <QXmlStreamWriter>
 
 class TcxFileReader : public RideFileReader {
     Q_DECLARE_TR_FUNCTIONS(TcxFileReader)
@@ -29,7 +30,9 @@ class TcxFileReader : public RideFileReader {
 
     virtual RideFile *openRideFile(QFile &file, QStringList &errors, QList<RideFile*>* = 0) const; 
     QByteArray toByteArray(Context *context, const RideFile *ride, bool withAlt, bool withWatts, bool withHr, bool withCad) const;
+    void writeDocument(QXmlStreamWriter &xml, Context *context, const RideFile *ride, bool withAlt, bool withWatts, bool withHr, bool withCad) const;
     bool writeRideFile(Context *context, const RideFile *ride, QFile &file) const;
+    bool writeRideStream(Context *context, const RideFile *ride, QIODevice &device) const;
     bool hasWrite() const { return true; }
 };
 
@@ -849,7 +849,8 @@ AnalysisSidebar::deleteRoute()
         context->athlete->routes->deleteRoute(activeInterval->route);
         activeInterval = NULL; // it goes below.
 
-        // the fingerprint for routes has changed, refresh is inevitable sadly
+        // the fingerprint for routes has changed, route intervals
+        // are searched for again but the metrics are left alone
         context->athlete->rideCache->refresh();
     }
 }
@@ -872,8 +873,8 @@ AnalysisSidebar::editRoute()
                 // find the interval?
                 foreach(IntervalItem *interval, ride->intervals(RideFileInterval::ROUTE)) {
                     if (interval->route == activeInterval->route) {
-                        //Make stale
-                        ride->isstale = true;
+                        // search again to pick up the new name
+                        ride->routestale = true;
                     }
                 }
             }
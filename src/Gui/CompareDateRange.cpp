@@ -27,22 +27,10 @@ RideFileCache *
 CompareDateRange::rideFileCache()
 {
     // refresh cache if incomplete, return otherwise
-    if (cache) {
-        if (cache->incomplete == false) return cache;
-        else {
-            delete cache;
-            cache = NULL;
-        }
-    }
+    if (cache && cache->incomplete == false) return cache.data();
 
-    // create one and set        
-    return (cache = new RideFileCache(sourceContext, start, end, false, QStringList(), true));
-}
-
-CompareDateRange::~CompareDateRange()
-{
-    if (cache) {
-        //XXX need to reference count! delete cache;
-        cache = NULL;
-    }
+    // create one and set, aggregates already read come from
+    // the shared store so this is cheap if prefetched
+    cache = QSharedPointer<RideFileCache>(new RideFileCache(sourceContext, start, end, false, QStringList(), true));
+    return cache.data();
 }
@@ -27,12 +27,12 @@ class RideFileCache;
 #include <QColor>
 #include <QDate>
 #include <QString>
+#include <QSharedPointer>
 
 class CompareDateRange
 {
     public:
-        CompareDateRange() : context(NULL), days(0), sourceContext(NULL), checked(false), cache(NULL) {}
-        ~CompareDateRange();
+        CompareDateRange() : context(NULL), days(0), sourceContext(NULL), checked(false) {}
 
         Context *context;
         QString name;
@@ -49,7 +49,8 @@ class CompareDateRange
         RideFileCache *rideFileCache();
 
     private:
-        RideFileCache *cache;
+        // shared by the copies charts take of the list
+        QSharedPointer<RideFileCache> cache;
 };
 
 #endif
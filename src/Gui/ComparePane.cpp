@@ -1030,6 +1030,10 @@ ComparePane::dropEvent(QDropEvent *event)
 
             context->compareDateRanges.append(newOnes);
 
+            // start reading them whilst the charts get going
+            foreach(CompareDateRange range, newOnes)
+                RideFileCache::prefetch(range.sourceContext, range.start, range.end);
+
             // refresh the table to reflect the new list
             refreshTable();
 
@@ -393,6 +393,7 @@ MainWindow::MainWindow(const QDir &home)
     connect(backupAthleteMenu, SIGNAL(aboutToShow()), this, SLOT(setBackupAthleteMenu()));
     backupMapper = new QSignalMapper(this); // maps each option
     connect(backupMapper, SIGNAL(mapped(const QString &)), this, SLOT(backupAthlete(const QString &)));
+    fileMenu->addAction(tr("Restore Athlete Backup..."), this, SLOT(restoreAthlete()));
 
     fileMenu->addSeparator();
     fileMenu->addAction(tr("Save all modified activities"), this, SLOT(saveAllUnsavedRides()));
@@ -1864,6 +1865,12 @@ MainWindow::backupAthlete(QString name)
     delete backup;
 }
 
+void
+MainWindow::restoreAthlete()
+{
+    AthleteBackup::restoreImmediate();
+}
+
 void
 MainWindow::saveGCState(Context *context)
 {
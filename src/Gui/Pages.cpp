@@ -912,6 +912,8 @@ BackupPage::BackupPage(Context *context) : context(context)
     backupInput->addWidget(autoBackupPeriod);
     //backupInput->addStretch();
     backupInput->addWidget(autoBackupUnitLabel);
+    autoBackupIncremental = new QCheckBox(tr("Only backup new and changed files"), this);
+    autoBackupIncremental->setChecked(appsettings->cvalue(context->athlete->cyclist, GC_AUTOBACKUP_INCREMENTAL, false).toBool());
 
     Qt::Alignment alignment = Qt::AlignLeft|Qt::AlignVCenter;
 
@@ -920,6 +922,7 @@ BackupPage::BackupPage(Context *context) : context(context)
     grid->addWidget(autoBackupFolderBrowse, 7, 2, alignment);
     grid->addWidget(autoBackupPeriodLabel, 8, 0,alignment);
     grid->addLayout(backupInput, 8, 1, alignment);
+    grid->addWidget(autoBackupIncremental, 9, 1, alignment);
 
     all->addLayout(grid);
     all->addStretch();
@@ -942,6 +945,7 @@ BackupPage::saveClicked()
     // Auto Backup
     appsettings->setCValue(context->athlete->cyclist, GC_AUTOBACKUP_FOLDER, autoBackupFolder->text());
     appsettings->setCValue(context->athlete->cyclist, GC_AUTOBACKUP_PERIOD, autoBackupPeriod->value());
+    appsettings->setCValue(context->athlete->cyclist, GC_AUTOBACKUP_INCREMENTAL, autoBackupIncremental->isChecked());
     return 0;
 }
 
@@ -2082,11 +2086,24 @@ TrainOptionsPage::TrainOptionsPage(QWidget *parent, Context *context) : QWidget(
     lapAlert = new QCheckBox(tr("Play sound before new lap"), this);
     lapAlert->setChecked(appsettings->value(this, TRAIN_LAPALERT, false).toBool());
 
+    // how often devices that support it are read from the acquisition thread,
+    // the rings hold 256 samples so 50Hz still rides out a 5s gui stall
+    sampleRate = new QSpinBox(this);
+    sampleRate->setRange(1, 50);
+    sampleRate->setSuffix(tr(" Hz"));
+    sampleRate->setValue(appsettings->value(this, TRAIN_SAMPLERATE, 5).toInt());
+
+    QHBoxLayout *rate = new QHBoxLayout;
+    rate->addWidget(new QLabel(tr("Device sample rate"), this));
+    rate->addWidget(sampleRate);
+    rate->addStretch();
+
     QVBoxLayout *all = new QVBoxLayout(this);
     all->addWidget(multiCheck);
     all->addWidget(autoConnect);
     all->addWidget(autoHide);
     all->addWidget(lapAlert);
+    all->addLayout(rate);
     all->addStretch();
 }
 
@@ -2099,6 +2116,7 @@ TrainOptionsPage::saveClicked()
     appsettings->setValue(TRAIN_AUTOCONNECT, autoConnect->isChecked());
     appsettings->setValue(TRAIN_AUTOHIDE, autoHide->isChecked());
     appsettings->setValue(TRAIN_LAPALERT, lapAlert->isChecked());
+    appsettings->setValue(TRAIN_SAMPLERATE, sampleRate->value());
 
     return 0;
 }
@@ -342,6 +342,7 @@ class BackupPage : public QWidget
         QSpinBox *autoBackupPeriod;
         QLineEdit *autoBackupFolder;
         QPushButton *autoBackupFolderBrowse;
+        QCheckBox *autoBackupIncremental;
 
     private slots:
 
@@ -456,6 +457,7 @@ class TrainOptionsPage : public QWidget
         QCheckBox   *autoConnect;
         QCheckBox   *autoHide;
         QCheckBox   *lapAlert;
+        QSpinBox    *sampleRate;
 };
 
 class RemotePage : public QWidget
@@ -1394,8 +1394,17 @@ RideNavigatorSortProxyModel::RideNavigatorSortProxyModel(QObject *parent) : QSor
 bool RideNavigatorSortProxyModel::lessThan(const QModelIndex &left,
                                            const QModelIndex &right) const
 {
-    QVariant leftData = sourceModel()->data(left);
-    QVariant rightData = sourceModel()->data(right);
+    // metrics and numeric fields come back as numbers
+    QVariant leftData = sourceModel()->data(left, RideCacheModel::SortRole);
+    QVariant rightData = sourceModel()->data(right, RideCacheModel::SortRole);
+
+    if (leftData.type() == QVariant::Double && rightData.type() == QVariant::Double) {
+        return leftData.toDouble() < rightData.toDouble();
+    }
+
+    // otherwise use what is displayed
+    leftData = sourceModel()->data(left);
+    rightData = sourceModel()->data(right);
 
     if (leftData.type() == QVariant::DateTime) {
         return leftData.toDateTime() < rightData.toDateTime();
@@ -38,6 +38,7 @@
 
 #include <QtGui>
 #include "RideNavigator.h"
+#include "RideCacheModel.h"
 #include "RideItem.h"
 #include "RideFile.h"
 
@@ -79,8 +80,14 @@ private:
 
     QMap<QString, QVector<int>*> groupToSourceRow;
     QVector<int> sourceRowToGroupRow;
+    QVector<int> sourceRowToGroup;
     QList<rankx> rankedRows;
 
+    // the group each source row is in, and for the columns
+    // we've grouped by since the source last changed
+    QStringList rowGroups;
+    QHash<int, QStringList> groupCache;
+
     void clearGroups() {
         // Wipe current
         QMapIterator<QString, QVector<int>*> i(groupToSourceRow);
@@ -92,7 +99,9 @@ private:
         groupIndexes.clear();
         groupToSourceRow.clear();
         sourceRowToGroupRow.clear();
+        sourceRowToGroup.clear();
         rankedRows.clear();
+        rowGroups.clear();
     }
 
     static bool initGroupRanges();
@@ -149,6 +158,7 @@ public:
 
         connect(model, SIGNAL(modelReset()), this, SLOT(sourceModelChanged()));
         connect(model, SIGNAL(dataChanged(QModelIndex, QModelIndex)), this, SIGNAL(dataChanged(QModelIndex, QModelIndex)));
+        connect(model, SIGNAL(dataChanged(QModelIndex, QModelIndex)), this, SLOT(sourceDataChanged()));
         connect(model, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(sourceModelChanged()));
         connect(model, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)), this, SLOT(sourceModelChanged()));
         connect(model, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(sourceModelChanged()));
@@ -197,17 +207,14 @@ public:
     QModelIndex mapFromSource(const QModelIndex &sourceIndex) const {
 
         // which group did we put this row into?
-        QString group = whichGroup(sourceIndex.row());
-        int groupNo = groups.indexOf(group);
+        int row = sourceIndex.row();
+        int groupNo = (row >= 0 && row < sourceRowToGroup.size()) ? sourceRowToGroup[row] : -1;
 
-        if (groupNo < 0) {
+        if (groupNo < 0 || row >= sourceRowToGroupRow.size()) {
             return QModelIndex();
         } else {
-            QModelIndex *p = new QModelIndex(createIndex(groupNo, 0, (void*)NULL));
-            if (sourceIndex.row() > 0 && sourceIndex.row() < sourceRowToGroupRow.size())
-                return createIndex(sourceRowToGroupRow[sourceIndex.row()], sourceIndex.column()+2, &p); // accommodate virtual columns
-            else
-                return QModelIndex();
+            return createIndex(sourceRowToGroupRow[row], sourceIndex.column()+2, // accommodate virtual columns
+                               (void*)&groupIndexes[groupNo]);
         }
     }
 
@@ -516,12 +523,18 @@ public:
         // wipe whatever is there first
         clearGroups();
 
-        if (groupBy >= 0) {
+        if (groupBy >= 0 && groupCache.contains(groupBy)) {
 
-            // rank all the values
+            // grouped by this before and nothing has changed
+            rowGroups = groupCache.value(groupBy);
+
+        } else if (groupBy >= 0) {
+
+            // rank all the values, metrics are ranked by value
+            // rather than what we'd get parsing the display text
             for (int i=0; i<sourceModel()->rowCount(QModelIndex()); i++) {
                 rankx rank;
-                rank.value = sourceModel()->data(sourceModel()->index(i,groupBy)).toDouble();
+                rank.value = sourceModel()->data(sourceModel()->index(i,groupBy), RideCacheModel::SortRole).toDouble();
                 rank.row = i;
                 rankedRows << rank;
             }
@@ -535,12 +548,19 @@ public:
             // sort by row again
             qStableSort(rankedRows.begin(), rankedRows.end(), rankx::sortByRow);
 
+            // which group is each row in?
+            for (int i=0; i<sourceModel()->rowCount(QModelIndex()); i++)
+                rowGroups << whichGroup(i); // uses rankedRows
+            groupCache.insert(groupBy, rowGroups);
+        }
+
+        if (groupBy >= 0) {
 
             // create a QMap from 'group' string to list of rows in that group
-            for (int i=0; i<sourceModel()->rowCount(QModelIndex()); i++) {
+            for (int i=0; i<rowGroups.count(); i++) {
 
                 // which group are we in?
-                QString value = whichGroup(i); // uses rankedRows
+                QString value = rowGroups[i];
 
                 QVector<int> *rows;
                 if ((rows=groupToSourceRow.value(value,NULL)) == NULL) {
@@ -571,9 +591,11 @@ public:
 
         // Update list of groups
         int group=0;
+        sourceRowToGroup.fill(-1, sourceRowToGroupRow.count());
         QMapIterator<QString, QVector<int>*> j(groupToSourceRow);
         while (j.hasNext()) {
             j.next();
+            foreach(int row, *j.value()) sourceRowToGroup[row] = group;
             groups << j.key();
             groupIndexes << createIndex(group++,0,(void*)NULL);
         }
@@ -584,11 +606,18 @@ public:
 
 public slots:
 
+    void sourceDataChanged() {
+
+        // rides were refreshed, regroup from scratch next time
+        groupCache.clear();
+    }
+
     void sourceModelChanged() {
 
         // notify everyone we're changing
         beginResetModel();
 
+        groupCache.clear();
         clearGroups();
         setGroupBy(groupBy+2); // accommodate virtual columns
         setIndexes();
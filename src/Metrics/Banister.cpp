@@ -48,9 +48,9 @@
 #include <assert.h>
 #include <algorithm>
 #include <QVector>
-#include <QMutex>
 #include <QApplication>
-#include "lmcurve.h"
+#include <QtConcurrent>
+#include "lmcurve_user.h"
 
 // the mean athlete from opendata analysis
 const double typical_CP = 261,
@@ -436,25 +436,35 @@ Banister::refresh()
 double
 banisterFit::f(double d, const double *parms)
 {
-    if (k1 > parms[0] || k1 < parms[0] ||
-        k2 > parms[1] || k2 < parms[1] ||
-        p0 > parms[2] || p0 < parms[2]) {
-
-        // we'll keep the parameters passed
-        k1 = parms[0];
-        k2 = parms[1];
-        p0 = parms[2];
-        // we fixed t1/t2 (for now)
-        t1 = parent->t1;
-        t2 = parent->t2;
-
-        //printd("fit iter %s to %s [k1=%g k2=%g t1=%g t2=%g p0=%g]\n", startDate.toString().toStdString().c_str(), stopDate.toString().toStdString().c_str(), k1,k2,t1,t2,p0); // too much info even in debug, unless you want it
-        compute(startIndex, stopIndex);
-    }
+    // windows are fitted concurrently, so we only work from our own
+    // buffers and leave parent->data alone until they're all done
+    int index = int(d) - startIndex;
+    if (index < 0 || index >= g.count()) return parms[2];
 
-    // return previously computed
-    //printd("result perf(%s)=%g vs test=%g\n", parent->start.addDays(d).toString().toStdString().c_str(),parent->data[int(d)].perf, parent->data[int(d)].test);
-    return parent->data[int(d)].perf;
+    return parms[2] + (g[index] * parms[0]) - (h[index] * parms[1]);
+}
+
+void
+banisterFit::decay()
+{
+    // t1/t2 are fixed whilst fitting, so the decay is only run once
+    t1 = parent->t1;
+    t2 = parent->t2;
+
+    double d1 = exp(-1/t1);
+    double d2 = exp(-1/t2);
+
+    int n = stopIndex - startIndex + 1;
+    if (n < 0) n = 0;
+    if (startIndex + n > parent->data.count()) n = parent->data.count() - startIndex;
+
+    g.fill(0, n);
+    h.fill(0, n);
+    for (int i=1; i<n; i++) {
+        double score = parent->data[startIndex+i].score;
+        g[i] = (g[i-1] * d1) + score;
+        h[i] = (h[i-1] * d2) + score;
+    }
 }
 
 void
@@ -496,11 +506,31 @@ banisterFit::combine(banisterFit other)
 }
 
 // used to wrap a function call when deriving parameters
-static QMutex calllmfit;
-static banisterFit *calllmfitmodel = NULL;
-static double calllmfitf(double t, const double *p) {
-return static_cast<banisterFit*>(calllmfitmodel)->f(t, p);
+static double calllmfitf(double t, const double *p, void *model) {
+return static_cast<banisterFit*>(model)->f(t, p);
+
+}
 
+// fit a single window, they're independent so run concurrently
+static void fitWindow(banisterFit &window)
+{
+    Banister *parent = window.parent;
+    double prior[3]={ parent->k1, parent->k2, parent->performanceScore[window.testoffset] };
+
+    lm_control_struct control = lm_control_double;
+    control.patience = 1000; // more than this and there really is a problem
+    lm_status_struct status;
+
+    window.decay();
+    lmcurve_user(3, prior, window.tests, parent->performanceDay.constData()+window.testoffset,
+                 parent->performanceScore.constData()+window.testoffset,
+                 calllmfitf, &window, &control, &status);
+
+    // we'll keep the parameters found
+    window.k1 = prior[0];
+    window.k2 = prior[1];
+    window.p0 = prior[2];
+    window.outcome = status.outcome;
 }
 
 void Banister::setDecay(double one, double two)
@@ -515,31 +545,23 @@ void Banister::setDecay(double one, double two)
 }
 void Banister::fit()
 {
-    for(int i=0; i<windows.length(); i++) {
-
-        double prior[3]={ k1, k2, performanceScore[windows[i].testoffset] };
+    printd("fitting %d windows\n", windows.length());
+    QtConcurrent::blockingMap(windows, fitWindow);
 
-        lm_control_struct control = lm_control_double;
-        control.patience = 1000; // more than this and there really is a problem
-        lm_status_struct status;
-
-        printd("fitting window %d start=%s [k1=%g k2=%g p0=%g]\n", i, windows[i].startDate.toString().toStdString().c_str(), prior[0], prior[1], prior[2]);
-
-        // use forwarder via global variable, so mutex around this !
-        calllmfit.lock();
-        calllmfitmodel=&windows[i];
+    // now update the curves, windows overlap so we go in
+    // order and the later window wins, as it always did
+    for(int i=0; i<windows.length(); i++) {
 
-        //fprintf(stderr, "Fitting ...\n" ); fflush(stderr);
-        lmcurve(3, prior, windows[i].tests, performanceDay.constData()+windows[i].testoffset, performanceScore.constData()+windows[i].testoffset,
-                calllmfitf, &control, &status);
+        windows[i].compute(windows[i].startIndex, windows[i].stopIndex);
 
-        // release for others
-        calllmfit.unlock();
+        // don't need them now
+        windows[i].g.clear();
+        windows[i].h.clear();
 
-        if (status.outcome >= 0) {
+        if (windows[i].outcome >= 0) {
             int n=0;
             double x=RMSE(windows[i].startDate, windows[i].stopDate, n);
-            printd("RMSE %g for %d points: window %d %s [k1=%g k2=%g p0=%g]\n", x, n, i, lm_infmsg[status.outcome], prior[0], prior[1], prior[2]);
+            printd("RMSE %g for %d points: window %d %s [k1=%g k2=%g p0=%g]\n", x, n, i, lm_infmsg[windows[i].outcome], windows[i].k1, windows[i].k2, windows[i].p0);
         }
     }
 
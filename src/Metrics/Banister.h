@@ -52,10 +52,11 @@ public:
 class Banister;
 class banisterFit {
 public:
-    banisterFit(Banister *parent) : p0(0),k1(0),k2(0),t1(0),t2(0),tests(0),testoffset(-1),parent(parent) {}
+    banisterFit(Banister *parent) : p0(0),k1(0),k2(0),t1(0),t2(0),tests(0),testoffset(-1),outcome(-1),parent(parent) {}
 
     double f(double t, const double *p);
     void combine(banisterFit other);
+    void decay();
     void compute(long startIndex, long stopIndex);
 
     long startIndex, stopIndex;
@@ -67,6 +68,11 @@ public:
     int tests;
     int testoffset;
 
+    // accumulated load across the window, g and h only depend on t1/t2
+    // so perf is linear in k1, k2 and p0 whilst they're being fitted
+    QVector<double> g, h;
+    int outcome;
+
     Banister *parent;
 };
 
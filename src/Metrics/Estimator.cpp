@@ -26,6 +26,8 @@
 
 #include "Banister.h"
 
+#include <QtConcurrent>
+
 #ifndef ESTIMATOR_DEBUG
 #define ESTIMATOR_DEBUG false
 #endif
@@ -99,6 +101,87 @@ class RollingBests {
         }
 };
 
+// a week's bests, fitted to each of the models
+struct EstimatorWeek {
+    Context *context;
+    QDate begin, end;
+    QVector<float> bests, wpk;
+    QList<PDEstimate> est;
+};
+
+static void
+estimateWeek(EstimatorWeek &week)
+{
+    // set up the models we support, they're created here since
+    // they fit when their data changes and that signal is only
+    // delivered directly in the thread they belong to
+    CP2Model p2model(week.context);
+    CP3Model p3model(week.context);
+    WSModel wsmodel(week.context);
+    MultiModel multimodel(week.context);
+    ExtendedModel extmodel(week.context);
+
+    QList <PDModel *> models;
+    models << &p2model;
+    models << &p3model;
+    models << &multimodel;
+    models << &extmodel;
+    models << &wsmodel;
+
+    foreach(PDModel *model, models) {
+
+        PDEstimate add;
+
+        // set the data
+        model->setData(week.bests);
+        model->saveParameters(add.parameters); // save the computed parms
+
+        add.wpk = false;
+        add.from = week.begin;
+        add.to = week.end;
+        add.model = model->code();
+        add.WPrime = model->hasWPrime() ? model->WPrime() : 0;
+        add.CP = model->hasCP() ? model->CP() : 0;
+        add.PMax = model->hasPMax() ? model->PMax() : 0;
+        add.FTP = model->hasFTP() ? model->FTP() : 0;
+
+        if (add.CP && add.WPrime) add.EI = add.WPrime / add.CP ;
+
+        // so long as the important model derived values are sensible ...
+        if (add.WPrime > 1000 && add.CP > 100) {
+            printd("Estimates for %s - %s\n", add.from.toString().toStdString().c_str(), add.to.toString().toStdString().c_str());
+            week.est << add;
+        }
+
+        //qDebug()<<add.to<<add.from<<model->code()<< "W'="<< model->WPrime() <<"CP="<< model->CP() <<"pMax="<<model->PMax();
+
+        // set the wpk data
+        model->setData(week.wpk);
+        model->saveParameters(add.parameters); // save the computed parms
+
+        add.wpk = true;
+        add.from = week.begin;
+        add.to = week.end;
+        add.model = model->code();
+        add.WPrime = model->hasWPrime() ? model->WPrime() : 0;
+        add.CP = model->hasCP() ? model->CP() : 0;
+        add.PMax = model->hasPMax() ? model->PMax() : 0;
+        add.FTP = model->hasFTP() ? model->FTP() : 0;
+        if (add.CP && add.WPrime) add.EI = add.WPrime / add.CP ;
+
+        // so long as the model derived values are sensible ...
+        if ((!model->hasWPrime() || add.WPrime > 10.0f) &&
+            (!model->hasCP() || add.CP > 1.0f) &&
+            (!model->hasPMax() || add.PMax > 1.0f) &&
+            (!model->hasFTP() || add.FTP > 1.0f)) {
+            printd("WPK Estimates for %s - %s\n", add.from.toString().toStdString().c_str(), add.to.toString().toStdString().c_str());
+            week.est << add;
+        }
+
+        //qDebug()<<add.from<<model->code()<< "KG W'="<< model->WPrime() <<"CP="<< model->CP() <<"pMax="<<model->PMax();
+    }
+}
+
 Estimator::Estimator(Context *context) : context(context)
 {
     // used to flag when we need to stop
@@ -208,20 +291,10 @@ Estimator::run()
         return;
     }
 
-    // set up the models we support
-    CP2Model p2model(context);
-    CP3Model p3model(context);
-    WSModel wsmodel(context);
-    MultiModel multimodel(context);
-    ExtendedModel extmodel(context);
-
-    QList <PDModel *> models;
-    models << &p2model;
-    models << &p3model;
-    models << &multimodel;
-    models << &extmodel;
-    models << &wsmodel;
-
+    // weeks are fitted in parallel, a batch at a time
+    // so we don't hold every week's bests at once
+    int batchsize = QThread::idealThreadCount() * 4;
+    QList<EstimatorWeek> batch;
 
     // from has first ride with Power data / looking at the next 7 days of data with Power
     // calculate Estimates for all data per week including the week of the last Power recording
@@ -272,61 +345,23 @@ Estimator::run()
         bestsWPK.addBests(wpk);
 
         // we now have the data
-        foreach(PDModel *model, models) {
-
-            PDEstimate add;
-
-            // set the data
-            model->setData(bests.aggregate());
-            model->saveParameters(add.parameters); // save the computed parms
-
-            add.wpk = false;
-            add.from = begin;
-            add.to = end;
-            add.model = model->code();
-            add.WPrime = model->hasWPrime() ? model->WPrime() : 0;
-            add.CP = model->hasCP() ? model->CP() : 0;
-            add.PMax = model->hasPMax() ? model->PMax() : 0;
-            add.FTP = model->hasFTP() ? model->FTP() : 0;
-
-            if (add.CP && add.WPrime) add.EI = add.WPrime / add.CP ;
-
-            // so long as the important model derived values are sensible ...
-            if (add.WPrime > 1000 && add.CP > 100) {
-                printd("Estimates for %s - %s\n", add.from.toString().toStdString().c_str(), add.to.toString().toStdString().c_str());
-                est << add;
-            }
-
-            //qDebug()<<add.to<<add.from<<model->code()<< "W'="<< model->WPrime() <<"CP="<< model->CP() <<"pMax="<<model->PMax();
-
-            // set the wpk data
-            model->setData(bestsWPK.aggregate());
-            model->saveParameters(add.parameters); // save the computed parms
-
-            add.wpk = true;
-            add.from = begin;
-            add.to = end;
-            add.model = model->code();
-            add.WPrime = model->hasWPrime() ? model->WPrime() : 0;
-            add.CP = model->hasCP() ? model->CP() : 0;
-            add.PMax = model->hasPMax() ? model->PMax() : 0;
-            add.FTP = model->hasFTP() ? model->FTP() : 0;
-            if (add.CP && add.WPrime) add.EI = add.WPrime / add.CP ;
-
-            // so long as the model derived values are sensible ...
-            if ((!model->hasWPrime() || add.WPrime > 10.0f) &&
-                (!model->hasCP() || add.CP > 1.0f) &&
-                (!model->hasPMax() || add.PMax > 1.0f) &&
-                (!model->hasFTP() || add.FTP > 1.0f)) {
-                printd("WPK Estimates for %s - %s\n", add.from.toString().toStdString().c_str(), add.to.toString().toStdString().c_str());
-                est << add;
-            }
-
-            //qDebug()<<add.from<<model->code()<< "KG W'="<< model->WPrime() <<"CP="<< model->CP() <<"pMax="<<model->PMax();
-        }
+        EstimatorWeek add;
+        add.context = context;
+        add.begin = begin;
+        add.end = end;
+        add.bests = bests.aggregate();
+        add.wpk = bestsWPK.aggregate();
+        batch << add;
 
         // go forward a week
         date = date.addDays(7);
+
+        // fit the models, keeping the estimates in date order
+        if (batch.count() >= batchsize || date >= to) {
+            QtConcurrent::blockingMap(batch, estimateWeek);
+            foreach(EstimatorWeek fitted, batch) est << fitted.est;
+            batch.clear();
+        }
     }
 
     // add a dummy entry if we have no estimates to stop constantly trying to refresh
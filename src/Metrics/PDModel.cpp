@@ -18,7 +18,7 @@
 
 #include "PDModel.h"
 #include "LTMTrend.h"
-#include "lmcurve.h"
+#include "lmcurve_user.h"
 
 //extern ztable PD_ZTABLE;
 // base class for all models
@@ -126,11 +126,10 @@ PDModel::setIntervals(double sanI1, double sanI2, double anI1, double anI2,
     emit intervalsChanged();
 }
 
-// used to wrap a function call when deriving parameters
-QMutex calllmfit;
-static PDModel *calllmfitmodel = NULL;
-static double calllmfitf(double t, const double *p) {
-    return static_cast<PDModel*>(calllmfitmodel)->f(t, p);
+// used to wrap a function call when deriving parameters, the model
+// is passed through by lmfit so fits can run in parallel
+static double calllmfitf(double t, const double *p, void *model) {
+    return static_cast<PDModel*>(model)->f(t, p);
 }
 
 // using the data and intervals from above, derive the
@@ -284,15 +283,8 @@ PDModel::deriveCPParameters(int model)
         lm_control_struct control = lm_control_double;
         lm_status_struct status;
 
-        // use forwarder via global variable, so mutex around this !
-        calllmfit.lock();
-        calllmfitmodel = this;
-
         //fprintf(stderr, "Fitting ...\n" ); fflush(stderr);
-        lmcurve(this->nparms(), par, p.count(), t.constData(), p.constData(), calllmfitf, &control, &status);
-
-        // release for others
-        calllmfit.unlock();
+        lmcurve_user(this->nparms(), par, p.count(), t.constData(), p.constData(), calllmfitf, this, &control, &status);
 
         //fprintf(stderr, "Results:\n" );
         //fprintf(stderr, "status after %d function evaluations:\n  %s\n",
@@ -1023,15 +1015,8 @@ ExtendedModel::deriveExtCPParameters()
         lm_control_struct control = lm_control_double;
         lm_status_struct status;
 
-        // use forwarder via global variable, so mutex around this !
-        calllmfit.lock();
-        calllmfitmodel = this;
-
         fprintf(stderr, "Fitting ...\n" ); fflush(stderr);
-        lmcurve(this->nparms(), par, p.count(), t.constData(), p.constData(), calllmfitf, &control, &status);
-
-        // release for others
-        calllmfit.unlock();
+        lmcurve_user(this->nparms(), par, p.count(), t.constData(), p.constData(), calllmfitf, this, &control, &status);
 
         fprintf(stderr, "Results:\n" );
         fprintf(stderr, "status after %d function evaluations:\n  %s\n",
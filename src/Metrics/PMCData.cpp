@@ -34,7 +34,7 @@
 #include <QProgressDialog>
 
 PMCData::PMCData(Context *context, Specification spec, QString metricName, int stsDays, int ltsDays) 
-    : context(context), specification_(spec), metricName_(metricName), stsDays_(stsDays), ltsDays_(ltsDays), isstale(true)
+    : context(context), specification_(spec), metricName_(metricName), stsDays_(stsDays), ltsDays_(ltsDays), sbToday_(false), dirtyFrom_(-1), isstale(true)
 {
     // get defaults if not passed
     useDefaults = false;
@@ -62,12 +62,12 @@ PMCData::PMCData(Context *context, Specification spec, QString metricName, int s
     connect(context, SIGNAL(rideAdded(RideItem*)), this, SLOT(invalidate()));
     connect(context, SIGNAL(rideDeleted(RideItem*)), this, SLOT(invalidate()));
     connect(context, SIGNAL(refreshUpdate(QDate)), this, SLOT(invalidate()));
-    connect(context->athlete->rideCache, SIGNAL(itemChanged(RideItem*)), this, SLOT(invalidate()));
+    connect(context->athlete->rideCache, SIGNAL(itemChanged(RideItem*)), this, SLOT(rideChanged(RideItem*)));
     connect(context->athlete->seasons, SIGNAL(seasonsChanged()), this, SLOT(invalidate()));
 }
 
 PMCData::PMCData(Context *context, Specification spec, Leaf *expr, DataFilterRuntime *df, int stsDays, int ltsDays) 
-    : context(context), specification_(spec), metricName_(""), stsDays_(stsDays), ltsDays_(ltsDays), isstale(true)
+    : context(context), specification_(spec), metricName_(""), stsDays_(stsDays), ltsDays_(ltsDays), sbToday_(false), dirtyFrom_(-1), isstale(true)
 {
     // get defaults if not passed
     useDefaults = false;
@@ -95,7 +95,7 @@ PMCData::PMCData(Context *context, Specification spec, Leaf *expr, DataFilterRun
     connect(context, SIGNAL(rideAdded(RideItem*)), this, SLOT(invalidate()));
     connect(context, SIGNAL(rideDeleted(RideItem*)), this, SLOT(invalidate()));
     connect(context, SIGNAL(refreshUpdate(QDate)), this, SLOT(invalidate()));
-    connect(context->athlete->rideCache, SIGNAL(itemChanged(RideItem*)), this, SLOT(invalidate()));
+    connect(context->athlete->rideCache, SIGNAL(itemChanged(RideItem*)), this, SLOT(rideChanged(RideItem*)));
 }
 
 void PMCData::invalidate()
@@ -103,29 +103,65 @@ void PMCData::invalidate()
     isstale=true;
 }
 
-void PMCData::refresh()
+void PMCData::rideChanged(RideItem *item)
 {
-    if (!isstale) return;
-
-    // we need to reread config if refreshing (it might have changed)
-    if (useDefaults) {
+    // full refresh is already pending
+    if (isstale) return;
+
+    // if the date range moves or the day rolled over the
+    // arrays need rebuilding, so fall back to a full refresh
+    QDate start, end;
+    dateRange(start, end);
+    if (start != start_ || end != end_ || today_ != QDate::currentDate()) {
+        invalidate();
+        return;
+    }
 
-        QVariant lts = appsettings->cvalue(context->athlete->cyclist, GC_LTS_DAYS);
-        if (lts.isNull() || lts.toInt() == 0) ltsDays_ = 42;
-        else ltsDays_ = lts.toInt();
+    // take out what it contributed last time and add what it contributes now
+    int from = -1;
+    if (contributions_.contains(item)) {
+        Contribution old = contributions_.take(item);
+        series_.add(old.offset, -old.value, old.planned);
+        from = old.offset;
+    }
 
-        QVariant sts = appsettings->cvalue(context->athlete->cyclist, GC_STS_DAYS);
-        if (sts.isNull() || sts.toInt() == 0) stsDays_ = 7;
-        else stsDays_ = sts.toInt();
+    Contribution now;
+    if (contribution(item, now)) {
+        series_.add(now.offset, now.value, now.planned);
+        contributions_.insert(item, now);
+        if (from < 0 || now.offset < from) from = now.offset;
     }
 
-    QTime timer;
-    timer.start();
+    // nothing changed for us
+    if (from < 0) return;
 
-    //
-    // STEP ONE: What is the date range ?
-    //
+    // recurrences need re-running from here onwards
+    if (dirtyFrom_ < 0 || from < dirtyFrom_) dirtyFrom_ = from;
+}
+
+bool PMCData::contribution(RideItem *item, Contribution &c)
+{
+    if (!specification_.pass(item)) return false;
+
+    int offset = start_.daysTo(item->dateTime.date());
+    if (offset <= 0 || offset >= series_.stress.count()) return false;
+
+    // although metrics are cleansed, we check here because development
+    // builds have a rideDB.json that has nan and inf values in it.
+    double value = 0;
+    if (fromDataFilter) value = expr->eval(df, expr, 0, item).number;
+    else value = item->getForSymbol(metricName_);
 
+    if (std::isinf(value) || std::isnan(value)) return false;
+
+    c.offset = offset;
+    c.value = value;
+    c.planned = item->planned;
+    return true;
+}
+
+void PMCData::dateRange(QDate &start, QDate &end)
+{
     // Date range needs to take into account seasons that
     // have a starting LTS/STS potentially before any rides
     QDate seed;
@@ -144,39 +180,67 @@ void PMCData::refresh()
     }
 
     // what is earliest date we got ? (substract 1 day to include first ride)
-    start_ = QDate(9999,12,31);
-    if (seed != QDate() && seed < start_) start_ = seed;
-    if (first != QDate() && first < start_) start_ = first.addDays(-1);
+    start = QDate(9999,12,31);
+    if (seed != QDate() && seed < start) start = seed;
+    if (first != QDate() && first < start) start = first.addDays(-1);
 
     // whats the latest date we got ? (and add a year for decay)
-    end_ = QDate();
-    if (last > seed) end_ = last.addDays(365);
-    else if (seed != QDate()) end_ = seed.addDays(365);
+    end = QDate();
+    if (last > seed) end = last.addDays(365);
+    else if (seed != QDate()) end = seed.addDays(365);
 
     // back to null date if not set, just to get round date arithmetic
-    if (start_ == QDate(9999,12,31)) start_ = QDate();
+    if (start == QDate(9999,12,31)) start = QDate();
+}
+
+void PMCData::refresh()
+{
+    if (!isstale && dirtyFrom_ < 0) return;
+
+    // we need to reread config if refreshing (it might have changed)
+    if (useDefaults) {
+
+        int ltsDays, stsDays;
+
+        QVariant lts = appsettings->cvalue(context->athlete->cyclist, GC_LTS_DAYS);
+        if (lts.isNull() || lts.toInt() == 0) ltsDays = 42;
+        else ltsDays = lts.toInt();
+
+        QVariant sts = appsettings->cvalue(context->athlete->cyclist, GC_STS_DAYS);
+        if (sts.isNull() || sts.toInt() == 0) stsDays = 7;
+        else stsDays = sts.toInt();
+
+        if (ltsDays != ltsDays_ || stsDays != stsDays_) isstale = true;
+        ltsDays_ = ltsDays;
+        stsDays_ = stsDays;
+    }
+
+    bool sbToday = appsettings->cvalue(context->athlete->cyclist, GC_SB_TODAY).toInt();
+    if (sbToday != sbToday_ || today_ != QDate::currentDate()) isstale = true;
+    sbToday_ = sbToday;
+
+    // only a few rides changed, the stress has already been
+    // adjusted, so just re-run the recurrences from that day
+    if (!isstale) {
+        series_.calculate(dirtyFrom_, start_, stsDays_, ltsDays_, sbToday_);
+        dirtyFrom_ = -1;
+        return;
+    }
+
+    QTime timer;
+    timer.start();
+
+    //
+    // STEP ONE: What is the date range ?
+    //
+    dateRange(start_, end_);
 
     // We got a valid range ?
     if (start_ != QDate() && end_ != QDate() && start_ < end_) {
 
         // resize arrays
         days_ = start_.daysTo(end_)+1;
-        stress_.resize(days_);
-        lts_.resize(days_);
-        sts_.resize(days_);
-        sb_.resize(days_+1); // for SB tomorrow!
-        rr_.resize(days_);
-
-        planned_stress_.resize(days_);
-        planned_lts_.resize(days_);
-        planned_sts_.resize(days_);
-        planned_sb_.resize(days_+1); // for SB tomorrow!
-        planned_rr_.resize(days_);
-
-        expected_lts_.resize(days_);
-        expected_sts_.resize(days_);
-        expected_sb_.resize(days_+1); // for SB tomorrow!
-        expected_rr_.resize(days_);
+        series_.resize(days_);
 
     } else {
 
@@ -184,23 +248,10 @@ void PMCData::refresh()
         start_= QDate();
         end_ = QDate();
         days_ = 0;
-        stress_.resize(0);
-        lts_.resize(0);
-        sts_.resize(0);
-        sb_.resize(0);
-        rr_.resize(0);
-
-        planned_stress_.resize(0);
-        planned_lts_.resize(0);
-        planned_sts_.resize(0);
-        planned_sb_.resize(0);
-        planned_rr_.resize(0);
-
-        expected_lts_.resize(0);
-        expected_sts_.resize(0);
-        expected_sb_.resize(0);
-        expected_rr_.resize(0);
+        series_.resize(0);
 
+        contributions_.clear();
+        dirtyFrom_ = -1;
 
         // give up
         return;
@@ -210,230 +261,67 @@ void PMCData::refresh()
     //
     // STEP TWO What are the seedings and ride values
     //
-    bool sbToday = appsettings->cvalue(context->athlete->cyclist, GC_SB_TODAY).toInt();
-    double lte = (double)exp(-1.0/ltsDays_);
-    double ste = (double)exp(-1.0/stsDays_);
 
     // clear what's there
-    stress_.fill(0);
-    lts_.fill(0);
-    sts_.fill(0);
-    sb_.fill(0);
-    rr_.fill(0);
-
-    planned_stress_.fill(0);
-    planned_lts_.fill(0);
-    planned_sts_.fill(0);
-    planned_sb_.fill(0);
-    planned_rr_.fill(0);
-
-    expected_lts_.fill(0);
-    expected_sts_.fill(0);
-    expected_sb_.fill(0);
-    expected_rr_.fill(0);
+    series_.clear();
+
+    contributions_.clear();
 
     // add the seeded values from seasons
     foreach(Season x, context->athlete->seasons->seasons) {
         if (x.getSeed()) {
             int offset = start_.daysTo(x.getStart());
-            lts_[offset] = x.getSeed() * -1;
-            sts_[offset] = x.getSeed() * -1;
-
-            planned_lts_[offset] = x.getSeed() * -1;
-            planned_sts_[offset] = x.getSeed() * -1;
+            series_.seed[offset] = x.getSeed();
         }
     }
 
-    // add the stress scores
-    foreach(RideItem *item, context->athlete->rideCache->rides()) {
-
-        if (!specification_.pass(item)) continue;
-
-        // seed with score for this one
-        int offset = start_.daysTo(item->dateTime.date());
-        if (offset > 0 && offset < stress_.count()) {
-
-            // although metrics are cleansed, we check here because development
-            // builds have a rideDB.json that has nan and inf values in it.
-            double value = 0;;
-            if (fromDataFilter) value = expr->eval(df, expr, 0, item).number;
-            else value = item->getForSymbol(metricName_);
-
-            if (!std::isinf(value) && !std::isnan(value)) {
-                if (item->planned)
-                    planned_stress_[offset] += value;
-                else
-                    stress_[offset] += value;
-                //qDebug()<<"stress_["<<offset<<"] :"<<stress_[offset];
-            }
-        }
+    // add the stress scores, when on the gui thread we can use the
+    // column store, datafilters may be evaluated during a refresh
+    bool columnar = !fromDataFilter && QThread::currentThread() == context->thread();
+    QVector<RideItem*> rides = context->athlete->rideCache->rides();
+    QVector<double> values;
+    QBitArray rows;
+    if (columnar) {
+        const RideCacheColumns &table = context->athlete->rideCache->columns();
+        rides = table.items;
+        values = table.column(RideCacheColumns::metricIndex(metricName_));
+        rows = table.mask(specification_);
+        columnar = values.count() == rides.count();
     }
 
-    //
-    // STEP THREE Calculate sts/lts, sb and rr
-    //
-    double lastLTS=0.0f;
-    double lastSTS=0.0f;
-
-    double rollingStress=0;
-
-    double planned_lastLTS=0.0f;
-    double planned_lastSTS=0.0f;
-
-    double planned_rollingStress=0;
-
-#if notyet
-    double expected_lastLTS=0.0f;
-    double expected_lastSTS=0.0f;
-#endif
+    for(int i=0; i<rides.count(); i++) {
 
-    double expected_rollingStress=0;
+        RideItem *item = rides[i];
+        Contribution c;
 
-    for(int day=0; day < days_; day++) {
+        if (columnar) {
 
-        // not seeded
-        if (lts_[day] >=0 || sts_[day]>=0) {
+            // same rules as contribution(), but no symbol lookup
+            if (!rows.testBit(i)) continue;
 
-            // LTS
-            if (day) lastLTS = lts_[day-1];
-            lts_[day] = (stress_[day] * (1.0 - lte)) + (lastLTS * lte);
+            c.offset = start_.daysTo(item->dateTime.date());
+            c.value = values[i];
+            c.planned = item->planned;
+            if (c.offset <= 0 || c.offset >= series_.stress.count()) continue;
+            if (std::isinf(c.value) || std::isnan(c.value)) continue;
 
-            // STS
-            if (day) lastSTS = sts_[day-1];
-            sts_[day] = (stress_[day] * (1.0 - ste)) + (lastSTS * ste);
-
-        } else if (lts_[day]< 0 || sts_[day]<0) {
-
-            lts_[day] *= -1;
-            sts_[day] *= -1;
-        }
-
-        // rolling stress for STS days
-        if (day && day <= stsDays_) {
-            // just starting out
-            rollingStress += lts_[day] - lts_[day-1];
-            rr_[day] = rollingStress;
-        } else if (day) {
-            rollingStress += lts_[day] - lts_[day-1];
-            rollingStress -= lts_[day-stsDays_] - lts_[day-stsDays_-1];
-            rr_[day] = rollingStress;
-        }
-
-        // SB (stress balance)  long term - short term
-        // We allow it to be shown today or tomorrow where
-        // most (sane/thinking) folks usually show SB on the following day
-        sb_[day+(sbToday ? 0 : 1)] =  lts_[day] - sts_[day];
-
-        // *******************
-        // ****  PLANNED  ****
-        // *******************
-
-        // not seeded
-        if (planned_lts_[day] >=0 || planned_sts_[day]>=0) {
-
-            // LTS
-            if (day) planned_lastLTS = planned_lts_[day-1];
-            planned_lts_[day] = (planned_stress_[day] * (1.0 - lte)) + (planned_lastLTS * lte);
-
-            // STS
-            if (day) planned_lastSTS = planned_sts_[day-1];
-            planned_sts_[day] = (planned_stress_[day] * (1.0 - ste)) + (planned_lastSTS * ste);
-
-        } else if (planned_lts_[day]< 0 || planned_sts_[day]<0) {
-
-            planned_lts_[day] *= -1;
-            planned_sts_[day] *= -1;
-        }
-
-        // rolling stress for STS days
-        if (day && day <= stsDays_) {
-            // just starting out
-            planned_rollingStress += planned_lts_[day] - planned_lts_[day-1];
-            planned_rr_[day] = planned_rollingStress;
-        } else if (day) {
-            planned_rollingStress += planned_lts_[day] - planned_lts_[day-1];
-            planned_rollingStress -= planned_lts_[day-stsDays_] - planned_lts_[day-stsDays_-1];
-            planned_rr_[day] = planned_rollingStress;
-        }
-
-        // SB (stress balance)  long term - short term
-        // We allow it to be shown today or tomorrow where
-        // most (sane/thinking) folks usually show SB on the following day
-        planned_sb_[day+(sbToday ? 0 : 1)] =  planned_lts_[day] - planned_sts_[day];
-
-        // ********************
-        // ****  EXPECTED  ****
-        // ********************
-
-        if (start_.addDays(day).daysTo(QDate::currentDate())<0) {
-            double lastLts = 0.0;
-            double lastSts = 0.0;
-            double ltsAtStsDays1 = 0.0;
-            double ltsAtStsDays2 = 0.0;
-
-            if (day) {
-                if (start_.addDays(day).daysTo(QDate::currentDate())<-1) {
-                    lastLts = expected_lts_[day-1];
-                    lastSts = expected_sts_[day-1];
-                } else {
-                    lastLts = lts_[day-1];
-                    lastSts = sts_[day-1];
-                }
-                if (day > stsDays_) {
-                    if (start_.addDays(day).daysTo(QDate::currentDate())<-1-stsDays_) {
-                        ltsAtStsDays1 = expected_lts_[day-stsDays_-1];
-                    } else {
-                        ltsAtStsDays1 = lts_[day-stsDays_-1];
-                    }
-
-                    if (start_.addDays(day).daysTo(QDate::currentDate())<-stsDays_) {
-                        ltsAtStsDays2 = expected_lts_[day-stsDays_];
-                    } else {
-                        ltsAtStsDays2 = lts_[day-stsDays_];
-                    }
-                }
-            }
-
-            // not seeded
-            if (expected_lts_[day] >=0 || expected_sts_[day]>=0) {
-                // LTS
-                expected_lts_[day] = (planned_stress_[day] * (1.0 - lte)) + (lastLts * lte);
-
-                // STS
-                expected_sts_[day] = (planned_stress_[day] * (1.0 - ste)) + (lastSts * ste);
-
-            } else if (expected_lts_[day]< 0 || expected_sts_[day]<0) {
-                expected_lts_[day] *= -1;
-                expected_sts_[day] *= -1;
-            }
-
-            // rolling stress for STS days
-            if (day && day <= stsDays_) {
-                // just starting out
-                expected_rollingStress += expected_lts_[day] - lastLts;
-                expected_rr_[day] = expected_rollingStress;
-            } else if (day) {
-                expected_rollingStress += expected_lts_[day] - lastLts;
-                expected_rollingStress -= ltsAtStsDays2 - ltsAtStsDays1;
-                expected_rr_[day] = expected_rollingStress;
-            }
-
-            // SB (stress balance)  long term - short term
-            // We allow it to be shown today or tomorrow where
-            // most (sane/thinking) folks usually show SB on the following day
-            expected_sb_[day+(sbToday ? 0 : 1)] =  expected_lts_[day] - expected_sts_[day];
-        } else {
-            expected_lts_[day] = 0;
-            expected_sts_[day] = 0;
-            expected_sb_[day] = 0;
-            expected_rr_[day] = 0;
-
-        }
+        } else if (!contribution(item, c)) continue;
 
+        // seed with score for this one, remember it
+        // so we can adjust when the ride changes
+        series_.add(c.offset, c.value, c.planned);
+        contributions_.insert(item, c);
     }
 
+    //
+    // STEP THREE Calculate sts/lts, sb and rr
+    //
+    series_.calculate(0, start_, stsDays_, ltsDays_, sbToday_);
+
     //qDebug()<<"refresh PMC in="<<timer.elapsed()<<"ms";
 
+    today_ = QDate::currentDate();
+    dirtyFrom_ = -1;
     isstale=false;
 }
 
@@ -458,7 +346,7 @@ PMCData::lts(QDate date)
 
     int index=indexOf(date);
     if (index == -1) return 0.0f;
-    else return lts_[index];
+    else return series_.lts[index];
 }
 
 double
@@ -468,7 +356,7 @@ PMCData::sts(QDate date)
 
     int index=indexOf(date);
     if (index == -1) return 0.0f;
-    else return sts_[index];
+    else return series_.sts[index];
 }
 
 double
@@ -478,7 +366,7 @@ PMCData::stress(QDate date)
 
     int index=indexOf(date);
     if (index == -1) return 0.0f;
-    else return stress_[index];
+    else return series_.stress[index];
 }
 
 double
@@ -488,7 +376,7 @@ PMCData::sb(QDate date)
 
     int index=indexOf(date);
     if (index == -1) return 0.0f;
-    else return sb_[index];
+    else return series_.sb[index];
 }
 
 double
@@ -498,7 +386,7 @@ PMCData::rr(QDate date)
 
     int index=indexOf(date);
     if (index == -1) return 0.0f;
-    else return rr_[index];
+    else return series_.rr[index];
 }
 
 double
@@ -508,7 +396,7 @@ PMCData::plannedLts(QDate date)
 
     int index=indexOf(date);
     if (index == -1) return 0.0f;
-    else return planned_lts_[index];
+    else return series_.planned_lts[index];
 }
 
 double
@@ -518,7 +406,7 @@ PMCData::plannedSts(QDate date)
 
     int index=indexOf(date);
     if (index == -1) return 0.0f;
-    else return planned_sts_[index];
+    else return series_.planned_sts[index];
 }
 
 double
@@ -528,7 +416,7 @@ PMCData::plannedStress(QDate date)
 
     int index=indexOf(date);
     if (index == -1) return 0.0f;
-    else return planned_stress_[index];
+    else return series_.planned_stress[index];
 }
 
 double
@@ -538,7 +426,7 @@ PMCData::plannedSb(QDate date)
 
     int index=indexOf(date);
     if (index == -1) return 0.0f;
-    else return planned_sb_[index];
+    else return series_.planned_sb[index];
 }
 
 double
@@ -548,7 +436,7 @@ PMCData::plannedRr(QDate date)
 
     int index=indexOf(date);
     if (index == -1) return 0.0f;
-    else return planned_rr_[index];
+    else return series_.planned_rr[index];
 }
 
 double
@@ -558,7 +446,7 @@ PMCData::expectedLts(QDate date)
 
     int index=indexOf(date);
     if (index == -1) return 0.0f;
-    else return expected_lts_[index];
+    else return series_.expected_lts[index];
 }
 
 double
@@ -568,7 +456,7 @@ PMCData::expectedSts(QDate date)
 
     int index=indexOf(date);
     if (index == -1) return 0.0f;
-    else return expected_sts_[index];
+    else return series_.expected_sts[index];
 }
 
 double
@@ -578,7 +466,7 @@ PMCData::expectedSb(QDate date)
 
     int index=indexOf(date);
     if (index == -1) return 0.0f;
-    else return expected_sb_[index];
+    else return series_.expected_sb[index];
 }
 
 double
@@ -588,7 +476,7 @@ PMCData::expectedRr(QDate date)
 
     int index=indexOf(date);
     if (index == -1) return 0.0f;
-    else return expected_rr_[index];
+    else return series_.expected_rr[index];
 }
 
 // rag reporting according to wattage type groupthink
@@ -25,6 +25,7 @@
 #include "Specification.h"
 
 #include "DataFilter.h"
+#include "PMCSeries.h"
 
 #include <QtCore>
 #include <QList>
@@ -32,6 +33,7 @@
 #include <QTreeWidgetItem>
 
 class Context;
+class RideItem;
 
 class PMCData : public QObject {
 
@@ -62,11 +64,11 @@ class PMCData : public QObject {
         int &days() { return days_; }
 
         // get arrays
-        QVector<double> &stress() { return stress_; }
-        QVector<double> &lts() { return lts_; }
-        QVector<double> &sts() { return sts_; }
-        QVector<double> &sb() { return sb_; }
-        QVector<double> &rr() { return rr_; }
+        QVector<double> &stress() { return series_.stress; }
+        QVector<double> &lts() { return series_.lts; }
+        QVector<double> &sts() { return series_.sts; }
+        QVector<double> &sb() { return series_.sb; }
+        QVector<double> &rr() { return series_.rr; }
 
         // index into the arrays
         int indexOf(QDate) ;
@@ -109,6 +111,10 @@ class PMCData : public QObject {
         void invalidate();
         void refresh();
 
+        // a single ride changed, adjust its stress and only
+        // recalculate from its date onwards
+        void rideChanged(RideItem*);
+
     private:
 
         // who we for ?
@@ -128,9 +134,22 @@ class PMCData : public QObject {
         // data
         QDate start_, end_;
         int days_;
-        QVector<double> stress_, lts_, sts_, sb_, rr_;
-        QVector<double> planned_stress_, planned_lts_, planned_sts_, planned_sb_, planned_rr_;
-        QVector<double> expected_lts_, expected_sts_, expected_sb_, expected_rr_;
+        PMCSeries series_; // daily stress, seeds and the recurrences
+
+        // what each ride added to stress, for incremental updates
+        struct Contribution {
+            int offset;
+            double value;
+            bool planned;
+        };
+        QHash<RideItem*, Contribution> contributions_;
+        bool contribution(RideItem *item, Contribution &c);
+
+        void dateRange(QDate &start, QDate &end);
+
+        bool sbToday_;
+        QDate today_; // expected series depend on it
+        int dirtyFrom_; // first day to recalculate, -1 if none
 
         bool isstale; // needs refreshing
 };
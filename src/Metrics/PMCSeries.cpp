@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "PMCSeries.h"
+
+#include <cmath>
+
+void
+PMCSeries::resize(int days)
+{
+    seed.resize(days);
+    stress.resize(days);
+    lts.resize(days);
+    sts.resize(days);
+    sb.resize(days ? days+1 : 0); // for SB tomorrow!
+    rr.resize(days);
+
+    planned_stress.resize(days);
+    planned_lts.resize(days);
+    planned_sts.resize(days);
+    planned_sb.resize(days ? days+1 : 0); // for SB tomorrow!
+    planned_rr.resize(days);
+
+    expected_lts.resize(days);
+    expected_sts.resize(days);
+    expected_sb.resize(days ? days+1 : 0); // for SB tomorrow!
+    expected_rr.resize(days);
+}
+
+void
+PMCSeries::clear()
+{
+    seed.fill(0);
+    stress.fill(0);
+    lts.fill(0);
+    sts.fill(0);
+    sb.fill(0);
+    rr.fill(0);
+
+    planned_stress.fill(0);
+    planned_lts.fill(0);
+    planned_sts.fill(0);
+    planned_sb.fill(0);
+    planned_rr.fill(0);
+
+    expected_lts.fill(0);
+    expected_sts.fill(0);
+    expected_sb.fill(0);
+    expected_rr.fill(0);
+}
+
+void
+PMCSeries::calculate(int from, QDate start, int stsDays, int ltsDays, bool sbToday)
+{
+    int days = stress.count();
+
+    double lte = (double)exp(-1.0/ltsDays);
+    double ste = (double)exp(-1.0/stsDays);
+
+    // the recurrences only look back one day (and stsDays for rr)
+    // so we can pick up where the previous day left off
+    double lastLTS=0.0f;
+    double lastSTS=0.0f;
+
+    double rollingStress = from ? rr[from-1] : 0;
+
+    double planned_lastLTS=0.0f;
+    double planned_lastSTS=0.0f;
+
+    double planned_rollingStress = from ? planned_rr[from-1] : 0;
+
+#if notyet
+    double expected_lastLTS=0.0f;
+    double expected_lastSTS=0.0f;
+#endif
+
+    double expected_rollingStress = from ? expected_rr[from-1] : 0;
+
+    for(int day=from; day < days; day++) {
+
+        // not seeded
+        if (seed[day] <= 0) {
+
+            // LTS
+            if (day) lastLTS = lts[day-1];
+            lts[day] = (stress[day] * (1.0 - lte)) + (lastLTS * lte);
+
+            // STS
+            if (day) lastSTS = sts[day-1];
+            sts[day] = (stress[day] * (1.0 - ste)) + (lastSTS * ste);
+
+        } else {
+
+            lts[day] = seed[day];
+            sts[day] = seed[day];
+        }
+
+        // rolling stress for STS days
+        if (day && day <= stsDays) {
+            // just starting out
+            rollingStress += lts[day] - lts[day-1];
+            rr[day] = rollingStress;
+        } else if (day) {
+            rollingStress += lts[day] - lts[day-1];
+            rollingStress -= lts[day-stsDays] - lts[day-stsDays-1];
+            rr[day] = rollingStress;
+        }
+
+        // SB (stress balance)  long term - short term
+        // We allow it to be shown today or tomorrow where
+        // most (sane/thinking) folks usually show SB on the following day
+        sb[day+(sbToday ? 0 : 1)] =  lts[day] - sts[day];
+
+        // *******************
+        // ****  PLANNED  ****
+        // *******************
+
+        // not seeded
+        if (seed[day] <= 0) {
+
+            // LTS
+            if (day) planned_lastLTS = planned_lts[day-1];
+            planned_lts[day] = (planned_stress[day] * (1.0 - lte)) + (planned_lastLTS * lte);
+
+            // STS
+            if (day) planned_lastSTS = planned_sts[day-1];
+            planned_sts[day] = (planned_stress[day] * (1.0 - ste)) + (planned_lastSTS * ste);
+
+        } else {
+
+            planned_lts[day] = seed[day];
+            planned_sts[day] = seed[day];
+        }
+
+        // rolling stress for STS days
+        if (day && day <= stsDays) {
+            // just starting out
+            planned_rollingStress += planned_lts[day] - planned_lts[day-1];
+            planned_rr[day] = planned_rollingStress;
+        } else if (day) {
+            planned_rollingStress += planned_lts[day] - planned_lts[day-1];
+            planned_rollingStress -= planned_lts[day-stsDays] - planned_lts[day-stsDays-1];
+            planned_rr[day] = planned_rollingStress;
+        }
+
+        // SB (stress balance)  long term - short term
+        // We allow it to be shown today or tomorrow where
+        // most (sane/thinking) folks usually show SB on the following day
+        planned_sb[day+(sbToday ? 0 : 1)] =  planned_lts[day] - planned_sts[day];
+
+        // ********************
+        // ****  EXPECTED  ****
+        // ********************
+
+        if (start.addDays(day).daysTo(QDate::currentDate())<0) {
+
+            // never seeded, so start from zero as a full refresh would
+            expected_lts[day] = 0;
+            expected_sts[day] = 0;
+
+            double lastLts = 0.0;
+            double lastSts = 0.0;
+            double ltsAtStsDays1 = 0.0;
+            double ltsAtStsDays2 = 0.0;
+
+            if (day) {
+                if (start.addDays(day).daysTo(QDate::currentDate())<-1) {
+                    lastLts = expected_lts[day-1];
+                    lastSts = expected_sts[day-1];
+                } else {
+                    lastLts = lts[day-1];
+                    lastSts = sts[day-1];
+                }
+                if (day > stsDays) {
+                    if (start.addDays(day).daysTo(QDate::currentDate())<-1-stsDays) {
+                        ltsAtStsDays1 = expected_lts[day-stsDays-1];
+                    } else {
+                        ltsAtStsDays1 = lts[day-stsDays-1];
+                    }
+
+                    if (start.addDays(day).daysTo(QDate::currentDate())<-stsDays) {
+                        ltsAtStsDays2 = expected_lts[day-stsDays];
+                    } else {
+                        ltsAtStsDays2 = lts[day-stsDays];
+                    }
+                }
+            }
+
+            // not seeded
+            if (expected_lts[day] >=0 || expected_sts[day]>=0) {
+                // LTS
+                expected_lts[day] = (planned_stress[day] * (1.0 - lte)) + (lastLts * lte);
+
+                // STS
+                expected_sts[day] = (planned_stress[day] * (1.0 - ste)) + (lastSts * ste);
+
+            } else if (expected_lts[day]< 0 || expected_sts[day]<0) {
+                expected_lts[day] *= -1;
+                expected_sts[day] *= -1;
+            }
+
+            // rolling stress for STS days
+            if (day && day <= stsDays) {
+                // just starting out
+                expected_rollingStress += expected_lts[day] - lastLts;
+                expected_rr[day] = expected_rollingStress;
+            } else if (day) {
+                expected_rollingStress += expected_lts[day] - lastLts;
+                expected_rollingStress -= ltsAtStsDays2 - ltsAtStsDays1;
+                expected_rr[day] = expected_rollingStress;
+            }
+
+            // SB (stress balance)  long term - short term
+            // We allow it to be shown today or tomorrow where
+            // most (sane/thinking) folks usually show SB on the following day
+            expected_sb[day+(sbToday ? 0 : 1)] =  expected_lts[day] - expected_sts[day];
+        } else {
+            expected_lts[day] = 0;
+            expected_sts[day] = 0;
+            expected_sb[day] = 0;
+            expected_rr[day] = 0;
+
+        }
+
+    }
+
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_PMCSeries_h
+#define _GC_PMCSeries_h 1
+
+#include <QVector>
+#include <QDate>
+
+// The daily stress arrays behind PMCData and the recurrences that turn
+// them into lts/sts, sb and rr. Kept free of the rest of the app so it
+// can be exercised on its own (see test/pmcbench).
+class PMCSeries {
+
+    public:
+
+        // resize to days, clear() zeroes everything
+        void resize(int days);
+        void clear();
+
+        // adjust the stress on a day, use -value to take it out again
+        void add(int offset, double value, bool planned) {
+            if (planned) planned_stress[offset] += value;
+            else stress[offset] += value;
+        }
+
+        // re-run the recurrences from day onwards, start is the date of
+        // day 0 (the expected series depend on where today falls)
+        void calculate(int from, QDate start, int stsDays, int ltsDays, bool sbToday);
+
+        QVector<double> stress, lts, sts, sb, rr;
+        QVector<double> planned_stress, planned_lts, planned_sts, planned_sb, planned_rr;
+        QVector<double> expected_lts, expected_sts, expected_sb, expected_rr;
+
+        QVector<double> seed; // seeded lts/sts from seasons
+};
+
+#endif
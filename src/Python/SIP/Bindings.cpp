@@ -16,6 +16,7 @@
 #include "PaceZones.h"
 
 #include "Bindings.h"
+#include "sipAPIgoldencheetah.h"
 
 #include <QWebEngineView>
 #include <QUrl>
@@ -544,6 +545,50 @@ Bindings::fromDateTime(PyObject* activity) const
     return NULL;
 }
 
+QStringList
+Bindings::nameList(PyObject* names) const
+{
+    QStringList returning;
+
+    if (names == NULL || names == Py_None) return returning;
+
+    // a single name
+    if (PyUnicode_Check(names)) {
+        returning << QString::fromUtf8(PyUnicode_AsUTF8(names));
+        return returning;
+    }
+
+    // a list or tuple of them, anything else is ignored
+    PyObject* seq = PySequence_Check(names) ? PySequence_Fast(names, "") : NULL;
+    if (seq == NULL) {
+        PyErr_Clear();
+        return returning;
+    }
+    for (Py_ssize_t i=0; i<PySequence_Fast_GET_SIZE(seq); i++) {
+        PyObject* name = PySequence_Fast_GET_ITEM(seq, i);
+        if (PyUnicode_Check(name)) returning << QString::fromUtf8(PyUnicode_AsUTF8(name));
+    }
+    Py_DECREF(seq);
+
+    return returning;
+}
+
+PyObject*
+Bindings::column(QString name, const QVector<double> &values, bool buffers) const
+{
+    if (buffers) {
+
+        // numpy.asarray() can wrap it without a copy
+        PythonDataSeries* ds = new PythonDataSeries(name, values.count());
+        if (values.count()) memcpy(ds->data, values.constData(), values.count() * sizeof(double));
+        return sipConvertFromNewType(ds, sipType_PythonDataSeries, NULL);
+    }
+
+    PyObject* list = PyList_New(values.count());
+    for (int i=0; i<values.count(); i++) PyList_SET_ITEM(list, i, PyFloat_FromDouble(values[i]));
+    return list;
+}
+
 // get the data series for the currently selected ride
 PythonDataSeries*
 Bindings::series(int type, PyObject* activity) const
@@ -915,11 +960,14 @@ Bindings::activityMetrics(RideItem* item) const
 }
 
 PyObject*
-Bindings::seasonMetrics(bool all, QString filter, bool compare) const
+Bindings::seasonMetrics(bool all, QString filter, bool compare, PyObject* metrics, bool buffers) const
 {
     Context *context = python->contexts.value(threadid()).context;
     if (context == NULL) return NULL;
 
+    // just the metrics asked for, or all of them
+    QStringList names = nameList(metrics);
+
     // want a list of compares
     if (compare) {
 
@@ -939,7 +987,7 @@ Bindings::seasonMetrics(bool all, QString filter, bool compare) const
                 if (p.isChecked()) {
 
                     // create a tuple (metrics, color)
-                    PyObject* tuple = Py_BuildValue("(Os)", seasonMetrics(all, DateRange(p.start, p.end), filter), p.color.name().toUtf8().constData());
+                    PyObject* tuple = Py_BuildValue("(Os)", seasonMetrics(all, DateRange(p.start, p.end), filter, names, buffers), p.color.name().toUtf8().constData());
                     // add to back and move on
                     PyList_SET_ITEM(list, idx++, tuple);
                 }
@@ -954,7 +1002,7 @@ Bindings::seasonMetrics(bool all, QString filter, bool compare) const
 
             // create a tuple (metrics, color)
             DateRange range = context->currentDateRange();
-            PyObject* tuple = Py_BuildValue("(Os)", seasonMetrics(all, range, filter), "#FF00FF");
+            PyObject* tuple = Py_BuildValue("(Os)", seasonMetrics(all, range, filter, names, buffers), "#FF00FF");
             // add to back and move on
             PyList_SET_ITEM(list, 0, tuple);
 
@@ -965,12 +1013,12 @@ Bindings::seasonMetrics(bool all, QString filter, bool compare) const
 
         // just a dict of metrics
         DateRange range = context->currentDateRange();
-        return seasonMetrics(all, range, filter);
+        return seasonMetrics(all, range, filter, names, buffers);
     }
 }
 
 PyObject*
-Bindings::seasonMetrics(bool all, DateRange range, QString filter) const
+Bindings::seasonMetrics(bool all, DateRange range, QString filter, QStringList names, bool buffers) const
 {
     Context *context = python->contexts.value(threadid()).context;
     if (context == NULL || context->athlete == NULL || context->athlete->rideCache == NULL) return NULL;
@@ -995,12 +1043,13 @@ Bindings::seasonMetrics(bool all, DateRange range, QString filter) const
 
     specification.setFilterSet(fs);
 
-    // we need to count rides that are in range...
-    int rides = 0;
+    // the rides that are in range...
+    QList<RideItem*> selected;
     foreach(RideItem *ride, context->athlete->rideCache->rides()) {
         if (!specification.pass(ride)) continue;
-        if (all || range.pass(ride->dateTime.date())) rides++;
+        if (all || range.pass(ride->dateTime.date())) selected << ride;
     }
+    int rides = selected.count();
 
     PyObject* dict = PyDict_New();
     if (dict == NULL) return dict;
@@ -1015,35 +1064,32 @@ Bindings::seasonMetrics(bool all, DateRange range, QString filter) const
     PyObject* colorlist = PyList_New(rides);
 
     int idx = 0;
-    foreach(RideItem *ride, context->athlete->rideCache->rides()) {
-        if (!specification.pass(ride)) continue;
-        if (all || range.pass(ride->dateTime.date())) {
+    foreach(RideItem *ride, selected) {
 
-            QDate d = ride->dateTime.date();
-            PyList_SET_ITEM(datelist, idx, PyDate_FromDate(d.year(), d.month(), d.day()));
+        QDate d = ride->dateTime.date();
+        PyList_SET_ITEM(datelist, idx, PyDate_FromDate(d.year(), d.month(), d.day()));
 
-            QTime t = ride->dateTime.time();
-            PyList_SET_ITEM(timelist, idx, PyTime_FromTime(t.hour(), t.minute(), t.second(), t.msec()*10));
+        QTime t = ride->dateTime.time();
+        PyList_SET_ITEM(timelist, idx, PyTime_FromTime(t.hour(), t.minute(), t.second(), t.msec()*10));
 
-            // apply item color, remembering that 1,1,1 means use default (reverse in this case)
-            QString color;
+        // apply item color, remembering that 1,1,1 means use default (reverse in this case)
+        QString color;
 
-            if (ride->color == QColor(1,1,1,1)) {
+        if (ride->color == QColor(1,1,1,1)) {
 
-                // use the inverted color, not plot marker as that hideous
-                QColor col =GCColor::invertColor(GColor(CPLOTBACKGROUND));
+            // use the inverted color, not plot marker as that hideous
+            QColor col =GCColor::invertColor(GColor(CPLOTBACKGROUND));
 
-                // white is jarring on a dark background!
-                if (col==QColor(Qt::white)) col=QColor(127,127,127);
+            // white is jarring on a dark background!
+            if (col==QColor(Qt::white)) col=QColor(127,127,127);
 
-                color = col.name();
-            } else
-                color = ride->color.name();
+            color = col.name();
+        } else
+            color = ride->color.name();
 
-            PyList_SET_ITEM(colorlist, idx, PyUnicode_FromString(color.toUtf8().constData()));
+        PyList_SET_ITEM(colorlist, idx, PyUnicode_FromString(color.toUtf8().constData()));
 
-            idx++;
-        }
+        idx++;
     }
 
     PyDict_SetItemString(dict, "date", datelist);
@@ -1063,19 +1109,18 @@ Bindings::seasonMetrics(bool all, DateRange range, QString filter) const
         name = name.replace(" ","_");
         name = name.replace("'","_");
 
-        // set a list of metric values
-        PyObject* metriclist = PyList_New(rides);
+        // not wanted
+        if (!names.isEmpty() && !names.contains(name)) continue;
 
-        int idx = 0;
-        foreach(RideItem *item, context->athlete->rideCache->rides()) {
-            if (!specification.pass(item)) continue;
-            if (all || range.pass(item->dateTime.date())) {
-                PyList_SET_ITEM(metriclist, idx++, PyFloat_FromDouble(item->metrics()[i] * (useMetricUnits ? 1.0f : metric->conversion()) + (useMetricUnits ? 0.0f : metric->conversionSum())));
-            }
-        }
+        // set a column of metric values
+        QVector<double> values(rides);
+        for (int idx=0; idx<rides; idx++)
+            values[idx] = selected[idx]->metrics()[i] * (useMetricUnits ? 1.0f : metric->conversion()) + (useMetricUnits ? 0.0f : metric->conversionSum());
 
-        // add to the dict
+        // add to the dict, which holds its own reference
+        PyObject* metriclist = column(name, values, buffers);
         PyDict_SetItemString(dict, name.toUtf8().constData(), metriclist);
+        Py_DECREF(metriclist);
     }
 
     //
@@ -1087,16 +1132,14 @@ Bindings::seasonMetrics(bool all, DateRange range, QString filter) const
         if (field.name == "" || field.tab == "" ||
             context->specialFields.isMetric(field.name)) continue;
 
+        // not wanted
+        if (!names.isEmpty() && !names.contains(QString(field.name).replace(" ","_"))) continue;
+
         // Create a string list
         PyObject* metalist = PyList_New(rides);
 
-        int idx = 0;
-        foreach(RideItem *item, context->athlete->rideCache->rides()) {
-            if (!specification.pass(item)) continue;
-            if (all || range.pass(item->dateTime.date())) {
-                PyList_SET_ITEM(metalist, idx++, PyUnicode_FromString(item->getText(field.name, "").toUtf8().constData()));
-            }
-        }
+        for (int idx=0; idx<rides; idx++)
+            PyList_SET_ITEM(metalist, idx, PyUnicode_FromString(selected[idx]->getText(field.name, "").toUtf8().constData()));
 
         // add to the dict
         PyDict_SetItemString(dict, field.name.replace(" ","_").toUtf8().constData(), metalist);
@@ -1106,11 +1149,14 @@ Bindings::seasonMetrics(bool all, DateRange range, QString filter) const
 }
 
 PyObject*
-Bindings::seasonIntervals(QString type, bool compare) const
+Bindings::seasonIntervals(QString type, bool compare, PyObject* metrics, bool buffers) const
 {
     Context *context = python->contexts.value(threadid()).context;
     if (context == NULL) return NULL;
 
+    // just the metrics asked for, or all of them
+    QStringList names = nameList(metrics);
+
     // want a list of compares
     if (compare) {
 
@@ -1130,7 +1176,7 @@ Bindings::seasonIntervals(QString type, bool compare) const
                 if (p.isChecked()) {
 
                     // create a tuple (metrics, color)
-                    PyObject* tuple = Py_BuildValue("(Os)", seasonIntervals(DateRange(p.start, p.end), type), p.color.name().toUtf8().constData());
+                    PyObject* tuple = Py_BuildValue("(Os)", seasonIntervals(DateRange(p.start, p.end), type, names, buffers), p.color.name().toUtf8().constData());
                     // add to back and move on
                     PyList_SET_ITEM(list, idx++, tuple);
                 }
@@ -1145,7 +1191,7 @@ Bindings::seasonIntervals(QString type, bool compare) const
 
             // create a tuple (metrics, color)
             DateRange range = context->currentDateRange();
-            PyObject* tuple = Py_BuildValue("(Os)", seasonIntervals(range, type), "#FF00FF");
+            PyObject* tuple = Py_BuildValue("(Os)", seasonIntervals(range, type, names, buffers), "#FF00FF");
             // add to back and move on
             PyList_SET_ITEM(list, 0, tuple);
 
@@ -1156,12 +1202,12 @@ Bindings::seasonIntervals(QString type, bool compare) const
 
         // just a dict of metrics
         DateRange range = context->currentDateRange();
-        return seasonIntervals(range, type);
+        return seasonIntervals(range, type, names, buffers);
     }
 }
 
 PyObject*
-Bindings::seasonIntervals(DateRange range, QString type) const
+Bindings::seasonIntervals(DateRange range, QString type, QStringList names, bool buffers) const
 {
     Context *context = python->contexts.value(threadid()).context;
     if (context == NULL || context->athlete == NULL || context->athlete->rideCache == NULL) return NULL;
@@ -1178,19 +1224,17 @@ Bindings::seasonIntervals(DateRange range, QString type) const
     fs.addFilter(context->ishomefiltered, context->homeFilters);
     specification.setFilterSet(fs);
 
-    // we need to count intervals that are in range...
-    intervals = 0;
+    // the intervals that are in range, with the ride they belong to
+    QList<IntervalItem*> selected;
     foreach(RideItem *ride, context->athlete->rideCache->rides()) {
         if (!specification.pass(ride)) continue;
         if (!range.pass(ride->dateTime.date())) continue;
 
-        if (type.isEmpty()) intervals += ride->intervals().count();
-        else {
-            foreach(IntervalItem *item, ride->intervals())
-                if (type == RideFileInterval::typeDescription(item->type))
-                    intervals++;
-        }
+        foreach(IntervalItem *item, ride->intervals())
+            if (type.isEmpty() || type == RideFileInterval::typeDescription(item->type))
+                selected << item;
     }
+    intervals = selected.count();
 
     PyObject* dict = PyDict_New();
     if (dict == NULL) return dict;
@@ -1207,41 +1251,37 @@ Bindings::seasonIntervals(DateRange range, QString type) const
     PyObject* colorlist = PyList_New(intervals);
 
     int idx=0;
-    foreach(RideItem *ride, context->athlete->rideCache->rides()) {
-        if (!specification.pass(ride)) continue;
-        if (range.pass(ride->dateTime.date())) {
-            foreach(IntervalItem *item, ride->intervals())
-                if (type.isEmpty() || type == RideFileInterval::typeDescription(item->type)) {
-
-                    // DATE
-                    QDate d = ride->dateTime.date();
-                    PyList_SET_ITEM(datelist, idx, PyDate_FromDate(d.year(), d.month(), d.day()));
-
-                    // TIME - time offsets by time of interval
-                    QTime t = ride->dateTime.time().addSecs(item->start);
-                    PyList_SET_ITEM(timelist, idx, PyTime_FromTime(t.hour(), t.minute(), t.second(), t.msec()*10));
-
-                    // NAME
-                    PyList_SET_ITEM(namelist, idx, PyUnicode_FromString(item->name.toUtf8().constData()));
-
-                    // TYPE
-                    PyList_SET_ITEM(typelist, idx, PyUnicode_FromString(RideFileInterval::typeDescription(item->type).toUtf8().constData()));
-
-                    // apply item color, remembering that 1,1,1 means use default (reverse in this case)
-                    QString color;
-                    if (item->color == QColor(1,1,1,1)) {
-                        // use the inverted color, not plot marker as that hideous
-                        QColor col =GCColor::invertColor(GColor(CPLOTBACKGROUND));
-                        // white is jarring on a dark background!
-                        if (col==QColor(Qt::white)) col=QColor(127,127,127);
-                        color = col.name();
-                    } else
-                        color = item->color.name();
-                    PyList_SET_ITEM(colorlist, idx, PyUnicode_FromString(color.toUtf8().constData()));
-
-                    idx++;
-                }
-        }
+    foreach(IntervalItem *item, selected) {
+
+        RideItem *ride = item->rideItem();
+
+        // DATE
+        QDate d = ride->dateTime.date();
+        PyList_SET_ITEM(datelist, idx, PyDate_FromDate(d.year(), d.month(), d.day()));
+
+        // TIME - time offsets by time of interval
+        QTime t = ride->dateTime.time().addSecs(item->start);
+        PyList_SET_ITEM(timelist, idx, PyTime_FromTime(t.hour(), t.minute(), t.second(), t.msec()*10));
+
+        // NAME
+        PyList_SET_ITEM(namelist, idx, PyUnicode_FromString(item->name.toUtf8().constData()));
+
+        // TYPE
+        PyList_SET_ITEM(typelist, idx, PyUnicode_FromString(RideFileInterval::typeDescription(item->type).toUtf8().constData()));
+
+        // apply item color, remembering that 1,1,1 means use default (reverse in this case)
+        QString color;
+        if (item->color == QColor(1,1,1,1)) {
+            // use the inverted color, not plot marker as that hideous
+            QColor col =GCColor::invertColor(GColor(CPLOTBACKGROUND));
+            // white is jarring on a dark background!
+            if (col==QColor(Qt::white)) col=QColor(127,127,127);
+            color = col.name();
+        } else
+            color = item->color.name();
+        PyList_SET_ITEM(colorlist, idx, PyUnicode_FromString(color.toUtf8().constData()));
+
+        idx++;
     }
 
     PyDict_SetItemString(dict, "date", datelist);
@@ -1253,33 +1293,27 @@ Bindings::seasonIntervals(DateRange range, QString type) const
     //
     // METRICS
     //
+    bool useMetricUnits = context->athlete->useMetricUnits;
     for(int i=0; i<factory.metricCount();i++) {
 
-        // set a list of metric values
-        PyObject* metriclist = PyList_New(intervals);
-
         QString symbol = factory.metricName(i);
         const RideMetric *metric = factory.rideMetric(symbol);
         QString name = context->specialFields.internalName(factory.rideMetric(symbol)->name());
         name = name.replace(" ","_");
         name = name.replace("'","_");
 
-        bool useMetricUnits = context->athlete->useMetricUnits;
-
-        int index=0;
-        foreach(RideItem *item, context->athlete->rideCache->rides()) {
-            if (!specification.pass(item)) continue;
-            if (range.pass(item->dateTime.date())) {
+        // not wanted
+        if (!names.isEmpty() && !names.contains(name)) continue;
 
-                foreach(IntervalItem *interval, item->intervals()) {
-                    if (type.isEmpty() || type == RideFileInterval::typeDescription(interval->type))
-                        PyList_SET_ITEM(metriclist, index++, PyFloat_FromDouble(interval->metrics()[i] * (useMetricUnits ? 1.0f : metric->conversion()) + (useMetricUnits ? 0.0f : metric->conversionSum())));
-                }
-            }
-        }
+        // set a column of metric values
+        QVector<double> values(intervals);
+        for (int index=0; index<intervals; index++)
+            values[index] = selected[index]->metrics()[i] * (useMetricUnits ? 1.0f : metric->conversion()) + (useMetricUnits ? 0.0f : metric->conversionSum());
 
-        // add to the dict
+        // add to the dict, which holds its own reference
+        PyObject* metriclist = column(name, values, buffers);
         PyDict_SetItemString(dict, name.toUtf8().constData(), metriclist);
+        Py_DECREF(metriclist);
     }
 
     return dict;
@@ -1507,7 +1541,7 @@ Bindings::activityMeanmax(bool compare) const
 }
 
 PyObject*
-Bindings::seasonMeanmax(bool all, QString filter, bool compare) const
+Bindings::seasonMeanmax(bool all, QString filter, bool compare, bool buffers) const
 {
     Context *context = python->contexts.value(threadid()).context;
     if (context == NULL) return NULL;
@@ -1531,7 +1565,7 @@ Bindings::seasonMeanmax(bool all, QString filter, bool compare) const
                 if (p.isChecked()) {
 
                     // create a tuple (meanmax, color)
-                    PyObject* tuple = Py_BuildValue("(Os)", seasonMeanmax(all, DateRange(p.start, p.end), filter), p.color.name().toUtf8().constData());
+                    PyObject* tuple = Py_BuildValue("(Os)", seasonMeanmax(all, DateRange(p.start, p.end), filter, buffers), p.color.name().toUtf8().constData());
                     // add to back and move on
                     PyList_SET_ITEM(list, idx++, tuple);
                 }
@@ -1546,7 +1580,7 @@ Bindings::seasonMeanmax(bool all, QString filter, bool compare) const
 
             // create a tuple (meanmax, color)
             DateRange range = context->currentDateRange();
-            PyObject* tuple = Py_BuildValue("(Os)", seasonMeanmax(all, range, filter), "#FF00FF");
+            PyObject* tuple = Py_BuildValue("(Os)", seasonMeanmax(all, range, filter, buffers), "#FF00FF");
             // add to back and move on
             PyList_SET_ITEM(list, 0, tuple);
 
@@ -1558,12 +1592,12 @@ Bindings::seasonMeanmax(bool all, QString filter, bool compare) const
         // just a datafram of meanmax
         DateRange range = context->currentDateRange();
 
-        return seasonMeanmax(all, range, filter);
+        return seasonMeanmax(all, range, filter, buffers);
     }
 }
 
 PyObject*
-Bindings::seasonMeanmax(bool all, DateRange range, QString filter) const
+Bindings::seasonMeanmax(bool all, DateRange range, QString filter, bool buffers) const
 {
     Context *context = python->contexts.value(threadid()).context;
     if (context == NULL) return NULL;
@@ -1586,7 +1620,7 @@ Bindings::seasonMeanmax(bool all, DateRange range, QString filter) const
     // RideFileCache for a date range with our filters (if any)
     RideFileCache cache(context, range.from, range.to, filt, filelist, false, NULL);
 
-    return rideFileCacheMeanmax(&cache);
+    return rideFileCacheMeanmax(&cache, buffers);
 }
 
 PyObject*
@@ -1596,7 +1630,7 @@ Bindings::activityMeanmax(const RideItem* item) const
 }
 
 PyObject*
-Bindings::rideFileCacheMeanmax(RideFileCache* cache) const
+Bindings::rideFileCacheMeanmax(RideFileCache* cache, bool buffers) const
 {
     if (PyDateTimeAPI == NULL) PyDateTime_IMPORT;// import datetime if necessary
 
@@ -1616,16 +1650,15 @@ Bindings::rideFileCacheMeanmax(RideFileCache* cache) const
         if (series != RideFile::watts && values.count()==0) continue;
 
 
-        // set a list
-        PyObject* list = PyList_New(values.count());
-
         // will have different sizes e.g. when a daterange
         // since longest ride with e.g. power may be different
         // to longest ride with heartrate
-        for(int j=0; j<values.count(); j++) PyList_SET_ITEM(list, j, PyFloat_FromDouble(values[j]));
+        QString name = RideFile::seriesName(series, true);
+        PyObject* list = column(name, values, buffers);
 
-        // add to the dict
-        PyDict_SetItemString(ans, RideFile::seriesName(series, true).toUtf8().constData(), list);
+        // add to the dict, which holds its own reference
+        PyDict_SetItemString(ans, name.toUtf8().constData(), list);
+        Py_DECREF(list);
 
         // if is power add the dates
         if(series == RideFile::watts) {
@@ -1894,7 +1927,7 @@ Bindings::season(bool all, bool compare) const
 }
 
 PyObject*
-Bindings::seasonPeaks(QString series, int duration, bool all, QString filter, bool compare) const
+Bindings::seasonPeaks(QString series, int duration, bool all, QString filter, bool compare, bool buffers) const
 {
     Context *context = python->contexts.value(threadid()).context;
     if (context == NULL) return NULL;
@@ -1939,7 +1972,7 @@ Bindings::seasonPeaks(QString series, int duration, bool all, QString filter, bo
                 if (p.isChecked()) {
 
                     // create a tuple (peaks, color)
-                    PyObject* tuple = Py_BuildValue("(Os)", seasonPeaks(all, DateRange(p.start, p.end), filter, seriesList, durations), p.color.name().toUtf8().constData());
+                    PyObject* tuple = Py_BuildValue("(Os)", seasonPeaks(all, DateRange(p.start, p.end), filter, seriesList, durations, buffers), p.color.name().toUtf8().constData());
                     // add to back and move on
                     PyList_SET_ITEM(list, idx++, tuple);
                 }
@@ -1954,7 +1987,7 @@ Bindings::seasonPeaks(QString series, int duration, bool all, QString filter, bo
 
             // create a tuple (peaks, color)
             DateRange range = context->currentDateRange();
-            PyObject* tuple = Py_BuildValue("(Os)", seasonPeaks(all, range, filter, seriesList, durations), "#FF00FF");
+            PyObject* tuple = Py_BuildValue("(Os)", seasonPeaks(all, range, filter, seriesList, durations, buffers), "#FF00FF");
             // add to back and move on
             PyList_SET_ITEM(list, 0, tuple);
 
@@ -1966,7 +1999,7 @@ Bindings::seasonPeaks(QString series, int duration, bool all, QString filter, bo
         // just a dict of peaks
         DateRange range = context->currentDateRange();
 
-        return seasonPeaks(all, range, filter, seriesList, durations);
+        return seasonPeaks(all, range, filter, seriesList, durations, buffers);
 
     }
 
@@ -1975,7 +2008,7 @@ Bindings::seasonPeaks(QString series, int duration, bool all, QString filter, bo
 }
 
 PyObject*
-Bindings::seasonPeaks(bool all, DateRange range, QString filter, QList<RideFile::SeriesType> series, QList<int> durations) const
+Bindings::seasonPeaks(bool all, DateRange range, QString filter, QList<RideFile::SeriesType> series, QList<int> durations, bool buffers) const
 {
     if (PyDateTimeAPI == NULL) PyDateTime_IMPORT;// import datetime if necessary
 
@@ -2003,32 +2036,28 @@ Bindings::seasonPeaks(bool all, DateRange range, QString filter, QList<RideFile:
     }
     specification.setFilterSet(fs);
 
-    // how many pass?
-    int size=0;
+    // which pass?
+    QList<RideItem*> selected;
     foreach(RideItem *item, context->athlete->rideCache->rides()) {
 
         // apply filters
         if (!specification.pass(item)) continue;
 
         // do we want this one ?
-        if (all || range.pass(item->dateTime.date()))  size++;
+        if (all || range.pass(item->dateTime.date())) selected << item;
     }
+    int size = selected.count();
 
     // dates first
     PyObject* datetimelist = PyList_New(size);
 
     // fill with values for date
     int i=0;
-    foreach(RideItem *item, context->athlete->rideCache->rides()) {
-        // apply filters
-        if (!specification.pass(item)) continue;
-
-        if (all || range.pass(item->dateTime.date())) {
-            // add datetime to the list
-            QDate d = item->dateTime.date();
-            QTime t = item->dateTime.time();
-            PyList_SET_ITEM(datetimelist, i++, PyDateTime_FromDateAndTime(d.year(), d.month(), d.day(), t.hour(), t.minute(), t.second(), t.msec()*10));
-        }
+    foreach(RideItem *item, selected) {
+        // add datetime to the list
+        QDate d = item->dateTime.date();
+        QTime t = item->dateTime.time();
+        PyList_SET_ITEM(datetimelist, i++, PyDateTime_FromDateAndTime(d.year(), d.month(), d.day(), t.hour(), t.minute(), t.second(), t.msec()*10));
     }
 
     // add to the dict
@@ -2038,31 +2067,21 @@ Bindings::seasonPeaks(bool all, DateRange range, QString filter, QList<RideFile:
 
         foreach(int pduration, durations) {
 
-            // set a list
-            PyObject* list = PyList_New(size);
-
             // give it a name
             QString name = QString("peak_%1_%2").arg(RideFile::seriesName(pseries, true)).arg(pduration);
 
             // fill with values
             // get the value for the series and duration requested, although this is called
-            int index=0;
-            foreach(RideItem *item, context->athlete->rideCache->rides()) {
-
-                // apply filters
-                if (!specification.pass(item)) continue;
-
-                // do we want this one ?
-                if (all || range.pass(item->dateTime.date())) {
-
-                    // for each series/duration independently its pretty quick since it lseeks to
-                    // the actual value, so /should't/ be too expensive.........
-                    PyList_SET_ITEM(list, index++, PyFloat_FromDouble(RideFileCache::best(item->context, item->fileName, pseries, pduration)));
-                }
-            }
-
-            // add to the dict
+            // for each series/duration independently its pretty quick since it lseeks to
+            // the actual value, so /should't/ be too expensive.........
+            QVector<double> values(size);
+            for (int index=0; index<size; index++)
+                values[index] = RideFileCache::best(selected[index]->context, selected[index]->fileName, pseries, pduration);
+
+            // add to the dict, which holds its own reference
+            PyObject* list = column(name, values, buffers);
             PyDict_SetItemString(ans, name.toUtf8().constData(), list);
+            Py_DECREF(list);
         }
     }
 
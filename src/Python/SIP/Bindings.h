@@ -1,4 +1,6 @@
 #include <QString>
+#include <QStringList>
+#include <QVector>
 #include "RideFile.h"
 #include "RideFileCache.h"
 
@@ -52,33 +54,40 @@ class Bindings {
 
         // working with metrics
         PyObject* activityMetrics(bool compare=false) const;
-        PyObject* seasonMetrics(bool all=false, QString filter=QString(), bool compare=false) const;
+        PyObject* seasonMetrics(bool all=false, QString filter=QString(), bool compare=false, PyObject* metrics=NULL, bool buffers=false) const;
         PythonDataSeries *metrics(QString metric, bool all=false, QString filter=QString()) const;
         PyObject* seasonPmc(bool all=false, QString metric=QString("TSS")) const;
         PyObject* seasonMeasures(bool all=false, QString group=QString("Body")) const;
 
         // working with meanmax data
         PyObject* activityMeanmax(bool compare=false) const;
-        PyObject* seasonMeanmax(bool all=false, QString filter=QString(), bool compare=false) const;
-        PyObject* seasonPeaks(QString series, int duration, bool all=false, QString filter=QString(), bool compare=false) const;
+        PyObject* seasonMeanmax(bool all=false, QString filter=QString(), bool compare=false, bool buffers=false) const;
+        PyObject* seasonPeaks(QString series, int duration, bool all=false, QString filter=QString(), bool compare=false, bool buffers=false) const;
 
         // working with intervals
-        PyObject* seasonIntervals(QString type=QString(), bool compare=false) const;
+        PyObject* seasonIntervals(QString type=QString(), bool compare=false, PyObject* metrics=NULL, bool buffers=false) const;
         PyObject* activityIntervals(QString type=QString(), PyObject* activity=NULL) const;
 
     private:
         // find a RideItem by DateTime
         RideItem* fromDateTime(PyObject* activity=NULL) const;
 
+        // names from a str or a sequence of str, empty means all
+        QStringList nameList(PyObject* names) const;
+
         // get a dict populated with metrics and metadata
         PyObject* activityMetrics(RideItem* item) const;
-        PyObject* seasonMetrics(bool all, DateRange range, QString filter) const;
-        PyObject* seasonIntervals(DateRange range, QString type) const;
+        PyObject* seasonMetrics(bool all, DateRange range, QString filter, QStringList names, bool buffers) const;
+        PyObject* seasonIntervals(DateRange range, QString type, QStringList names, bool buffers) const;
 
         // get a dict populated with meanmax data
         PyObject* activityMeanmax(const RideItem* item) const;
-        PyObject* seasonMeanmax(bool all, DateRange range, QString filter) const;
-        PyObject* rideFileCacheMeanmax(RideFileCache* cache) const;
-        PyObject* seasonPeaks(bool all, DateRange range, QString filter, QList<RideFile::SeriesType> series, QList<int> durations) const;
+        PyObject* seasonMeanmax(bool all, DateRange range, QString filter, bool buffers) const;
+        PyObject* rideFileCacheMeanmax(RideFileCache* cache, bool buffers=false) const;
+        PyObject* seasonPeaks(bool all, DateRange range, QString filter, QList<RideFile::SeriesType> series, QList<int> durations, bool buffers) const;
+
+        // a column of values as a list, or as a PythonDataSeries
+        // using the buffer protocol to avoid a float object per value
+        PyObject* column(QString name, const QVector<double> &values, bool buffers) const;
 
 };
@@ -77,38 +77,40 @@
 #define sipName___str__ &sipStrings_goldencheetah[354]
 #define sipNameNr_QString 362
 #define sipName_QString &sipStrings_goldencheetah[362]
-#define sipNameNr_metric 370
-#define sipName_metric &sipStrings_goldencheetah[370]
-#define sipNameNr_series 377
-#define sipName_series &sipStrings_goldencheetah[377]
-#define sipNameNr_season 384
-#define sipName_season &sipStrings_goldencheetah[384]
-#define sipNameNr_filter 391
-#define sipName_filter &sipStrings_goldencheetah[391]
-#define sipNameNr_result 398
-#define sipName_result &sipStrings_goldencheetah[398]
-#define sipNameNr_group 405
-#define sipName_group &sipStrings_goldencheetah[405]
-#define sipNameNr_xdata 411
-#define sipName_xdata &sipStrings_goldencheetah[411]
-#define sipNameNr_sport 417
-#define sipName_sport &sipStrings_goldencheetah[417]
-#define sipNameNr_value 423
-#define sipName_value &sipStrings_goldencheetah[423]
-#define sipNameNr_build 429
-#define sipName_build &sipStrings_goldencheetah[429]
-#define sipNameNr_join 435
-#define sipName_join &sipStrings_goldencheetah[435]
-#define sipNameNr_name 440
-#define sipName_name &sipStrings_goldencheetah[440]
-#define sipNameNr_type 445
-#define sipName_type &sipStrings_goldencheetah[445]
-#define sipNameNr_date 450
-#define sipName_date &sipStrings_goldencheetah[450]
-#define sipNameNr_all 455
-#define sipName_all &sipStrings_goldencheetah[455]
-#define sipNameNr_url 459
-#define sipName_url &sipStrings_goldencheetah[459]
+#define sipNameNr_buffers 370
+#define sipName_buffers &sipStrings_goldencheetah[370]
+#define sipNameNr_metric 378
+#define sipName_metric &sipStrings_goldencheetah[378]
+#define sipNameNr_series 385
+#define sipName_series &sipStrings_goldencheetah[385]
+#define sipNameNr_season 392
+#define sipName_season &sipStrings_goldencheetah[392]
+#define sipNameNr_filter 399
+#define sipName_filter &sipStrings_goldencheetah[399]
+#define sipNameNr_result 406
+#define sipName_result &sipStrings_goldencheetah[406]
+#define sipNameNr_group 413
+#define sipName_group &sipStrings_goldencheetah[413]
+#define sipNameNr_xdata 419
+#define sipName_xdata &sipStrings_goldencheetah[419]
+#define sipNameNr_sport 425
+#define sipName_sport &sipStrings_goldencheetah[425]
+#define sipNameNr_value 431
+#define sipName_value &sipStrings_goldencheetah[431]
+#define sipNameNr_build 437
+#define sipName_build &sipStrings_goldencheetah[437]
+#define sipNameNr_join 443
+#define sipName_join &sipStrings_goldencheetah[443]
+#define sipNameNr_name 448
+#define sipName_name &sipStrings_goldencheetah[448]
+#define sipNameNr_type 453
+#define sipName_type &sipStrings_goldencheetah[453]
+#define sipNameNr_date 458
+#define sipName_date &sipStrings_goldencheetah[458]
+#define sipNameNr_all 463
+#define sipName_all &sipStrings_goldencheetah[463]
+#define sipNameNr_url 467
+#define sipName_url &sipStrings_goldencheetah[467]
 
 #define sipMalloc                   sipAPI_goldencheetah->api_malloc
 #define sipFree                     sipAPI_goldencheetah->api_free
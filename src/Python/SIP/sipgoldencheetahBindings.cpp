@@ -585,19 +585,23 @@ static PyObject *meth_Bindings_seasonMetrics(PyObject *sipSelf, PyObject *sipArg
          ::QString* a1 = &a1def;
         int a1State = 0;
         bool a2 = 0;
+        PyObject * a3 = 0;
+        bool a4 = 0;
          ::Bindings *sipCpp;
 
         static const char *sipKwdList[] = {
             sipName_all,
             sipName_filter,
             sipName_compare,
+            sipName_metrics,
+            sipName_buffers,
         };
 
-        if (sipParseKwdArgs(&sipParseErr, sipArgs, sipKwds, sipKwdList, NULL, "B|bJ1b", &sipSelf, sipType_Bindings, &sipCpp, &a0, sipType_QString,&a1, &a1State, &a2))
+        if (sipParseKwdArgs(&sipParseErr, sipArgs, sipKwds, sipKwdList, NULL, "B|bJ1bP0b", &sipSelf, sipType_Bindings, &sipCpp, &a0, sipType_QString,&a1, &a1State, &a2, &a3, &a4))
         {
             PyObject * sipRes;
 
-            sipRes = sipCpp->seasonMetrics(a0,*a1,a2);
+            sipRes = sipCpp->seasonMetrics(a0,*a1,a2,a3,a4);
             sipReleaseType(a1,sipType_QString,a1State);
 
             return sipRes;
@@ -761,19 +765,21 @@ static PyObject *meth_Bindings_seasonMeanmax(PyObject *sipSelf, PyObject *sipArg
          ::QString* a1 = &a1def;
         int a1State = 0;
         bool a2 = 0;
+        bool a3 = 0;
          ::Bindings *sipCpp;
 
         static const char *sipKwdList[] = {
             sipName_all,
             sipName_filter,
             sipName_compare,
+            sipName_buffers,
         };
 
-        if (sipParseKwdArgs(&sipParseErr, sipArgs, sipKwds, sipKwdList, NULL, "B|bJ1b", &sipSelf, sipType_Bindings, &sipCpp, &a0, sipType_QString,&a1, &a1State, &a2))
+        if (sipParseKwdArgs(&sipParseErr, sipArgs, sipKwds, sipKwdList, NULL, "B|bJ1bb", &sipSelf, sipType_Bindings, &sipCpp, &a0, sipType_QString,&a1, &a1State, &a2, &a3))
         {
             PyObject * sipRes;
 
-            sipRes = sipCpp->seasonMeanmax(a0,*a1,a2);
+            sipRes = sipCpp->seasonMeanmax(a0,*a1,a2,a3);
             sipReleaseType(a1,sipType_QString,a1State);
 
             return sipRes;
@@ -801,6 +807,7 @@ static PyObject *meth_Bindings_seasonPeaks(PyObject *sipSelf, PyObject *sipArgs,
          ::QString* a3 = &a3def;
         int a3State = 0;
         bool a4 = 0;
+        bool a5 = 0;
          ::Bindings *sipCpp;
 
         static const char *sipKwdList[] = {
@@ -809,13 +816,14 @@ static PyObject *meth_Bindings_seasonPeaks(PyObject *sipSelf, PyObject *sipArgs,
             sipName_all,
             sipName_filter,
             sipName_compare,
+            sipName_buffers,
         };
 
-        if (sipParseKwdArgs(&sipParseErr, sipArgs, sipKwds, sipKwdList, NULL, "BJ1i|bJ1b", &sipSelf, sipType_Bindings, &sipCpp, sipType_QString,&a0, &a0State, &a1, &a2, sipType_QString,&a3, &a3State, &a4))
+        if (sipParseKwdArgs(&sipParseErr, sipArgs, sipKwds, sipKwdList, NULL, "BJ1i|bJ1bb", &sipSelf, sipType_Bindings, &sipCpp, sipType_QString,&a0, &a0State, &a1, &a2, sipType_QString,&a3, &a3State, &a4, &a5))
         {
             PyObject * sipRes;
 
-            sipRes = sipCpp->seasonPeaks(*a0,a1,a2,*a3,a4);
+            sipRes = sipCpp->seasonPeaks(*a0,a1,a2,*a3,a4,a5);
             sipReleaseType(a0,sipType_QString,a0State);
             sipReleaseType(a3,sipType_QString,a3State);
 
@@ -840,18 +848,22 @@ static PyObject *meth_Bindings_seasonIntervals(PyObject *sipSelf, PyObject *sipA
          ::QString* a0 = &a0def;
         int a0State = 0;
         bool a1 = 0;
+        PyObject * a2 = 0;
+        bool a3 = 0;
          ::Bindings *sipCpp;
 
         static const char *sipKwdList[] = {
             sipName_type,
             sipName_compare,
+            sipName_metrics,
+            sipName_buffers,
         };
 
-        if (sipParseKwdArgs(&sipParseErr, sipArgs, sipKwds, sipKwdList, NULL, "B|J1b", &sipSelf, sipType_Bindings, &sipCpp, sipType_QString,&a0, &a0State, &a1))
+        if (sipParseKwdArgs(&sipParseErr, sipArgs, sipKwds, sipKwdList, NULL, "B|J1bP0b", &sipSelf, sipType_Bindings, &sipCpp, sipType_QString,&a0, &a0State, &a1, &a2, &a3))
         {
             PyObject * sipRes;
 
-            sipRes = sipCpp->seasonIntervals(*a0,a1);
+            sipRes = sipCpp->seasonIntervals(*a0,a1,a2,a3);
             sipReleaseType(a0,sipType_QString,a0State);
 
             return sipRes;
@@ -47,6 +47,7 @@ const char sipStrings_goldencheetah[] = {
     '_', '_', 'l', 'e', 'n', '_', '_', 0,
     '_', '_', 's', 't', 'r', '_', '_', 0,
     'Q', 'S', 't', 'r', 'i', 'n', 'g', 0,
+    'b', 'u', 'f', 'f', 'e', 'r', 's', 0,
     'm', 'e', 't', 'r', 'i', 'c', 0,
     's', 'e', 'r', 'i', 'e', 's', 0,
     's', 'e', 'a', 's', 'o', 'n', 0,
@@ -183,9 +183,10 @@ RTool::RTool()
 
             // all=FALSE, compare=FALSE
             { "GC.season", (DL_FUNC) &RTool::season, 2 },
-            { "GC.season.metrics", (DL_FUNC) &RTool::metrics, 3 },
-            // type=any, compare=FALSE
-            { "GC.season.intervals", (DL_FUNC) &RTool::seasonIntervals, 2 },
+            // all=FALSE, filter="", compare=FALSE, metrics=NULL
+            { "GC.season.metrics", (DL_FUNC) &RTool::metrics, 4 },
+            // type=any, compare=FALSE, metrics=NULL
+            { "GC.season.intervals", (DL_FUNC) &RTool::seasonIntervals, 3 },
             { "GC.season.meanmax", (DL_FUNC) &RTool::seasonMeanmax, 3 },
             { "GC.season.peaks", (DL_FUNC) &RTool::seasonPeaks, 5 },
             // return a data.frame of pmc series (all=FALSE, metric="BikeStress")
@@ -274,8 +275,8 @@ RTool::RTool()
 
                                // season
                                "GC.season <- function(all=FALSE, compare=FALSE) { .Call(\"GC.season\", all, compare) }\n"
-                               "GC.season.metrics <- function(all=FALSE, filter=\"\", compare=FALSE) { .Call(\"GC.season.metrics\", all, filter, compare) }\n"
-                               "GC.season.intervals <- function(type=NULL, compare=FALSE) { .Call(\"GC.season.intervals\", type, compare) }\n"
+                               "GC.season.metrics <- function(all=FALSE, filter=\"\", compare=FALSE, metrics=NULL) { .Call(\"GC.season.metrics\", all, filter, compare, metrics) }\n"
+                               "GC.season.intervals <- function(type=NULL, compare=FALSE, metrics=NULL) { .Call(\"GC.season.intervals\", type, compare, metrics) }\n"
                                "GC.season.pmc <- function(all=FALSE, metric=\"BikeStress\") { .Call(\"GC.season.pmc\", all, metric) }\n"
                                "GC.season.measures <- function(all=FALSE, group=\"Body\") { .Call(\"GC.season.measures\", all, group) }\n"
                                "GC.season.meanmax <- function(all=FALSE, filter=\"\", compare=FALSE) { .Call(\"GC.season.meanmax\", all, filter, compare) }\n"
@@ -287,7 +288,7 @@ RTool::RTool()
                                "   .Call(\"GC.season.peaks\", all, filter, compare, series, duration)"
                                "}\n"
                                // these 2 added for backward compatibility, may be deprecated
-                               "GC.metrics <- function(all=FALSE, filter=\"\", compare=FALSE) { .Call(\"GC.season.metrics\", all, filter, compare) }\n"
+                               "GC.metrics <- function(all=FALSE, filter=\"\", compare=FALSE, metrics=NULL) { .Call(\"GC.season.metrics\", all, filter, compare, metrics) }\n"
                                "GC.pmc <- function(all=FALSE, metric=\"BikeStress\") { .Call(\"GC.season.pmc\", all, metric) }\n"
 
                                // version and build
@@ -1128,27 +1129,23 @@ RTool::dfForRideItem(const RideItem *ri)
     return ans;
 }
 
+// R's own shorthand for row names 1..n is c(NA_integer_, -n), the
+// same as .set_row_names(n), rather than a vector of n strings
 SEXP
-RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
+RTool::compactRowNames(int rows)
 {
-    const RideMetricFactory &factory = RideMetricFactory::instance();
-    int rides = rtool->context->athlete->rideCache->count();
-    int metrics = factory.metricCount();
-
-    // count the number of meta fields to add
-    int meta = 0;
-    if (rtool->context && rtool->context->athlete->rideMetadata()) {
+    if (rows == 0) return Rf_allocVector(INTSXP, 0);
 
-        // count active fields
-        foreach(FieldDefinition def, rtool->context->athlete->rideMetadata()->getFields()) {
-            if (def.name != "" && def.tab != "" &&
-                !rtool->context->specialFields.isMetric(def.name))
-                meta++;
-        }
-    }
+    SEXP rownames = Rf_allocVector(INTSXP, 2);
+    INTEGER(rownames)[0] = NA_INTEGER;
+    INTEGER(rownames)[1] = -rows;
+    return rownames;
+}
 
-    // how many rides to return if we're limiting to the
-    // currently selected date range ?
+SEXP
+RTool::dfForDateRange(bool all, DateRange range, SEXP filter, QStringList columns)
+{
+    const RideMetricFactory &factory = RideMetricFactory::instance();
 
     // apply any global filters
     Specification specification;
@@ -1174,11 +1171,44 @@ RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
     specification.setFilterSet(fs);
     UNPROTECT(1);
 
-    // we need to count rides that are in range...
-    rides = 0;
-    foreach(RideItem *ride, rtool->context->athlete->rideCache->rides()) {
-        if (!specification.pass(ride)) continue;
-        if (all || range.pass(ride->dateTime.date())) rides++;
+    // the rows that are in range, found once for every column; the
+    // metrics are read from the column store, whole columns at a time
+    // when nothing is filtered out
+    if (!all) specification.setDateRange(range);
+    RideCacheColumns store = rtool->context->athlete->rideCache->columns();
+    QBitArray mask = store.mask(specification);
+    QVector<int> selected;
+    for(int row=0; row<store.count(); row++) if (mask.testBit(row)) selected << row;
+    int rides = selected.count();
+    bool everything = rides == store.count();
+
+    // the metrics wanted, all of them unless some were named
+    QList<int> metrics;
+    QStringList metricnames;
+    for(int i=0; i<factory.metricCount();i++) {
+
+        QString name = rtool->context->specialFields.internalName(factory.rideMetric(factory.metricName(i))->name());
+        name = name.replace(" ","_");
+        name = name.replace("'","_");
+
+        if (!columns.isEmpty() && !columns.contains(name)) continue;
+        metrics << i;
+        metricnames << name;
+    }
+
+    // and the meta fields
+    QList<FieldDefinition> meta;
+    if (rtool->context && rtool->context->athlete->rideMetadata()) {
+
+        foreach(FieldDefinition def, rtool->context->athlete->rideMetadata()->getFields()) {
+
+            // don't add incomplete meta definitions or metric override fields
+            if (def.name == "" || def.tab == "" ||
+                rtool->context->specialFields.isMetric(def.name)) continue;
+
+            if (!columns.isEmpty() && !columns.contains(QString(def.name).replace(" ","_"))) continue;
+            meta << def;
+        }
     }
 
     // get a listAllocated
@@ -1187,15 +1217,9 @@ RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
     SEXP rownames; // row names (numeric)
 
     // +3 is for date and datetime and color
-    PROTECT(ans=Rf_allocVector(VECSXP, metrics+meta+3));
-    PROTECT(names = Rf_allocVector(STRSXP, metrics+meta+3));
-
-    // we have to give a name to each row
-    PROTECT(rownames = Rf_allocVector(STRSXP, rides));
-    for(int i=0; i<rides; i++) {
-        QString rownumber=QString("%1").arg(i+1);
-        SET_STRING_ELT(rownames, i, Rf_mkChar(rownumber.toLatin1().constData()));
-    }
+    PROTECT(ans=Rf_allocVector(VECSXP, metrics.count()+meta.count()+3));
+    PROTECT(names = Rf_allocVector(STRSXP, metrics.count()+meta.count()+3));
+    PROTECT(rownames = compactRowNames(rides));
 
     // next name
     int next=0;
@@ -1204,13 +1228,9 @@ RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
     SEXP date;
     PROTECT(date=Rf_allocVector(INTSXP, rides));
 
-    int k=0;
+    int *days = INTEGER(date);
     QDate d1970(1970,01,01);
-    foreach(RideItem *ride, rtool->context->athlete->rideCache->rides()) {
-        if (!specification.pass(ride)) continue;
-        if (all || range.pass(ride->dateTime.date()))
-            INTEGER(date)[k++] = d1970.daysTo(ride->dateTime.date());
-    }
+    for(int k=0; k<rides; k++) days[k] = d1970.daysTo(store.items[selected[k]]->dateTime.date());
 
     SEXP dclas;
     PROTECT(dclas=Rf_allocVector(STRSXP, 1));
@@ -1225,13 +1245,8 @@ RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
     SEXP time;
     PROTECT(time=Rf_allocVector(REALSXP, rides));
 
-    // fill with values for date and class if its one we need to return
-    k=0;
-    foreach(RideItem *ride, rtool->context->athlete->rideCache->rides()) {
-        if (!specification.pass(ride)) continue;
-        if (all || range.pass(ride->dateTime.date()))
-            REAL(time)[k++] = ride->dateTime.toUTC().toTime_t();
-    }
+    double *secs = REAL(time);
+    for(int k=0; k<rides; k++) secs[k] = store.items[selected[k]]->dateTime.toUTC().toTime_t();
 
     // POSIXct class
     SEXP clas;
@@ -1253,34 +1268,29 @@ RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
     //
     // METRICS
     //
-    for(int i=0; i<factory.metricCount();i++) {
+    bool useMetricUnits = rtool->context->athlete->useMetricUnits;
+    for(int j=0; j<metrics.count(); j++) {
 
-        // set a vector
+        int i = metrics[j];
+        const RideMetric *metric = factory.rideMetric(factory.metricName(i));
+        double factor = useMetricUnits ? 1.0f : metric->conversion();
+        double offset = useMetricUnits ? 0.0f : metric->conversionSum();
+
+        // set a vector, writing straight into its storage
         SEXP m;
         PROTECT(m=Rf_allocVector(REALSXP, rides));
 
-        QString symbol = factory.metricName(i);
-        const RideMetric *metric = factory.rideMetric(symbol);
-        QString name = rtool->context->specialFields.internalName(factory.rideMetric(symbol)->name());
-        name = name.replace(" ","_");
-        name = name.replace("'","_");
-
-        bool useMetricUnits = rtool->context->athlete->useMetricUnits;
-
-        int index=0;
-        foreach(RideItem *item, rtool->context->athlete->rideCache->rides()) {
-            if (!specification.pass(item)) continue;
-            if (all || range.pass(item->dateTime.date())) {
-                REAL(m)[index++] = item->metrics()[i] * (useMetricUnits ? 1.0f : metric->conversion())
-                                                      + (useMetricUnits ? 0.0f : metric->conversionSum());
-            }
-        }
+        double *values = REAL(m);
+        const double *column = store.column(i).constData();
+        if (everything && factor == 1.0 && offset == 0.0) memcpy(values, column, rides * sizeof(double));
+        else if (everything) for(int k=0; k<rides; k++) values[k] = column[k] * factor + offset;
+        else for(int k=0; k<rides; k++) values[k] = column[selected[k]] * factor + offset;
 
         // add to the list
         SET_VECTOR_ELT(ans, next, m);
 
         // give it a name
-        SET_STRING_ELT(names, next, Rf_mkChar(name.toLatin1().constData()));
+        SET_STRING_ELT(names, next, Rf_mkChar(metricnames[j].toLatin1().constData()));
 
         next++;
 
@@ -1291,23 +1301,14 @@ RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
     //
     // META
     //
-    foreach(FieldDefinition field, rtool->context->athlete->rideMetadata()->getFields()) {
-
-        // don't add incomplete meta definitions or metric override fields
-        if (field.name == "" || field.tab == "" ||
-            rtool->context->specialFields.isMetric(field.name)) continue;
+    foreach(FieldDefinition field, meta) {
 
         // Create a string vector
         SEXP m;
         PROTECT(m=Rf_allocVector(STRSXP, rides));
 
-        int index=0;
-        foreach(RideItem *item, rtool->context->athlete->rideCache->rides()) {
-            if (!specification.pass(item)) continue;
-            if (all || range.pass(item->dateTime.date())) {
-                SET_STRING_ELT(m, index++, Rf_mkChar(item->getText(field.name, "").toLatin1().constData()));
-            }
-        }
+        for(int k=0; k<rides; k++)
+            SET_STRING_ELT(m, k, Rf_mkChar(store.items[selected[k]]->getText(field.name, "").toLatin1().constData()));
 
         // add to the list
         SET_VECTOR_ELT(ans, next, m);
@@ -1325,24 +1326,22 @@ RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
     SEXP color;
     PROTECT(color=Rf_allocVector(STRSXP, rides));
 
-    int index=0;
-    foreach(RideItem *item, rtool->context->athlete->rideCache->rides()) {
-        if (!specification.pass(item)) continue;
-        if (all || range.pass(item->dateTime.date())) {
+    for(int k=0; k<rides; k++) {
 
-            // apply item color, remembering that 1,1,1 means use default (reverse in this case)
-            if (item->color == QColor(1,1,1,1)) {
+        RideItem *item = store.items[selected[k]];
 
-                // use the inverted color, not plot marker as that hideous
-                QColor col =GCColor::invertColor(GColor(CPLOTBACKGROUND));
+        // apply item color, remembering that 1,1,1 means use default (reverse in this case)
+        if (item->color == QColor(1,1,1,1)) {
 
-                // white is jarring on a dark background!
-                if (col==QColor(Qt::white)) col=QColor(127,127,127);
+            // use the inverted color, not plot marker as that hideous
+            QColor col =GCColor::invertColor(GColor(CPLOTBACKGROUND));
 
-                SET_STRING_ELT(color, index++, Rf_mkChar(col.name().toLatin1().constData()));
-            } else
-                SET_STRING_ELT(color, index++, Rf_mkChar(item->color.name().toLatin1().constData()));
-        }
+            // white is jarring on a dark background!
+            if (col==QColor(Qt::white)) col=QColor(127,127,127);
+
+            SET_STRING_ELT(color, k, Rf_mkChar(col.name().toLatin1().constData()));
+        } else
+            SET_STRING_ELT(color, k, Rf_mkChar(item->color.name().toLatin1().constData()));
     }
 
     // add to the list and name it
@@ -1357,7 +1356,7 @@ RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
     Rf_setAttrib(ans, R_RowNamesSymbol, rownames);
     Rf_namesgets(ans, names);
 
-    // ans + names
+    // ans + names + rownames
     UNPROTECT(3);
 
     // return it
@@ -1365,14 +1364,9 @@ RTool::dfForDateRange(bool all, DateRange range, SEXP filter)
 }
 
 SEXP
-RTool::dfForDateRangeIntervals(DateRange range, QStringList types)
+RTool::dfForDateRangeIntervals(DateRange range, QStringList types, QStringList columns)
 {
     const RideMetricFactory &factory = RideMetricFactory::instance();
-    int intervals = 0;
-    int metrics = factory.metricCount();
-
-    // how many rides to return if we're limiting to the
-    // currently selected date range ?
 
     // apply any global filters
     Specification specification;
@@ -1381,18 +1375,30 @@ RTool::dfForDateRangeIntervals(DateRange range, QStringList types)
     fs.addFilter(rtool->context->ishomefiltered, rtool->context->homeFilters);
     specification.setFilterSet(fs);
 
-    // we need to count intervals that are in range...
-    intervals = 0;
+    // the intervals that are in range, found once for every column
+    QList<IntervalItem*> selected;
     foreach(RideItem *ride, rtool->context->athlete->rideCache->rides()) {
         if (!specification.pass(ride)) continue;
         if (!range.pass(ride->dateTime.date())) continue;
 
-        if (types.isEmpty()) intervals += ride->intervals().count();
-        else {
-            foreach(IntervalItem *item, ride->intervals())
-                if (types.contains(RideFileInterval::typeDescription(item->type)))
-                    intervals++;
-        }
+        foreach(IntervalItem *item, ride->intervals())
+            if (types.isEmpty() || types.contains(RideFileInterval::typeDescription(item->type)))
+                selected << item;
+    }
+    int intervals = selected.count();
+
+    // the metrics wanted, all of them unless some were named
+    QList<int> metrics;
+    QStringList metricnames;
+    for(int i=0; i<factory.metricCount();i++) {
+
+        QString name = rtool->context->specialFields.internalName(factory.rideMetric(factory.metricName(i))->name());
+        name = name.replace(" ","_");
+        name = name.replace("'","_");
+
+        if (!columns.isEmpty() && !columns.contains(name)) continue;
+        metrics << i;
+        metricnames << name;
     }
 
     // get a listAllocated
@@ -1401,15 +1407,9 @@ RTool::dfForDateRangeIntervals(DateRange range, QStringList types)
     SEXP rownames; // row names (numeric)
 
     // +5 is for date and datetime, name, type and color
-    PROTECT(ans=Rf_allocVector(VECSXP, metrics+5));
-    PROTECT(names = Rf_allocVector(STRSXP, metrics+5));
-
-    // we have to give a name to each row
-    PROTECT(rownames = Rf_allocVector(STRSXP, intervals));
-    for(int i=0; i<intervals; i++) {
-        QString rownumber=QString("%1").arg(i+1);
-        SET_STRING_ELT(rownames, i, Rf_mkChar(rownumber.toLatin1().constData()));
-    }
+    PROTECT(ans=Rf_allocVector(VECSXP, metrics.count()+5));
+    PROTECT(names = Rf_allocVector(STRSXP, metrics.count()+5));
+    PROTECT(rownames = compactRowNames(intervals));
 
     // next name
     int next=0;
@@ -1418,16 +1418,9 @@ RTool::dfForDateRangeIntervals(DateRange range, QStringList types)
     SEXP date;
     PROTECT(date=Rf_allocVector(INTSXP, intervals));
 
-    int k=0;
+    int *days = INTEGER(date);
     QDate d1970(1970,01,01);
-    foreach(RideItem *ride, rtool->context->athlete->rideCache->rides()) {
-        if (!specification.pass(ride)) continue;
-        if (range.pass(ride->dateTime.date())) {
-            foreach(IntervalItem *item, ride->intervals())
-                if (types.isEmpty() || types.contains(RideFileInterval::typeDescription(item->type)))
-                    INTEGER(date)[k++] = d1970.daysTo(ride->dateTime.date());
-        }
-    }
+    for(int k=0; k<intervals; k++) days[k] = d1970.daysTo(selected[k]->rideItem()->dateTime.date());
 
     SEXP dclas;
     PROTECT(dclas=Rf_allocVector(STRSXP, 1));
@@ -1442,16 +1435,10 @@ RTool::dfForDateRangeIntervals(DateRange range, QStringList types)
     SEXP time;
     PROTECT(time=Rf_allocVector(REALSXP, intervals));
 
-    // fill with values for date and class if its one we need to return
-    k=0;
-    foreach(RideItem *ride, rtool->context->athlete->rideCache->rides()) {
-        if (!specification.pass(ride)) continue;
-        if (range.pass(ride->dateTime.date())) {
-            foreach(IntervalItem *item, ride->intervals())
-                if (types.isEmpty() || types.contains(RideFileInterval::typeDescription(item->type)))
-                    REAL(time)[k++] = ride->dateTime.toUTC().toTime_t() + item->start;  // time offsets by time of interval
-        }
-    }
+    // time offsets by time of interval
+    double *secs = REAL(time);
+    for(int k=0; k<intervals; k++)
+        secs[k] = selected[k]->rideItem()->dateTime.toUTC().toTime_t() + selected[k]->start;
 
     // POSIXct class
     SEXP clas;
@@ -1471,15 +1458,8 @@ RTool::dfForDateRangeIntervals(DateRange range, QStringList types)
     // NAME
     SEXP intervalnames;
     PROTECT(intervalnames = Rf_allocVector(STRSXP, intervals));
-    k=0;
-    foreach(RideItem *ride, rtool->context->athlete->rideCache->rides()) {
-        if (!specification.pass(ride)) continue;
-        if (range.pass(ride->dateTime.date())) {
-            foreach(IntervalItem *item, ride->intervals())
-                if (types.isEmpty() || types.contains(RideFileInterval::typeDescription(item->type)))
-                    SET_STRING_ELT(intervalnames, k++, Rf_mkChar(item->name.toLatin1().constData()));
-        }
-    }
+    for(int k=0; k<intervals; k++)
+        SET_STRING_ELT(intervalnames, k, Rf_mkChar(selected[k]->name.toLatin1().constData()));
 
     // add to the list and give a columnname
     SET_VECTOR_ELT(ans, next, intervalnames);
@@ -1489,15 +1469,8 @@ RTool::dfForDateRangeIntervals(DateRange range, QStringList types)
     // TYPE
     SEXP intervaltypes;
     PROTECT(intervaltypes = Rf_allocVector(STRSXP, intervals));
-    k=0;
-    foreach(RideItem *ride, rtool->context->athlete->rideCache->rides()) {
-        if (!specification.pass(ride)) continue;
-        if (range.pass(ride->dateTime.date())) {
-            foreach(IntervalItem *item, ride->intervals())
-                if (types.isEmpty() || types.contains(RideFileInterval::typeDescription(item->type)))
-                    SET_STRING_ELT(intervaltypes, k++, Rf_mkChar(RideFileInterval::typeDescription(item->type).toLatin1().constData()));
-        }
-    }
+    for(int k=0; k<intervals; k++)
+        SET_STRING_ELT(intervaltypes, k, Rf_mkChar(RideFileInterval::typeDescription(selected[k]->type).toLatin1().constData()));
     SET_VECTOR_ELT(ans, next, intervaltypes);
     SET_STRING_ELT(names, next, Rf_mkChar("type"));
     next++;
@@ -1508,38 +1481,26 @@ RTool::dfForDateRangeIntervals(DateRange range, QStringList types)
     //
     // METRICS
     //
-    for(int i=0; i<factory.metricCount();i++) {
+    bool useMetricUnits = rtool->context->athlete->useMetricUnits;
+    for(int j=0; j<metrics.count(); j++) {
 
-        // set a vector
+        int i = metrics[j];
+        const RideMetric *metric = factory.rideMetric(factory.metricName(i));
+        double factor = useMetricUnits ? 1.0f : metric->conversion();
+        double offset = useMetricUnits ? 0.0f : metric->conversionSum();
+
+        // set a vector, writing straight into its storage
         SEXP m;
         PROTECT(m=Rf_allocVector(REALSXP, intervals));
 
-        QString symbol = factory.metricName(i);
-        const RideMetric *metric = factory.rideMetric(symbol);
-        QString name = rtool->context->specialFields.internalName(factory.rideMetric(symbol)->name());
-        name = name.replace(" ","_");
-        name = name.replace("'","_");
-
-        bool useMetricUnits = rtool->context->athlete->useMetricUnits;
-
-        int index=0;
-        foreach(RideItem *item, rtool->context->athlete->rideCache->rides()) {
-            if (!specification.pass(item)) continue;
-            if (range.pass(item->dateTime.date())) {
-
-                foreach(IntervalItem *interval, item->intervals()) {
-                    if (types.isEmpty() || types.contains(RideFileInterval::typeDescription(interval->type)))
-                        REAL(m)[index++] = interval->metrics()[i] * (useMetricUnits ? 1.0f : metric->conversion())
-                                                          + (useMetricUnits ? 0.0f : metric->conversionSum());
-                }
-            }
-        }
+        double *values = REAL(m);
+        for(int k=0; k<intervals; k++) values[k] = selected[k]->metrics()[i] * factor + offset;
 
         // add to the list
         SET_VECTOR_ELT(ans, next, m);
 
         // give it a name
-        SET_STRING_ELT(names, next, Rf_mkChar(name.toLatin1().constData()));
+        SET_STRING_ELT(names, next, Rf_mkChar(metricnames[j].toLatin1().constData()));
 
         next++;
 
@@ -1551,28 +1512,22 @@ RTool::dfForDateRangeIntervals(DateRange range, QStringList types)
     SEXP color;
     PROTECT(color=Rf_allocVector(STRSXP, intervals));
 
-    int index=0;
-    foreach(RideItem *item, rtool->context->athlete->rideCache->rides()) {
-        if (!specification.pass(item)) continue;
-        if (!range.pass(item->dateTime.date())) continue;
-
-        foreach(IntervalItem *interval, item->intervals()) {
+    for(int k=0; k<intervals; k++) {
 
-            if (!types.isEmpty() && !types.contains(RideFileInterval::typeDescription(interval->type))) continue;
+        IntervalItem *interval = selected[k];
 
-            // apply item color, remembering that 1,1,1 means use default (reverse in this case)
-            if (interval->color == QColor(1,1,1,1)) {
+        // apply item color, remembering that 1,1,1 means use default (reverse in this case)
+        if (interval->color == QColor(1,1,1,1)) {
 
-                // use the inverted color, not plot marker as that hideous
-                QColor col =GCColor::invertColor(GColor(CPLOTBACKGROUND));
+            // use the inverted color, not plot marker as that hideous
+            QColor col =GCColor::invertColor(GColor(CPLOTBACKGROUND));
 
-                // white is jarring on a dark background!
-                if (col==QColor(Qt::white)) col=QColor(127,127,127);
+            // white is jarring on a dark background!
+            if (col==QColor(Qt::white)) col=QColor(127,127,127);
 
-                SET_STRING_ELT(color, index++, Rf_mkChar(col.name().toLatin1().constData()));
-            } else
-                SET_STRING_ELT(color, index++, Rf_mkChar(interval->color.name().toLatin1().constData()));
-        }
+            SET_STRING_ELT(color, k, Rf_mkChar(col.name().toLatin1().constData()));
+        } else
+            SET_STRING_ELT(color, k, Rf_mkChar(interval->color.name().toLatin1().constData()));
     }
 
     // add to the list and name it
@@ -1587,7 +1542,7 @@ RTool::dfForDateRangeIntervals(DateRange range, QStringList types)
     Rf_setAttrib(ans, R_RowNamesSymbol, rownames);
     Rf_namesgets(ans, names);
 
-    // ans + names
+    // ans + names + rownames
     UNPROTECT(3);
 
     // return it
@@ -1693,15 +1648,21 @@ RTool::season(SEXP pAll, SEXP pCompare)
 }
 
 SEXP
-RTool::seasonIntervals(SEXP pTypes, SEXP pCompare)
+RTool::seasonIntervals(SEXP pTypes, SEXP pCompare, SEXP pMetrics)
 {
     // p1 - type of intervals to get (vector of strings)
     // p2 - compare mode (true or false)
+    // p3 - metrics to return (vector of strings), NULL for all
     pTypes = Rf_coerceVector(pTypes, STRSXP);
     QStringList types;
     for(int i=0; i<Rf_length(pTypes); i++)
         types << QString(CHAR(STRING_ELT(pTypes,i)));
 
+    pMetrics = Rf_coerceVector(pMetrics, STRSXP);
+    QStringList columns;
+    for(int i=0; i<Rf_length(pMetrics); i++)
+        columns << QString(CHAR(STRING_ELT(pMetrics,i)));
+
     //pType = Rf_coerceVector(pAll, LGLSXP);
     //bool all = LOGICAL(pAll)[0];
 
@@ -1741,7 +1702,7 @@ RTool::seasonIntervals(SEXP pTypes, SEXP pCompare)
                     PROTECT(namedlist=Rf_allocVector(VECSXP, 2));
 
                     // add the ride
-                    SEXP df = rtool->dfForDateRangeIntervals(DateRange(p.start, p.end), types);
+                    SEXP df = rtool->dfForDateRangeIntervals(DateRange(p.start, p.end), types, columns);
                     SET_VECTOR_ELT(namedlist, 0, df);
 
                     // add the color
@@ -1781,7 +1742,7 @@ RTool::seasonIntervals(SEXP pTypes, SEXP pCompare)
 
             // add the metrics
             DateRange range = rtool->context->currentDateRange();
-            SEXP df = rtool->dfForDateRangeIntervals(range, types);
+            SEXP df = rtool->dfForDateRangeIntervals(range, types, columns);
             SET_VECTOR_ELT(namedlist, 0, df);
 
             // add the color
@@ -1804,7 +1765,7 @@ RTool::seasonIntervals(SEXP pTypes, SEXP pCompare)
 
         // just a datafram of metrics
         DateRange range = rtool->context->currentDateRange();
-        return rtool->dfForDateRangeIntervals(range, types);
+        return rtool->dfForDateRangeIntervals(range, types, columns);
 
     }
 
@@ -2007,7 +1968,7 @@ RTool::activityIntervals(SEXP pTypes, SEXP datetime)
 }
 
 SEXP
-RTool::metrics(SEXP pAll, SEXP pFilter, SEXP pCompare)
+RTool::metrics(SEXP pAll, SEXP pFilter, SEXP pCompare, SEXP pMetrics)
 {
     // p1 - all=TRUE|FALSE - return all metrics or just within
     //                       the currently selected date range
@@ -2018,6 +1979,12 @@ RTool::metrics(SEXP pAll, SEXP pFilter, SEXP pCompare)
     pCompare = Rf_coerceVector(pCompare, LGLSXP);
     bool compare = LOGICAL(pCompare)[0];
 
+    // p3 - metrics and metadata to return (vector of strings), NULL for all
+    pMetrics = Rf_coerceVector(pMetrics, STRSXP);
+    QStringList columns;
+    for(int i=0; i<Rf_length(pMetrics); i++)
+        columns << QString(CHAR(STRING_ELT(pMetrics,i)));
+
     // want a list of compares not a dataframe
     if (compare && rtool->context) {
 
@@ -2050,7 +2017,7 @@ RTool::metrics(SEXP pAll, SEXP pFilter, SEXP pCompare)
                     PROTECT(namedlist=Rf_allocVector(VECSXP, 2));
 
                     // add the ride
-                    SEXP df = rtool->dfForDateRange(all, DateRange(p.start, p.end), pFilter);
+                    SEXP df = rtool->dfForDateRange(all, DateRange(p.start, p.end), pFilter, columns);
                     SET_VECTOR_ELT(namedlist, 0, df);
 
                     // add the color
@@ -2090,7 +2057,7 @@ RTool::metrics(SEXP pAll, SEXP pFilter, SEXP pCompare)
 
             // add the metrics
             DateRange range = rtool->context->currentDateRange();
-            SEXP df = rtool->dfForDateRange(all, range, pFilter);
+            SEXP df = rtool->dfForDateRange(all, range, pFilter, columns);
             SET_VECTOR_ELT(namedlist, 0, df);
 
             // add the color
@@ -2113,7 +2080,7 @@ RTool::metrics(SEXP pAll, SEXP pFilter, SEXP pCompare)
 
         // just a datafram of metrics
         DateRange range = rtool->context->currentDateRange();
-        return rtool->dfForDateRange(all, range, pFilter);
+        return rtool->dfForDateRange(all, range, pFilter, columns);
 
     }
 
@@ -2627,8 +2594,8 @@ RTool::dfForRideFileCache(RideFileCache *cache)
 
         // will have different sizes e.g. when a daterange
         // since longest ride with e.g. power may be different
-        // to longest ride with heartrate
-        for(int j=0; j<values.count(); j++) REAL(vector)[j] = values[j];
+        // to longest ride with heartrate, copied as a block
+        memcpy(REAL(vector), values.constData(), values.count() * sizeof(double));
 
         // add to the list
         SET_VECTOR_ELT(ans, next, vector);
@@ -2676,11 +2643,7 @@ RTool::dfForRideFileCache(RideFileCache *cache)
 
     // add rownames
     SEXP rownames;
-    PROTECT(rownames = Rf_allocVector(STRSXP, size));
-    for(unsigned int i=0; i<size; i++) {
-        QString rownumber=QString("%1").arg(i+1);
-        SET_STRING_ELT(rownames, i, Rf_mkChar(rownumber.toLatin1().constData()));
-    }
+    PROTECT(rownames = compactRowNames(size));
 
     // turn the list into a data frame + set column names
     Rf_setAttrib(ans, R_RowNamesSymbol, rownames);
@@ -2875,16 +2838,17 @@ RTool::dfForDateRangePeaks(bool all, DateRange range, SEXP filter, QList<RideFil
     specification.setFilterSet(fs);
     UNPROTECT(1);
 
-    // how many pass?
-    int size=0;
+    // which pass?
+    QList<RideItem*> selected;
     foreach(RideItem *item, rtool->context->athlete->rideCache->rides()) {
 
         // apply filters
         if (!specification.pass(item)) continue;
 
         // do we want this one ?
-        if (all || range.pass(item->dateTime.date()))  size++;
+        if (all || range.pass(item->dateTime.date())) selected << item;
     }
+    int size = selected.count();
 
 
     // dates first
@@ -2892,15 +2856,8 @@ RTool::dfForDateRangePeaks(bool all, DateRange range, SEXP filter, QList<RideFil
     PROTECT(dates=Rf_allocVector(REALSXP, size));
 
     // fill with values for date and class
-    int i=0;
-    foreach(RideItem *item, rtool->context->athlete->rideCache->rides()) {
-        // apply filters
-        if (!specification.pass(item)) continue;
-
-        if (all || range.pass(item->dateTime.date())) {
-            REAL(dates)[i++] = item->dateTime.toUTC().toTime_t();
-        }
-    }
+    double *secs = REAL(dates);
+    for(int i=0; i<size; i++) secs[i] = selected[i]->dateTime.toUTC().toTime_t();
 
     // POSIXct class
     SEXP clas;
@@ -2926,20 +2883,11 @@ RTool::dfForDateRangePeaks(bool all, DateRange range, SEXP filter, QList<RideFil
 
             // fill with values
             // get the value for the series and duration requested, although this is called
-            int index=0;
-            foreach(RideItem *item, rtool->context->athlete->rideCache->rides()) {
-
-                // apply filters
-                if (!specification.pass(item)) continue;
-
-                // do we want this one ?
-                if (all || range.pass(item->dateTime.date())) {
-
-                    // for each series/duration independently its pretty quick since it lseeks to
-                    // the actual value, so /should't/ be too expensive.........
-                    REAL(vector)[index++] = RideFileCache::best(item->context, item->fileName, pseries, pduration);
-                }
-            }
+            // for each series/duration independently its pretty quick since it lseeks to
+            // the actual value, so /should't/ be too expensive.........
+            double *values = REAL(vector);
+            for(int index=0; index<size; index++)
+                values[index] = RideFileCache::best(selected[index]->context, selected[index]->fileName, pseries, pduration);
 
             // add named vector to the list
             SET_VECTOR_ELT(df, dfindex++, vector);
@@ -2951,11 +2899,7 @@ RTool::dfForDateRangePeaks(bool all, DateRange range, SEXP filter, QList<RideFil
 
     // set names + data.frame
     SEXP rownames;
-    PROTECT(rownames = Rf_allocVector(STRSXP, size));
-    for(int i=0; i<size; i++) {
-        QString rownumber=QString("%1").arg(i+1);
-        SET_STRING_ELT(rownames, i, Rf_mkChar(rownumber.toLatin1().constData()));
-    }
+    PROTECT(rownames = compactRowNames(size));
 
     // turn the list into a data frame + set column names
     Rf_setAttrib(df, R_ClassSymbol, Rf_mkString("data.frame"));
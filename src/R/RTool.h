@@ -62,8 +62,8 @@ class RTool {
 
         // seasons
         static SEXP season(SEXP all, SEXP compare);
-        static SEXP metrics(SEXP all, SEXP filter, SEXP compare);
-        static SEXP seasonIntervals(SEXP type, SEXP compare);
+        static SEXP metrics(SEXP all, SEXP filter, SEXP compare, SEXP metrics);
+        static SEXP seasonIntervals(SEXP type, SEXP compare, SEXP metrics);
         static SEXP seasonMeanmax(SEXP all, SEXP filter, SEXP compare);
         static SEXP seasonPeaks(SEXP all, SEXP filter, SEXP compare, SEXP series, SEXP duration);
         static SEXP pmc(SEXP all, SEXP metric);
@@ -104,12 +104,15 @@ class RTool {
         SEXP dfForActivityXData(RideFile *f, QString name); // returns XData series by name for an activity
         SEXP dfForActivityMeanmax(const RideItem *i);   // returns mean maximals for an activity
         SEXP dfForRideItem(const RideItem *i);          // returns metrics and meradata for an activity
-        SEXP dfForDateRange(bool all, DateRange range, SEXP filter); // returns metrics and metadata for a season
-        SEXP dfForDateRangeIntervals(DateRange range, QStringList types); // returns metrics and metadata for a season
+        SEXP dfForDateRange(bool all, DateRange range, SEXP filter, QStringList columns); // returns metrics and metadata for a season
+        SEXP dfForDateRangeIntervals(DateRange range, QStringList types, QStringList columns); // returns metrics and metadata for a season
         SEXP dfForDateRangeMeanmax(bool all, DateRange range, SEXP filter); // returns the meanmax for a season
         SEXP dfForDateRangePeaks(bool all, DateRange range, SEXP filter, QList<RideFile::SeriesType> series, QList<int> durations);
         SEXP dfForRideFileCache(RideFileCache *p);      // returns meanmax for a cache
 
+        // data.frame row names 1..n without a string per row
+        static SEXP compactRowNames(int rows);
+
 };
 
 // there is a global instance created in main
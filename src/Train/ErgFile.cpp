@@ -943,25 +943,10 @@ ErgFile::wattsAt(long x, int &lapnum)
     if (x < 0 || x > Duration) return -100;   // out of bounds!!!
 
     // do we need to return the Lap marker?
-    if (Laps.count() > 0) {
-        int lap=0;
-        for (int i=0; i<Laps.count(); i++) {
-            if (x>=Laps.at(i).x) lap += 1;
-        }
-        lapnum = lap;
-
-    } else lapnum = 0;
+    lapnum = lapAt(x);
 
     // find right section of the file
-    while (x < Points.at(leftPoint).x || x > Points.at(rightPoint).x) {
-        if (x < Points.at(leftPoint).x) {
-            leftPoint--;
-            rightPoint--;
-        } else if (x > Points.at(rightPoint).x) {
-            leftPoint++;
-            rightPoint++;
-        }
-    }
+    findPoints(x);
 
     // two different points in time but the same watts
     // at both, it doesn't really matter which value
@@ -1001,25 +986,10 @@ ErgFile::gradientAt(long x, int &lapnum)
     if (x < 0 || x > Duration) return -100;   // out of bounds!!! (-10 through +15 are valid return vals)
 
     // do we need to return the Lap marker?
-    if (Laps.count() > 0) {
-        int lap=0;
-        for (int i=0; i<Laps.count(); i++) {
-            if (x>=Laps.at(i).x) lap += 1;
-        }
-        lapnum = lap;
-
-    } else lapnum = 0;
+    lapnum = lapAt(x);
 
     // find right section of the file
-    while (x < Points.at(leftPoint).x || x > Points.at(rightPoint).x) {
-        if (x < Points.at(leftPoint).x) {
-            leftPoint--;
-            rightPoint--;
-        } else if (x > Points.at(rightPoint).x) {
-            leftPoint++;
-            rightPoint++;
-        }
-    }
+    findPoints(x);
     return Points.at(leftPoint).val;
 }
 
@@ -1030,13 +1000,10 @@ int ErgFile::nextLap(long x)
 {
     if (!isValid()) return -1; // not a valid ergfile
 
-    // do we need to return the Lap marker?
-    if (Laps.count() > 0) {
-        // If the current position is before the start the lap, then the lap is next
-        for (int i=0; i<Laps.count(); i++) {
-            if (x<Laps.at(i).x) return Laps.at(i).x;
-        }
-    }
+    // the first lap that starts after the current position is next
+    int next = lapAt(x);
+    if (next < searchIndex.laps.count()) return searchIndex.laps.at(next);
+
     return -1; // nope, no marker ahead of there
 }
 
@@ -1049,12 +1016,37 @@ ErgFile::currentLap(long x)
     if (!isValid()) return -1; // not a valid ergfile
 
     // If the current position is before the start of the next lap, return this lap
-    for (int i=0; i<Laps.count() - 1; i++) {
-        if (x<Laps.at(i+1).x) return Laps.at(i).x;
-    }
+    int next = lapAt(x);
+    if (searchIndex.laps.count() > 1 && next < searchIndex.laps.count()) return searchIndex.laps.at(next > 0 ? next-1 : 0);
+
     return -1; // No matching lap
 }
 
+void
+ErgFile::rebuildIndex()
+{
+    searchIndex.points.resize(Points.count());
+    for (int i=0; i<Points.count(); i++) searchIndex.points[i] = Points.at(i).x;
+
+    searchIndex.laps.clear();
+    foreach(ErgFileLap lap, Laps) searchIndex.laps << lap.x;
+    searchIndex.sortLaps();
+}
+
+int
+ErgFile::lapAt(long x)
+{
+    if (searchIndex.laps.count() != Laps.count()) rebuildIndex();
+    return searchIndex.lapAt(x);
+}
+
+void
+ErgFile::findPoints(long x)
+{
+    if (searchIndex.points.count() != Points.count()) rebuildIndex();
+    searchIndex.findPoints(x, leftPoint, rightPoint);
+}
+
 void
 ErgFile::calculateMetrics()
 {
@@ -1065,6 +1057,9 @@ ErgFile::calculateMetrics()
 
     maxY = 0; // we need to reset it
 
+    // points may have been changed
+    rebuildIndex();
+
     // is it valid?
     if (!isValid()) return;
 
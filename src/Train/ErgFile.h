@@ -31,7 +31,9 @@
 #include <QTextStream>
 #include <QTextEdit>
 #include <QRegExp>
+#include <QVector>
 #include "Zones.h"      // For zones ... see below vvvv
+#include "ErgFileIndex.h"
 
 // which section of the file are we in?
 #define NOMANSLAND  0
@@ -143,6 +145,10 @@ class ErgFile
         QList<ErgFileLap>   Laps;      // interval markers in the file
         QList<ErgFileText>  Texts;     // texts to display
 
+        // must be called after changing Points or Laps directly
+        // (calculateMetrics does it for you)
+        void rebuildIndex();
+
         void calculateMetrics(); // calculate IsoPower value for ErgFile
 
         // Metrics for this workout
@@ -154,6 +160,13 @@ class ErgFile
 
         Context *context;
 
+    private:
+
+        // x of each point, and sorted lap starts, for searching
+        ErgFileIndex searchIndex;
+
+        void findPoints(long x);   // set leftPoint/rightPoint either side of x
+        int lapAt(long x);         // how many laps have started by x
 };
 
 #endif
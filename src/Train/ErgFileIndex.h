@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_ErgFileIndex_h
+#define _GC_ErgFileIndex_h 1
+
+#include <QVector>
+#include <QtGlobal>
+#include <algorithm> // for std::upper_bound, std::sort
+
+//
+// Where each point of an ErgFile sits on the x axis, and the sorted
+// lap starts, so a position can be found by binary search instead of
+// walking the points. ErgFile fills it when the points or laps change.
+//
+// It has no dependencies so it can be exercised on its own, see the
+// seek benchmark in test/ergseek.
+//
+class ErgFileIndex
+{
+    public:
+
+        QVector<double> points; // x of each point, in file order
+        QVector<long> laps;     // lap starts, call sortLaps() after filling
+
+        void sortLaps() { std::sort(laps.begin(), laps.end()); }
+
+        // how many laps have started by x
+        int lapAt(long x) const {
+            return std::upper_bound(laps.begin(), laps.end(), x) - laps.begin();
+        }
+
+        // set left/right to the points either side of x
+        void findPoints(long x, int &left, int &right) const {
+
+            int n = points.count();
+            if (n < 2) {
+                left = right = 0;
+                return;
+            }
+
+            // during a workout we are usually still between the same
+            // two points, or have just moved on to the next pair
+            if (left >= 0 && right == left+1 && right < n) {
+                if (x >= points[left] && x <= points[right]) return;
+                if (right+1 < n && x >= points[right] && x <= points[right+1]) {
+                    left++;
+                    right++;
+                    return;
+                }
+            }
+
+            // otherwise we jumped (seek, lap skip), so search for it
+            int i = std::upper_bound(points.begin(), points.end(), double(x)) - points.begin();
+            left = qBound(0, i-1, n-2);
+            right = left + 1;
+        }
+};
+
+#endif
@@ -201,6 +201,10 @@ int LibUsb::read(char *buf, int bytes, int timeout)
     {
         // don't report timeouts - lots of noise so commented out
         //qDebug()<<"usb_bulk_read Error reading: "<<rc<< usb_strerror();
+
+        // the buffered bytes were copied out above, they must be
+        // counted or the caller will lose them
+        if (bufRemain > 0) return bufRemain;
         return rc;
     }
     readBufSize = rc;
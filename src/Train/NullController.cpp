@@ -31,7 +31,8 @@ NullController::NullController(TrainSidebar *parent,
 }
 
 int NullController::start() {
-  count = 0;
+  beats = 0;
+  beat.start();
   return 0;
 }
 
@@ -52,6 +53,12 @@ bool NullController::find() {
 }
 
 void NullController::getRealtimeData(RealtimeData &rtData) {
+    sampleRealtimeData(rtData);
+}
+
+// nothing here needs the gui, so the robot can be sampled at any rate
+// by the acquisition thread, which makes it handy for measuring jitter
+bool NullController::sampleRealtimeData(RealtimeData &rtData) {
     rtData.setName((char *)"Null");
     //rtData.setWatts(load + ((rand()%25)-15)); // for testing virtual power
     rtData.setWatts(load); // no randomisation
@@ -63,7 +70,9 @@ void NullController::getRealtimeData(RealtimeData &rtData) {
     processRealtimeData(rtData); // for testing virtual power etc
 
     // generate an R-R data signal based upon 60bpm +/- 2bpm
-    if (count++%5 == 0) {
+    // once a second, regardless of how often we are sampled
+    if (beat.hasExpired(1000)) {
+        beat.restart();
 
         // emit measurementTime 1/1024s plus a little randomness, incremental beat count, bpm of 60 +/- 2
         uint16_t m = (beats * 1024) + (rand()%50);
@@ -73,6 +82,7 @@ void NullController::getRealtimeData(RealtimeData &rtData) {
         //qDebug()<<"rrdata:"<<m<<b<<bpm;
         emit rrData(m, b, bpm);
     }
+    return true;
 }
 
 void NullController::pushRealtimeData(RealtimeData &) {
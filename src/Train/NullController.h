@@ -24,6 +24,7 @@
 
 #include <QString>
 #include <QDebug>
+#include <QElapsedTimer>
 
 #include "RealtimeController.h"
 #include "RealtimeData.h"
@@ -52,8 +53,10 @@ class NullController : public RealtimeController
         bool doesPush() {  return false; }
         bool doesPull() {  return true; }
         bool doesLoad() {  return false; }
+        bool doesSample() {  return true; }
         void setLoad(double watts) { load = watts; }
         void getRealtimeData(RealtimeData &rtData);
+        bool sampleRealtimeData(RealtimeData &rtData);
         void pushRealtimeData(RealtimeData &rtData);
 
     signals:
@@ -65,7 +68,8 @@ class NullController : public RealtimeController
     private:
 
         double load;
-        int beats,count; // send an R-R signal every 4th call
+        int beats;
+        QElapsedTimer beat; // send an R-R signal every second
 };
 
 
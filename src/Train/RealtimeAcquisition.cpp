@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "RealtimeAcquisition.h"
+
+RealtimeAcquisition::RealtimeAcquisition(QObject *parent) : QThread(parent),
+    failures(NULL), stopping(0), rate(5), samples(0), totalLate(0), maxLate(0)
+{
+}
+
+RealtimeAcquisition::~RealtimeAcquisition()
+{
+    stop();
+    clear();
+}
+
+void
+RealtimeAcquisition::clear()
+{
+    foreach(Ring *ring, rings) delete ring;
+    rings.clear();
+    sampling.clear();
+    controllers.clear();
+    delete[] failures;
+    failures = NULL;
+}
+
+void
+RealtimeAcquisition::setControllers(QList<RealtimeSampler*> list)
+{
+    stop();
+    clear();
+
+    controllers = list;
+    failures = new QAtomicInt[list.count()];
+    foreach(RealtimeSampler *controller, list) {
+        sampling << controller->doesSample();
+        for (int i=0; i<CONSUMERS; i++) rings << new Ring;
+    }
+
+    statsLock.lock();
+    samples = totalLate = maxLate = 0;
+    statsLock.unlock();
+
+    clock.start();
+}
+
+void
+RealtimeAcquisition::setInputs(const RealtimeData &x)
+{
+    inputsLock.lock();
+    inputs = x;
+    inputsLock.unlock();
+}
+
+bool
+RealtimeAcquisition::isSampling(int device) const
+{
+    return device >= 0 && device < sampling.count() && sampling[device];
+}
+
+bool
+RealtimeAcquisition::failed(int device) const
+{
+    return isSampling(device) && failures[device].load();
+}
+
+void
+RealtimeAcquisition::stop()
+{
+    if (!isRunning()) return;
+
+    stopping.store(1);
+    wait();
+    stopping.store(0);
+}
+
+void
+RealtimeAcquisition::jitter(qint64 &n, qint64 &mean, qint64 &max)
+{
+    statsLock.lock();
+    n = samples;
+    mean = samples ? totalLate / samples : 0;
+    max = maxLate;
+    statsLock.unlock();
+}
+
+void
+RealtimeAcquisition::run()
+{
+    // nothing for us to do?
+    if (!sampling.contains(true)) return;
+
+    for (int i=0; i<controllers.count(); i++) failures[i].store(0);
+
+    // schedule against the clock rather than sleeping a period
+    // after each sample, so the time taken to sample doesn't drift
+    const qint64 period = 1000000 / rate;
+    qint64 due = clock.nsecsElapsed() / 1000;
+
+    while (!stopping.load()) {
+
+        qint64 now = clock.nsecsElapsed() / 1000;
+        if (now < due) {
+            usleep(due - now);
+            continue;
+        }
+
+        statsLock.lock();
+        samples++;
+        totalLate += now - due;
+        if (now - due > maxLate) maxLate = now - due;
+        statsLock.unlock();
+
+        // fell behind, skip rather than try to catch up
+        due += period;
+        if (due < now) due = now + period;
+
+        RealtimeSample sample;
+        sample.msecs = now / 1000;
+
+        inputsLock.lock();
+        RealtimeData seed = inputs;
+        inputsLock.unlock();
+
+        for (int i=0; i<controllers.count(); i++) {
+
+            if (!sampling[i] || failures[i].load()) continue;
+
+            sample.data = seed;
+            if (!controllers[i]->sampleRealtimeData(sample.data)) {
+                failures[i].store(1);
+                continue;
+            }
+
+            for (int c=0; c<CONSUMERS; c++) rings[i*CONSUMERS + c]->push(sample);
+        }
+    }
+}
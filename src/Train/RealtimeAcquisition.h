@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_RealtimeAcquisition_h
+#define _GC_RealtimeAcquisition_h 1
+#include "GoldenCheetah.h"
+
+#include <QThread>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QVector>
+#include <QList>
+#include <QElapsedTimer>
+
+#include "RealtimeData.h"
+
+//
+// What the acquisition thread reads from. RealtimeController implements
+// it for the devices, but it needs nothing else so the thread can be run
+// against anything that produces readings.
+//
+class RealtimeSampler
+{
+    public:
+        virtual ~RealtimeSampler() {}
+
+        virtual bool doesSample() { return false; } // pull device that can be read off the gui thread
+
+        // read by the acquisition thread (only called for doesSample devices) so it
+        // must not touch the gui; returns false when the device has gone away and
+        // getRealtimeData will then be called from the gui thread to deal with it
+        virtual bool sampleRealtimeData(RealtimeData &) { return false; }
+};
+
+// a reading from one device and when it was taken
+struct RealtimeSample {
+    qint64 msecs; // since acquisition started
+    RealtimeData data;
+};
+
+//
+// Fixed size ring with a single producer and a single consumer,
+// neither side takes a lock. Indexes run over twice the size so
+// full and empty can be told apart. Only the producer moves head
+// and only the consumer moves tail, so a slot is never written
+// whilst it is being read: when full the new sample is dropped and
+// counted, and a consumer that falls behind works through what is
+// held before it sees newer readings.
+//
+template <class T, int N> // N must be a power of 2
+class RealtimeRing
+{
+    public:
+        RealtimeRing() : head(0), tail(0), dropped(0) {}
+
+        // producer only
+        void push(const T &x) {
+            int h = head.load();
+            int t = tail.loadAcquire();
+            if (((h - t) & (2*N-1)) == N) {
+                // full, the consumer may be copying out of any slot
+                dropped.ref();
+                return;
+            }
+            buffer[h & (N-1)] = x;
+            head.storeRelease((h+1) & (2*N-1));
+        }
+
+        // consumer only
+        bool pop(T &x) {
+            int t = tail.load();
+            if (t == head.loadAcquire()) return false;
+            x = buffer[t & (N-1)];
+            tail.storeRelease((t+1) & (2*N-1));
+            return true;
+        }
+
+        // consumer only, discard what is held
+        void clear() {
+            T x;
+            while (pop(x)) ;
+        }
+
+        // consumer only, skip to the most recent held
+        bool latest(T &x) {
+            bool got = false;
+            while (pop(x)) got = true;
+            return got;
+        }
+
+        int overruns() const { return dropped.load(); }
+
+    private:
+        T buffer[N];
+        QAtomicInt head, tail, dropped;
+};
+
+//
+// Samples the pull devices that support it from a thread of its own
+// at a fixed rate, so a busy gui doesn't delay or skew the readings.
+// Each device has a ring per consumer; the gui and the recorder read
+// theirs independently. Devices that need the gui thread to read their
+// telemetry are left for the gui to poll as before (see doesSample).
+//
+class RealtimeAcquisition : public QThread
+{
+    Q_OBJECT
+
+    public:
+        enum { GUI=0, RECORDER, CONSUMERS };
+        typedef RealtimeRing<RealtimeSample, 256> Ring;
+
+        RealtimeAcquisition(QObject *parent);
+        ~RealtimeAcquisition();
+
+        // set before start, devices are referred to by their index in this list
+        void setControllers(QList<RealtimeSampler*> controllers);
+        void setRate(int hz) { rate = hz > 0 ? hz : 1; }
+
+        // mode, load, slope etc the controllers are passed when sampled
+        void setInputs(const RealtimeData &inputs);
+
+        // stop sampling and wait for the thread to finish
+        void stop();
+
+        bool isSampling(int device) const;
+        bool failed(int device) const; // device went away, let the gui deal with it
+        Ring &ring(int device, int consumer) { return *rings[device*CONSUMERS + consumer]; }
+
+        // msecs since setControllers, the clock samples are stamped with
+        qint64 elapsed() const { return clock.elapsed(); }
+
+        // how late each sample was taken against its schedule, in microseconds
+        void jitter(qint64 &samples, qint64 &mean, qint64 &max);
+
+    protected:
+        void run();
+
+    private:
+        QList<RealtimeSampler*> controllers;
+        QVector<bool> sampling;
+        QVector<Ring*> rings;
+        QAtomicInt *failures;
+        QAtomicInt stopping;
+        QElapsedTimer clock;
+        int rate;
+
+        QMutex inputsLock;
+        RealtimeData inputs;
+
+        QMutex statsLock;
+        qint64 samples, totalLate, maxLate;
+
+        void clear();
+};
+
+#endif // _GC_RealtimeAcquisition_h
@@ -21,6 +21,7 @@
 #include "RealtimeData.h"
 #include "CalibrationData.h"
 #include "TrainSidebar.h"
+#include "RealtimeAcquisition.h"
 
 #ifndef _GC_RealtimeController_h
 #define _GC_RealtimeController_h 1
@@ -29,7 +30,7 @@
 #define DEVICE_ERROR 1
 #define DEVICE_OK 0
 
-class RealtimeController : public QObject
+class RealtimeController : public QObject, public RealtimeSampler
 {
     Q_OBJECT
 
@@ -57,6 +58,8 @@ public:
     virtual void getRealtimeData(RealtimeData &rtData); // update realtime data with current values
     virtual void pushRealtimeData(RealtimeData &rtData); // update realtime data with current values
 
+    // doesSample() and sampleRealtimeData() come from RealtimeSampler
+
     // only relevant for Computrainer like devices
     virtual void setLoad(double) { return; }
     virtual void setGradient(double) { return; }
@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "TrainRecorder.h"
+#include "JsonRideFile.h" // for DATETIME_FORMAT
+
+#include <QElapsedTimer>
+
+#ifdef Q_OS_WIN
+#include <io.h> // _commit
+#else
+#include <unistd.h> // fsync
+#endif
+
+// how often the batch is written and synced
+#define SYNCMSECS 10000
+
+static const char *header = "{\n\t\"RIDE\":{\n\t\t\"STARTTIME\":\"";
+static const char *samples = "\t\t\"SAMPLES\":[\n";
+static const char *ending = "\n\t}\n}\n";
+
+static void
+syncFile(QFile &file)
+{
+    file.flush();
+#ifdef Q_OS_WIN
+    _commit(file.handle());
+#else
+    fsync(file.handle());
+#endif
+}
+
+TrainRecorder::TrainRecorder(QObject *parent) : QThread(parent), stopping(0)
+{
+}
+
+TrainRecorder::~TrainRecorder()
+{
+    stop();
+}
+
+bool
+TrainRecorder::start(QString filename, QDateTime startTime, QList<Source> list)
+{
+    stop();
+
+    file.setFileName(filename);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) return false;
+
+    // the device rings fill up whilst nobody is recording, what they
+    // hold is from before the session; we are their only reader and
+    // the thread isn't running yet so it is safe to empty them here
+    sources = list;
+    foreach(Source source, sources) source.ring->clear();
+    pending.fill(QList<RealtimeSample>(), sources.count());
+    current.count = 0;
+    lastSession = 0;
+    laps.clear();
+    targets.clear();
+    beatsLock.lock();
+    beats.clear();
+    beatsLock.unlock();
+    first = true;
+
+    // everything up to the samples, which follow as they arrive
+    batch = header;
+    batch += startTime.toUTC().toString(DATETIME_FORMAT).toUtf8();
+    batch += "\",\n\t\t\"RECINTSECS\":1,\n";
+    batch += "\t\t\"DEVICETYPE\":\"GoldenCheetah\",\n";
+    batch += "\t\t\"IDENTIFIER\":\"\",\n";
+    batch += samples;
+    write(true);
+
+    QThread::start();
+    return true;
+}
+
+void
+TrainRecorder::stop()
+{
+    if (!isRunning()) return;
+
+    stopping.store(1);
+    wait();
+    stopping.store(0);
+}
+
+void
+TrainRecorder::beat(double secs, int msecs)
+{
+    beatsLock.lock();
+    beats << QPair<double, int>(secs, msecs);
+    beatsLock.unlock();
+}
+
+void
+TrainRecorder::run()
+{
+    QElapsedTimer synced;
+    synced.start();
+
+    forever {
+
+        // anything pushed before we were asked to stop gets recorded
+        bool last = stopping.load();
+
+        TrainRecorderTick tick;
+        while (ring.pop(tick)) process(tick);
+
+        if (last) break;
+
+        if (synced.elapsed() >= SYNCMSECS) {
+            write(true);
+            synced.restart();
+        }
+        msleep(100);
+    }
+
+    finish();
+}
+
+void
+TrainRecorder::process(const TrainRecorderTick &tick)
+{
+    RealtimeData data = tick.data;
+
+    // device samples taken since the last tick, in acquisition time, so
+    // anything from before the session started or whilst paused is dropped
+    qint64 since = tick.acquired - (tick.session - lastSession);
+
+    for (int i=0; i<sources.count(); i++) {
+
+        RealtimeSample sample;
+        while (sources[i].ring->pop(sample)) pending[i] << sample;
+
+        int n=0;
+        double watts=0, hr=0, cad=0, kph=0, lrbalance=0, lte=0, rte=0, lps=0, rps=0, smo2=0, thb=0;
+        while (pending[i].count() && pending[i].first().msecs <= tick.acquired) {
+
+            RealtimeSample s = pending[i].takeFirst();
+            if (s.msecs <= since) continue;
+
+            n++;
+            watts += s.data.getWatts();
+            hr += s.data.getHr();
+            cad += s.data.getCadence();
+            kph += s.data.getSpeed();
+            lrbalance += s.data.getLRBalance();
+            lte += s.data.getLTE();
+            rte += s.data.getRTE();
+            lps += s.data.getLPS();
+            rps += s.data.getRPS();
+            smo2 += s.data.getSmO2();
+            thb += s.data.gettHb();
+        }
+        if (n == 0) continue;
+
+        // the device's own readings beat the gui's snapshot of them
+        int series = sources[i].series;
+        if (series & Watts) {
+            data.setWatts(watts/n);
+            data.setLRBalance(lrbalance/n);
+            data.setLTE(lte/n);
+            data.setRTE(rte/n);
+            data.setLPS(lps/n);
+            data.setRPS(rps/n);
+        }
+        if (series & HeartRate) data.setHr(hr/n);
+        if (series & Cadence) data.setCadence(cad/n);
+        if (series & Speed) data.setSpeed(kph/n);
+        if (series & Hb) data.setHb(smo2/n, thb/n);
+    }
+    lastSession = tick.session;
+
+    add(data, tick.session);
+}
+
+void
+TrainRecorder::add(const RealtimeData &data, qint64 session)
+{
+    int secs = session / 1000;
+
+    if (current.count && current.secs != secs) endSecond();
+
+    if (current.count == 0) {
+        current.secs = secs;
+        current.watts = current.hr = current.cad = current.kph = 0;
+        current.lrbalance = current.lte = current.rte = current.lps = current.rps = 0;
+        current.smo2 = current.thb = 0;
+    }
+
+    current.count++;
+    current.watts += data.getWatts();
+    current.hr += data.getHr();
+    current.cad += data.getCadence();
+    current.kph += data.getSpeed();
+    current.lrbalance += data.getLRBalance();
+    current.lte += data.getLTE();
+    current.rte += data.getRTE();
+    current.lps += data.getLPS();
+    current.rps += data.getRPS();
+    current.smo2 += data.getSmO2();
+    current.thb += data.gettHb();
+
+    // as they stand at the end of the second
+    current.km = data.getDistance();
+    current.load = data.getLoad();
+    current.lap = data.getLap();
+}
+
+void
+TrainRecorder::endSecond()
+{
+    double n = current.count;
+    current.count = 0;
+
+    if (!first) batch += ",\n";
+    first = false;
+
+    batch += QString("\t\t\t{ \"SECS\":%1, \"KM\":%2, \"WATTS\":%3, \"CAD\":%4, \"KPH\":%5, \"HR\":%6")
+             .arg(current.secs).arg(current.km).arg(current.watts/n).arg(current.cad/n)
+             .arg(current.kph/n).arg(current.hr/n).toUtf8();
+    if (current.lrbalance) batch += QString(", \"LRBALANCE\":%1").arg(current.lrbalance/n).toUtf8();
+    if (current.lte) batch += QString(", \"LTE\":%1").arg(current.lte/n).toUtf8();
+    if (current.rte) batch += QString(", \"RTE\":%1").arg(current.rte/n).toUtf8();
+    if (current.lps) batch += QString(", \"LPS\":%1").arg(current.lps/n).toUtf8();
+    if (current.rps) batch += QString(", \"RPS\":%1").arg(current.rps/n).toUtf8();
+    if (current.smo2) batch += QString(", \"SMO2\":%1").arg(current.smo2/n).toUtf8();
+    if (current.thb) batch += QString(", \"THB\":%1").arg(current.thb/n).toUtf8();
+    batch += " }";
+
+    // laps and targets are kept for the end
+    if (laps.isEmpty() || laps.last().lap != current.lap) {
+        Lap add = { current.lap, current.secs, current.secs };
+        laps << add;
+    } else {
+        laps.last().stop = current.secs;
+    }
+    if (current.load > 0) {
+        Target add = { current.secs, current.km, current.load };
+        targets << add;
+    }
+}
+
+void
+TrainRecorder::write(bool sync)
+{
+    if (batch.size()) {
+        file.write(batch);
+        batch.clear();
+    }
+    if (sync) syncFile(file);
+}
+
+void
+TrainRecorder::finish()
+{
+    if (current.count) endSecond();
+    batch += "\n\t\t]";
+
+    // laps become intervals as they did when importing the csv,
+    // a lap that runs to the end is only marked if it isn't lap 0
+    QList<Lap> intervals;
+    for (int i=0; i<laps.count(); i++) {
+        if (i+1 < laps.count() || laps[i].lap > 0) intervals << laps[i];
+    }
+    if (intervals.count()) {
+        batch += ",\n\t\t\"INTERVALS\":[\n";
+        for (int i=0; i<intervals.count(); i++) {
+            if (i) batch += ",\n";
+            batch += QString("\t\t\t{ \"NAME\":\"%1\", \"START\": %2, \"STOP\": %3 }")
+                     .arg(intervals[i].lap).arg(intervals[i].start).arg(intervals[i].stop).toUtf8();
+        }
+        batch += "\n\t\t]";
+    }
+
+    // the workout's target power and any r-r intervals
+    beatsLock.lock();
+    QList<QPair<double, int> > rr = beats;
+    beatsLock.unlock();
+
+    if (targets.count() || rr.count()) {
+        batch += ",\n\t\t\"XDATA\":[\n";
+        if (targets.count()) {
+            batch += "\t\t{\n";
+            batch += "\t\t\t\"NAME\" : \"TRAIN\",\n";
+            batch += "\t\t\t\"VALUE\" : \"TARGET\",\n";
+            batch += "\t\t\t\"UNIT\" : \"Watts\",\n";
+            batch += "\t\t\t\"SAMPLES\" : [\n";
+            for (int i=0; i<targets.count(); i++) {
+                if (i) batch += ",\n";
+                batch += QString("\t\t\t\t{ \"SECS\":%1, \"KM\":%2, \"VALUE\":%3 }")
+                         .arg(targets[i].secs).arg(targets[i].km).arg(targets[i].load).toUtf8();
+            }
+            batch += "\n\t\t\t]\n\t\t}";
+        }
+        if (rr.count()) {
+            // same as the polar and csv imports
+            if (targets.count()) batch += ",\n";
+            batch += "\t\t{\n";
+            batch += "\t\t\t\"NAME\" : \"HRV\",\n";
+            batch += "\t\t\t\"VALUE\" : \"R-R\",\n";
+            batch += "\t\t\t\"UNIT\" : \"msecs\",\n";
+            batch += "\t\t\t\"SAMPLES\" : [\n";
+            for (int i=0; i<rr.count(); i++) {
+                if (i) batch += ",\n";
+                batch += QString("\t\t\t\t{ \"SECS\":%1, \"KM\":0, \"VALUE\":%2 }")
+                         .arg(rr[i].first).arg(rr[i].second).toUtf8();
+            }
+            batch += "\n\t\t\t]\n\t\t}";
+        }
+        batch += "\n\t\t]";
+    }
+
+    batch += ending;
+    write(true);
+    file.close();
+}
+
+QStringList
+TrainRecorder::recover(QDir records)
+{
+    QStringList returning;
+
+    foreach(QString name, records.entryList(QStringList() << "*.json", QDir::Files)) {
+
+        QFile recording(records.absoluteFilePath(name));
+        if (!recording.open(QFile::ReadWrite)) continue;
+
+        // only ours, and only if it didn't get finished
+        QByteArray content = recording.readAll();
+        if (!content.startsWith(header) || !content.contains("\"DEVICETYPE\":\"GoldenCheetah\"") ||
+            content.endsWith(ending)) {
+            recording.close();
+            continue;
+        }
+
+        // lose anything after the last complete sample
+        int start = content.indexOf(samples);
+        int end = content.lastIndexOf(" }");
+        if (start < 0 || end < start) {
+            // nothing worth keeping
+            recording.remove();
+            continue;
+        }
+
+        recording.resize(end + 2);
+        recording.seek(end + 2);
+        recording.write(QByteArray("\n\t\t]") + ending);
+        syncFile(recording);
+        recording.close();
+
+        returning << recording.fileName();
+    }
+    return returning;
+}
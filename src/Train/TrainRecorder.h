@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_TrainRecorder_h
+#define _GC_TrainRecorder_h 1
+#include "GoldenCheetah.h"
+
+#include <QThread>
+#include <QFile>
+#include <QDir>
+#include <QDateTime>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+#include <QMutex>
+
+#include "RealtimeData.h"
+#include "RealtimeAcquisition.h"
+
+// the session as the gui saw it at a screen update
+struct TrainRecorderTick {
+    qint64 session;  // msecs into the session, pauses excluded
+    qint64 acquired; // acquisition clock at the same moment
+    RealtimeData data;
+};
+
+//
+// Records a training session straight into a .json activity from a
+// thread of its own. The gui hands over each screen update through a
+// ring, and devices sampled by the acquisition thread are read from
+// their own rings at the full device rate. Readings are averaged into
+// one second samples and written in batches that are synced to disk,
+// leaving the file one closing bracket short of valid json until the
+// session ends; recover() tidies up any left that way by a crash.
+//
+class TrainRecorder : public QThread
+{
+    Q_OBJECT
+
+    public:
+        // the series a device provides, see TrainSidebar::mergeTelemetry
+        enum { Watts=0x01, HeartRate=0x02, Cadence=0x04, Speed=0x08, Hb=0x10 };
+
+        struct Source {
+            RealtimeAcquisition::Ring *ring;
+            int series;
+        };
+
+        typedef RealtimeRing<TrainRecorderTick, 256> Ring;
+
+        TrainRecorder(QObject *parent);
+        ~TrainRecorder();
+
+        // open the file and start the thread, sources can be empty
+        bool start(QString filename, QDateTime startTime, QList<Source> sources);
+
+        // write out whatever is left, close the file and wait for the thread
+        void stop();
+
+        QString fileName() const { return file.fileName(); }
+
+        // an r-r interval, secs into the session
+        void beat(double secs, int msecs);
+
+        // gui thread only, while recording
+        Ring &ticks() { return ring; }
+
+        // finish off recordings interrupted by a crash, returns their names
+        static QStringList recover(QDir records);
+
+    protected:
+        void run();
+
+    private:
+        QFile file;
+        Ring ring;
+        QList<Source> sources;
+        QAtomicInt stopping;
+
+        // device samples waiting for the tick that covers them
+        QVector<QList<RealtimeSample> > pending;
+
+        // the second being accumulated
+        struct Second {
+            int secs, count;
+            double watts, hr, cad, kph, lrbalance, lte, rte, lps, rps, smo2, thb;
+            double km, load;
+            int lap;
+        } current;
+        qint64 lastSession;
+
+        // written at the end, they don't need to survive a crash
+        struct Lap { int lap, start, stop; };
+        struct Target { int secs; double km, load; };
+        QList<Lap> laps;
+        QList<Target> targets;
+
+        QMutex beatsLock;
+        QList<QPair<double, int> > beats;
+
+        QByteArray batch;
+        bool first;
+
+        void process(const TrainRecorderTick &tick);
+        void add(const RealtimeData &data, qint64 session);
+        void endSecond();
+        void write(bool sync);
+        void finish();
+};
+
+#endif // _GC_TrainRecorder_h
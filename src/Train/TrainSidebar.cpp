@@ -327,15 +327,15 @@ TrainSidebar::TrainSidebar(Context *context) : GcWindow(context), context(contex
 
     // now the GUI is setup lets sort our control variables
     gui_timer = new QTimer(this);
-    disk_timer = new QTimer(this);
     load_timer = new QTimer(this);
+    acquisition = new RealtimeAcquisition(this);
+    recorder = new TrainRecorder(this);
 
     session_time = QTime();
     session_elapsed_msec = 0;
     lap_time = QTime();
     lap_elapsed_msec = 0;
 
-    rrFile = recordFile = NULL;
     status = 0;
     setStatusFlags(RT_MODE_ERGO);         // ergo mode by default
     mode = ERG;
@@ -355,7 +355,6 @@ TrainSidebar::TrainSidebar(Context *context) : GcWindow(context), context(contex
     displayLRBalance = displayLTE = displayRTE = displayLPS = displayRPS = 0;
 
     connect(gui_timer, SIGNAL(timeout()), this, SLOT(guiUpdate()));
-    connect(disk_timer, SIGNAL(timeout()), this, SLOT(diskUpdate()));
     connect(load_timer, SIGNAL(timeout()), this, SLOT(loadUpdate()));
 
     configChanged(CONFIG_APPEARANCE | CONFIG_DEVICES | CONFIG_ZONES); // will reset the workout tree
@@ -624,6 +623,7 @@ TrainSidebar::configChanged(qint32)
         deviceTree->setSelectionMode(QAbstractItemView::SingleSelection);
 
     // wipe whatever is there
+    acquisition->stop();
     foreach(DeviceConfiguration x, Devices) delete x.controller;
     Devices.clear();
 
@@ -1118,7 +1118,6 @@ void TrainSidebar::Start()       // when start button is pressed
         clearStatusFlags(RT_PAUSED);
         //foreach(int dev, activeDevices) Devices[dev].controller->restart();
         //gui_timer->start(REFRESHRATE);
-        if (status & RT_RECORDING) disk_timer->start(SAMPLERATE);
         load_period.restart();
         if (status & RT_WORKOUT) load_timer->start(LOADRATE);
 
@@ -1144,7 +1143,6 @@ void TrainSidebar::Start()       // when start button is pressed
         setStatusFlags(RT_PAUSED);
         //foreach(int dev, activeDevices) Devices[dev].controller->pause();
         //gui_timer->stop();
-        if (status & RT_RECORDING) disk_timer->stop();
         if (status & RT_WORKOUT) load_timer->stop();
         load_msecs += load_period.restart();
 
@@ -1236,26 +1234,40 @@ void TrainSidebar::Start()       // when start button is pressed
         if (status & RT_RECORDING) {
             QDateTime now = QDateTime::currentDateTime();
 
-            // setup file
-            QString filename = now.toString(QString("yyyy_MM_dd_hh_mm_ss")) + QString(".csv");
-
             if (!context->athlete->home->records().exists())
                 context->athlete->home->createAllSubdirs();
 
-            QString fulltarget = context->athlete->home->records().canonicalPath() + "/" + filename;
-
-            if (recordFile) delete recordFile;
-            recordFile = new QFile(fulltarget);
-            if (!recordFile->open(QFile::WriteOnly | QFile::Truncate)) {
-                clearStatusFlags(RT_RECORDING);
-            } else {
+            // anything left behind by a crash gets finished off and imported
+            QStringList recovered = TrainRecorder::recover(context->athlete->home->records());
+            if (recovered.count()) {
+                RideImportWizard *dialog = new RideImportWizard (recovered, context);
+                dialog->process(); // do it!
+            }
 
-                // CSV File header
+            // setup file
+            QString filename = now.toString(QString("yyyy_MM_dd_hh_mm_ss")) + QString(".json");
+            QString fulltarget = context->athlete->home->records().canonicalPath() + "/" + filename;
 
-                QTextStream recordFileStream(recordFile);
-                recordFileStream << "secs, cad, hr, km, kph, nm, watts, alt, lon, lat, headwind, slope, temp, interval, lrbalance, lte, rte, lps, rps, smo2, thb, o2hb, hhb, target\n";
+            // devices sampled off the gui thread are recorded at their own
+            // rate, for the series we take from them (see mergeTelemetry)
+            QList<TrainRecorder::Source> sources;
+            for (int i=0; i<activeDevices.count(); i++) {
+                if (!acquisition->isSampling(i)) continue;
+
+                int dev = activeDevices[i];
+                TrainRecorder::Source source;
+                source.ring = &acquisition->ring(i, RealtimeAcquisition::RECORDER);
+                source.series = 0;
+                if (dev == wattsTelemetry) source.series |= TrainRecorder::Watts;
+                if (dev == bpmTelemetry) source.series |= TrainRecorder::HeartRate;
+                if (dev == rpmTelemetry) source.series |= TrainRecorder::Cadence;
+                if (dev == kphTelemetry) source.series |= TrainRecorder::Speed;
+                if (Devices[dev].type == DEV_ANTLOCAL || Devices[dev].type == DEV_NULL) source.series |= TrainRecorder::Hb;
+                if (source.series) sources << source;
+            }
 
-                disk_timer->start(SAMPLERATE);  // start screen
+            if (!recorder->start(fulltarget, now, sources)) {
+                clearStatusFlags(RT_RECORDING);
             }
         }
         gui_timer->start(REFRESHRATE);      // start recording
@@ -1278,7 +1290,6 @@ void TrainSidebar::Pause()        // pause capture to recalibrate
         clearStatusFlags(RT_PAUSED);
         foreach(int dev, activeDevices) Devices[dev].controller->restart();
         gui_timer->start(REFRESHRATE);
-        if (status & RT_RECORDING) disk_timer->start(SAMPLERATE);
         load_period.restart();
         if (status & RT_WORKOUT) load_timer->start(LOADRATE);
 
@@ -1298,7 +1309,6 @@ void TrainSidebar::Pause()        // pause capture to recalibrate
         foreach(int dev, activeDevices) Devices[dev].controller->pause();
         setStatusFlags(RT_PAUSED);
         gui_timer->stop();
-        if (status & RT_RECORDING) disk_timer->stop();
         if (status & RT_WORKOUT) load_timer->stop();
         load_msecs += load_period.restart();
 
@@ -1355,27 +1365,18 @@ void TrainSidebar::Stop(int deviceStatus)        // when stop button is pressed
     QDateTime now = QDateTime::currentDateTime();
 
     if (status & RT_RECORDING) {
-        disk_timer->stop();
-
-        // close and reset File
-        recordFile->close();
 
-        // close rrFile
-        if (rrFile) {
-            //fprintf(stderr, "Closing r-r file\n"); fflush(stderr);
-            rrFile->close();
-            delete rrFile;
-            rrFile=NULL;
-        }
+        // write out what's left and close the file
+        recorder->stop();
 
         if(deviceStatus == DEVICE_ERROR)
         {
-            recordFile->remove();
+            QFile::remove(recorder->fileName());
         }
         else {
             // add to the view - using basename ONLY
             QString name;
-            name = recordFile->fileName();
+            name = recorder->fileName();
 
             QList<QString> list;
             list.append(name);
@@ -1495,6 +1496,15 @@ void TrainSidebar::Connect()
         Devices[dev].controller->start();
         Devices[dev].controller->resetCalibrationState();
     }
+
+    // sample what we can away from the gui
+    QList<RealtimeSampler*> controllers;
+    foreach(int dev, activeDevices) controllers << Devices[dev].controller;
+    sampled.fill(RealtimeData(), controllers.count());
+    acquisition->setControllers(controllers);
+    acquisition->setRate(appsettings->value(this, TRAIN_SAMPLERATE, 1000/REFRESHRATE).toInt());
+    acquisition->start();
+
     setStatusFlags(RT_CONNECTED);
     gui_timer->start(REFRESHRATE);
 
@@ -1511,6 +1521,15 @@ void TrainSidebar::Disconnect()
 
     qDebug() << "disconnecting..";
 
+    acquisition->stop();
+
+#ifdef GC_DEBUG
+    // how steady was sampling? the robot makes a good test device for this
+    qint64 samples, mean, max;
+    acquisition->jitter(samples, mean, max);
+    if (samples) qDebug() << "acquisition:" << samples << "samples, jitter mean" << mean << "max" << max << "usecs";
+#endif
+
     foreach(int dev, activeDevices) Devices[dev].controller->stop();
     clearStatusFlags(RT_CONNECTED);
 
@@ -1523,6 +1542,69 @@ void TrainSidebar::Disconnect()
 // SCREEN UPDATE FUNCTIONS
 //----------------------------------------------------------------------
 
+// latest telemetry from the index'th active device, taken from the
+// acquisition thread when it samples the device, otherwise polled here
+void TrainSidebar::deviceTelemetry(int index, RealtimeData &local)
+{
+    if (acquisition->isSampling(index) && !acquisition->failed(index)) {
+        RealtimeSample sample;
+        if (acquisition->ring(index, RealtimeAcquisition::GUI).latest(sample)) sampled[index] = sample.data;
+        local = sampled[index];
+    } else {
+        Devices[activeDevices[index]].controller->getRealtimeData(local);
+    }
+}
+
+// take the series we get from this device
+void TrainSidebar::mergeTelemetry(int dev, const RealtimeData &local, RealtimeData &rtData)
+{
+    // get spinscan data from a computrainer?
+    if (Devices[dev].type == DEV_CT) {
+        memcpy((uint8_t*)rtData.spinScan, (uint8_t*)local.spinScan, 24);
+        rtData.setLoad(local.getLoad()); // and get load in case it was adjusted
+        rtData.setSlope(local.getSlope()); // and get slope in case it was adjusted
+        // to within defined limits
+    }
+
+    if (Devices[dev].type == DEV_FORTIUS || Devices[dev].type == DEV_IMAGIC) {
+        rtData.setLoad(local.getLoad()); // and get load in case it was adjusted
+        rtData.setSlope(local.getSlope()); // and get slope in case it was adjusted
+        // to within defined limits
+    }
+
+    if (Devices[dev].type == DEV_ANTLOCAL || Devices[dev].type == DEV_NULL) {
+        rtData.setHb(local.getSmO2(), local.gettHb()); //only moxy data from ant and robot devices right now
+    }
+
+    // what are we getting from this one?
+    if (dev == bpmTelemetry) rtData.setHr(local.getHr());
+    if (dev == rpmTelemetry) rtData.setCadence(local.getCadence());
+    if (dev == kphTelemetry) {
+        rtData.setSpeed(local.getSpeed());
+        rtData.setDistance(local.getDistance());
+        rtData.setLapDistance(local.getLapDistance());
+        rtData.setLapDistanceRemaining(local.getLapDistanceRemaining());
+    }
+    if (dev == wattsTelemetry) {
+        rtData.setWatts(local.getWatts());
+        rtData.setAltWatts(local.getAltWatts());
+        rtData.setLRBalance(local.getLRBalance());
+        rtData.setLTE(local.getLTE());
+        rtData.setRTE(local.getRTE());
+        rtData.setLPS(local.getLPS());
+        rtData.setRPS(local.getRPS());
+    }
+    if (local.getTrainerStatusAvailable())
+    {
+        rtData.setTrainerStatusAvailable(true);
+        rtData.setTrainerReady(local.getTrainerReady());
+        rtData.setTrainerRunning(local.getTrainerRunning());
+        rtData.setTrainerCalibRequired(local.getTrainerCalibRequired());
+        rtData.setTrainerConfigRequired(local.getTrainerConfigRequired());
+        rtData.setTrainerBrakeFault(local.getTrainerBrakeFault());
+    }
+}
+
 void TrainSidebar::guiUpdate()           // refreshes the telemetry
 {
     RealtimeData rtData;
@@ -1547,14 +1629,15 @@ void TrainSidebar::guiUpdate()           // refreshes the telemetry
 #endif
         
         if(calibrating) {
-            foreach(int dev, activeDevices) { // Do for selected device only
+            for (int i=0; i<activeDevices.count(); i++) { // Do for selected device only
+                int dev = activeDevices[i];
                 RealtimeData local = rtData;
 
                 if (calibrationDeviceIndex == dev) {
                     // need telemetry for calibration dialog updates
                     // (and F3 button press for Computrainer)
 
-                    Devices[dev].controller->getRealtimeData(local);
+                    deviceTelemetry(i, local);
                     calibrationCurrentSpeed = local.getSpeed();
                     calibrationTorque = local.getTorque();
                     calibrationCadence = local.getCadence();
@@ -1600,57 +1683,15 @@ void TrainSidebar::guiUpdate()           // refreshes the telemetry
             rtData.setLoad(load); // always set load..
             rtData.setSlope(slope); // always set load..
 
+            // the devices sampled off the gui thread see these too
+            acquisition->setInputs(rtData);
+
             // fetch the right data from each device...
-            foreach(int dev, activeDevices) {
+            for (int i=0; i<activeDevices.count(); i++) {
 
                 RealtimeData local = rtData;
-                Devices[dev].controller->getRealtimeData(local);
-
-                // get spinscan data from a computrainer?
-                if (Devices[dev].type == DEV_CT) {
-                    memcpy((uint8_t*)rtData.spinScan, (uint8_t*)local.spinScan, 24);
-                    rtData.setLoad(local.getLoad()); // and get load in case it was adjusted
-                    rtData.setSlope(local.getSlope()); // and get slope in case it was adjusted
-                    // to within defined limits
-                }
-
-                if (Devices[dev].type == DEV_FORTIUS || Devices[dev].type == DEV_IMAGIC) {
-	                rtData.setLoad(local.getLoad()); // and get load in case it was adjusted
-                    rtData.setSlope(local.getSlope()); // and get slope in case it was adjusted
-					// to within defined limits
-				}
-
-                if (Devices[dev].type == DEV_ANTLOCAL || Devices[dev].type == DEV_NULL) {
-                    rtData.setHb(local.getSmO2(), local.gettHb()); //only moxy data from ant and robot devices right now
-                }
-
-                // what are we getting from this one?
-                if (dev == bpmTelemetry) rtData.setHr(local.getHr());
-                if (dev == rpmTelemetry) rtData.setCadence(local.getCadence());
-                if (dev == kphTelemetry) {
-                    rtData.setSpeed(local.getSpeed());
-                    rtData.setDistance(local.getDistance());
-                    rtData.setLapDistance(local.getLapDistance());
-                    rtData.setLapDistanceRemaining(local.getLapDistanceRemaining());
-                }
-                if (dev == wattsTelemetry) {
-                    rtData.setWatts(local.getWatts());
-                    rtData.setAltWatts(local.getAltWatts());
-                    rtData.setLRBalance(local.getLRBalance());
-                    rtData.setLTE(local.getLTE());
-                    rtData.setRTE(local.getRTE());
-                    rtData.setLPS(local.getLPS());
-                    rtData.setRPS(local.getRPS());
-                }
-                if (local.getTrainerStatusAvailable())
-                {
-                    rtData.setTrainerStatusAvailable(true);
-                    rtData.setTrainerReady(local.getTrainerReady());
-                    rtData.setTrainerRunning(local.getTrainerRunning());
-                    rtData.setTrainerCalibRequired(local.getTrainerCalibRequired());
-                    rtData.setTrainerConfigRequired(local.getTrainerConfigRequired());
-                    rtData.setTrainerBrakeFault(local.getTrainerBrakeFault());
-                }
+                deviceTelemetry(i, local);
+                mergeTelemetry(activeDevices[i], local, rtData);
             }
 
             // only update time & distance if actively running (not just connected, and not running but paused)
@@ -1730,6 +1771,15 @@ void TrainSidebar::guiUpdate()           // refreshes the telemetry
                             ergTimeRemaining = 0;
                 }
                 rtData.setErgMsecsRemaining(ergTimeRemaining);
+
+                // hand the update to the recorder
+                if (status & RT_RECORDING) {
+                    TrainRecorderTick tick;
+                    tick.session = total_msecs;
+                    tick.acquired = acquisition->elapsed();
+                    tick.data = rtData;
+                    recorder->ticks().push(tick);
+                }
             } else {
                 rtData.setDistance(displayDistance);
                 rtData.setLapDistance(displayLapDistance);
@@ -1877,52 +1927,6 @@ void TrainSidebar::warnnoConfig()
     QMessageBox::warning(this, tr("No Devices Configured"), tr("Please configure a device in Preferences."));
 }
 
-//----------------------------------------------------------------------
-// DISK UPDATE FUNCTIONS
-//----------------------------------------------------------------------
-void TrainSidebar::diskUpdate()
-{
-    int  secs;
-
-    long torq = 0, altitude = 0;
-    QTextStream recordFileStream(recordFile);
-
-    if (calibrating) return;
-
-    // convert from milliseconds to secondes
-    total_msecs = session_elapsed_msec + session_time.elapsed();
-    secs = total_msecs;
-    secs /= 1000.0;
-
-    // GoldenCheetah CVS Format "secs, cad, hr, km, kph, nm, watts, alt, lon, lat, headwind, slope, temp, interval, lrbalance, lte, rte, lps, rps, smo2, thb, o2hb, hhb\n";
-
-    recordFileStream    << secs
-                        << "," << displayCadence
-                        << "," << displayHeartRate
-                        << "," << displayDistance
-                        << "," << displaySpeed
-                        << "," << torq
-                        << "," << displayPower
-                        << "," << altitude
-                        << "," // lon
-                        << "," // lat
-                        << "," // headwind
-                        << "," // slope
-                        << "," // temp
-                        << "," << (displayLap + displayWorkoutLap)
-                        << "," << displayLRBalance
-                        << "," << displayLTE
-                        << "," << displayRTE
-                        << "," << displayLPS
-                        << "," << displayRPS
-                        << "," << displaySMO2
-                        << "," << displayTHB
-                        << "," << displayO2HB
-                        << "," << displayHHB
-                        << "," << load
-                        << "," << "\n";
-}
-
 //----------------------------------------------------------------------
 // WORKOUT MODE
 //----------------------------------------------------------------------
@@ -1999,7 +2003,6 @@ void TrainSidebar::toggleCalibration()
 
         clearStatusFlags(RT_CALIBRATING);
         if (status & RT_WORKOUT) load_timer->start(LOADRATE);
-        if (status & RT_RECORDING) disk_timer->start(SAMPLERATE);
         context->notifyUnPause(); // get video started again, amongst other things
 
         // back to ergo/slope mode and restore load/gradient
@@ -2031,7 +2034,6 @@ void TrainSidebar::toggleCalibration()
         lap_elapsed_msec += lap_time.elapsed();
 
         setStatusFlags(RT_CALIBRATING);
-        if (status & RT_RECORDING) disk_timer->stop();
         if (status & RT_WORKOUT) load_timer->stop();
         load_msecs += load_period.restart();
 
@@ -2716,32 +2718,13 @@ TrainSidebar::remoteControl(uint16_t command)
 // HRV R-R data received
 void TrainSidebar::rrData(uint16_t  rrtime, uint8_t count, uint8_t bpm)
 {
-    if (status&RT_RECORDING && rrFile == NULL && recordFile != NULL) {
-        QString rrfile = recordFile->fileName().replace("csv", "rr");
-        //fprintf(stderr, "First r-r, need to open file %s\n", rrfile.toStdString().c_str()); fflush(stderr);
-
-        // setup the rr file
-        rrFile = new QFile(rrfile);
-        if (!rrFile->open(QFile::WriteOnly | QFile::Truncate)) {
-            delete rrFile;
-            rrFile=NULL;
-        } else {
-
-            // CSV File header
-            QTextStream recordFileStream(rrFile);
-            recordFileStream << "secs, hr, msecs\n";
-        }
-    }
-
-    // output a line if recording and file ready
-    if (status&RT_RECORDING && rrFile) {
-        QTextStream recordFileStream(rrFile);
+    // recorded alongside the session as HRV xdata
+    if (status&RT_RECORDING && recorder->isRunning()) {
 
         // convert from milliseconds to secondes
         double secs = double(session_elapsed_msec + session_time.elapsed()) / 1000.00;
 
-        // output a line
-        recordFileStream << secs << ", " << bpm << ", " << rrtime << "\n";
+        recorder->beat(secs, rrtime);
     }
     //fprintf(stderr, "R-R: %d ms, HR=%d, count=%d\n", rrtime, bpm, count); fflush(stderr);
 }
@@ -22,6 +22,8 @@
 
 #include "Context.h"
 #include "RealtimeData.h"
+#include "RealtimeAcquisition.h"
+#include "TrainRecorder.h"
 #include "RealtimePlot.h"
 #include "DeviceConfiguration.h"
 #include "DeviceTypes.h"
@@ -64,7 +66,6 @@
 // msecs constants for timers
 #define REFRESHRATE    200 // screen refresh in milliseconds
 #define STREAMRATE     200 // rate at which we stream updates to remote peer
-#define SAMPLERATE     1000 // disk update in milliseconds
 #define LOADRATE       1000 // rate at which load is adjusted
 
 // device treeview node types
@@ -190,7 +191,6 @@ class TrainSidebar : public GcWindow
 
         // Timed actions
         void guiUpdate();           // refreshes the telemetry
-        void diskUpdate();          // writes to CSV file
         void loadUpdate();          // sets Load on CT like devices
 
         // When no config has been setup
@@ -243,6 +243,15 @@ class TrainSidebar : public GcWindow
         QList<DeviceConfiguration> Devices;
         QList<int> activeDevices;
 
+        // samples the devices that can be read off the gui thread,
+        // keeping the latest reading from each for when none arrived
+        RealtimeAcquisition *acquisition;
+        QVector<RealtimeData> sampled;
+
+        // latest telemetry from the index'th active device
+        void deviceTelemetry(int index, RealtimeData &local);
+        void mergeTelemetry(int dev, const RealtimeData &local, RealtimeData &rtData);
+
         // updated with a RealtimeData object either from
         // update() - from a push device (quarqd ANT+)
         // Device->getRealtimeData() - from a pull device (Computrainer)
@@ -266,8 +275,7 @@ class TrainSidebar : public GcWindow
         int status;
         int displaymode;
 
-        QFile *recordFile;      // where we record!
-        QFile *rrFile;          // r-r records, if any received.
+        TrainRecorder *recorder; // where we record!
         ErgFile *ergFile;       // workout file
         VideoSyncFile *videosyncFile;       // videosync file
 
@@ -287,8 +295,7 @@ class TrainSidebar : public GcWindow
         QTime session_time, lap_time;
 
         QTimer      *gui_timer,     // refresh the gui
-                    *load_timer,    // change the load on the device
-                    *disk_timer;    // write to .CSV file
+                    *load_timer;    // change the load on the device
 
         bool autoConnect;
         bool pendingConfigChange;
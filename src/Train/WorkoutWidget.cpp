@@ -124,6 +124,7 @@ WorkoutWidget::updateErgFile(ErgFile *f)
     }
 
     f->Laps = laps_;
+    f->rebuildIndex();
 
     // update METADATA too
     // XXX missing!
@@ -1486,6 +1487,7 @@ WorkoutWidget::save()
         ergFile->Duration = p->x * 1000; // whatever the last is
     }
     ergFile->Laps = laps_;
+    ergFile->rebuildIndex();
 
     //
     // SAVE
@@ -0,0 +1,22 @@
+#
+# Runs the trainer acquisition thread against the NullController robot
+# and reports how late each sample is taken against its schedule, next
+# to polling the robot from a gui thread that stalls, at several rates.
+#
+#   qmake && make && ./acqjitter [seconds] [stallms] [hz ...]
+#
+# The recorder ring is drained at the gui refresh rate, so samples it
+# dropped whilst the gui stalled are counted too.
+#
+TEMPLATE = app
+TARGET = acqjitter
+QT += widgets
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../../src/Train ../../src/Charts ../../src/Gui ../../src/Core
+HEADERS += ../../src/Train/RealtimeAcquisition.h \
+           ../../src/Train/RealtimeData.h
+SOURCES += main.cpp \
+           ../../src/Train/RealtimeAcquisition.cpp \
+           ../../src/Train/RealtimeData.cpp
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QList>
+#include <QStringList>
+#include <QTextStream>
+#include <QThread>
+
+#include <stdlib.h>
+
+#include "RealtimeAcquisition.h"
+#include "RealtimeData.h"
+
+// the gui's screen update, see REFRESHRATE in TrainSidebar.h
+static const int refresh = 200;
+
+//
+// The readings NullController::sampleRealtimeData makes. The controller
+// itself needs the train view to construct, and the robot has no device
+// config so processRealtimeData leaves its readings alone.
+//
+class NullSampler : public RealtimeSampler
+{
+    public:
+        NullSampler() : load(100) {}
+
+        bool doesSample() { return true; }
+        bool sampleRealtimeData(RealtimeData &rtData) {
+            rtData.setName((char *)"Null");
+            rtData.setWatts(load);
+            rtData.setLoad(load);
+            rtData.setSpeed(25 + ((rand()%5)-2));
+            rtData.setCadence(85 + ((rand()%10)-5));
+            rtData.setHr(145 + ((rand()%3)-2));
+            rtData.setHb(35 + ((rand()%30)), 11 + (double(rand()%100) * 0.01f));
+            return true;
+        }
+
+    private:
+        double load;
+};
+
+struct Result {
+    qint64 samples, expected, mean, max, overruns;
+};
+
+// what the gui thread does between readings, stalling once a second
+static void
+gui(QElapsedTimer &clock, qint64 &stalled, int stall)
+{
+    if (stall && clock.elapsed() - stalled >= 1000) {
+        QThread::msleep(stall);
+        stalled = clock.elapsed();
+    }
+}
+
+// sampled by the acquisition thread, the gui and recorder drain their rings
+static Result
+threaded(int rate, int seconds, int stall)
+{
+    NullSampler robot;
+    QList<RealtimeSampler*> devices;
+    devices << &robot;
+
+    RealtimeAcquisition acquisition(NULL);
+    acquisition.setControllers(devices);
+    acquisition.setRate(rate);
+    acquisition.start();
+
+    QElapsedTimer clock;
+    clock.start();
+    qint64 stalled = 0, recorded = 0;
+    RealtimeSample sample;
+
+    while (clock.elapsed() < seconds * 1000) {
+        QThread::msleep(refresh);
+        acquisition.ring(0, RealtimeAcquisition::GUI).latest(sample);
+        while (acquisition.ring(0, RealtimeAcquisition::RECORDER).pop(sample)) recorded++;
+        gui(clock, stalled, stall);
+    }
+    acquisition.stop();
+    while (acquisition.ring(0, RealtimeAcquisition::RECORDER).pop(sample)) recorded++;
+
+    Result result;
+    acquisition.jitter(result.samples, result.mean, result.max);
+    result.expected = qint64(seconds) * rate;
+    result.overruns = acquisition.ring(0, RealtimeAcquisition::RECORDER).overruns();
+
+    // the recorder must see every sample taken that wasn't dropped
+    if (recorded + result.overruns != result.samples) result.samples = -1;
+    return result;
+}
+
+// polled on the gui thread, as devices that don't sample still are
+static Result
+polled(int rate, int seconds, int stall)
+{
+    NullSampler robot;
+    RealtimeData data;
+
+    QElapsedTimer clock;
+    clock.start();
+    qint64 stalled = 0;
+
+    const qint64 period = 1000000 / rate;
+    qint64 due = clock.nsecsElapsed() / 1000;
+
+    Result result;
+    result.samples = result.mean = result.max = result.overruns = 0;
+    qint64 totalLate = 0;
+
+    while (clock.elapsed() < seconds * 1000) {
+
+        qint64 now = clock.nsecsElapsed() / 1000;
+        if (now < due) {
+            QThread::usleep(due - now);
+            continue;
+        }
+
+        result.samples++;
+        totalLate += now - due;
+        if (now - due > result.max) result.max = now - due;
+
+        due += period;
+        if (due < now) due = now + period;
+
+        robot.sampleRealtimeData(data);
+        gui(clock, stalled, stall);
+    }
+
+    result.expected = qint64(seconds) * rate;
+    result.mean = result.samples ? totalLate / result.samples : 0;
+    return result;
+}
+
+static void
+report(QTextStream &out, QString how, int rate, const Result &r)
+{
+    out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+           .arg(how, -8).arg(rate, 6)
+           .arg(r.samples, 8).arg(r.expected, 8)
+           .arg(r.mean, 10).arg(r.max, 10).arg(r.overruns, 8);
+}
+
+int
+main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    QTextStream out(stdout);
+
+    int seconds = args.count() > 1 ? qMax(1, args[1].toInt()) : 5;
+    int stall = args.count() > 2 ? args[2].toInt() : 300;
+    QList<int> rates;
+    if (args.count() > 3) {
+        foreach (QString rate, args.mid(3)) if (rate.toInt() > 0) rates << rate.toInt();
+    } else {
+        rates << 5 << 50 << 200 << 1000;
+    }
+
+    out << seconds << "s per run, gui stalls " << stall << "ms a second\n";
+    out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+           .arg("how", -8).arg("hz", 6).arg("samples", 8).arg("expected", 8)
+           .arg("mean us", 10).arg("max us", 10).arg("dropped", 8);
+    out.flush();
+
+    int lost = 0;
+    foreach (int rate, rates) {
+        Result t = threaded(rate, seconds, stall);
+        report(out, "thread", rate, t);
+        if (t.samples < 0) lost++;
+
+        report(out, "gui", rate, polled(rate, seconds, stall));
+        out.flush();
+    }
+
+    if (lost) out << lost << " runs lost samples between the ring and the recorder\n";
+    return lost ? 1 : 0;
+}
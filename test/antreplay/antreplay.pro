@@ -0,0 +1,19 @@
+#
+# Replays ANT traffic through a pseudo terminal into the framing the
+# ANT thread uses, read the way ANT::rawRead reads a serial stick, and
+# checks every message arrives intact. Unix only (needs a pty).
+#
+#   qmake && make
+#   ./antreplay [antlog.raw] [speedup]
+#
+# Without a log a synthetic stream with noise and bad checksums is used.
+#
+TEMPLATE = app
+TARGET = antreplay
+QT -= gui
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../../src/ANT
+HEADERS += ../../src/ANT/ANTFramer.h
+SOURCES += main.cpp
@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "ANTFramer.h"
+
+#include <QCoreApplication>
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QTextStream>
+#include <QThread>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+// what the ANT thread waits for serial data, see ANT_POLL_TIMEOUT
+static const int pollTimeout = 10;
+
+// one frame on the wire, good frames are expected out the other side
+struct Frame {
+    QByteArray bytes;
+    qint64 msecs; // when to send it, from the start
+    bool good;
+};
+
+static QByteArray
+frame(unsigned char id, const unsigned char *data, int length)
+{
+    QByteArray bytes;
+    bytes.append(char(ANT_SYNC_BYTE));
+    bytes.append(char(length));
+    bytes.append(char(id));
+    bytes.append((const char *)data, length);
+
+    unsigned char checksum = 0;
+    for (int i=0; i<bytes.size(); i++) checksum ^= (unsigned char)bytes[i];
+    bytes.append(char(checksum));
+    return bytes;
+}
+
+// the received messages in antlog.raw, see ANTLogger::logRawAntMessage
+static QList<Frame>
+fromLog(QString name, double speedup)
+{
+    QList<Frame> frames;
+    QFile file(name);
+    if (!file.open(QIODevice::ReadOnly)) return frames;
+
+    QByteArray log = file.readAll();
+    const int record = 1 + 8 + ANT_MAX_MESSAGE_SIZE;
+    qint64 first = -1;
+
+    for (int at=0; at + record <= log.size(); at += record) {
+        const unsigned char *r = (const unsigned char *)log.constData() + at;
+        if (r[0] != 'R') continue;
+
+        qint64 millis = 0;
+        for (int i=7; i>=0; i--) millis = (millis << 8) | r[1+i];
+        if (first < 0) first = millis;
+
+        const unsigned char *m = r + 9;
+        int length = m[1];
+        if (m[0] != ANT_SYNC_BYTE || length == 0 || length > ANT_MAX_LENGTH) continue;
+
+        Frame f;
+        f.bytes = frame(m[2], m + 3, length);
+        f.msecs = qint64((millis - first) / speedup);
+        f.good = true;
+        frames << f;
+    }
+    return frames;
+}
+
+// broadcast data on a few channels at 4Hz each, with line noise
+// and the odd corrupted checksum thrown in
+static QList<Frame>
+synthetic(int count)
+{
+    QList<Frame> frames;
+    srand(1);
+
+    for (int i=0; i<count; i++) {
+
+        // noise never contains a sync byte, so it can't look like a frame
+        if (rand() % 10 == 0) {
+            Frame noise;
+            int n = 1 + rand() % 8;
+            for (int k=0; k<n; k++) noise.bytes.append(char(rand() % (ANT_SYNC_BYTE-1)));
+            noise.msecs = i;
+            noise.good = false;
+            frames << noise;
+        }
+
+        unsigned char data[ANT_MAX_LENGTH];
+        data[0] = i % 4; // channel
+        for (int k=1; k<ANT_MAX_LENGTH; k++) data[k] = (i * 7 + k) % (ANT_SYNC_BYTE-1);
+
+        Frame f;
+        f.bytes = frame(0x4E, data, ANT_MAX_LENGTH);
+        f.msecs = i;
+        f.good = true;
+
+        if (rand() % 50 == 0) {
+            f.bytes[f.bytes.size()-1] = char(f.bytes[f.bytes.size()-1] ^ 0x01);
+            f.good = false;
+        }
+        frames << f;
+    }
+    return frames;
+}
+
+// writes the frames into the pty master in random sized pieces
+class Writer : public QThread
+{
+    public:
+        Writer(int fd, const QList<Frame> &frames) : fd(fd), frames(frames), done(0) {}
+
+        void run() {
+            QByteArray pending;
+            QElapsedTimer clock;
+            clock.start();
+
+            foreach(const Frame &f, frames) {
+                qint64 wait = f.msecs - clock.elapsed();
+                if (wait > 0) {
+                    flush(pending);
+                    msleep(wait);
+                }
+                pending += f.bytes;
+                if (pending.size() > rand() % 64) flush(pending);
+            }
+            flush(pending);
+            done.store(1);
+        }
+
+        int fd;
+        QList<Frame> frames;
+        QAtomicInt done;
+
+    private:
+        void flush(QByteArray &bytes) {
+            int at = 0;
+            while (at < bytes.size()) {
+                int rc = ::write(fd, bytes.constData() + at, bytes.size() - at);
+                if (rc > 0) at += rc;
+                else if (errno != EAGAIN && errno != EINTR) break;
+            }
+            bytes.clear();
+        }
+};
+
+int
+main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    QTextStream out(stdout);
+
+    double speedup = args.count() > 2 ? args[2].toDouble() : 10.0;
+    if (speedup <= 0) speedup = 1;
+    QList<Frame> frames = args.count() > 1 ? fromLog(args[1], speedup) : synthetic(20000);
+    if (frames.isEmpty()) {
+        out << "no messages to replay\n";
+        return 1;
+    }
+
+    // a pty pair, the slave set up the way ANT::openPort sets up a stick
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) || unlockpt(master)) {
+        out << "cannot open a pseudo terminal\n";
+        return 1;
+    }
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (slave < 0) {
+        out << "cannot open " << ptsname(master) << "\n";
+        return 1;
+    }
+    struct termios settings;
+    tcgetattr(slave, &settings);
+    cfmakeraw(&settings);
+    tcsetattr(slave, TCSANOW, &settings);
+
+    QList<QByteArray> expected;
+    qint64 bytes = 0;
+    foreach(const Frame &f, frames) {
+        bytes += f.bytes.size();
+        if (f.good) expected << f.bytes.left(f.bytes.size()-1); // checksum isn't kept
+    }
+
+    Writer writer(master, frames);
+    writer.start();
+
+    // the ANT thread's receive loop
+    ANTFramer rx;
+    unsigned char message[ANT_MAX_MESSAGE_SIZE];
+    int received = 0, mismatches = 0, reads = 0;
+    QElapsedTimer timer;
+    timer.start();
+
+    forever {
+        struct pollfd fds;
+        fds.fd = slave;
+        fds.events = POLLIN;
+        fds.revents = 0;
+
+        int rc = poll(&fds, 1, pollTimeout);
+        if (rc == 0) {
+            if (writer.done.load()) break;
+            continue;
+        }
+        if (rc < 0 && errno == EINTR) continue;
+        if (rc < 0) break;
+
+        int space;
+        unsigned char *into = rx.space(space);
+        rc = read(slave, into, space);
+        if (rc == -1 && (errno == EAGAIN || errno == EINTR)) continue;
+        if (rc <= 0) break;
+
+        reads++;
+        rx.received(rc);
+        while (rx.next(message)) {
+            if (received >= expected.count() ||
+                memcmp(message, expected[received].constData(), expected[received].size()) != 0)
+                mismatches++;
+            received++;
+        }
+    }
+    qint64 elapsed = timer.elapsed();
+    writer.wait();
+
+    out << "replayed " << frames.count() << " frames, " << bytes << " bytes in " << elapsed << "ms using " << reads << " reads\n";
+    out << "expected " << expected.count() << " messages, received " << received << ", mismatched " << mismatches << "\n";
+
+    close(slave);
+    close(master);
+
+    return (received == expected.count() && mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "LoadClient.h"
+
+LoadClient::LoadClient(QString host, quint16 port, QList<LoadRequest> requests, int offset, QObject *parent)
+    : QObject(parent), errors(0), reconnects(0), host(host), port(port), requests(requests),
+      next(requests.count() ? offset % requests.count() : 0), running(false)
+{
+    connect(&socket, SIGNAL(connected()), this, SLOT(connected()));
+    connect(&socket, SIGNAL(readyRead()), this, SLOT(readyRead()));
+    connect(&socket, SIGNAL(disconnected()), this, SLOT(disconnected()));
+}
+
+void
+LoadClient::start()
+{
+    if (requests.isEmpty()) return;
+    running = true;
+    socket.connectToHost(host, port);
+}
+
+void
+LoadClient::stop()
+{
+    // the request in flight is abandoned
+    running = false;
+    socket.abort();
+}
+
+void
+LoadClient::connected()
+{
+    send();
+}
+
+void
+LoadClient::send()
+{
+    if (!running) return;
+
+    buffer.clear();
+    QByteArray request = "GET " + requests[next].path.toUtf8() + " HTTP/1.1\r\n"
+                         "Host: " + host.toUtf8() + "\r\n"
+                         "Connection: keep-alive\r\n\r\n";
+    timer.start();
+    socket.write(request);
+}
+
+void
+LoadClient::readyRead()
+{
+    buffer.append(socket.readAll());
+    if (!running || !complete()) return;
+
+    qint64 elapsed = timer.nsecsElapsed();
+    latency[requests[next].route].append(elapsed);
+    if (!buffer.startsWith("HTTP/1.1 200") && !buffer.startsWith("HTTP/1.0 200")) errors++;
+
+    next = (next + 1) % requests.count();
+
+    // server wants to close, wait for it and reconnect
+    int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (buffer.left(headerEnd).toLower().contains("connection: close")) return;
+
+    send();
+}
+
+void
+LoadClient::disconnected()
+{
+    if (!running) return;
+    reconnects++;
+    socket.connectToHost(host, port);
+}
+
+bool
+LoadClient::complete()
+{
+    int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) return false;
+
+    int bodyStart = headerEnd + 4;
+    QList<QByteArray> headers = buffer.left(headerEnd).split('\n');
+
+    foreach(QByteArray header, headers) {
+        QByteArray lower = header.trimmed().toLower();
+
+        if (lower.startsWith("content-length:")) {
+            int length = lower.mid(15).trimmed().toInt();
+            return buffer.size() - bodyStart >= length;
+        }
+
+        if (lower.startsWith("transfer-encoding:") && lower.contains("chunked")) {
+
+            // walk the chunks, the last is zero length
+            int pos = bodyStart;
+            while (true) {
+                int eol = buffer.indexOf("\r\n", pos);
+                if (eol < 0) return false;
+
+                bool ok;
+                int size = buffer.mid(pos, eol - pos).trimmed().toInt(&ok, 16);
+                if (!ok) return true; // malformed, give up on it
+
+                if (size == 0) return buffer.indexOf("\r\n", eol + 2) >= 0;
+
+                pos = eol + 2 + size + 2;
+                if (pos > buffer.size()) return false;
+            }
+        }
+    }
+
+    // no length given, the body runs until the server closes
+    return false;
+}
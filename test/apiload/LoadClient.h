@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _GC_LoadClient_h
+#define _GC_LoadClient_h
+
+#include <QObject>
+#include <QTcpSocket>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QVector>
+#include <QMap>
+
+// one request the clients cycle through, route is the label
+// results are reported against (athlete and filename wildcarded)
+struct LoadRequest {
+    QString route;
+    QString path;
+};
+
+// A single keep-alive HTTP/1.1 connection that issues the requests
+// back to back, one in flight at a time, and records the latency of
+// each. The server answers with a Content-Length or chunked body.
+class LoadClient : public QObject
+{
+    Q_OBJECT
+
+    public:
+        LoadClient(QString host, quint16 port, QList<LoadRequest> requests, int offset, QObject *parent=NULL);
+
+        void start();
+        void stop();
+
+        // results, latencies in nanoseconds per route
+        QMap<QString, QVector<qint64> > latency;
+        int errors;      // non 200 responses
+        int reconnects;  // server closed a keep-alive connection
+
+    private slots:
+        void connected();
+        void readyRead();
+        void disconnected();
+
+    private:
+        void send();
+        bool complete(); // a whole response is in buffer
+
+        QString host;
+        quint16 port;
+        QList<LoadRequest> requests;
+        int next;
+        bool running;
+
+        QTcpSocket socket;
+        QByteArray buffer;
+        QElapsedTimer timer;
+};
+
+#endif // _GC_LoadClient_h
@@ -0,0 +1,17 @@
+#
+# Load test for the API web service. Builds a synthetic athlete directory,
+# starts GoldenCheetah --server against it with stats=true and drives
+# keep-alive clients at /athlete, /athlete/activity and /athlete/meanmax.
+#
+#   qmake && make
+#   ./apiload path/to/GoldenCheetah [clients] [seconds] [activities]
+#
+TEMPLATE = app
+TARGET = apiload
+QT += network
+QT -= gui
+CONFIG += console
+CONFIG -= app_bundle
+
+HEADERS += LoadClient.h
+SOURCES += LoadClient.cpp main.cpp
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "LoadClient.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+
+#include <cmath>
+
+static const char *athlete = "loadtest";
+static const quint16 port = 12099;
+
+//
+// The synthetic athlete: an hour of 1s samples per activity in GC json
+// and a rideDB.json listing them with a few metrics, enough for the
+// server to answer every route without an athlete ever being opened.
+//
+static bool
+writeFile(QString name, QString content)
+{
+    QFile file(name);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    QTextStream out(&file);
+    out << content;
+    file.close();
+    return true;
+}
+
+static QStringList
+buildAthlete(QDir home, int count)
+{
+    QStringList filenames;
+
+    home.mkpath(QString("%1/activities").arg(athlete));
+    home.mkpath(QString("%1/cache").arg(athlete));
+
+    QString ridedb = "{\n  \"VERSION\":\"1.9\",\n  \"RIDES\":[\n";
+    QDateTime start(QDate(2016, 1, 1), QTime(7, 0, 0), Qt::UTC);
+
+    for (int i=0; i<count; i++) {
+
+        QDateTime when = start.addDays(i);
+        QString filename = when.toString("yyyy_MM_dd_hh_mm_ss") + ".json";
+        filenames << filename;
+
+        // samples vary with the ride so no two are the same
+        QString samples;
+        double km = 0;
+        for (int secs=0; secs<3600; secs++) {
+            double watts = 200 + 80 * sin(secs / (60.0 + i)) + (secs % 30 == 0 ? 300 : 0);
+            double kph = 28 + 4 * sin(secs / 300.0);
+            km += kph / 3600.0;
+            if (secs) samples += ",\n";
+            samples += QString("\t\t\t{ \"SECS\":%1, \"KM\":%2, \"WATTS\":%3, \"CAD\":90, \"KPH\":%4, \"HR\":%5 }")
+                       .arg(secs).arg(km, 0, 'f', 5).arg(int(watts)).arg(kph, 0, 'f', 2).arg(120 + int(watts) / 10);
+        }
+        writeFile(home.absoluteFilePath(QString("%1/activities/%2").arg(athlete).arg(filename)),
+                  QString("{\n\t\"RIDE\":{\n\t\t\"STARTTIME\":\"%1\",\n\t\t\"RECINTSECS\":1,\n"
+                          "\t\t\"DEVICETYPE\":\"apiload\",\n\t\t\"IDENTIFIER\":\"\",\n"
+                          "\t\t\"TAGS\":{ \"Sport\":\"Bike\" },\n\t\t\"SAMPLES\":[\n%2\n\t\t]\n\t}\n}\n")
+                  .arg(when.toString("yyyy/MM/dd hh:mm:ss' UTC'")).arg(samples));
+
+        if (i) ridedb += ",\n";
+        ridedb += QString("\t{\n\t\t\"date\":\"%1\",\n\t\t\"filename\":\"%2\",\n\t\t\"fingerprint\":\"%3\",\n"
+                          "\t\t\"samples\":\"1\",\n\t\t\"METRICS\":{\n"
+                          "\t\t\t\"workout_time\":\"3600.00000\",\n\t\t\t\"total_distance\":\"%4\",\n"
+                          "\t\t\t\"average_power\":\"%5\"\n\t\t},\n"
+                          "\t\t\"TAGS\":{ \"Sport\":\"Bike\" }\n\t}")
+                  .arg(when.toString("yyyy/MM/dd hh:mm:ss' UTC'")).arg(filename).arg(i + 1)
+                  .arg(km, 0, 'f', 5).arg(200 + i % 20, 0, 'f', 5);
+    }
+    ridedb += "\n  ]\n}\n";
+    writeFile(home.absoluteFilePath(QString("%1/cache/rideDB.json").arg(athlete)), ridedb);
+
+    return filenames;
+}
+
+static QString
+percentile(QVector<qint64> values, double p)
+{
+    if (values.isEmpty()) return "-";
+    qSort(values);
+    int index = qMin(values.count() - 1, int(p * values.count()));
+    return QString::number(values[index] / 1000000.0, 'f', 2);
+}
+
+// one shot GET with the connection closed, for /_server/stats
+static QByteArray
+fetch(QString path)
+{
+    QTcpSocket socket;
+    socket.connectToHost("127.0.0.1", port);
+    if (!socket.waitForConnected(5000)) return QByteArray();
+    socket.write("GET " + path.toUtf8() + " HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n\r\n");
+
+    QByteArray reply;
+    while (socket.waitForReadyRead(5000)) reply += socket.readAll();
+    reply += socket.readAll();
+    int body = reply.indexOf("\r\n\r\n");
+    return body < 0 ? reply : reply.mid(body + 4);
+}
+
+int
+main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    QTextStream out(stdout);
+
+    if (args.count() < 2) {
+        out << "usage: apiload path/to/GoldenCheetah [clients] [seconds] [activities]\n";
+        return 1;
+    }
+    QString binary = args[1];
+    int clients = args.count() > 2 ? qMax(1, args[2].toInt()) : 8;
+    int seconds = args.count() > 3 ? qMax(1, args[3].toInt()) : 30;
+    int activities = args.count() > 4 ? qMax(1, args[4].toInt()) : 50;
+
+    QTemporaryDir temp;
+    if (!temp.isValid()) {
+        out << "cannot create a temporary athlete directory\n";
+        return 1;
+    }
+    QDir home(temp.path());
+    out << "building " << activities << " activities in " << home.absolutePath() << "\n";
+    out.flush();
+    QStringList filenames = buildAthlete(home, activities);
+
+    // enough handlers for every client, and stats on
+    writeFile(home.absoluteFilePath("httpserver.ini"),
+              QString("port=%1\nminThreads=1\nmaxThreads=%2\ncleanupInterval=1000\nreadTimeout=60000\n"
+                      "maxRequestSize=16000\nmaxMultiPartSize=1000000\nhost=127.0.0.1\nstats=true\n")
+              .arg(port).arg(clients));
+
+    QProcess server;
+    server.setProcessChannelMode(QProcess::ForwardedChannels);
+    server.start(binary, QStringList() << "--server" << home.absolutePath());
+    if (!server.waitForStarted(10000)) {
+        out << "cannot start " << binary << "\n";
+        return 1;
+    }
+
+    // wait for the listener to come up
+    bool up = false;
+    for (int i=0; i<100 && !up; i++) {
+        QTcpSocket probe;
+        probe.connectToHost("127.0.0.1", port);
+        up = probe.waitForConnected(100);
+        if (!up) QThread::msleep(100);
+    }
+    if (!up) {
+        out << "server did not start listening on port " << port << "\n";
+        server.kill();
+        server.waitForFinished();
+        return 1;
+    }
+
+    // the mix each client cycles through
+    QList<LoadRequest> requests;
+    foreach(QString filename, filenames) {
+        LoadRequest list = { "/athlete", QString("/%1").arg(athlete) };
+        LoadRequest activity = { "/athlete/activity/*", QString("/%1/activity/%2").arg(athlete).arg(filename) };
+        LoadRequest meanmax = { "/athlete/meanmax/*", QString("/%1/meanmax/%2").arg(athlete).arg(filename) };
+        requests << list << activity << meanmax;
+    }
+    LoadRequest bests = { "/athlete/meanmax/bests", QString("/%1/meanmax/bests").arg(athlete) };
+    requests << bests;
+
+    QList<LoadClient*> pool;
+    for (int i=0; i<clients; i++) {
+        // stagger the clients through the mix
+        pool << new LoadClient("127.0.0.1", port, requests, i * requests.count() / clients, &app);
+        pool.last()->start();
+    }
+
+    out << "driving " << clients << " keep-alive clients for " << seconds << "s\n";
+    out.flush();
+
+    QEventLoop loop;
+    QTimer::singleShot(seconds * 1000, &loop, SLOT(quit()));
+    loop.exec();
+
+    foreach(LoadClient *client, pool) client->stop();
+
+    // merge what the clients saw
+    QMap<QString, QVector<qint64> > latency;
+    int errors = 0, reconnects = 0;
+    foreach(LoadClient *client, pool) {
+        errors += client->errors;
+        reconnects += client->reconnects;
+        QMapIterator<QString, QVector<qint64> > it(client->latency);
+        while (it.hasNext()) {
+            it.next();
+            latency[it.key()] += it.value();
+        }
+    }
+
+    out << "\nclient view, times in ms\n";
+    out << QString("%1 %2 %3 %4 %5 %6\n").arg("route", -24).arg("requests", 9).arg("req/s", 9)
+                                         .arg("p50", 9).arg("p95", 9).arg("p99", 9);
+    QMapIterator<QString, QVector<qint64> > it(latency);
+    while (it.hasNext()) {
+        it.next();
+        out << QString("%1 %2 %3 %4 %5 %6\n").arg(it.key(), -24)
+                                             .arg(it.value().count(), 9)
+                                             .arg(double(it.value().count()) / seconds, 9, 'f', 1)
+                                             .arg(percentile(it.value(), 0.50), 9)
+                                             .arg(percentile(it.value(), 0.95), 9)
+                                             .arg(percentile(it.value(), 0.99), 9);
+    }
+    out << "errors " << errors << ", reconnects " << reconnects << "\n";
+
+    out << "\nserver view, /_server/stats\n" << fetch("/_server/stats");
+    out.flush();
+
+    server.kill();
+    server.waitForFinished();
+
+    return errors ? 1 : 0;
+}
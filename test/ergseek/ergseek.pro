@@ -0,0 +1,16 @@
+#
+# Times finding the current point and lap in a long synthetic workout,
+# walking the points and scanning the laps as ErgFile used to against
+# the binary search index it uses now, for playback and random seeks.
+#
+#   qmake && make && ./ergseek [hours] [lookups]
+#
+TEMPLATE = app
+TARGET = ergseek
+QT -= gui
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../../src/Train
+HEADERS += ../../src/Train/ErgFileIndex.h
+SOURCES += main.cpp
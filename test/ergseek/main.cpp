@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QList>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+#include "ErgFileIndex.h"
+
+//
+// The parts of ErgFile the lookups touch: points on the x axis in
+// msecs, the lap markers and the pair of points we are between.
+//
+struct Point {
+    double x;
+    double val;
+};
+
+struct Workout {
+    QList<Point> Points;
+    QList<long> Laps;
+    long Duration;
+    int leftPoint, rightPoint;
+};
+
+// what ErgFile::wattsAt() did before the index
+static int
+linear(Workout &erg, long x, int &lapnum)
+{
+    int lap=0;
+    for (int i=0; i<erg.Laps.count(); i++) {
+        if (x>=erg.Laps.at(i)) lap += 1;
+    }
+    lapnum = lap;
+
+    while (x < erg.Points.at(erg.leftPoint).x || x > erg.Points.at(erg.rightPoint).x) {
+        if (x < erg.Points.at(erg.leftPoint).x) {
+            erg.leftPoint--;
+            erg.rightPoint--;
+        } else if (x > erg.Points.at(erg.rightPoint).x) {
+            erg.leftPoint++;
+            erg.rightPoint++;
+        }
+    }
+    return erg.leftPoint;
+}
+
+// and what it does now
+static int
+indexed(Workout &erg, const ErgFileIndex &index, long x, int &lapnum)
+{
+    lapnum = index.lapAt(x);
+    index.findPoints(x, erg.leftPoint, erg.rightPoint);
+    return erg.leftPoint;
+}
+
+// look up every position, returns how many disagreed
+static int
+run(Workout &erg, const ErgFileIndex &index, const QVector<long> &positions,
+    qint64 &lineartime, qint64 &indexedtime)
+{
+    QVector<int> lefts(positions.count()), laps(positions.count());
+    QElapsedTimer timer;
+
+    erg.leftPoint = 0;
+    erg.rightPoint = 1;
+    timer.start();
+    for (int i=0; i<positions.count(); i++) lefts[i] = linear(erg, positions[i], laps[i]);
+    lineartime = timer.nsecsElapsed();
+
+    int mismatches = 0;
+    erg.leftPoint = 0;
+    erg.rightPoint = 1;
+    timer.start();
+    for (int i=0; i<positions.count(); i++) {
+        int lap;
+        int left = indexed(erg, index, positions[i], lap);
+
+        // where a position is exactly on a point either pair is
+        // right, so only the value there has to agree
+        if (lap != laps[i] || (left != lefts[i] && erg.Points.at(left).val != erg.Points.at(lefts[i]).val &&
+                               positions[i] != erg.Points.at(left).x && positions[i] != erg.Points.at(lefts[i]).x))
+            mismatches++;
+    }
+    indexedtime = timer.nsecsElapsed();
+    return mismatches;
+}
+
+int
+main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    QTextStream out(stdout);
+
+    int hours = args.count() > 1 ? args[1].toInt() : 4;
+    int lookups = args.count() > 2 ? args[2].toInt() : 20000;
+    if (hours < 1) hours = 1;
+    if (lookups < 1) lookups = 1;
+
+    // a ramp or a block every 5-30 seconds, a lap every 5 minutes,
+    // much like a long .erg built in the workout editor
+    qsrand(1);
+    Workout erg;
+    long x = 0;
+    erg.Duration = hours * 3600000L;
+    while (x < erg.Duration) {
+        Point p;
+        p.x = x;
+        p.val = 100 + qrand() % 300;
+        erg.Points << p;
+        if (x % 300000 < 5000) erg.Laps << x;
+        x += 5000 + (qrand() % 6) * 5000;
+    }
+    Point end;
+    end.x = erg.Duration;
+    end.val = erg.Points.last().val;
+    erg.Points << end;
+
+    ErgFileIndex index;
+    foreach(Point p, erg.Points) index.points << p.x;
+    foreach(long lap, erg.Laps) index.laps << lap;
+    index.sortLaps();
+
+    out << hours << " hours, " << erg.Points.count() << " points, " << erg.Laps.count() << " laps, "
+        << lookups << " lookups\n";
+
+    // playback, the trainer asks every 100ms or so
+    QVector<long> playback;
+    for (long t=0; t <= erg.Duration && playback.count() < lookups; t += 100) playback << t;
+
+    // seeking about, skipping laps and dragging the slider
+    QVector<long> seeks;
+    for (int i=0; i<lookups; i++) seeks << long((qint64(qrand()) * RAND_MAX + qrand()) % erg.Duration);
+
+    qint64 lineartime, indexedtime;
+    int mismatches = 0;
+
+    out << QString("%1 %2 %3 %4\n").arg("lookups", -10).arg("linear ms", 12).arg("index ms", 12).arg("speedup", 8);
+
+    mismatches += run(erg, index, playback, lineartime, indexedtime);
+    out << QString("%1 %2 %3 %4\n").arg("playback", -10)
+                                    .arg(lineartime / 1000000.0, 12, 'f', 2)
+                                    .arg(indexedtime / 1000000.0, 12, 'f', 2)
+                                    .arg(indexedtime ? double(lineartime) / indexedtime : 0, 8, 'f', 2);
+
+    mismatches += run(erg, index, seeks, lineartime, indexedtime);
+    out << QString("%1 %2 %3 %4\n").arg("seek", -10)
+                                    .arg(lineartime / 1000000.0, 12, 'f', 2)
+                                    .arg(indexedtime / 1000000.0, 12, 'f', 2)
+                                    .arg(indexedtime ? double(lineartime) / indexedtime : 0, 8, 'f', 2);
+
+    if (mismatches) out << mismatches << " lookups disagree\n";
+    return mismatches ? 1 : 0;
+}
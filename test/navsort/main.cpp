@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <QCoreApplication>
+#include <QAbstractTableModel>
+#include <QSortFilterProxyModel>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMap>
+#include <QRegExp>
+#include <QStringList>
+#include <QTextStream>
+#include <QTime>
+#include <QVector>
+
+
+//
+// RideNavigatorSortProxyModel and GroupByModel need a RideNavigator
+// and a whole athlete behind them, so the comparisons and grouping
+// steps they make are copied here and run over a table that answers
+// the way RideCacheModel does.
+//
+
+// as RideCacheModel::SortRole
+enum { SortRole = Qt::UserRole + 16 };
+
+enum { Date, Duration, IF, Work, Sport, Columns };
+static const char *names[] = { "Date", "Duration", "IF", "Work", "Sport" };
+
+struct Ride {
+    QDateTime date;
+    double duration, intensity, work;
+    QString sport;
+};
+
+class Rides : public QAbstractTableModel
+{
+    public:
+        Rides(const QVector<Ride> &rides) : rides(rides) {}
+
+        int rowCount(const QModelIndex &parent = QModelIndex()) const {
+            return parent.isValid() ? 0 : rides.count();
+        }
+        int columnCount(const QModelIndex &parent = QModelIndex()) const {
+            return parent.isValid() ? 0 : Columns;
+        }
+        QVariant headerData(int section, Qt::Orientation, int role = Qt::DisplayRole) const {
+            if (role != Qt::DisplayRole || section < 0 || section >= Columns) return QVariant();
+            return QString(names[section]);
+        }
+
+        // formatted as RideCacheModel::data() formats metrics, times as
+        // a QTime, high precision as a string and the rest rounded
+        QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const {
+
+            if (role != Qt::DisplayRole && role != Qt::EditRole && role != SortRole) return QVariant();
+            if (!index.isValid() || index.row() >= rides.count()) return QVariant();
+
+            const Ride &ride = rides[index.row()];
+            switch (index.column()) {
+            case Date: return ride.date;
+            case Duration:
+                if (role == SortRole) return ride.duration;
+                return QTime(0,0,0).addSecs(ride.duration);
+            case IF:
+                if (role == SortRole) return ride.intensity;
+                return QString::number(ride.intensity, 'f', 3);
+            case Work:
+                if (role == SortRole) return ride.work;
+                return double(qRound(ride.work));
+            case Sport: return ride.sport;
+            }
+            return QVariant();
+        }
+
+    private:
+        QVector<Ride> rides;
+};
+
+// the navigator sort as it was, everything through the display text
+class DisplaySort : public QSortFilterProxyModel
+{
+    protected:
+        bool lessThan(const QModelIndex &left, const QModelIndex &right) const {
+
+            QVariant leftData = sourceModel()->data(left);
+            QVariant rightData = sourceModel()->data(right);
+
+            if (leftData.type() == QVariant::DateTime) {
+                return leftData.toDateTime() < rightData.toDateTime();
+            }
+            QString leftString = leftData.toString();
+            QString rightString = rightData.toString();
+
+            if (leftString.contains(QRegExp("[^0-9.,]")) ||
+                    rightString.contains(QRegExp("[^0-9.,]"))) { // alpha
+                return QString::localeAwareCompare(leftString, rightString) < 0;
+            }
+            // assume numeric
+            return leftString.toDouble() < rightString.toDouble();
+        }
+};
+
+// and as it is now, numbers first
+class TypedSort : public DisplaySort
+{
+    protected:
+        bool lessThan(const QModelIndex &left, const QModelIndex &right) const {
+
+            QVariant leftData = sourceModel()->data(left, SortRole);
+            QVariant rightData = sourceModel()->data(right, SortRole);
+
+            if (leftData.type() == QVariant::Double && rightData.type() == QVariant::Double) {
+                return leftData.toDouble() < rightData.toDouble();
+            }
+            return DisplaySort::lessThan(left, right);
+        }
+};
+
+//
+// GroupByModel::setGroups() and whichGroup() with the metric quartiles
+// from groupFromValue(), ranking on role and mapping every row the way
+// the view does once grouped.
+//
+struct rankx {
+    double row;
+    double value;
+
+    bool operator< (rankx right) const {
+        return (value > right.value);  // sort ascending! (.gt not .lt)
+    }
+    static bool sortByRow(const rankx &left, const rankx &right) {
+        return (left.row < right.row); // sort ascending by row
+    }
+};
+
+static QString
+groupFromValue(int column, QString value, double rank, double count)
+{
+    if (column == Sport) return value;
+    if (column == Date) return QDateTime::fromString(value, Qt::ISODate).toString("yyyy-MM (MMMM)");
+
+    double quartile = rank / count;
+    if (value.toDouble() == 0 && column != Duration) return QString("Zero or not present");
+    else if (rank < 10) return QString("Best 10");
+    else if (quartile <= 0.25) return QString("Quartile 1:  0% -  25%");
+    else if (quartile <= 0.50) return QString("Quartile 2: 25% -  50%");
+    else if (quartile <= 0.75) return QString("Quartile 3: 50% -  75%");
+    else return QString("Quartile 4: 75% - 100%");
+}
+
+static QList<rankx>
+rankRows(const QAbstractItemModel *model, int column, int role)
+{
+    QList<rankx> rankedRows;
+    for (int i=0; i<model->rowCount(); i++) {
+        rankx rank;
+        rank.value = model->data(model->index(i,column), role).toDouble();
+        rank.row = i;
+        rankedRows << rank;
+    }
+    qSort(rankedRows); // sort by value
+    for (int i=0; i<rankedRows.count(); i++) rankedRows[i].value = i;
+    qStableSort(rankedRows.begin(), rankedRows.end(), rankx::sortByRow);
+    return rankedRows;
+}
+
+static QString
+whichGroup(const QAbstractItemModel *model, int column, const QList<rankx> &rankedRows, int row)
+{
+    return groupFromValue(column, model->data(model->index(row,column)).toString(),
+                          rankedRows[row].value, rankedRows.count());
+}
+
+static QStringList
+rowGroups(const QAbstractItemModel *model, int column, int role)
+{
+    QList<rankx> rankedRows = rankRows(model, column, role);
+    QStringList groups;
+    for (int i=0; i<model->rowCount(); i++) groups << whichGroup(model, column, rankedRows, i);
+    return groups;
+}
+
+// as it was, ranked on the display value and each row's group worked
+// out again whenever the view mapped it
+static int
+groupDisplay(const QAbstractItemModel *model, int column)
+{
+    QList<rankx> rankedRows = rankRows(model, column, Qt::DisplayRole);
+    QMap<QString, int> names;
+    for (int i=0; i<model->rowCount(); i++) names.insert(whichGroup(model, column, rankedRows, i), 0);
+    QStringList groups = names.keys();
+
+    int mapped = 0;
+    for (int i=0; i<model->rowCount(); i++)
+        if (groups.indexOf(whichGroup(model, column, rankedRows, i)) >= 0) mapped++;
+    return mapped;
+}
+
+// as it is now, ranked on SortRole, the row groups kept per column
+// and each row's group looked up when mapped
+static int
+groupTyped(const QAbstractItemModel *model, int column, QHash<int, QStringList> &groupCache)
+{
+    QStringList rows;
+    if (groupCache.contains(column)) rows = groupCache.value(column);
+    else {
+        rows = rowGroups(model, column, SortRole);
+        groupCache.insert(column, rows);
+    }
+
+    QMap<QString, int> names;
+    foreach(QString group, rows) names.insert(group, 0);
+    int n = 0;
+    for (QMap<QString, int>::iterator i = names.begin(); i != names.end(); ++i) i.value() = n++;
+
+    QVector<int> rowToGroup(rows.count());
+    for (int i=0; i<rows.count(); i++) rowToGroup[i] = names.value(rows[i]);
+
+    int mapped = 0;
+    for (int i=0; i<model->rowCount(); i++) if (rowToGroup[i] >= 0) mapped++;
+    return mapped;
+}
+
+// the sorted column must read in order
+static bool
+ordered(const QSortFilterProxyModel &proxy, int column)
+{
+    for (int i=1; i<proxy.rowCount(); i++) {
+        QVariant a = proxy.data(proxy.index(i-1, column), SortRole);
+        QVariant b = proxy.data(proxy.index(i, column), SortRole);
+        if (a.type() == QVariant::Double) {
+            if (a.toDouble() > b.toDouble()) return false;
+        } else if (a.type() == QVariant::DateTime) {
+            if (a.toDateTime() > b.toDateTime()) return false;
+        } else if (QString::localeAwareCompare(a.toString(), b.toString()) > 0) return false;
+    }
+    return true;
+}
+
+int
+main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    QTextStream out(stdout);
+
+    int count = args.count() > 1 ? args[1].toInt() : 10000;
+    int repeats = args.count() > 2 ? args[2].toInt() : 3;
+    if (count < 1) count = 1;
+    if (repeats < 1) repeats = 1;
+
+    // a decade or so of rides, about one a day
+    qsrand(1);
+    QStringList sports;
+    sports << "Bike" << "Run" << "Swim" << "Row";
+    QVector<Ride> list;
+    QDateTime when(QDate(2010,1,1), QTime(7,0,0));
+    for (int i=0; i<count; i++) {
+        Ride ride;
+        ride.date = when.addSecs(i * 86400 + (qrand() % 36000));
+        ride.duration = 600 + qrand() % 18000;
+        ride.intensity = (qrand() % 1200) / 1000.0;
+        ride.work = ride.duration * (0.1 + (qrand() % 300) / 1000.0);
+        ride.sport = sports[qrand() % sports.count()];
+        list << ride;
+    }
+    Rides rides(list);
+
+    DisplaySort display;
+    TypedSort typed;
+    display.setSourceModel(&rides);
+    typed.setSourceModel(&rides);
+
+    out << count << " rides, " << repeats << " repeats\n";
+    out << QString("%1 %2 %3 %4 %5 %6\n").arg("column", -10)
+                                         .arg("sort ms", 10).arg("typed ms", 10)
+                                         .arg("group ms", 10).arg("typed ms", 10).arg("speedup", 8);
+
+    int failures = 0;
+    QElapsedTimer timer;
+    for (int column=0; column<Columns; column++) {
+
+        qint64 sortdisplay=0, sorttyped=0, groupdisplay=0, grouptyped=0;
+        QHash<int, QStringList> groupCache;
+        int a=0, b=0;
+
+        for (int r=0; r<repeats; r++) {
+
+            // toggle the order so each repeat really sorts
+            Qt::SortOrder order = r % 2 ? Qt::DescendingOrder : Qt::AscendingOrder;
+
+            timer.start();
+            display.sort(column, order);
+            sortdisplay += timer.nsecsElapsed();
+
+            timer.start();
+            typed.sort(column, order);
+            sorttyped += timer.nsecsElapsed();
+
+            // grouping is redone whenever the view is reset
+            timer.start();
+            a += groupDisplay(&rides, column);
+            groupdisplay += timer.nsecsElapsed();
+
+            timer.start();
+            b += groupTyped(&rides, column, groupCache);
+            grouptyped += timer.nsecsElapsed();
+        }
+
+        // typed sort is in order, and the group cache is what
+        // grouping from scratch would give
+        typed.sort(column, Qt::AscendingOrder);
+        if (!ordered(typed, column)) {
+            out << names[column] << " is not sorted\n";
+            failures++;
+        }
+        if (groupCache.value(column) != rowGroups(&rides, column, SortRole)) {
+            out << names[column] << " groups differ\n";
+            failures++;
+        }
+        if (a != b) {
+            out << names[column] << " mapped " << a << " vs " << b << " rows\n";
+            failures++;
+        }
+
+        double before = (sortdisplay + groupdisplay) / 1000000.0 / repeats;
+        double after = (sorttyped + grouptyped) / 1000000.0 / repeats;
+        out << QString("%1 %2 %3 %4 %5 %6\n").arg(names[column], -10)
+                                             .arg(sortdisplay / 1000000.0 / repeats, 10, 'f', 2)
+                                             .arg(sorttyped / 1000000.0 / repeats, 10, 'f', 2)
+                                             .arg(groupdisplay / 1000000.0 / repeats, 10, 'f', 2)
+                                             .arg(grouptyped / 1000000.0 / repeats, 10, 'f', 2)
+                                             .arg(after > 0 ? before / after : 0, 8, 'f', 2);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,14 @@
+#
+# Times sorting and grouping a large synthetic ride list the way the
+# ride navigator does, comparing on the formatted display values as it
+# used to against the typed SortRole values and cached row groups.
+#
+#   qmake && make && ./navsort [rides] [repeats]
+#
+TEMPLATE = app
+TARGET = navsort
+QT -= gui
+CONFIG += console
+CONFIG -= app_bundle
+
+SOURCES += main.cpp
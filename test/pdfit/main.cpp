@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QStringList>
+#include <QTextStream>
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <cmath>
+
+#include "lmcurve.h"
+#include "lmcurve_user.h"
+
+//
+// The two models the estimator always fits, with the same functions
+// and starting values as CP2Model and CP3Model in PDModel.
+//
+class Model {
+    public:
+        virtual ~Model() {}
+        virtual int nparms() const = 0;
+        virtual void start(double *par) const = 0;
+        virtual double f(double t, const double *par) const = 0;
+};
+
+class CP2 : public Model {
+    public:
+        int nparms() const { return 2; }
+        void start(double *par) const { par[0] = 200; par[1] = 15000; }
+        double f(double t, const double *par) const { return par[0] + (par[1]/t); }
+};
+
+class CP3 : public Model {
+    public:
+        int nparms() const { return 3; }
+        void start(double *par) const { par[0] = 250; par[1] = 18000; par[2] = 32; }
+        double f(double t, const double *par) const { return par[0] + (par[1]/(t+par[2])); }
+};
+
+static CP2 cp2;
+static CP3 cp3;
+
+// a week's mean maximal power and what each model made of it
+struct Week {
+    QVector<double> t, p;
+    double cp2[2], cp3[3];
+};
+
+// the old way, the model behind a global so a mutex around the fit
+static QMutex calllmfit;
+static const Model *calllmfitmodel = NULL;
+static double calllmfitf(double t, const double *p) {
+    return calllmfitmodel->f(t, p);
+}
+
+static void
+fit(const Model &model, const Week &week, double *par)
+{
+    lm_control_struct control = lm_control_double;
+    lm_status_struct status;
+
+    model.start(par);
+    calllmfit.lock();
+    calllmfitmodel = &model;
+    lmcurve(model.nparms(), par, week.p.count(), week.t.constData(), week.p.constData(), calllmfitf, &control, &status);
+    calllmfit.unlock();
+}
+
+static void
+locked(Week &week)
+{
+    fit(cp2, week, week.cp2);
+    fit(cp3, week, week.cp3);
+}
+
+// and the new, the model passed through
+static double calllmfitfuser(double t, const double *p, void *model) {
+    return static_cast<const Model*>(model)->f(t, p);
+}
+
+static void
+fitUser(const Model &model, const Week &week, double *par)
+{
+    lm_control_struct control = lm_control_double;
+    lm_status_struct status;
+
+    model.start(par);
+    lmcurve_user(model.nparms(), par, week.p.count(), week.t.constData(), week.p.constData(),
+                 calllmfitfuser, const_cast<Model*>(&model), &control, &status);
+}
+
+static void
+reentrant(Week &week)
+{
+    fitUser(cp2, week, week.cp2);
+    fitUser(cp3, week, week.cp3);
+}
+
+static bool
+same(const QVector<Week> &a, const QVector<Week> &b)
+{
+    for (int i=0; i<a.count(); i++) {
+        for (int j=0; j<2; j++) if (a[i].cp2[j] != b[i].cp2[j]) return false;
+        for (int j=0; j<3; j++) if (a[i].cp3[j] != b[i].cp3[j]) return false;
+    }
+    return true;
+}
+
+int
+main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    QTextStream out(stdout);
+
+    int count = args.count() > 1 ? args[1].toInt() : 520;
+    if (count < 1) count = 1;
+
+    // an athlete whose CP drifts over the season, each week's bests
+    // from 2s to 20 minutes (what the 3 parameter model is fitted to)
+    // with a little noise so the fits don't converge instantly
+    qsrand(1);
+    QVector<Week> weeks(count);
+    for (int i=0; i<count; i++) {
+        double cp = 250 + 30 * sin(i / 8.0);
+        double w = 20000 + 2000 * cos(i / 5.0);
+        double k = 30;
+        for (int t=2; t<=1200; t++) {
+            weeks[i].t << t;
+            weeks[i].p << (cp + w/(t+k)) * (0.97 + (qrand() % 600) / 10000.0);
+        }
+    }
+
+    out << count << " weeks, " << QThread::idealThreadCount() << " threads\n";
+
+    QVector<Week> serial = weeks, mutex = weeks, parallel = weeks;
+    QElapsedTimer timer;
+
+    // as the estimator used to, one week after another
+    timer.start();
+    for (int i=0; i<serial.count(); i++) locked(serial[i]);
+    qint64 serialtime = timer.nsecsElapsed();
+
+    // all the weeks at once, but queued on the mutex
+    timer.start();
+    QtConcurrent::blockingMap(mutex, locked);
+    qint64 mutextime = timer.nsecsElapsed();
+
+    // all the weeks at once, each fit on its own
+    timer.start();
+    QtConcurrent::blockingMap(parallel, reentrant);
+    qint64 paralleltime = timer.nsecsElapsed();
+
+    out << QString("%1 %2 %3\n").arg("", -10).arg("ms", 10).arg("speedup", 8);
+    out << QString("%1 %2 %3\n").arg("serial", -10).arg(serialtime / 1000000.0, 10, 'f', 1).arg(1.0, 8, 'f', 2);
+    out << QString("%1 %2 %3\n").arg("mutex", -10).arg(mutextime / 1000000.0, 10, 'f', 1)
+                                .arg(mutextime ? double(serialtime) / mutextime : 0, 8, 'f', 2);
+    out << QString("%1 %2 %3\n").arg("parallel", -10).arg(paralleltime / 1000000.0, 10, 'f', 1)
+                                .arg(paralleltime ? double(serialtime) / paralleltime : 0, 8, 'f', 2);
+
+    // the fits must not depend on how they were run
+    if (!same(serial, mutex) || !same(serial, parallel)) {
+        out << "fitted parameters differ\n";
+        return 1;
+    }
+    out << QString("week 1 CP2 cp=%1 w'=%2, CP3 cp=%3 w'=%4 k=%5\n")
+           .arg(parallel[0].cp2[0], 0, 'f', 1).arg(parallel[0].cp2[1], 0, 'f', 0)
+           .arg(parallel[0].cp3[0], 0, 'f', 1).arg(parallel[0].cp3[1], 0, 'f', 0).arg(parallel[0].cp3[2], 0, 'f', 1);
+    return 0;
+}
@@ -0,0 +1,18 @@
+#
+# Times fitting the 2 and 3 parameter CP models to every week of a
+# synthetic season, through lmcurve with the model behind a global
+# and a mutex as PDModel used to, against lmcurve_user which passes
+# the model through so the weeks can be fitted in parallel.
+#
+#   qmake && make && ./pdfit [weeks]
+#
+TEMPLATE = app
+TARGET = pdfit
+QT += concurrent
+QT -= gui
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../../lmfit
+HEADERS += ../../lmfit/lmcurve.h ../../lmfit/lmcurve_user.h ../../lmfit/lmmin.h ../../lmfit/lmstruct.h
+SOURCES += ../../lmfit/lmcurve.c ../../lmfit/lmcurve_user.c ../../lmfit/lmmin.c main.cpp
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+#include <QDate>
+
+#include <cmath>
+
+#include "PMCSeries.h"
+
+//
+// A ride as PMCData sees it, the day it lands on and what it
+// contributes to that day's stress.
+//
+struct Ride {
+    int offset;
+    double value;
+    bool planned;
+};
+
+static const int stsDays = 7;
+static const int ltsDays = 42;
+
+// what PMCData::refresh() does, everything from scratch
+static void
+full(PMCSeries &series, const QVector<Ride> &rides, QDate start)
+{
+    series.clear();
+    series.seed[1] = 50; // a season seeded on the first day
+    foreach (Ride ride, rides) series.add(ride.offset, ride.value, ride.planned);
+    series.calculate(0, start, stsDays, ltsDays, false);
+}
+
+// what the chart does when it redraws, read every point
+static double
+redraw(const PMCSeries &series)
+{
+    double sum = 0;
+    for (int i = 0; i < series.stress.count(); i++) {
+        sum += series.stress[i] + series.lts[i] + series.sts[i] + series.sb[i] + series.rr[i];
+        sum += series.planned_lts[i] + series.planned_sts[i] + series.planned_sb[i];
+        sum += series.expected_lts[i] + series.expected_sts[i] + series.expected_sb[i];
+    }
+    return sum;
+}
+
+static bool
+same(const QVector<double> &a, const QVector<double> &b)
+{
+    if (a.count() != b.count()) return false;
+    for (int i = 0; i < a.count(); i++)
+        if (std::fabs(a[i] - b[i]) > 1e-6 * (1.0 + std::fabs(b[i]))) return false;
+    return true;
+}
+
+static bool
+same(const PMCSeries &a, const PMCSeries &b)
+{
+    return same(a.stress, b.stress) && same(a.lts, b.lts) && same(a.sts, b.sts) &&
+           same(a.sb, b.sb) && same(a.rr, b.rr) &&
+           same(a.planned_stress, b.planned_stress) && same(a.planned_lts, b.planned_lts) &&
+           same(a.planned_sts, b.planned_sts) && same(a.planned_sb, b.planned_sb) &&
+           same(a.planned_rr, b.planned_rr) &&
+           same(a.expected_lts, b.expected_lts) && same(a.expected_sts, b.expected_sts) &&
+           same(a.expected_sb, b.expected_sb) && same(a.expected_rr, b.expected_rr);
+}
+
+int
+main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    QTextStream out(stdout);
+
+    int years = args.count() > 1 ? args[1].toInt() : 15;
+    int edits = args.count() > 2 ? args[2].toInt() : 200;
+    if (years < 1) years = 1;
+    if (edits < 1) edits = 1;
+
+    // history ends a few weeks ahead of today so the planned and
+    // expected series have something to do, plus a year for decay
+    // as PMCData::dateRange() allows
+    QDate last = QDate::currentDate().addDays(28);
+    QDate start = last.addYears(-years).addDays(-1);
+    int days = start.daysTo(last.addDays(365)) + 1;
+
+    // roughly six rides a week, some doubles, planned ones
+    // only in the future
+    qsrand(1);
+    QVector<Ride> rides;
+    for (int day = 1; day <= start.daysTo(last); day++) {
+        int count = qrand() % 7 == 0 ? 0 : (qrand() % 5 == 0 ? 2 : 1);
+        for (int i = 0; i < count; i++) {
+            Ride ride;
+            ride.offset = day;
+            ride.value = 20 + qrand() % 180;
+            ride.planned = start.addDays(day) > QDate::currentDate();
+            rides << ride;
+        }
+    }
+
+    PMCSeries incremental, rebuilt;
+    incremental.resize(days);
+    rebuilt.resize(days);
+    full(incremental, rides, start);
+
+    out << years << " years, " << days << " days, " << rides.count() << " rides, " << edits << " edits\n";
+
+    qint64 fulltime = 0, incrementaltime = 0;
+    double checksum = 0; // full less incremental, keeps the redraws honest
+    int mismatches = 0;
+    QElapsedTimer timer;
+
+    for (int i = 0; i < edits; i++) {
+
+        // change one ride's stress, as editing it would
+        int index = qrand() % rides.count();
+        Ride old = rides[index];
+        rides[index].value = 20 + qrand() % 180;
+        Ride now = rides[index];
+
+        timer.start();
+        full(rebuilt, rides, start);
+        checksum += redraw(rebuilt);
+        fulltime += timer.nsecsElapsed();
+
+        // what PMCData::rideChanged() and the refresh after it do
+        timer.start();
+        incremental.add(old.offset, -old.value, old.planned);
+        incremental.add(now.offset, now.value, now.planned);
+        incremental.calculate(qMin(old.offset, now.offset), start, stsDays, ltsDays, false);
+        checksum -= redraw(incremental);
+        incrementaltime += timer.nsecsElapsed();
+
+        if (!same(incremental, rebuilt)) {
+            out << "mismatch after editing ride on day " << now.offset << "\n";
+            mismatches++;
+        }
+    }
+
+    double f = double(fulltime) / 1000000.0 / edits;
+    double n = double(incrementaltime) / 1000000.0 / edits;
+    out << QString("%1 %2\n").arg("full ms", 16).arg(f, 10, 'f', 3);
+    out << QString("%1 %2\n").arg("incremental ms", 16).arg(n, 10, 'f', 3);
+    out << QString("%1 %2\n").arg("speedup", 16).arg(n > 0 ? f / n : 0, 10, 'f', 2);
+    out << QString("%1 %2\n").arg("redraw delta", 16).arg(checksum, 10, 'g', 3);
+
+    return mismatches ? 1 : 0;
+}
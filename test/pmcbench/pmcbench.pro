@@ -0,0 +1,17 @@
+#
+# Times redrawing the PMC after editing one ride on a long synthetic
+# history, rebuilding every series from scratch against adjusting the
+# ride's stress and re-running the recurrences from its day onwards.
+#
+#   qmake && make && ./pmcbench [years] [edits]
+#
+TEMPLATE = app
+TARGET = pmcbench
+QT -= gui
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../../src/Metrics
+
+HEADERS += ../../src/Metrics/PMCSeries.h
+SOURCES += ../../src/Metrics/PMCSeries.cpp main.cpp
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2026 GoldenCheetah Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation; either version 2 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc., 51
+ * Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QProcess>
+#include <QStringList>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <QXmlDefaultHandler>
+#include <QXmlStreamReader>
+
+//
+// Both readers do the work the activity parsers do per element: gather
+// the text and convert it to a number when the element closes. The sum
+// is returned so neither loop can be optimised away and so the two can
+// be checked against each other.
+//
+
+// the old way, as TcxParser and friends were written against SAX
+class SaxBench : public QXmlDefaultHandler
+{
+    public:
+        SaxBench() : sum(0), elements(0) {}
+
+        bool startElement(const QString&, const QString&, const QString&, const QXmlAttributes&) {
+            buffer.clear();
+            return true;
+        }
+        bool endElement(const QString&, const QString&, const QString& qName) {
+            if (qName != "Time" && qName != "time") sum += buffer.toDouble();
+            elements++;
+            return true;
+        }
+        bool characters(const QString &str) {
+            buffer += str;
+            return true;
+        }
+
+        double sum;
+        int elements;
+
+    private:
+        QString buffer;
+};
+
+static double
+sax(QFile &file, int &elements)
+{
+    SaxBench handler;
+    QXmlInputSource source(&file);
+    QXmlSimpleReader reader;
+    reader.setContentHandler(&handler);
+    reader.parse(source);
+    elements = handler.elements;
+    return handler.sum;
+}
+
+// the pull loop the readers now use
+static double
+pull(QFile &file, int &elements)
+{
+    double sum = 0;
+    QString buffer;
+    QXmlStreamReader xml(&file);
+    xml.setNamespaceProcessing(false);
+
+    elements = 0;
+    while (!xml.atEnd()) {
+        switch (xml.readNext()) {
+        case QXmlStreamReader::StartElement:
+            buffer.resize(0);
+            break;
+        case QXmlStreamReader::EndElement:
+            if (xml.qualifiedName() != QLatin1String("Time") && xml.qualifiedName() != QLatin1String("time"))
+                sum += buffer.toDouble();
+            elements++;
+            break;
+        case QXmlStreamReader::Characters:
+            buffer.append(xml.text());
+            break;
+        default:
+            break;
+        }
+    }
+    return sum;
+}
+
+//
+// The real readers. TcxParser, GpxParser, PwxRideFile, GcRideFile and
+// the rest need RideFile and so the whole application, so they are
+// driven through a GoldenCheetah binary running as an API server: the
+// samples are copied into a scratch athlete and each is fetched as csv
+// from /athlete/activity, which reads it through RideFileFactory. Give
+// a build from before the change and one from after to compare them,
+// the csv from each must match.
+//
+static const char *athlete = "xmlbench";
+static const quint16 port = 12098;
+
+// one GET on its own connection, the body or empty on failure
+static QByteArray
+fetch(QString path)
+{
+    QTcpSocket socket;
+    socket.connectToHost("127.0.0.1", port);
+    if (!socket.waitForConnected(5000)) return QByteArray();
+    socket.write("GET " + path.toUtf8() + " HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n\r\n");
+
+    QByteArray reply;
+    while (socket.waitForReadyRead(30000)) reply += socket.readAll();
+    reply += socket.readAll();
+    if (!reply.startsWith("HTTP/1.1 200")) return QByteArray();
+    int body = reply.indexOf("\r\n\r\n");
+    return body < 0 ? QByteArray() : reply.mid(body + 4);
+}
+
+// time every file through one binary, the csv for each is kept
+static bool
+serve(QString binary, QDir home, QStringList files, int iterations,
+      QMap<QString, qint64> &time, QMap<QString, QByteArray> &csv)
+{
+    QTextStream out(stdout);
+
+    QProcess server;
+    server.setProcessChannelMode(QProcess::ForwardedChannels);
+    server.start(binary, QStringList() << "--server" << home.absolutePath());
+    if (!server.waitForStarted(10000)) {
+        out << "cannot start " << binary << "\n";
+        return false;
+    }
+
+    bool up = false;
+    for (int i=0; i<100 && !up; i++) {
+        QTcpSocket probe;
+        probe.connectToHost("127.0.0.1", port);
+        up = probe.waitForConnected(100);
+        if (!up) QThread::msleep(100);
+    }
+
+    bool ok = up;
+    if (!up) out << "server did not start listening on port " << port << "\n";
+
+    foreach (QString name, files) {
+        if (!ok) break;
+
+        QString path = QString("/%1/activity/%2?format=csv").arg(athlete).arg(name);
+        QString ext = QFileInfo(name).suffix().toLower();
+        QElapsedTimer timer;
+
+        timer.start();
+        for (int i = 0; i < iterations; i++) {
+            csv[name] = fetch(path);
+            if (csv[name].isEmpty()) {
+                out << binary << " could not read " << name << "\n";
+                ok = false;
+                break;
+            }
+        }
+        time[ext] += timer.nsecsElapsed();
+    }
+
+    server.kill();
+    server.waitForFinished();
+    return ok;
+}
+
+static int
+readers(QStringList binaries, QString path, int iterations)
+{
+    QTextStream out(stdout);
+
+    QDir dir(path);
+    QStringList filters;
+    filters << "*.tcx" << "*.gpx" << "*.pwx" << "*.gc" << "*.sml" << "*.fitlog" << "*.smf" << "*.slf";
+    QStringList files = dir.entryList(filters, QDir::Files, QDir::Name);
+    if (files.isEmpty()) {
+        out << "no XML activity files in " << dir.absolutePath() << "\n";
+        return 1;
+    }
+
+    // a scratch athlete holding copies of the samples
+    QTemporaryDir temp;
+    if (!temp.isValid()) {
+        out << "cannot create a temporary athlete directory\n";
+        return 1;
+    }
+    QDir home(temp.path());
+    home.mkpath(QString("%1/activities").arg(athlete));
+    home.mkpath(QString("%1/cache").arg(athlete));
+
+    QMap<QString, qint64> bytes;
+    foreach (QString name, files) {
+        QFile::copy(dir.absoluteFilePath(name), home.absoluteFilePath(QString("%1/activities/%2").arg(athlete).arg(name)));
+        bytes[QFileInfo(name).suffix().toLower()] += QFileInfo(dir.absoluteFilePath(name)).size();
+    }
+
+    QFile ridedb(home.absoluteFilePath(QString("%1/cache/rideDB.json").arg(athlete)));
+    if (ridedb.open(QIODevice::WriteOnly)) {
+        ridedb.write("{\n  \"VERSION\":\"1.9\",\n  \"RIDES\":[\n  ]\n}\n");
+        ridedb.close();
+    }
+
+    QFile ini(home.absoluteFilePath("httpserver.ini"));
+    if (ini.open(QIODevice::WriteOnly)) {
+        ini.write(QString("port=%1\nminThreads=1\nmaxThreads=4\ncleanupInterval=1000\nreadTimeout=60000\n"
+                          "maxRequestSize=16000\nmaxMultiPartSize=1000000\nhost=127.0.0.1\n").arg(port).toUtf8());
+        ini.close();
+    }
+
+    QList<QMap<QString, qint64> > times;
+    QList<QMap<QString, QByteArray> > csvs;
+    foreach (QString binary, binaries) {
+        QMap<QString, qint64> time;
+        QMap<QString, QByteArray> csv;
+        if (!serve(binary, home, files, iterations, time, csv)) return 1;
+        times << time;
+        csvs << csv;
+    }
+
+    // what came back must not depend on which build read it
+    int mismatches = 0;
+    for (int i = 1; i < csvs.count(); i++) {
+        foreach (QString name, files) {
+            if (csvs[i].value(name) != csvs[0].value(name)) {
+                out << name << " reads differently in " << binaries[i] << "\n";
+                mismatches++;
+            }
+        }
+    }
+
+    out << QString("%1 %2").arg("format", -8).arg("KB", 8);
+    for (int i = 0; i < binaries.count(); i++) out << QString(" %1").arg(QString("ms %1").arg(i+1), 10);
+    if (binaries.count() == 2) out << QString(" %1").arg("speedup", 8);
+    out << "\n";
+
+    foreach (QString ext, bytes.keys()) {
+        out << QString("%1 %2").arg(ext, -8).arg(bytes[ext] / 1024, 8);
+        for (int i = 0; i < times.count(); i++)
+            out << QString(" %1").arg(double(times[i].value(ext)) / 1000000.0 / iterations, 10, 'f', 2);
+        if (times.count() == 2) {
+            double before = times[0].value(ext), after = times[1].value(ext);
+            out << QString(" %1").arg(after > 0 ? before / after : 0, 8, 'f', 2);
+        }
+        out << "\n";
+    }
+    return mismatches ? 1 : 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+
+    // xmlbench --readers before/GoldenCheetah [after/GoldenCheetah] [ridesdir] [iterations]
+    if (args.count() > 2 && args[1] == "--readers") {
+        QStringList binaries;
+        binaries << args[2];
+        int next = 3;
+        if (args.count() > next && QFileInfo(args[next]).isFile()) binaries << args[next++];
+        QString path = args.count() > next ? args[next] : QString("../rides");
+        int iterations = args.count() > next+1 ? qMax(1, args[next+1].toInt()) : 5;
+        return readers(binaries, path, iterations);
+    }
+
+    QString path = args.count() > 1 ? args[1] : QString("../rides");
+    int iterations = args.count() > 2 ? args[2].toInt() : 20;
+    if (iterations < 1) iterations = 1;
+
+    QDir dir(path);
+    QStringList filters;
+    filters << "*.tcx" << "*.gpx" << "*.pwx" << "*.sml" << "*.fitlog" << "*.smf" << "*.slf";
+    QStringList files = dir.entryList(filters, QDir::Files, QDir::Name);
+
+    QTextStream out(stdout);
+    if (files.isEmpty()) {
+        out << "no XML activity files in " << dir.absolutePath() << "\n";
+        return 1;
+    }
+
+    // per extension totals
+    QMap<QString, qint64> saxtime, pulltime, bytes;
+    int mismatches = 0;
+
+    foreach (QString name, files) {
+        QFile file(dir.absoluteFilePath(name));
+        QString ext = QFileInfo(name).suffix().toLower();
+        bytes[ext] += file.size();
+
+        double saxsum = 0, pullsum = 0;
+        int saxelements = 0, pullelements = 0;
+        QElapsedTimer timer;
+
+        timer.start();
+        for (int i = 0; i < iterations; i++) {
+            file.open(QIODevice::ReadOnly);
+            saxsum = sax(file, saxelements);
+            file.close();
+        }
+        saxtime[ext] += timer.nsecsElapsed();
+
+        timer.start();
+        for (int i = 0; i < iterations; i++) {
+            file.open(QIODevice::ReadOnly);
+            pullsum = pull(file, pullelements);
+            file.close();
+        }
+        pulltime[ext] += timer.nsecsElapsed();
+
+        if (saxelements != pullelements || saxsum != pullsum) {
+            out << "mismatch in " << name << ": " << saxelements << " vs " << pullelements << " elements\n";
+            mismatches++;
+        }
+    }
+
+    out << QString("%1 %2 %3 %4 %5\n").arg("format", -8).arg("KB", 8).arg("sax ms", 10).arg("pull ms", 10).arg("speedup", 8);
+    foreach (QString ext, bytes.keys()) {
+        double s = double(saxtime[ext]) / 1000000.0 / iterations;
+        double p = double(pulltime[ext]) / 1000000.0 / iterations;
+        out << QString("%1 %2 %3 %4 %5\n").arg(ext, -8)
+                                        .arg(bytes[ext] / 1024, 8)
+                                        .arg(s, 10, 'f', 2)
+                                        .arg(p, 10, 'f', 2)
+                                        .arg(p > 0 ? s / p : 0, 8, 'f', 2);
+    }
+    return mismatches ? 1 : 0;
+}
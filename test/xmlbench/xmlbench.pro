@@ -0,0 +1,20 @@
+#
+# Times the two ways GoldenCheetah reads XML activity files, the SAX
+# handlers and the QXmlStreamReader pull loop, over the sample rides.
+#
+#   qmake && make && ./xmlbench [ridesdir] [iterations]
+#
+# With --readers it times the real activity readers instead, through
+# GoldenCheetah builds running as an API server, from before and after
+# a change, and checks both read every sample the same.
+#
+#   ./xmlbench --readers before/GoldenCheetah after/GoldenCheetah [ridesdir] [iterations]
+#
+TEMPLATE = app
+TARGET = xmlbench
+QT += xml network
+QT -= gui
+CONFIG += console
+CONFIG -= app_bundle
+
+SOURCES += main.cpp